@@ -14,81 +14,51 @@
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
 
 //ROOT includes
 #include "TH2F.h"
 #include "TH1F.h"
+#include "TParameter.h"
+#include "TProfile2D.h"
+#include "TSystem.h"
+#include "TTree.h"
 
-//---------------------------------------------------------------------------------------
-// Define a set of structs for use interpreting the output from G4CMP
-struct Hit
-{
-  int runID;
-  int eventID;
-  int trackID;
-  std::string particleName;
-  double startEnergy_eV;
-  double startX_mm;
-  double startY_mm;
-  double startZ_mm;
-  double startT_ns;
-  double eDep_eV;
-  double trackWeight;
-  double endX_mm;
-  double endY_mm;
-  double endZ_mm;
-  double endT_ns;
-};
+//Hit/PrimaryInfo/Event structs, the streaming reader for G4CMP output
+//and the multithreaded event loop
+#include "FourQubitEventStream.hh"
+#include "FourQubitParallelFill.hh"
 
-struct PrimaryInfo
-{
-  int runID;
-  int eventID;
-  int trackID;
-  std::string particleName;
-  double energy_eV;
-  double X_mm;
-  double Y_mm;
-  double Z_mm;
-  double T_ns;  
-};
+//Hit-to-qubit assignment from the simulation's geometry description file
+#include "FourQubitQubitIndex.hh"
 
-struct Event
-{
-  int runID;
-  int eventID;
-  std::vector<Hit> hitVect;
-  PrimaryInfo thePrim;
-};
+//Binned, kernel-convolved per-channel pulses
+#include "FourQubitPulseSynth.hh"
 
-//Forward declarations
-std::vector<Event> ReadInG4CMPPrimaryAndHitFiles(std::string hitTextFilename, std::string primaryTextFilename);
-std::map<int,std::vector<Hit> > ParseHitTextFileForHits(std::string filename);
-std::map<int,PrimaryInfo> ParsePrimaryTextFileForPrimaries(std::string filename);
-int FindClosestQubitID(double hitX_mm, double hitY_mm);
-  
-void AnalyzeMuonEvent(std::string primariesFilename, std::string hitsFilename,double scaleFactorEHPairs)
-{
-  //Read in the text files
-  std::vector<Event> eventList = ReadInG4CMPPrimaryAndHitFiles(hitsFilename,primariesFilename);
-  std::cout << "Done reading in events." << std::endl;
+//Reference-versus-fast statistical tests and the benchmark JSON reader
+#include "FourQubitCompare.hh"
 
-  //Define an outfile
-  TFile * fOut = new TFile("AnalysisOutput.root","RECREATE");
-  
-  //Define a number of histograms for the hits
-  TH1F * h_eDep = new TH1F("h_eDep","Hit EDeps; log10(eDep[eV]); nEvents",200,-6,1);
-  TH1F * h_qubitTotalHitEnergy_singleEvent = new TH1F("h_qubitTotalHitEnergy_singleEvent","In-Qubit Total Energy; Qubit ID; Energy [eV]",6,0,6);
-  TH2F * h_hitXY = new TH2F("h_nHitsXY","XY Locations of Hits; X [mm]; Y [mm]; NHits/bin",200,-5,5,200,-5,5);
-  TH2F * h_hitYZ = new TH2F("h_nHitsYZ","YZ Locations of Hits; Y [mm]; Z [mm]; NHits/bin",200,-5,5,200,4.6,5.02);
-  TH2F * h_hitXZ = new TH2F("h_nHitsXZ","XZ Locations of Hits; X [mm]; Z [mm]; NHits/bin",200,-5,5,200,4.6,5.02);
-  
-  //Loop over events
-  for( int iE = 0; iE < eventList.size(); ++iE ){
-    if( iE % 1000 == 0 ) std::cout << "Done with " << iE << " event histogram fills." << std::endl;
-    
-    //Get the event
-    Event tE = eventList[iE];
+//---------------------------------------------------------------------------------------
+// Histograms of AnalyzeMuonEvent, filled per thread slot. A suffix on the names
+// keeps two sets apart in one file (CompareFastMode).
+struct MuonEventHists
+{
+  MuonEventHists(const QubitIndex& qubits, int nSlots, std::string suffix = "") :
+    fQubits(qubits),
+    h_eDep(new TH1F(("h_eDep"+suffix).c_str(),"Hit EDeps; log10(eDep[eV]); nEvents",200,-6,1),nSlots),
+    h_qubitTotalHitEnergy_singleEvent(new TH1F(("h_qubitTotalHitEnergy_singleEvent"+suffix).c_str(),"In-Qubit Total Energy; Qubit ID; Energy [eV]",qubits.NumberOfQubits(),0,qubits.NumberOfQubits()),nSlots),
+    h_hitXY(new TH2F(("h_nHitsXY"+suffix).c_str(),"XY Locations of Hits; X [mm]; Y [mm]; NHits/bin",200,-5,5,200,-5,5),nSlots),
+    h_hitYZ(new TH2F(("h_nHitsYZ"+suffix).c_str(),"YZ Locations of Hits; Y [mm]; Z [mm]; NHits/bin",200,-5,5,200,4.6,5.02),nSlots),
+    h_hitXZ(new TH2F(("h_nHitsXZ"+suffix).c_str(),"XZ Locations of Hits; X [mm]; Z [mm]; NHits/bin",200,-5,5,200,4.6,5.02),nSlots)
+  {}
+
+  //Every fill carries the event's sampling weight, which is 1 unless the
+  //primaries were biased (/g4cmp/PrimarySampling biased)
+  void Fill(const Event& tE, int slot)
+  {
+    double w = tE.thePrim.weight;
     
     //Plot a number of hit-related things: 
     for ( int iH = 0; iH < tE.hitVect.size(); ++iH ){
@@ -99,292 +69,500 @@ void AnalyzeMuonEvent(std::string primariesFilename, std::string hitsFilename,do
       double hitZ_mm = tE.hitVect[iH].endZ_mm;      
       double energy_eV = tE.hitVect[iH].eDep_eV;
 
-      //From hit XY, figure out which qubit we're closest to, and add the
-      //energy to that qubit id
-      int closestQubitID = FindClosestQubitID(hitX_mm,hitY_mm);
-      h_qubitTotalHitEnergy_singleEvent->Fill(closestQubitID,energy_eV);
+      //The simulation records which qubit each hit landed on; only older files
+      //without that column fall back to the footprint lookup from hit XY. Hits
+      //off every qubit go to the underflow bin.
+      int qubitID = tE.hitVect[iH].qubitID;
+      if( qubitID == kUnknownVolumeID ) qubitID = fQubits.Find(hitX_mm,hitY_mm);
+      h_qubitTotalHitEnergy_singleEvent[slot]->Fill(qubitID,w*energy_eV);
       
       //Plot other hit information
-      h_hitXY->Fill(hitX_mm,hitY_mm);
-      h_hitYZ->Fill(hitY_mm,hitZ_mm);
-      h_hitXZ->Fill(hitX_mm,hitZ_mm);
+      h_hitXY[slot]->Fill(hitX_mm,hitY_mm,w);
+      h_hitYZ[slot]->Fill(hitY_mm,hitZ_mm,w);
+      h_hitXZ[slot]->Fill(hitX_mm,hitZ_mm,w);
     }
   }
 
-  //Last up, we need to remember that we did downsampling, so we need to scale our simulations back up to match
-  h_qubitTotalHitEnergy_singleEvent->Scale(1.0/scaleFactorEHPairs);
-  
-  fOut->Write();
-}
+  //Sum the per-thread clones back into the output histograms
+  void Merge()
+  {
+    h_eDep.Merge();
+    h_qubitTotalHitEnergy_singleEvent.Merge();
+    h_hitXY.Merge();
+    h_hitYZ.Merge();
+    h_hitXZ.Merge();
+  }
 
-//---------------------------------------------------------------------------------------
-// This is a bit of a kludge. What we really should do is pass the hit VOLUME out of
-// G4CMP in the hit info. However, this involves some broader modifications to G4CMP
-// beyond this example so we're kludging it together with this function.
-int FindClosestQubitID(double hitX_mm, double hitY_mm)
-{
-  const int nQubits = 6;
-  double qubitXY[nQubits][2] = {{-1.85,1.8},
-				{0,1.8},
-				{1.85,1.8},
-				{-1.85,-1.8},
-				{0,-1.8},
-				{1.85,-1.8}};
-  double lowestDeltaR2_mm = 1000000;
-  int theQubitID = -1;
-  for( int iQ = 0; iQ < nQubits; ++iQ ){
-    double deltaR2_mm = TMath::Power((qubitXY[iQ][0] - hitX_mm),2) + TMath::Power((qubitXY[iQ][1] - hitY_mm),2);
-    if( deltaR2_mm < lowestDeltaR2_mm ){
-      lowestDeltaR2_mm = deltaR2_mm;
-      theQubitID = iQ;
-    }
+  //Last up, we need to remember that we did downsampling, so we need to scale our simulations back up to match
+  void Finish(double scaleFactorEHPairs)
+  {
+    h_qubitTotalHitEnergy_singleEvent->Scale(1.0/scaleFactorEHPairs);
   }
-  return theQubitID;	 
-}
 
+  const QubitIndex& fQubits;
+  SlotHist<TH1F> h_eDep;
+  SlotHist<TH1F> h_qubitTotalHitEnergy_singleEvent;
+  SlotHist<TH2F> h_hitXY;
+  SlotHist<TH2F> h_hitYZ;
+  SlotHist<TH2F> h_hitXZ;
+};
 
 //---------------------------------------------------------------------------------------
-// Analysis Script: Phonon Collection Efficiency
-void PCEStudy(std::string primariesFilename, std::string hitsFilename)
+// Analysis Script: Muon Event. Either filename may be a comma-separated list
+// of per-thread shards (matched in order); nThreads = 0 uses every core.
+// Qubit footprints come from the geometry file written by the simulation.
+void AnalyzeMuonEvent(std::string primariesFilename, std::string hitsFilename,double scaleFactorEHPairs,int nThreads = 0,
+		      std::string geometryFilename = "FourQubit_geometry.txt")
 {
-  //Read in the text files
-  std::vector<Event> eventList = ReadInG4CMPPrimaryAndHitFiles(hitsFilename,primariesFilename);
-  std::cout << "Done reading in events." << std::endl;
+  QubitIndex qubits;
+  if( !qubits.Load(geometryFilename) ) return;
 
+  //Files are streamed one event at a time, one file pair per thread
+  std::vector<std::string> hitFiles = SplitFileList(hitsFilename);
+  std::vector<std::string> primFiles = SplitFileList(primariesFilename);
+  int nSlots = NumberOfSlots(nThreads,hitFiles,primFiles);
 
   //Define an outfile
   TFile * fOut = new TFile("AnalysisOutput.root","RECREATE");
   
   //Define a number of histograms for the hits
-  TH1F * h_nHits = new TH1F("h_nHits","Number of Hits Per Event; nHits; nEvents",100,0,100);
-  TH1F * h_eDep = new TH1F("h_eDep","Hit EDeps; log10(eDep[eV]); nEvents",200,-6,1);  
-  TH2F * h_hitXY = new TH2F("h_nHitsXY","XY Locations of Hits; X [mm]; Y [mm]; NHits/bin",200,-5,5,200,-5,5);
-  TH2F * h_hitYZ = new TH2F("h_nHitsYZ","YZ Locations of Hits; Y [mm]; Z [mm]; NHits/bin",200,-5,5,200,4.6,5.02);
-  TH2F * h_hitXZ = new TH2F("h_nHitsXZ","XZ Locations of Hits; X [mm]; Z [mm]; NHits/bin",200,-5,5,200,4.6,5.02);
-  
-  //Define a number of histograms for the primaries
-  TH2F * h_primXY = new TH2F("h_primXY","XY Location of Primary; X [mm]; Y [mm]; Primaries/bin",200,-5,5,200,-5,5);
-  TH2F * h_primYZ = new TH2F("h_primYZ","YZ Location of Primary; Y [mm]; Z [mm]; Primaries/bin",200,-5,5,200,4.6,5.02);
-  TH2F * h_primXZ = new TH2F("h_primXZ","XZ Location of Primary; X [mm]; Z [mm]; Primaries/bin",200,-5,5,200,4.6,5.02);
-
-  //Define histograms useful for calculating PCE
-  int nPCEBinsX = 50;
-  int nPCEBinsY = 50;
-  TH2F * h_totalHitEnergyAtPrimaryXY = new TH2F("h_totalHitEnergyAtPrimaryXY","Total Energy of Hits Generated by Primaries at this XY; X [mm]; Y [mm]; Energy/bin [eV]",nPCEBinsX,-5,5,nPCEBinsY,-5,5);
-  TH2F * h_totalPrimaryEnergyAtPrimaryXY = new TH2F("h_totalPrimaryEnergyAtPrimaryXY","Total Energy of Primaries at this XY; X [mm]; Y [mm]; Energy/bin [eV]",nPCEBinsX,-5,5,nPCEBinsY,-5,5);
-  TH2F * h_pceVsXY = new TH2F("h_pceVsXY","Phonon Collection Efficiency vs. Primary XY; X [mm]; Y [mm]; PCE",nPCEBinsX,-5,5,nPCEBinsY,-5,5);
-  
+  MuonEventHists hists(qubits,nSlots);
   
   //Loop over events
-  for( int iE = 0; iE < eventList.size(); ++iE ){
-    if( iE % 1000 == 0 ) std::cout << "Done with " << iE << " event histogram fills." << std::endl;
+  ProcessEvents(hitFiles,primFiles,nSlots,[&](const Event& tE, int slot){ hists.Fill(tE,slot); });
 
-    //Get the event
-    Event tE = eventList[iE];
-    
+  hists.Merge();
+  hists.Finish(scaleFactorEHPairs);
+  
+  fOut->Write();
+}
+
+//---------------------------------------------------------------------------------------
+// Histograms of PCEStudy, filled per thread slot; names as for MuonEventHists
+struct PCEStudyHists
+{
+  static const int nPCEBinsX = 50;
+  static const int nPCEBinsY = 50;
+
+  PCEStudyHists(int nSlots, std::string suffix = "") :
+    //Define a number of histograms for the hits
+    h_nHits(new TH1F(("h_nHits"+suffix).c_str(),"Number of Hits Per Event; nHits; nEvents",100,0,100),nSlots),
+    h_eDep(new TH1F(("h_eDep"+suffix).c_str(),"Hit EDeps; log10(eDep[eV]); nEvents",200,-6,1),nSlots),
+    h_hitXY(new TH2F(("h_nHitsXY"+suffix).c_str(),"XY Locations of Hits; X [mm]; Y [mm]; NHits/bin",200,-5,5,200,-5,5),nSlots),
+    h_hitYZ(new TH2F(("h_nHitsYZ"+suffix).c_str(),"YZ Locations of Hits; Y [mm]; Z [mm]; NHits/bin",200,-5,5,200,4.6,5.02),nSlots),
+    h_hitXZ(new TH2F(("h_nHitsXZ"+suffix).c_str(),"XZ Locations of Hits; X [mm]; Z [mm]; NHits/bin",200,-5,5,200,4.6,5.02),nSlots),
+  
+    //Define a number of histograms for the primaries
+    h_primXY(new TH2F(("h_primXY"+suffix).c_str(),"XY Location of Primary; X [mm]; Y [mm]; Primaries/bin",200,-5,5,200,-5,5),nSlots),
+    h_primYZ(new TH2F(("h_primYZ"+suffix).c_str(),"YZ Location of Primary; Y [mm]; Z [mm]; Primaries/bin",200,-5,5,200,4.6,5.02),nSlots),
+    h_primXZ(new TH2F(("h_primXZ"+suffix).c_str(),"XZ Location of Primary; X [mm]; Z [mm]; Primaries/bin",200,-5,5,200,4.6,5.02),nSlots),
+
+    //Define histograms useful for calculating PCE
+    h_totalHitEnergyAtPrimaryXY(new TH2F(("h_totalHitEnergyAtPrimaryXY"+suffix).c_str(),"Total Energy of Hits Generated by Primaries at this XY; X [mm]; Y [mm]; Energy/bin [eV]",nPCEBinsX,-5,5,nPCEBinsY,-5,5),nSlots),
+    h_totalPrimaryEnergyAtPrimaryXY(new TH2F(("h_totalPrimaryEnergyAtPrimaryXY"+suffix).c_str(),"Total Energy of Primaries at this XY; X [mm]; Y [mm]; Energy/bin [eV]",nPCEBinsX,-5,5,nPCEBinsY,-5,5),nSlots),
+    h_pceVsXY(new TH2F(("h_pceVsXY"+suffix).c_str(),"Phonon Collection Efficiency vs. Primary XY; X [mm]; Y [mm]; PCE",nPCEBinsX,-5,5,nPCEBinsY,-5,5))
+  {}
+
+  //Primary fills carry the event's sampling weight; hit fills carry the hit's
+  //track weight, which is that weight times any phonon roulette weight
+  //(/g4cmp/PhononRouletteBounces)
+  void Fill(const Event& tE, int slot)
+  {
     //Add to the primary vector
-    PrimaryInfo thePrim = tE.thePrim;
-    h_primXY->Fill(thePrim.X_mm,thePrim.Y_mm);
-    h_primXZ->Fill(thePrim.X_mm,thePrim.Z_mm);
-    h_primYZ->Fill(thePrim.Y_mm,thePrim.Z_mm);
-    h_totalPrimaryEnergyAtPrimaryXY->Fill(thePrim.X_mm,thePrim.Y_mm,thePrim.energy_eV);      
+    const PrimaryInfo& thePrim = tE.thePrim;
+    double w = thePrim.weight;
+    h_primXY[slot]->Fill(thePrim.X_mm,thePrim.Y_mm,w);
+    h_primXZ[slot]->Fill(thePrim.X_mm,thePrim.Z_mm,w);
+    h_primYZ[slot]->Fill(thePrim.Y_mm,thePrim.Z_mm,w);
+    h_totalPrimaryEnergyAtPrimaryXY[slot]->Fill(thePrim.X_mm,thePrim.Y_mm,w*thePrim.energy_eV);      
     
     //Plot a number of hit-related things: hit multiplicity, hit locations in XYZ, hits in XYZ weighted by energy, etc.
-    h_nHits->Fill(tE.hitVect.size());
+    h_nHits[slot]->Fill(tE.hitVect.size(),w);
     for ( int iH = 0; iH < tE.hitVect.size(); ++iH ){
 
       //Gather hit information
       double hitX = tE.hitVect[iH].endX_mm;
       double hitY = tE.hitVect[iH].endY_mm;
       double hitZ = tE.hitVect[iH].endZ_mm;
-      double startX = tE.hitVect[iH].startX_mm;
-      double startY = tE.hitVect[iH].startY_mm;
-      double startZ = tE.hitVect[iH].startZ_mm;
       double logEnergy_eV = TMath::Log10(tE.hitVect[iH].eDep_eV);
-
-
+      double hitW = tE.hitVect[iH].trackWeight;
       
       //Plot hit information
-      h_hitXY->Fill(hitX,hitY);
-      h_hitYZ->Fill(hitY,hitZ);
-      h_hitXZ->Fill(hitX,hitZ);
-      h_eDep->Fill(logEnergy_eV);
-      h_totalHitEnergyAtPrimaryXY->Fill(thePrim.X_mm,thePrim.Y_mm,tE.hitVect[iH].eDep_eV);
+      h_hitXY[slot]->Fill(hitX,hitY,hitW);
+      h_hitYZ[slot]->Fill(hitY,hitZ,hitW);
+      h_hitXZ[slot]->Fill(hitX,hitZ,hitW);
+      h_eDep[slot]->Fill(logEnergy_eV,hitW);
+      h_totalHitEnergyAtPrimaryXY[slot]->Fill(thePrim.X_mm,thePrim.Y_mm,hitW*tE.hitVect[iH].eDep_eV);
     }
   }
 
+  //Sum the per-thread clones back into the output histograms
+  void Merge()
+  {
+    h_nHits.Merge();
+    h_eDep.Merge();
+    h_hitXY.Merge();
+    h_hitYZ.Merge();
+    h_hitXZ.Merge();
+    h_primXY.Merge();
+    h_primYZ.Merge();
+    h_primXZ.Merge();
+    h_totalHitEnergyAtPrimaryXY.Merge();
+    h_totalPrimaryEnergyAtPrimaryXY.Merge();
+  }
+
   //Post-processing division
-  for( int iBX = 1; iBX <= h_totalHitEnergyAtPrimaryXY->GetNbinsX(); ++iBX ){
-    for( int iBY = 1; iBY <= h_totalHitEnergyAtPrimaryXY->GetNbinsY(); ++iBY ){
-      double num = h_totalHitEnergyAtPrimaryXY->GetBinContent(iBX,iBY);
-      double denom = h_totalPrimaryEnergyAtPrimaryXY->GetBinContent(iBX,iBY);
-      double pce = 0;
-      if( denom != 0 ) pce = num/denom;
-      h_pceVsXY->SetBinContent(iBX,iBY,pce);
+  void Finish()
+  {
+    for( int iBX = 1; iBX <= h_totalHitEnergyAtPrimaryXY->GetNbinsX(); ++iBX ){
+      for( int iBY = 1; iBY <= h_totalHitEnergyAtPrimaryXY->GetNbinsY(); ++iBY ){
+	double num = h_totalHitEnergyAtPrimaryXY->GetBinContent(iBX,iBY);
+	double denom = h_totalPrimaryEnergyAtPrimaryXY->GetBinContent(iBX,iBY);
+	double pce = 0;
+	if( denom != 0 ) pce = num/denom;
+	h_pceVsXY->SetBinContent(iBX,iBY,pce);
+      }
     }
   }
 
+  SlotHist<TH1F> h_nHits;
+  SlotHist<TH1F> h_eDep;
+  SlotHist<TH2F> h_hitXY;
+  SlotHist<TH2F> h_hitYZ;
+  SlotHist<TH2F> h_hitXZ;
+  SlotHist<TH2F> h_primXY;
+  SlotHist<TH2F> h_primYZ;
+  SlotHist<TH2F> h_primXZ;
+  SlotHist<TH2F> h_totalHitEnergyAtPrimaryXY;
+  SlotHist<TH2F> h_totalPrimaryEnergyAtPrimaryXY;
+  TH2F * h_pceVsXY;
+};
+
+//---------------------------------------------------------------------------------------
+// Analysis Script: Phonon Collection Efficiency. Filenames and nThreads as for AnalyzeMuonEvent.
+void PCEStudy(std::string primariesFilename, std::string hitsFilename, int nThreads = 0)
+{
+  //Files are streamed one event at a time, one file pair per thread
+  std::vector<std::string> hitFiles = SplitFileList(hitsFilename);
+  std::vector<std::string> primFiles = SplitFileList(primariesFilename);
+  int nSlots = NumberOfSlots(nThreads,hitFiles,primFiles);
+
+
+  //Define an outfile
+  TFile * fOut = new TFile("AnalysisOutput.root","RECREATE");
+  
+  //Define the histograms
+  PCEStudyHists hists(nSlots);
+  
+  //Loop over events
+  ProcessEvents(hitFiles,primFiles,nSlots,[&](const Event& tE, int slot){ hists.Fill(tE,slot); });
+
+  hists.Merge();
+  hists.Finish();
   
   //Write stuff currently established
   fOut->Write();
 
 }
 
-  
-  
+//---------------------------------------------------------------------------------------
+// Analysis Script: Pulse Synthesis. Filenames, nThreads and geometry file as for
+// AnalyzeMuonEvent. Each event's hit energy is binned by hit end time into nBins
+// bins of binWidth_ns per qubit (channelMode "qubit") or per sensor ("sensor"),
+// counted from the primary's time, and convolved with a response kernel: a
+// double exponential (rise_ns, fall_ns), or one sample per bin read from
+// kernelFilename if that is given. Every channel that received energy in an
+// event becomes one entry in the "pulses" tree of PulseOutput.root.
+void SynthesizePulses(std::string primariesFilename, std::string hitsFilename,
+		      double binWidth_ns = 10, int nBins = 2048,
+		      double rise_ns = 100, double fall_ns = 1000,
+		      std::string channelMode = "qubit", int nThreads = 0,
+		      std::string geometryFilename = "FourQubit_geometry.txt",
+		      std::string kernelFilename = "")
+{
+  QubitIndex qubits;
+  if( !qubits.Load(geometryFilename) ) return;
 
+  bool bySensor = (channelMode == "sensor");
+  if( !bySensor && channelMode != "qubit" ){
+    std::cerr << "SynthesizePulses: channelMode must be qubit or sensor, not " << channelMode << std::endl;
+    return;
+  }
+  int nChannels = qubits.NumberOfQubits();
+  if( bySensor ){
+    nChannels = 0;
+    for( size_t i = 0; i < qubits.GetSensors().size(); ++i ) nChannels = std::max(nChannels,qubits.GetSensors()[i].id+1);
+  }
 
+  std::vector<float> kernel = kernelFilename.empty() ?
+    PulseSynth::ExponentialKernel(rise_ns,fall_ns,binWidth_ns) : PulseSynth::KernelFromFile(kernelFilename);
+  if( kernel.empty() ) return;
 
+  //Files are streamed one event at a time, one file pair per thread, each
+  //thread with its own synthesizer
+  std::vector<std::string> hitFiles = SplitFileList(hitsFilename);
+  std::vector<std::string> primFiles = SplitFileList(primariesFilename);
+  int nSlots = NumberOfSlots(nThreads,hitFiles,primFiles);
 
-  
+  std::vector<PulseSynth*> synths;
+  for( int i = 0; i < nSlots; ++i ){
+    synths.push_back(new PulseSynth(nChannels,nBins,binWidth_ns));
+    synths.back()->SetKernel(kernel);
+  }
 
+  //Define an outfile
+  TFile * fOut = new TFile("PulseOutput.root","RECREATE");
+  TParameter<double>("binWidth_ns",binWidth_ns).Write();
+  TParameter<int>("nBins",nBins).Write();
+  TParameter<double>("rise_ns",rise_ns).Write();
+  TParameter<double>("fall_ns",fall_ns).Write();
+
+  //One entry per channel and event; the event's sampling weight is stored,
+  //not applied to the trace
+  int runID, eventID, channel, nHits;
+  double energy_eV, outside_eV, weight;
+  std::vector<float> trace(nBins);
+  TTree * tPulses = new TTree("pulses","Synthesized per-channel pulses");
+  tPulses->Branch("RunID",&runID);
+  tPulses->Branch("EventID",&eventID);
+  tPulses->Branch("Channel",&channel);
+  tPulses->Branch("NHits",&nHits);
+  tPulses->Branch("Energy_eV",&energy_eV);
+  tPulses->Branch("Outside_eV",&outside_eV);
+  tPulses->Branch("Weight",&weight);
+  tPulses->Branch("Trace",&trace);
+  std::mutex treeMutex;
+
+  SlotHist<TH1F> h_pulseEnergy(new TH1F("h_pulseEnergy","Binned Energy Per Pulse; log10(energy[eV]); nPulses",200,-6,4),nSlots);
+
+  ProcessEvents(hitFiles,primFiles,nSlots,[&](const Event& tE, int slot){
+    PulseSynth& synth = *synths[slot];
+    double w = tE.thePrim.weight;
+    synth.Clear();
+
+    //Hit weights are the event weight times any phonon roulette weight; only
+    //the roulette part belongs in the pulse
+    for ( int iH = 0; iH < tE.hitVect.size(); ++iH ){
+      const Hit& hit = tE.hitVect[iH];
+      int ch = bySensor ? hit.sensorID : hit.qubitID;
+      if( !bySensor && ch == kUnknownVolumeID ) ch = qubits.Find(hit.endX_mm,hit.endY_mm);
+      double hitW = (w != 0) ? hit.trackWeight/w : 1;
+      synth.Add(ch,hit.endT_ns-tE.thePrim.T_ns,hitW*hit.eDep_eV);
+    }
+    synth.Synthesize();
+
+    std::lock_guard<std::mutex> lock(treeMutex);
+    for( int ch = 0; ch < synth.NumberOfChannels(); ++ch ){
+      if( !synth.Filled(ch) ) continue;
+      runID = tE.runID;
+      eventID = tE.eventID;
+      channel = ch;
+      nHits = synth.NumberOfHits(ch);
+      energy_eV = synth.Energy(ch);
+      outside_eV = synth.Outside();
+      weight = w;
+      trace.assign(synth.Trace(ch),synth.Trace(ch)+nBins);
+      tPulses->Fill();
+      h_pulseEnergy[slot]->Fill(TMath::Log10(energy_eV),w);
+    }
+  });
 
+  h_pulseEnergy.Merge();
+  for( int i = 0; i < nSlots; ++i ) delete synths[i];
 
+  fOut->Write();
+}
 
+//---------------------------------------------------------------------------------------
+// Histograms compared by CompareFastMode: those of PCEStudy and AnalyzeMuonEvent,
+// plus a per-event PCE profile, per-qubit spectra of the energy each event leaves
+// in each qubit, and the hit arrival times counted from the primary's time
+struct ValidationHists
+{
+  ValidationHists(const QubitIndex& qubits, int nSlots, std::string suffix) :
+    fQubits(qubits),
+    pce(nSlots,suffix),
+    muon(qubits,nSlots,"_muon"+suffix),
+    p_pceVsXY(new TProfile2D(("p_pceVsXY"+suffix).c_str(),"Per-Event Phonon Collection Efficiency vs. Primary XY; X [mm]; Y [mm]; PCE",PCEStudyHists::nPCEBinsX,-5,5,PCEStudyHists::nPCEBinsY,-5,5),nSlots),
+    h_arrivalTime(new TH1F(("h_arrivalTime"+suffix).c_str(),"Hit Arrival Times; log10(t - t_{primary} [ns]); Hits/bin",200,-2,7),nSlots)
+  {
+    for( int iQ = 0; iQ < qubits.NumberOfQubits(); ++iQ ){
+      std::ostringstream name, title;
+      name << "h_qubitSpectrum" << iQ << suffix;
+      title << "Energy in Qubit " << iQ << " Per Event; log10(energy[eV]); nEvents";
+      h_qubitSpectrum.emplace_back(new SlotHist<TH1F>(new TH1F(name.str().c_str(),title.str().c_str(),200,-6,4),nSlots));
+    }
+  }
 
+  //Hit weights are the event weight times any phonon roulette weight; the
+  //per-event quantities keep the roulette part and are filled with the event weight
+  void Fill(const Event& tE, int slot)
+  {
+    pce.Fill(tE,slot);
+    muon.Fill(tE,slot);
 
+    const PrimaryInfo& thePrim = tE.thePrim;
+    double w = thePrim.weight;
+    if( w <= 0 ) return;
 
+    double hitEnergy_eV = 0;
+    std::vector<double> qubitEnergy_eV(h_qubitSpectrum.size(),0);
+    for ( int iH = 0; iH < tE.hitVect.size(); ++iH ){
+      const Hit& hit = tE.hitVect[iH];
+      double energy_eV = hit.trackWeight/w*hit.eDep_eV;
+      hitEnergy_eV += energy_eV;
 
+      int qubitID = hit.qubitID;
+      if( qubitID == kUnknownVolumeID ) qubitID = fQubits.Find(hit.endX_mm,hit.endY_mm);
+      if( qubitID >= 0 && qubitID < (int)qubitEnergy_eV.size() ) qubitEnergy_eV[qubitID] += energy_eV;
 
-//---------------------------------------------------------------------------------------
-// Parsing function
-std::vector<Event> ReadInG4CMPPrimaryAndHitFiles(std::string hitTextFilename, std::string primaryTextFilename)
-{
-  //Output: a vector of event objects nicely organizing our data.
-  std::vector<Event> output;
-
-  //First, let's open up our primary file and parse it. We'll get a map of int (event ID)
-  //to primary info and a map of int (eventID) to a list of hits
-  std::map<int,PrimaryInfo> primaryInfo = ParsePrimaryTextFileForPrimaries(primaryTextFilename);
-  std::map<int,std::vector<Hit> > hitInfo = ParseHitTextFileForHits(hitTextFilename);
-
-  //Now we do a final loop over event ID to merge these into actual events.
-  for( std::map<int,PrimaryInfo>::iterator it = primaryInfo.begin(); it != primaryInfo.end(); ++it ){
-    Event theEvent;
-    theEvent.runID = it->second.runID;
-    theEvent.eventID = it->first;
-    theEvent.hitVect = hitInfo[it->first];
-    theEvent.thePrim = it->second;
-    output.push_back(theEvent);
+      double dt_ns = hit.endT_ns - thePrim.T_ns;
+      if( dt_ns > 0 ) h_arrivalTime[slot]->Fill(TMath::Log10(dt_ns),hit.trackWeight);
+    }
+
+    if( thePrim.energy_eV > 0 ) p_pceVsXY[slot]->Fill(thePrim.X_mm,thePrim.Y_mm,hitEnergy_eV/thePrim.energy_eV,w);
+    for( size_t iQ = 0; iQ < qubitEnergy_eV.size(); ++iQ ){
+      if( qubitEnergy_eV[iQ] > 0 ) (*h_qubitSpectrum[iQ])[slot]->Fill(TMath::Log10(qubitEnergy_eV[iQ]),w);
+    }
   }
-  return output;
 
-}
-  
+  void Merge()
+  {
+    pce.Merge();
+    muon.Merge();
+    p_pceVsXY.Merge();
+    h_arrivalTime.Merge();
+    for( size_t iQ = 0; iQ < h_qubitSpectrum.size(); ++iQ ) h_qubitSpectrum[iQ]->Merge();
+    pce.Finish();
+  }
+
+  const QubitIndex& fQubits;
+  PCEStudyHists pce;
+  MuonEventHists muon;
+  SlotHist<TProfile2D> p_pceVsXY;
+  SlotHist<TH1F> h_arrivalTime;
+  std::vector<std::unique_ptr<SlotHist<TH1F> > > h_qubitSpectrum;
+};
 
 //---------------------------------------------------------------------------------------
-// Parsing function
-std::map<int,std::vector<Hit> > ParseHitTextFileForHits(std::string filename)
+// Analysis Script: Fast-Mode Validation. Compares the output of a reference and a
+// fast configuration of the same source (filenames and nThreads as for
+// AnalyzeMuonEvent; hit-level output, since event-mode sums have no hit times or
+// positions) and prints every test with PASS/FAIL, then the speed-up if both event
+// rates are given. Both sets of histograms go to ValidationOutput.root, suffixed
+// _ref and _fast, with the seeds the two samples were made with if given (0 if
+// not known). Returns true if every test passed; see FourQubitCompare.hh for the
+// tests and the alpha threshold.
+bool CompareFastMode(std::string refPrimariesFilename, std::string refHitsFilename,
+		     std::string fastPrimariesFilename, std::string fastHitsFilename,
+		     double refEventsPerSecond = 0, double fastEventsPerSecond = 0,
+		     double alpha = 0.01, int nThreads = 0,
+		     std::string geometryFilename = "FourQubit_geometry.txt",
+		     long refSeed = 0, long fastSeed = 0)
 {
-  std::map<int,std::vector<Hit> > output;
-  std::vector<Hit> dummy;
-  
-  std::ifstream infile;
-  infile.open(filename.c_str());
-  std::string wholeLine;
-
-  //Begin loop through file
-  int eventID = -1;
-  int runID = -1;
-  int counter = 0;
-  while(1){
-    if(!infile.good()) break;
-    if(infile.is_open()){
-      std::getline(infile,wholeLine);
-      
-      //Tokenize the string (split between spaces)
-      stringstream check1(wholeLine);
-      string token;
-      std::vector<std::string> tokens;
-      while(getline(check1,token,' ')){
-	tokens.push_back(token);
-      }
-      if( tokens.size() == 0 ) break;
-	  
-      //If we're on the first line of the file
-      if( tokens[0].find("Run") != std::string::npos ){
-	continue;
-      }
+  QubitIndex qubits;
+  if( !qubits.Load(geometryFilename) ) return false;
 
-      //Check the runID and eventID, and if different than existing one,
-      //push back a new event into the map
-      if( std::atoi(tokens[0].c_str()) != runID || std::atoi(tokens[1].c_str()) != eventID ){
-	output.emplace(std::atoi(tokens[1].c_str()),dummy);
-	runID = std::atoi(tokens[0].c_str());
-	eventID = std::atoi(tokens[1].c_str());
-	counter++; 
-	if( counter % 1000 == 0 ) std::cout << "Done reading " << counter << " events for hits." << std::endl;
-      }
+  //The χ² tests need the sums of squared weights; the caller's setting is put back
+  Bool_t defaultSumw2 = TH1::GetDefaultSumw2();
+  TH1::SetDefaultSumw2(kTRUE);
 
-      //Log the hit information and push back into the most recently-created event in the vector
-      Hit theHit;      
-      theHit.runID = std::atoi(tokens[0].c_str());
-      theHit.eventID = std::atoi(tokens[1].c_str());
-      theHit.trackID = std::atoi(tokens[2].c_str());
-      theHit.particleName = tokens[3];
-      theHit.startEnergy_eV = std::atof(tokens[4].c_str());
-      theHit.startX_mm = std::atof(tokens[5].c_str());
-      theHit.startY_mm = std::atof(tokens[6].c_str());
-      theHit.startZ_mm = std::atof(tokens[7].c_str());
-      theHit.startT_ns = std::atof(tokens[8].c_str());
-      theHit.eDep_eV = std::atof(tokens[9].c_str());
-      theHit.trackWeight = std::atof(tokens[10].c_str());
-      theHit.endX_mm = std::atof(tokens[11].c_str());
-      theHit.endY_mm = std::atof(tokens[12].c_str());
-      theHit.endZ_mm = std::atof(tokens[13].c_str());
-      theHit.endT_ns = std::atof(tokens[14].c_str());
-      output[eventID].push_back(theHit);
-    }
+  //Define an outfile
+  TFile * fOut = new TFile("ValidationOutput.root","RECREATE");
+
+  std::vector<std::string> refHitFiles = SplitFileList(refHitsFilename);
+  std::vector<std::string> refPrimFiles = SplitFileList(refPrimariesFilename);
+  int nRefSlots = NumberOfSlots(nThreads,refHitFiles,refPrimFiles);
+  ValidationHists ref(qubits,nRefSlots,"_ref");
+  ProcessEvents(refHitFiles,refPrimFiles,nRefSlots,[&](const Event& tE, int slot){ ref.Fill(tE,slot); });
+  ref.Merge();
+
+  std::vector<std::string> fastHitFiles = SplitFileList(fastHitsFilename);
+  std::vector<std::string> fastPrimFiles = SplitFileList(fastPrimariesFilename);
+  int nFastSlots = NumberOfSlots(nThreads,fastHitFiles,fastPrimFiles);
+  ValidationHists fast(qubits,nFastSlots,"_fast");
+  ProcessEvents(fastHitFiles,fastPrimFiles,nFastSlots,[&](const Event& tE, int slot){ fast.Fill(tE,slot); });
+  fast.Merge();
+
+  //PCE maps, hit distributions, per-qubit energy and arrival times
+  EquivalenceTests tests;
+  tests.AddProfile("p_pceVsXY",ref.p_pceVsXY[0],fast.p_pceVsXY[0]);
+  tests.Add("h_totalHitEnergyAtPrimaryXY",ref.pce.h_totalHitEnergyAtPrimaryXY[0],fast.pce.h_totalHitEnergyAtPrimaryXY[0]);
+  tests.Add("h_primXY",ref.pce.h_primXY[0],fast.pce.h_primXY[0]);
+  tests.Add("h_nHits",ref.pce.h_nHits[0],fast.pce.h_nHits[0]);
+  tests.Add("h_eDep",ref.pce.h_eDep[0],fast.pce.h_eDep[0]);
+  tests.Add("h_nHitsXY",ref.pce.h_hitXY[0],fast.pce.h_hitXY[0]);
+  tests.Add("h_nHitsYZ",ref.pce.h_hitYZ[0],fast.pce.h_hitYZ[0]);
+  tests.Add("h_nHitsXZ",ref.pce.h_hitXZ[0],fast.pce.h_hitXZ[0]);
+  tests.Add("h_qubitTotalHitEnergy_singleEvent",ref.muon.h_qubitTotalHitEnergy_singleEvent[0],fast.muon.h_qubitTotalHitEnergy_singleEvent[0]);
+  for( size_t iQ = 0; iQ < ref.h_qubitSpectrum.size(); ++iQ ){
+    std::ostringstream name;
+    name << "h_qubitSpectrum" << iQ;
+    tests.Add(name.str(),(*ref.h_qubitSpectrum[iQ])[0],(*fast.h_qubitSpectrum[iQ])[0]);
   }
-  return output;
-}
+  tests.Add("h_arrivalTime",ref.h_arrivalTime[0],fast.h_arrivalTime[0]);
 
+  bool passed = tests.Print(alpha,refEventsPerSecond,fastEventsPerSecond);
+
+  TParameter<double>("alpha",alpha).Write();
+  TParameter<double>("refEventsPerSecond",refEventsPerSecond).Write();
+  TParameter<double>("fastEventsPerSecond",fastEventsPerSecond).Write();
+  TParameter<long>("refSeed",refSeed).Write();
+  TParameter<long>("fastSeed",fastSeed).Write();
+  TParameter<int>("passed",passed).Write();
+  fOut->Write();
+  TH1::SetDefaultSumw2(defaultSumw2);
+  return passed;
+}
 
 //---------------------------------------------------------------------------------------
-// Parsing function
-std::map<int,PrimaryInfo> ParsePrimaryTextFileForPrimaries(std::string filename)
+// Analysis Script: Fast-Mode Validation, end to end. Runs each setup macro through
+// FourQubitBench (nEvents events with text hit output, on simThreads threads, with
+// its physics list), then compares the two with CompareFastMode using the measured
+// event rates. The fast configuration can differ by macro (culling, roulette,
+// dp_flattenConductors, ...), by physics list, or both:
+//
+//   ValidateFastMode("benchPhononBath.mac","validatePhononCull.mac")
+//   ValidateFastMode("benchPhononBath.mac","benchPhononBath.mac",1000,"full","phonon")
+//
+// Output files are tagged validateRef_<macro>_text and validateFast_<macro>_text,
+// the benchmark results go to validateRef.json and validateFast.json; qubits
+// missing from the hit files are found with the reference geometry. The tests
+// need independent samples, so the reference runs with /random/setSeeds seed and
+// the fast configuration with seed+1, even when both use the same macro.
+bool ValidateFastMode(std::string referenceMacro, std::string fastMacro, int nEvents = 1000,
+		      std::string referencePhysics = "full", std::string fastPhysics = "full",
+		      int simThreads = 1, double alpha = 0.01, int nThreads = 0,
+		      std::string bench = "./FourQubitBench", long seed = 1)
 {
-  std::map<int,PrimaryInfo> output;
-  std::ifstream infile;
-  infile.open(filename.c_str());
-  std::string wholeLine;
-
-  //Begin loop through file
-  while(1){
-    if(!infile.good()) break;
-    if(infile.is_open()){
-      std::getline(infile,wholeLine);
-      
-      //Tokenize the string (split between spaces)
-      stringstream check1(wholeLine);
-      string token;
-      std::vector<std::string> tokens;
-      while(getline(check1,token,' ')){
-	tokens.push_back(token);
-      }
-      if( tokens.size() == 0 ) break;
-	  
-      //If we're on the first line of the file
-      if( tokens[0].find("Run") != std::string::npos ){
-	continue;
-      }
-
-      //Here, it's simpler since there's one line per event (assuming only a single run)
-      //So we can use the event id as an index.
-      PrimaryInfo thePrim;
-      thePrim.runID = std::atoi(tokens[0].c_str());
-      thePrim.eventID = std::atoi(tokens[1].c_str());
-      thePrim.particleName = tokens[2];
-      thePrim.energy_eV = std::atof(tokens[3].c_str());
-      thePrim.X_mm = std::atof(tokens[4].c_str());
-      thePrim.Y_mm = std::atof(tokens[5].c_str());
-      thePrim.Z_mm = std::atof(tokens[6].c_str());
-      thePrim.T_ns = std::atof(tokens[7].c_str());
-      output.emplace(thePrim.eventID,thePrim);
+  const std::string prefixes[2] = { "validateRef", "validateFast" };
+  const std::string macros[2] = { referenceMacro, fastMacro };
+  const std::string physics[2] = { referencePhysics, fastPhysics };
+  const long seeds[2] = { seed, seed+1 };
+  std::string tags[2];
+  double eventsPerSecond[2];
+
+  for( int i = 0; i < 2; ++i ){
+    //Tag as FourQubitBench makes it: <prefix>_<macro file stem>_<mode>
+    std::string stem = gSystem->BaseName(macros[i].c_str());
+    size_t dot = stem.rfind('.');
+    if( dot != std::string::npos ) stem.erase(dot);
+    tags[i] = prefixes[i] + "_" + stem + "_text";
+
+    std::string json = prefixes[i] + ".json";
+    std::ostringstream cmd;
+    cmd << bench << " -t " << simThreads << " -p " << physics[i] << " -n " << nEvents
+	<< " -s " << seeds[i] << " -m text -g " << prefixes[i] << " -o " << json << " " << macros[i];
+    std::cout << "ValidateFastMode: " << cmd.str() << std::endl;
+    if( gSystem->Exec(cmd.str().c_str()) != 0 ){
+      std::cerr << "ValidateFastMode: " << bench << " failed for " << macros[i] << std::endl;
+      return false;
     }
+    eventsPerSecond[i] = ReadBenchNumber(json,"eventsPerSecond");
   }
-  return output;
-}
-
-
 
+  return CompareFastMode("FourQubit_primary_"+tags[0]+".txt","FourQubit_hits_"+tags[0]+".txt",
+			 "FourQubit_primary_"+tags[1]+".txt","FourQubit_hits_"+tags[1]+".txt",
+			 eventsPerSecond[0],eventsPerSecond[1],alpha,nThreads,
+			 "FourQubit_geometry_"+tags[0]+".txt",seeds[0],seeds[1]);
+}
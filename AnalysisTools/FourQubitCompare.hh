@@ -0,0 +1,249 @@
+//---------------------------------------------------------
+//
+// FourQubitCompare.hh
+//
+// Statistical comparison of a reference and a fast
+// simulation configuration, histogram by histogram.  Each
+// pair is tested for a common parent distribution: a χ²
+// homogeneity test (TH1::Chi2Test, weighted events), plus
+// a Kolmogorov-Smirnov test for 1D histograms.  2D maps
+// finer than kMaxBins2D bins a side are compared as
+// rebinned copies, since the χ² needs a few entries per
+// bin and a 200x200 map of 1000 events has far fewer (a
+// bin count with no whole grouping into kMinBins2D to
+// kMaxBins2D bins is tested as it is, with a warning); profile
+// pairs (per-bin means, such as the PCE map) get a χ² of
+// the bin-by-bin mean differences.  A pair passes if every
+// one of its p-values is above alpha/nPValues, where
+// nPValues counts every p-value computed (two for a 1D
+// pair, one otherwise), so the false failure rate of the
+// whole comparison stays below alpha:
+//
+//   EquivalenceTests tests;
+//   tests.Add("eDep",h_ref,h_fast);
+//   tests.AddProfile("pce",p_ref,p_fast);
+//   bool pass = tests.Print(0.01,refRate,fastRate);
+//
+// Histograms that are empty in both configurations are
+// skipped; empty in one of them is a failure.
+//
+//---------------------------------------------------------
+
+#ifndef FourQubitCompare_hh
+#define FourQubitCompare_hh
+
+//C++ includes
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//ROOT includes
+#include "TH1.h"
+#include "TH2.h"
+#include "TMath.h"
+#include "TProfile2D.h"
+
+class EquivalenceTests
+{
+public:
+  struct Result
+  {
+    std::string name;
+    std::string method;		//"chi2", "chi2 rebinned", "chi2+KS", "profile chi2" or "skipped"
+    double pChi2;
+    double pKS;			//-1 if not a 1D pair
+    int ndf;			//Profile tests only
+    bool empty;			//Empty in one configuration only
+  };
+
+  static const int kMaxBins2D = 50;
+  static const int kMinBins2D = 10;
+
+  void Add(const std::string& name, TH1* ref, TH1* fast)
+  {
+    Result r = MakeResult(name);
+    bool refEmpty = ( ref->GetEntries() == 0 );
+    bool fastEmpty = ( fast->GetEntries() == 0 );
+    if( refEmpty || fastEmpty ){
+      r.empty = ( refEmpty != fastEmpty );
+      if( !r.empty ) r.method = "skipped";
+      fResults.push_back(r);
+      return;
+    }
+
+    r.method = "chi2";
+    int factorX = 1, factorY = 1;
+    if( ref->GetDimension() == 2 && (ref->GetNbinsX() > kMaxBins2D || ref->GetNbinsY() > kMaxBins2D) ){
+      factorX = RebinFactor(ref->GetNbinsX());
+      factorY = RebinFactor(ref->GetNbinsY());
+      if( factorX == 0 || factorY == 0 ){
+	std::cerr << "EquivalenceTests: " << name << " (" << ref->GetNbinsX() << " x " << ref->GetNbinsY()
+		  << " bins) can't be grouped into " << kMinBins2D << " to " << kMaxBins2D
+		  << " bins a side; testing it unrebinned." << std::endl;
+	factorX = factorY = 1;
+      }
+    }
+    if( factorX > 1 || factorY > 1 ){
+      std::unique_ptr<TH2> refCoarse(Coarse((TH2*)ref,factorX,factorY));
+      std::unique_ptr<TH2> fastCoarse(Coarse((TH2*)fast,factorX,factorY));
+      r.method = "chi2 rebinned";
+      r.pChi2 = refCoarse->Chi2Test(fastCoarse.get(),"WW");
+    } else {
+      r.pChi2 = ref->Chi2Test(fast,"WW");
+    }
+    if( ref->GetDimension() == 1 ){
+      r.method = "chi2+KS";
+      r.pKS = ref->KolmogorovTest(fast);
+    }
+    fResults.push_back(r);
+  }
+
+  //Bins with fewer than two effective entries in either profile carry no
+  //usable error and are left out
+  void AddProfile(const std::string& name, TProfile2D* ref, TProfile2D* fast)
+  {
+    Result r = MakeResult(name);
+    double chi2 = 0;
+    for( int iBX = 1; iBX <= ref->GetNbinsX(); ++iBX ){
+      for( int iBY = 1; iBY <= ref->GetNbinsY(); ++iBY ){
+	int bin = ref->GetBin(iBX,iBY);
+	if( ref->GetBinEffectiveEntries(bin) < 2 || fast->GetBinEffectiveEntries(bin) < 2 ) continue;
+	double e2 = std::pow(ref->GetBinError(bin),2) + std::pow(fast->GetBinError(bin),2);
+	if( e2 <= 0 ) continue;
+	chi2 += std::pow(ref->GetBinContent(bin)-fast->GetBinContent(bin),2)/e2;
+	++r.ndf;
+      }
+    }
+
+    if( r.ndf == 0 ){
+      r.empty = ( (ref->GetEntries() == 0) != (fast->GetEntries() == 0) );
+      if( !r.empty ) r.method = "skipped";
+    } else {
+      r.method = "profile chi2";
+      r.pChi2 = TMath::Prob(chi2,r.ndf);
+    }
+    fResults.push_back(r);
+  }
+
+  //The Bonferroni divisor: χ² and KS of a 1D pair are two tests
+  int NumberOfPValues() const
+  {
+    int n = 0;
+    for( size_t i = 0; i < fResults.size(); ++i ){
+      if( fResults[i].method == "skipped" ) continue;
+      n += ( fResults[i].method == "chi2+KS" ) ? 2 : 1;
+    }
+    return n;
+  }
+
+  //"threshold" is alpha over NumberOfPValues(), for each p-value of the pair
+  bool Passed(const Result& r, double threshold) const
+  {
+    if( r.method == "skipped" ) return true;
+    if( r.empty ) return false;
+    return r.pChi2 > threshold && (r.pKS < 0 || r.pKS > threshold);
+  }
+
+  const std::vector<Result>& GetResults() const { return fResults; }
+
+  //Table of p-values and verdicts, then the overall verdict and the speed-up
+  //(fast over reference events per second; not shown if either is 0)
+  bool Print(double alpha, double refEventsPerSecond = 0, double fastEventsPerSecond = 0) const
+  {
+    int nPValues = NumberOfPValues();
+    double threshold = ( nPValues > 0 ) ? alpha/nPValues : alpha;
+    bool allPassed = true;
+
+    std::cout << "Fast-mode comparison: " << fResults.size() << " histogram pairs, "
+	      << nPValues << " p-values, each at p > " << threshold
+	      << " (alpha " << alpha << ")" << std::endl;
+    char line[256];
+    std::snprintf(line,sizeof(line),"  %-40s %-13s %10s %10s  %s","histogram","test","p(chi2)","p(KS)","result");
+    std::cout << line << std::endl;
+    for( size_t i = 0; i < fResults.size(); ++i ){
+      const Result& r = fResults[i];
+      bool pass = Passed(r,threshold);
+      allPassed = allPassed && pass;
+
+      std::string pChi2 = ( r.method == "skipped" || r.empty ) ? "-" : Format(r.pChi2);
+      std::string pKS = ( r.pKS < 0 ) ? "-" : Format(r.pKS);
+      const char* verdict = ( r.method == "skipped" ) ? "skipped" : (pass ? "PASS" : "FAIL");
+      std::string method = r.empty ? "empty in one" : r.method;
+      std::snprintf(line,sizeof(line),"  %-40s %-13s %10s %10s  %s",r.name.c_str(),method.c_str(),pChi2.c_str(),pKS.c_str(),verdict);
+      std::cout << line << std::endl;
+    }
+
+    std::cout << "Fast-mode comparison: " << (allPassed ? "PASS" : "FAIL");
+    if( refEventsPerSecond > 0 && fastEventsPerSecond > 0 )
+      std::cout << ", speed-up " << fastEventsPerSecond/refEventsPerSecond
+		<< " (" << refEventsPerSecond << " -> " << fastEventsPerSecond << " events/s)";
+    std::cout << std::endl;
+    return allPassed;
+  }
+
+private:
+  static Result MakeResult(const std::string& name)
+  {
+    Result r;
+    r.name = name;
+    r.method = "chi2";
+    r.pChi2 = -1;
+    r.pKS = -1;
+    r.ndf = 0;
+    r.empty = false;
+    return r;
+  }
+
+  //Smallest whole grouping of bins that leaves at most kMaxBins2D of them,
+  //or 0 if that leaves fewer than kMinBins2D (a prime count, say)
+  static int RebinFactor(int nBins)
+  {
+    if( nBins <= kMaxBins2D ) return 1;
+    for( int factor = (nBins + kMaxBins2D - 1)/kMaxBins2D; nBins/factor >= kMinBins2D; ++factor )
+      if( nBins % factor == 0 ) return factor;
+    return 0;
+  }
+
+  //A detached rebinned copy, for the caller to delete
+  static TH2* Coarse(TH2* h, int factorX, int factorY)
+  {
+    std::string name = std::string(h->GetName()) + "_coarse";
+    TH2* coarse = h->Rebin2D(factorX,factorY,name.c_str());
+    coarse->SetDirectory(0);
+    return coarse;
+  }
+
+  static std::string Format(double p)
+  {
+    char buffer[32];
+    std::snprintf(buffer,sizeof(buffer),"%.3g",p);
+    return buffer;
+  }
+
+  std::vector<Result> fResults;
+};
+
+//---------------------------------------------------------------------------------------
+// A number from a FourQubitBench JSON file ("eventsPerSecond": 123.4); the
+// first occurrence, or 0 if the file or the key is missing
+inline double ReadBenchNumber(const std::string& filename, const std::string& key)
+{
+  std::ifstream in(filename.c_str());
+  std::stringstream text;
+  text << in.rdbuf();
+  std::string json = text.str();
+
+  size_t pos = json.find("\"" + key + "\"");
+  if( pos == std::string::npos ) return 0;
+  pos = json.find(':',pos);
+  if( pos == std::string::npos ) return 0;
+  return std::strtod(json.c_str()+pos+1,0);
+}
+
+#endif
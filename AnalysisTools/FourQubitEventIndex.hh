@@ -0,0 +1,108 @@
+//---------------------------------------------------------
+//
+// FourQubitEventIndex.hh
+//
+// Event index of a hit or primary file, the "<file>.idx"
+// written beside it with /g4cmp/EventIndex (see
+// FourQubitHitFormat::IndexRecord).  Loading it reads 32
+// bytes per event instead of the whole data file; after
+// that, finding an event is a binary search and going to
+// it a single seek:
+//
+//   FourQubitEventIndex index;
+//   FourQubitHitFileReader r;
+//   if (index.Open("FourQubit_hits.txt") && r.Open("FourQubit_hits.txt")) {
+//     const FourQubitHitFormat::IndexRecord* e = index.Find(0,1234);
+//     if (e && r.Seek(*e)) {
+//       FourQubitHitFormat::HitRecord h;
+//       for (int i=0; i<e->nRecords && r.Next(h); i++) { ... }
+//     }
+//   }
+//
+// Text files are read the same way, through
+// FourQubitInputFile::Seek() and the EventStream sources
+// (EventStream::Seek() for hits and primary together).
+// Events without hits have no entry in the hit index.
+//
+//---------------------------------------------------------
+
+#ifndef FourQubitEventIndex_hh
+#define FourQubitEventIndex_hh
+
+#include "FourQubitHitReader.hh"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+class FourQubitEventIndex
+{
+public:
+  typedef FourQubitHitFormat::IndexRecord Entry;
+
+  // Loads "<dataFile>.idx"; false if there is none
+  bool Open(const std::string& dataFile)
+  {
+    fEntries.clear();
+    fOpen = false;
+
+    FourQubitIndexFileReader reader;
+    if( !reader.Open(FourQubitHitFormat::IndexFileName(dataFile)) ) return false;
+
+    Entry e;
+    while( reader.Next(e) ) fEntries.push_back(e);
+
+    //Written in file order, which is (run, event) order unless runs were
+    //appended out of order
+    if( !std::is_sorted(fEntries.begin(),fEntries.end(),Before) )
+      std::stable_sort(fEntries.begin(),fEntries.end(),Before);
+    fOpen = true;
+    return true;
+  }
+
+  bool IsOpen() const { return fOpen; }
+  size_t Size() const { return fEntries.size(); }
+  const std::vector<Entry>& Entries() const { return fEntries; }
+
+  // The event, or null if it has no records in the file
+  const Entry* Find(int runID, int eventID) const
+  {
+    const Entry* e = LowerBound(runID,eventID);
+    return (e && e->runID == runID && e->eventID == eventID) ? e : 0;
+  }
+
+  // First event at or after (runID, eventID), or null
+  const Entry* LowerBound(int runID, int eventID) const
+  {
+    Entry key = {};
+    key.runID = runID;
+    key.eventID = eventID;
+    auto it = std::lower_bound(fEntries.begin(),fEntries.end(),key,Before);
+    return (it == fEntries.end()) ? 0 : &*it;
+  }
+
+  // Events firstEvent to lastEvent of one run, as [first, last)
+  std::pair<const Entry*,const Entry*> Range(int runID, int firstEvent, int lastEvent) const
+  {
+    Entry lo = {}, hi = {};
+    lo.runID = hi.runID = runID;
+    lo.eventID = firstEvent;
+    hi.eventID = lastEvent;
+    auto first = std::lower_bound(fEntries.begin(),fEntries.end(),lo,Before);
+    auto last = std::upper_bound(first,fEntries.end(),hi,Before);
+    const Entry* base = fEntries.data();
+    return std::make_pair(base+(first-fEntries.begin()),base+(last-fEntries.begin()));
+  }
+
+private:
+  static bool Before(const Entry& a, const Entry& b)
+  {
+    return a.runID < b.runID || (a.runID == b.runID && a.eventID < b.eventID);
+  }
+
+  std::vector<Entry> fEntries;
+  bool fOpen = false;
+};
+
+#endif
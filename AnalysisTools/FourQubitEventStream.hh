@@ -0,0 +1,751 @@
+//---------------------------------------------------------
+//
+// FourQubitEventStream.hh
+//
+// Streaming reader for the hit and primary output of the
+// FourQubit simulation.  Both files are read in
+// (runID, eventID) order, walked in lockstep, and one
+// event is assembled at a time:
+//
+//   EventStream stream;
+//   if( stream.Open(hitsFilename,primariesFilename) ){
+//     Event tE;
+//     while( stream.Next(tE) ){ ... }
+//   }
+//
+// The Event passed to Next() is refilled in place, so
+// memory use is bounded by the largest single event.
+// Text, binary (/g4cmp/HitsFormat binary) and ROOT
+// (/g4cmp/HitsFormat root) files are all accepted, and
+// text and binary files may be zstd-compressed
+// (/g4cmp/OutputCompression zstd; compile with
+// -DFOURQUBIT_ZSTD and link -lzstd to read those).
+//
+// Text and binary files with event indexes
+// (/g4cmp/EventIndex) can also be entered at any event:
+//
+//   if( stream.Seek(runID,eventID) && stream.Next(tE) ){ ... }
+//
+// and Next() carries on from there, so a range of events
+// costs one seek.  SeekRange() does the same by position in
+// the primary index and stops Next() after a given number
+// of events, which is how ProcessEvents splits one file
+// between threads.
+//
+// Merged shards are written in (run, event) order and read
+// straight through.  Files out of that order are still
+// paired correctly: a ROOT tree (merged MT ntuples) is read
+// in sorted chunks of entries, and text and binary files
+// with event indexes are read event by event through them.
+// A text or binary file without an index is checked as it
+// is read: Next() stops at the first record out of order,
+// and Failed() says so.
+//
+//---------------------------------------------------------
+
+#ifndef FourQubitEventStream_hh
+#define FourQubitEventStream_hh
+
+//C++ includes
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+//ROOT includes
+#include "TFile.h"
+#include "TTreeReader.h"
+#include "TTreeReaderArray.h"
+#include "TTreeReaderValue.h"
+
+//Reader for /g4cmp/HitsFormat binary output, and the event indexes
+#include "FourQubitEventIndex.hh"
+#include "FourQubitHitReader.hh"
+
+//---------------------------------------------------------------------------------------
+// Define a set of structs for use interpreting the output from G4CMP
+struct Hit
+{
+  int runID;
+  int eventID;
+  int trackID;
+  std::string particleName;
+  double startEnergy_eV;
+  double startX_mm;
+  double startY_mm;
+  double startZ_mm;
+  double startT_ns;
+  double eDep_eV;
+  double trackWeight;
+  double endX_mm;
+  double endY_mm;
+  double endZ_mm;
+  double endT_ns;
+  int sensorID;		//From FourQubitSensorTable; -1 if not on a sensor/qubit,
+  int qubitID;		//kUnknownVolumeID if the file predates these columns
+};
+
+const int kUnknownVolumeID = -2;
+
+struct PrimaryInfo
+{
+  int runID;
+  int eventID;
+  int trackID;
+  std::string particleName;
+  double energy_eV;
+  double X_mm;
+  double Y_mm;
+  double Z_mm;
+  double T_ns;
+  int stratum;		//PrimaryStrata cell; -1 if not stratified or not recorded
+  double weight;	//Biased sampling weight of the event; 1 if not recorded
+  int flags;		//Event watchdog flags (1 = step, 2 = track budget); 0 if none
+};
+
+// Event IDs restart with every run, and per-thread shards of an MT run are
+// read as separate streams, so an event is only unique with all three
+struct EventKey
+{
+  int runID;
+  int eventID;
+  int threadID;
+
+  bool operator<(const EventKey& o) const
+  {
+    if( runID != o.runID ) return runID < o.runID;
+    if( eventID != o.eventID ) return eventID < o.eventID;
+    return threadID < o.threadID;
+  }
+  bool operator==(const EventKey& o) const
+  {
+    return runID == o.runID && eventID == o.eventID && threadID == o.threadID;
+  }
+};
+
+struct Event
+{
+  int runID;
+  int eventID;
+  int threadID;		//From the shard name ("_t<N>"), 0 for merged files
+  std::vector<Hit> hitVect;
+  PrimaryInfo thePrim;
+
+  EventKey Key() const { EventKey k = {runID,eventID,threadID}; return k; }
+};
+
+
+//---------------------------------------------------------------------------------------
+// Record sources: each returns one record per call, in file order
+template <class Record>
+class RecordSource
+{
+public:
+  virtual ~RecordSource() {}
+  virtual bool Read(Record& rec) = 0;
+
+  // Go to an indexed event; only text and binary files can
+  virtual bool Seek(const FourQubitHitFormat::IndexRecord&) { return false; }
+};
+
+// Worker shards are named "<file>_t<N>.<ext>"; anything else is thread 0
+inline int ShardThreadID(const std::string& filename)
+{
+  size_t slash = filename.rfind('/');
+  size_t tag = filename.rfind("_t");
+  if( tag == std::string::npos || (slash != std::string::npos && tag < slash) ) return 0;
+  char* end;
+  long tid = std::strtol(filename.c_str()+tag+2,&end,10);
+  if( end == filename.c_str()+tag+2 || (*end != '.' && *end != '\0') ) return 0;
+  return (int)tid;
+}
+
+// ROOT output holds "hits" and "primaries" ntuples in one file
+inline bool IsRootFile(const std::string& filename)
+{
+  return filename.size() > 5 && filename.compare(filename.size()-5,5,".root") == 0;
+}
+
+
+//---------------------------------------------------------------------------------------
+// Text files: one space-separated record per line, after a header line
+class TextSource
+{
+protected:
+  bool Open(const std::string& filename)
+  {
+    fIn.open(filename);
+    return fIn.is_open();
+  }
+
+  bool SeekTo(const FourQubitHitFormat::IndexRecord& entry)
+  {
+    return fIn.Seek(entry.offset,entry.skip);
+  }
+
+  // Reads the next data line, skipping the header; fPos points at its start
+  bool NextLine()
+  {
+    while( std::getline(fIn,fLine) ){
+      if( fLine.empty() || fLine.find("Run") != std::string::npos ) continue;
+      fPos = fLine.c_str();
+      return true;
+    }
+    return false;
+  }
+
+  int NextInt() { char* end; int v = std::strtol(fPos,&end,10); fPos = end; return v; }
+  int NextOptionalInt(int missing)
+  {
+    char* end;
+    int v = std::strtol(fPos,&end,10);
+    if( end == fPos ) return missing;
+    fPos = end;
+    return v;
+  }
+  double NextDouble() { char* end; double v = std::strtod(fPos,&end); fPos = end; return v; }
+  double NextOptionalDouble(double missing)
+  {
+    char* end;
+    double v = std::strtod(fPos,&end);
+    if( end == fPos ) return missing;
+    fPos = end;
+    return v;
+  }
+  void NextWord(std::string& word)
+  {
+    while( *fPos == ' ' ) ++fPos;
+    const char* start = fPos;
+    while( *fPos && *fPos != ' ' ) ++fPos;
+    word.assign(start,fPos);
+  }
+
+  FourQubitInputFile fIn;		//Decompresses .zst files
+  std::string fLine;
+  const char* fPos;
+};
+
+class TextHitSource : public RecordSource<Hit>, private TextSource
+{
+public:
+  bool Open(const std::string& filename) { return TextSource::Open(filename); }
+  bool Seek(const FourQubitHitFormat::IndexRecord& entry) { return SeekTo(entry); }
+
+  bool Read(Hit& theHit)
+  {
+    if( !NextLine() ) return false;
+    theHit.runID = NextInt();
+    theHit.eventID = NextInt();
+    theHit.trackID = NextInt();
+    NextWord(theHit.particleName);
+    theHit.startEnergy_eV = NextDouble();
+    theHit.startX_mm = NextDouble();
+    theHit.startY_mm = NextDouble();
+    theHit.startZ_mm = NextDouble();
+    theHit.startT_ns = NextDouble();
+    theHit.eDep_eV = NextDouble();
+    theHit.trackWeight = NextDouble();
+    theHit.endX_mm = NextDouble();
+    theHit.endY_mm = NextDouble();
+    theHit.endZ_mm = NextDouble();
+    theHit.endT_ns = NextDouble();
+    theHit.sensorID = NextOptionalInt(kUnknownVolumeID);
+    theHit.qubitID = NextOptionalInt(kUnknownVolumeID);
+    return true;
+  }
+};
+
+class TextPrimarySource : public RecordSource<PrimaryInfo>, private TextSource
+{
+public:
+  bool Open(const std::string& filename) { return TextSource::Open(filename); }
+  bool Seek(const FourQubitHitFormat::IndexRecord& entry) { return SeekTo(entry); }
+
+  bool Read(PrimaryInfo& thePrim)
+  {
+    if( !NextLine() ) return false;
+    thePrim.runID = NextInt();
+    thePrim.eventID = NextInt();
+    NextWord(thePrim.particleName);
+    thePrim.energy_eV = NextDouble();
+    thePrim.X_mm = NextDouble();
+    thePrim.Y_mm = NextDouble();
+    thePrim.Z_mm = NextDouble();
+    thePrim.T_ns = NextDouble();
+    thePrim.stratum = NextOptionalInt(-1);
+    thePrim.weight = NextOptionalDouble(1.);
+    thePrim.flags = NextOptionalInt(0);
+    return true;
+  }
+};
+
+
+//---------------------------------------------------------------------------------------
+// Binary files, through FourQubitHitReader
+class BinaryHitSource : public RecordSource<Hit>
+{
+public:
+  bool Open(const std::string& filename) { return fReader.Open(filename); }
+  bool Seek(const FourQubitHitFormat::IndexRecord& entry) { return fReader.Seek(entry); }
+
+  bool Read(Hit& theHit)
+  {
+    FourQubitHitFormat::HitRecord rec;
+    if( !fReader.Next(rec) ) return false;
+    theHit.runID = rec.runID;
+    theHit.eventID = rec.eventID;
+    theHit.trackID = rec.trackID;
+    theHit.particleName = fReader.ParticleName(rec.particle);
+    theHit.startEnergy_eV = rec.startEnergy;
+    theHit.startX_mm = rec.startX;
+    theHit.startY_mm = rec.startY;
+    theHit.startZ_mm = rec.startZ;
+    theHit.startT_ns = rec.startTime;
+    theHit.eDep_eV = rec.energyDeposit;
+    theHit.trackWeight = rec.weight;
+    theHit.endX_mm = rec.finalX;
+    theHit.endY_mm = rec.finalY;
+    theHit.endZ_mm = rec.finalZ;
+    theHit.endT_ns = rec.finalTime;
+    bool hasIDs = fReader.GetHeader().version >= 2;
+    theHit.sensorID = hasIDs ? rec.sensorID : kUnknownVolumeID;
+    theHit.qubitID = hasIDs ? rec.qubitID : kUnknownVolumeID;
+    return true;
+  }
+
+private:
+  FourQubitHitFileReader fReader;
+};
+
+class BinaryPrimarySource : public RecordSource<PrimaryInfo>
+{
+public:
+  bool Open(const std::string& filename) { return fReader.Open(filename); }
+  bool Seek(const FourQubitHitFormat::IndexRecord& entry) { return fReader.Seek(entry); }
+
+  bool Read(PrimaryInfo& thePrim)
+  {
+    FourQubitHitFormat::PrimaryRecord rec;
+    if( !fReader.Next(rec) ) return false;
+    thePrim.runID = rec.runID;
+    thePrim.eventID = rec.eventID;
+    thePrim.particleName = fReader.ParticleName(rec.particle);
+    thePrim.energy_eV = rec.energy;
+    thePrim.X_mm = rec.x;
+    thePrim.Y_mm = rec.y;
+    thePrim.Z_mm = rec.z;
+    thePrim.T_ns = rec.time;
+    thePrim.stratum = (fReader.GetHeader().version >= 3) ? rec.stratum : -1;
+    thePrim.weight = (fReader.GetHeader().version >= 4) ? rec.weight : 1.;
+    thePrim.flags = (fReader.GetHeader().version >= 5) ? rec.flags : 0;
+    return true;
+  }
+
+private:
+  FourQubitPrimaryFileReader fReader;
+};
+
+
+//---------------------------------------------------------------------------------------
+// ROOT ntuples, through TTreeReader
+class RootSource
+{
+protected:
+  RootSource(const std::string& filename, const char* treeName)
+    : fFile(TFile::Open(filename.c_str())),
+      fReader(treeName, (fFile && !fFile->IsZombie()) ? fFile.get() : 0) {}
+
+  bool IsOpen() const { return fFile && !fFile->IsZombie() && fReader.GetTree(); }
+
+  // One pass over the run and event IDs alone.  A merged MT ntuple holds
+  // each worker's entries in (run, event) order, in chunks interleaved with
+  // the other workers'; if the tree is out of order, its chunks of
+  // consecutive entries with one event are sorted (stably, so an event
+  // split over chunks keeps its order) and NextEntry() follows them
+  void Order(TTreeReaderValue<int>& runID, TTreeReaderValue<int>& eventID)
+  {
+    bool sorted = true;
+    while( fReader.Next() ){
+      int run = *runID, event = *eventID;
+      if( !fChunks.empty() && fChunks.back().runID == run && fChunks.back().eventID == event ){
+	++fChunks.back().nEntries;
+	continue;
+      }
+      if( !fChunks.empty() && (run < fChunks.back().runID ||
+			       (run == fChunks.back().runID && event < fChunks.back().eventID)) ) sorted = false;
+      Chunk c = { run, event, fReader.GetCurrentEntry(), 1 };
+      fChunks.push_back(c);
+    }
+    fReader.Restart();
+
+    if( sorted ) fChunks.clear();		//Read straight through
+    else std::stable_sort(fChunks.begin(),fChunks.end(),Earlier);
+    fChunk = 0;
+    fInChunk = 0;
+  }
+
+  bool NextEntry()
+  {
+    if( fChunks.empty() ) return fReader.Next();
+    while( fChunk < fChunks.size() && fInChunk == fChunks[fChunk].nEntries ){
+      ++fChunk;
+      fInChunk = 0;
+    }
+    if( fChunk == fChunks.size() ) return false;
+    return fReader.SetEntry(fChunks[fChunk].first + fInChunk++) == TTreeReader::kEntryValid;
+  }
+
+  std::unique_ptr<TFile> fFile;
+  TTreeReader fReader;
+
+private:
+  struct Chunk
+  {
+    int runID, eventID;
+    Long64_t first, nEntries;
+  };
+
+  static bool Earlier(const Chunk& a, const Chunk& b)
+  {
+    return a.runID < b.runID || (a.runID == b.runID && a.eventID < b.eventID);
+  }
+
+  std::vector<Chunk> fChunks;		//Empty if the tree is in order
+  size_t fChunk = 0;
+  Long64_t fInChunk = 0;
+};
+
+class RootHitSource : public RecordSource<Hit>, private RootSource
+{
+public:
+  RootHitSource(const std::string& filename)
+    : RootSource(filename,"hits"),
+      runID(fReader,"RunID"), eventID(fReader,"EventID"), trackID(fReader,"TrackID"),
+      particleName(fReader,"ParticleName"), startEnergy(fReader,"StartEnergy"),
+      startX(fReader,"StartX"), startY(fReader,"StartY"), startZ(fReader,"StartZ"),
+      startT(fReader,"StartTime"), eDep(fReader,"EnergyDeposited"), weight(fReader,"TrackWeight"),
+      endX(fReader,"EndX"), endY(fReader,"EndY"), endZ(fReader,"EndZ"), endT(fReader,"FinalTime"),
+      sensorID(fReader,"SensorID"), qubitID(fReader,"QubitID")
+  {
+    if( IsOpen() ) Order(runID,eventID);
+  }
+
+  bool Open() const { return IsOpen(); }
+
+  bool Read(Hit& theHit)
+  {
+    if( !NextEntry() ) return false;
+    theHit.runID = *runID;
+    theHit.eventID = *eventID;
+    theHit.trackID = *trackID;
+    theHit.particleName = &particleName[0];
+    theHit.startEnergy_eV = *startEnergy;
+    theHit.startX_mm = *startX;
+    theHit.startY_mm = *startY;
+    theHit.startZ_mm = *startZ;
+    theHit.startT_ns = *startT;
+    theHit.eDep_eV = *eDep;
+    theHit.trackWeight = *weight;
+    theHit.endX_mm = *endX;
+    theHit.endY_mm = *endY;
+    theHit.endZ_mm = *endZ;
+    theHit.endT_ns = *endT;
+    theHit.sensorID = *sensorID;
+    theHit.qubitID = *qubitID;
+    return true;
+  }
+
+private:
+  TTreeReaderValue<int> runID, eventID, trackID;
+  TTreeReaderArray<char> particleName;
+  TTreeReaderValue<double> startEnergy, startX, startY, startZ, startT, eDep, weight;
+  TTreeReaderValue<double> endX, endY, endZ, endT;
+  TTreeReaderValue<int> sensorID, qubitID;
+};
+
+class RootPrimarySource : public RecordSource<PrimaryInfo>, private RootSource
+{
+public:
+  RootPrimarySource(const std::string& filename)
+    : RootSource(filename,"primaries"),
+      runID(fReader,"RunID"), eventID(fReader,"EventID"), particleName(fReader,"ParticleName"),
+      energy(fReader,"StartEnergy"), X(fReader,"StartX"), Y(fReader,"StartY"),
+      Z(fReader,"StartZ"), T(fReader,"StartTime")
+  {
+    //Files written before the columns existed have no stratum, weight or flags
+    if( IsOpen() && fReader.GetTree()->GetBranch("Stratum") )
+      stratum.reset(new TTreeReaderValue<int>(fReader,"Stratum"));
+    if( IsOpen() && fReader.GetTree()->GetBranch("Weight") )
+      weight.reset(new TTreeReaderValue<double>(fReader,"Weight"));
+    if( IsOpen() && fReader.GetTree()->GetBranch("Flags") )
+      flags.reset(new TTreeReaderValue<int>(fReader,"Flags"));
+    if( IsOpen() ) Order(runID,eventID);
+  }
+
+  bool Open() const { return IsOpen(); }
+
+  bool Read(PrimaryInfo& thePrim)
+  {
+    if( !NextEntry() ) return false;
+    thePrim.runID = *runID;
+    thePrim.eventID = *eventID;
+    thePrim.particleName = &particleName[0];
+    thePrim.energy_eV = *energy;
+    thePrim.X_mm = *X;
+    thePrim.Y_mm = *Y;
+    thePrim.Z_mm = *Z;
+    thePrim.T_ns = *T;
+    thePrim.stratum = stratum ? **stratum : -1;
+    thePrim.weight = weight ? **weight : 1.;
+    thePrim.flags = flags ? **flags : 0;
+    return true;
+  }
+
+private:
+  TTreeReaderValue<int> runID, eventID;
+  TTreeReaderArray<char> particleName;
+  TTreeReaderValue<double> energy, X, Y, Z, T;
+  std::unique_ptr<TTreeReaderValue<int> > stratum;
+  std::unique_ptr<TTreeReaderValue<double> > weight;
+  std::unique_ptr<TTreeReaderValue<int> > flags;
+};
+
+
+//---------------------------------------------------------------------------------------
+// Lockstep walk over a hit file and its primary file
+class EventStream
+{
+public:
+  // Picks the right source for each file; for ROOT output the primary
+  // ntuple is taken from the hit file unless a .root primary file is given
+  bool Open(const std::string& hitsFilename, const std::string& primariesFilename)
+  {
+    fHitPending = false;
+    fHitsDone = false;
+    fIndexed = false;
+    fFailed = false;
+    fHavePrim = fHaveHit = false;
+    fNextPrim = 0;
+    fRemaining = -1;
+    fHitsName = hitsFilename;
+    fPrimsName = primariesFilename;
+    fThreadID = ShardThreadID(hitsFilename);
+    fHitIndex.Open(hitsFilename);		//Either may be missing; see Seek()
+    fPrimIndex.Open(primariesFilename);
+    if( IsRootFile(hitsFilename) ){
+      const std::string& primFile = IsRootFile(primariesFilename) ? primariesFilename : hitsFilename;
+      RootHitSource* hits = new RootHitSource(hitsFilename);
+      RootPrimarySource* prims = new RootPrimarySource(primFile);
+      fHits.reset(hits);
+      fPrims.reset(prims);
+      return Check(hits->Open(),hitsFilename) && Check(prims->Open(),primFile);
+    }
+
+    fHits.reset(OpenHits(hitsFilename));
+    fPrims.reset(OpenPrimaries(primariesFilename));
+    if( !Check(fHits != 0,hitsFilename) || !Check(fPrims != 0,primariesFilename) ) return false;
+
+    //An index tells whether its file is in order; a file without one is
+    //taken to be, and checked record by record in Next().  Files out of
+    //order are read through their indexes
+    bool hitsInOrder = !fHitIndex.IsOpen() || InFileOrder(fHitIndex);
+    bool primsInOrder = !fPrimIndex.IsOpen() || InFileOrder(fPrimIndex);
+    if( hitsInOrder && primsInOrder ) return true;
+
+    if( fHitIndex.IsOpen() && fPrimIndex.IsOpen() ){
+      fIndexed = true;
+      return true;
+    }
+    std::cerr << "EventStream: " << (hitsInOrder ? primariesFilename : hitsFilename)
+	      << " is not in (run, event) order, and "
+	      << (fHitIndex.IsOpen() ? primariesFilename : hitsFilename)
+	      << " has no event index, so the pair can't be read through its indexes;"
+	      << " rerun with /g4cmp/EventIndex on." << std::endl;
+    fHits.reset();
+    fPrims.reset();
+    return false;
+  }
+
+  // Positions the stream so that Next() returns event (runID, eventID).
+  // False if either file has no index or the event has no primary; the
+  // stream is then left where it was, or at an unknown place if the seek
+  // itself failed.
+  bool Seek(int runID, int eventID)
+  {
+    if( !fHitIndex.IsOpen() || !fPrimIndex.IsOpen() || !fHits || !fPrims ) return false;
+
+    const FourQubitEventIndex::Entry* prim = fPrimIndex.Find(runID,eventID);
+    if( !prim ) return false;
+    if( fIndexed ){
+      fNextPrim = prim - fPrimIndex.Entries().data();
+      return true;
+    }
+    const FourQubitEventIndex::Entry* hit = fHitIndex.LowerBound(runID,eventID);
+
+    fHitPending = false;
+    fHitsDone = !hit;				//No hits from here on
+    fHavePrim = fHaveHit = false;
+    return fPrims->Seek(*prim) && (!hit || fHits->Seek(*hit));
+  }
+
+  // Seek() to entry "first" of the primary index, the events' (run, event)
+  // order, and read no more than "nEvents" from there
+  bool SeekRange(size_t first, size_t nEvents)
+  {
+    if( !fPrimIndex.IsOpen() || first >= fPrimIndex.Size() ) return false;
+    const Entry& e = fPrimIndex.Entries()[first];
+    if( !Seek(e.runID,e.eventID) ) return false;
+    fRemaining = (long)nEvents;
+    return true;
+  }
+
+  // Refills "theEvent" with the next primary and all of its hits.  The
+  // hit vector is cleared, not freed, so its storage is reused.
+  bool Next(Event& theEvent)
+  {
+    if( fFailed || fRemaining == 0 ) return false;
+    if( fRemaining > 0 ) --fRemaining;
+    if( fIndexed ) return NextIndexed(theEvent);
+
+    if( !fPrims || !fPrims->Read(theEvent.thePrim) ) return false;
+    if( fHavePrim && !Before(fLastPrim,theEvent.thePrim) ) return OutOfOrder(fPrimsName,theEvent.thePrim);
+    fLastPrim = theEvent.thePrim;
+    fHavePrim = true;
+    theEvent.runID = theEvent.thePrim.runID;
+    theEvent.eventID = theEvent.thePrim.eventID;
+    theEvent.threadID = fThreadID;
+    theEvent.hitVect.clear();
+
+    while( fHitPending || (!fHitsDone && fHits && ReadHit()) ){
+      fHitPending = true;
+      if( Before(fNextHit,theEvent.thePrim) ){	//Hit without a primary: drop it
+	fHitPending = false;
+	continue;
+      }
+      if( fNextHit.runID != theEvent.runID || fNextHit.eventID != theEvent.eventID ) break;
+      theEvent.hitVect.push_back(fNextHit);
+      fHitPending = false;
+    }
+    return !fFailed;
+  }
+
+  // True once a file turned out to be out of order (see above)
+  bool Failed() const { return fFailed; }
+
+private:
+  typedef FourQubitEventIndex::Entry Entry;
+
+  template <class A, class B>
+  static bool Before(const A& a, const B& b)
+  {
+    return a.runID < b.runID || (a.runID == b.runID && a.eventID < b.eventID);
+  }
+
+  // Text or binary source for the file; null if it cannot be opened
+  static RecordSource<Hit>* OpenHits(const std::string& filename)
+  {
+    if( FourQubitHitFileReader::IsBinaryFile(filename) ){
+      std::unique_ptr<BinaryHitSource> hits(new BinaryHitSource);
+      return hits->Open(filename) ? hits.release() : 0;
+    }
+    std::unique_ptr<TextHitSource> hits(new TextHitSource);
+    return hits->Open(filename) ? hits.release() : 0;
+  }
+
+  static RecordSource<PrimaryInfo>* OpenPrimaries(const std::string& filename)
+  {
+    if( FourQubitPrimaryFileReader::IsBinaryFile(filename) ){
+      std::unique_ptr<BinaryPrimarySource> prims(new BinaryPrimarySource);
+      return prims->Open(filename) ? prims.release() : 0;
+    }
+    std::unique_ptr<TextPrimarySource> prims(new TextPrimarySource);
+    return prims->Open(filename) ? prims.release() : 0;
+  }
+
+  // The index, sorted by (run, event), points forward through the file
+  static bool InFileOrder(const FourQubitEventIndex& index)
+  {
+    const std::vector<Entry>& e = index.Entries();
+    for( size_t i = 1; i < e.size(); ++i ){
+      if( e[i].offset < e[i-1].offset || (e[i].offset == e[i-1].offset && e[i].skip < e[i-1].skip) ) return false;
+    }
+    return true;
+  }
+
+  bool ReadHit()
+  {
+    if( !fHits->Read(fNextHit) ) return false;
+    if( fHaveHit && Before(fNextHit,fLastHit) ) return OutOfOrder(fHitsName,fNextHit);
+    fLastHit = fNextHit;
+    fHaveHit = true;
+    return true;
+  }
+
+  // One seek per file and event
+  bool NextIndexed(Event& theEvent)
+  {
+    const std::vector<Entry>& prims = fPrimIndex.Entries();
+    if( fNextPrim >= prims.size() ) return false;
+    const Entry& prim = prims[fNextPrim++];
+    if( !fPrims->Seek(prim) || !fPrims->Read(theEvent.thePrim) ) return Unreadable(fPrimsName,prim);
+    theEvent.runID = theEvent.thePrim.runID;
+    theEvent.eventID = theEvent.thePrim.eventID;
+    theEvent.threadID = fThreadID;
+    theEvent.hitVect.clear();
+
+    const Entry* hits = fHitIndex.Find(prim.runID,prim.eventID);
+    if( !hits ) return true;
+    if( !fHits->Seek(*hits) ) return Unreadable(fHitsName,*hits);
+    for( int i = 0; i < hits->nRecords; ++i ){
+      if( !fHits->Read(fNextHit) ) return Unreadable(fHitsName,*hits);
+      theEvent.hitVect.push_back(fNextHit);
+    }
+    return true;
+  }
+
+  template <class Record>
+  bool OutOfOrder(const std::string& filename, const Record& rec)
+  {
+    std::cerr << "EventStream: " << filename << " is not in (run, event) order at run "
+	      << rec.runID << " event " << rec.eventID << "; stopping. Write it with"
+	      << " /g4cmp/EventIndex to have it read through its index." << std::endl;
+    fFailed = true;
+    return false;
+  }
+
+  bool Unreadable(const std::string& filename, const Entry& e)
+  {
+    std::cerr << "EventStream: cannot read run " << e.runID << " event " << e.eventID
+	      << " of " << filename << " at its index entry; stopping." << std::endl;
+    fFailed = true;
+    return false;
+  }
+
+  static bool Check(bool ok, const std::string& filename)
+  {
+    if( !ok ) std::cerr << "EventStream: could not open " << filename << std::endl;
+    return ok;
+  }
+
+  std::unique_ptr<RecordSource<Hit> > fHits;
+  std::unique_ptr<RecordSource<PrimaryInfo> > fPrims;
+  std::string fHitsName, fPrimsName;
+  Hit fNextHit;			//One-hit lookahead into the next event
+  bool fHitPending;
+  bool fHitsDone;		//Sought past the last event with hits
+  int fThreadID;
+  FourQubitEventIndex fHitIndex, fPrimIndex;
+
+  bool fIndexed;		//Read through the indexes, event by event
+  size_t fNextPrim;		//Next primary index entry, if indexed
+  long fRemaining;		//Events left to read after SeekRange(), or -1
+  bool fFailed;
+  Hit fLastHit;			//For the order checks
+  PrimaryInfo fLastPrim;
+  bool fHavePrim, fHaveHit;
+};
+
+#endif
@@ -0,0 +1,130 @@
+//---------------------------------------------------------
+//
+// FourQubitHitReader.hh
+//
+// Reader for the binary hit and primary files written
+// with /g4cmp/HitsFormat binary, and for the step traces
+// written with /g4cmp/StepTraceFile, and for the per-event
+// sensor sums written with /g4cmp/HitsMode event.  Files compressed with
+// /g4cmp/OutputCompression zstd are decompressed as they are read (see
+// FourQubitCompressedInput.hh).  Header-only and free of
+// Geant4/ROOT dependencies, so it can be used from ROOT
+// macros or compiled code alike:
+//
+//   FourQubitHitReader<FourQubitHitFormat::HitRecord> r;
+//   if (r.Open("FourQubit_hits.txt")) {
+//     FourQubitHitFormat::HitRecord h;
+//     while (r.Next(h)) { ... r.ParticleName(h.particle) ... }
+//   }
+//
+// With the file's event index (FourQubitEventIndex.hh), Seek()
+// goes straight to one event's records.
+//
+//---------------------------------------------------------
+
+#ifndef FourQubitHitReader_hh
+#define FourQubitHitReader_hh
+
+#include "../include/FourQubitCompressedInput.hh"
+#include "../include/FourQubitHitFormat.hh"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+//---------------------------------------------------------------------------------------
+// Sequential reader over one file of Record (HitRecord or PrimaryRecord)
+template <class Record>
+class FourQubitHitReader
+{
+public:
+  // Returns false if the file is missing, is text, or holds the other
+  // record type; any complaint is printed to std::cerr
+  bool Open(const std::string& filename)
+  {
+    fIn.close();
+    fIn.clear();
+    fIn.open(filename);
+    if( !fIn.is_open() ) return false;
+
+    if( !FourQubitHitFormat::ReadHeader(fIn,fHeader) ) return false;
+
+    //Older versions are accepted: their records are a prefix of the current ones
+    if( !IsRecordType(fHeader) ){
+      std::cerr << "FourQubitHitReader: " << filename << " holds "
+		<< std::string(fHeader.magic,strnlen(fHeader.magic,8))
+		<< " records, not the type requested." << std::endl;
+      return false;
+    }
+    if( fHeader.recordSize > sizeof(Record) ||
+	fHeader.version > FourQubitHitFormat::kFormatVersion ){
+      std::cerr << "FourQubitHitReader: " << filename << " has format version "
+		<< fHeader.version << ", record size " << fHeader.recordSize
+		<< "; expected version " << FourQubitHitFormat::kFormatVersion
+		<< ", size " << sizeof(Record) << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  // Reads the next record, already in host byte order.  Fields missing from
+  // an older file are filled with all-ones bytes: -1 for integer IDs
+  bool Next(Record& rec)
+  {
+    char* bytes = reinterpret_cast<char*>(&rec);
+    if( fHeader.recordSize < sizeof(Record) )
+      std::memset(bytes+fHeader.recordSize,0xFF,sizeof(Record)-fHeader.recordSize);
+    if( !fIn.read(bytes,fHeader.recordSize) ) return false;
+    if( !FourQubitHitFormat::HostIsLittleEndian() )
+      FourQubitHitFormat::SwapRecord(&rec,fHeader.fields);
+    return true;
+  }
+
+  // Go to the first record of an indexed event; Next() reads on from there
+  bool Seek(const FourQubitHitFormat::IndexRecord& entry)
+  {
+    return fIn.Seek(entry.offset,entry.skip);
+  }
+
+  //Any code from the name table (particle; process or volume in a step trace)
+  const std::string& ParticleName(int code) const
+  {
+    static const std::string unknown = "unknown";
+    if( code < 0 || code >= (int)fHeader.particles.size() ) return unknown;
+    return fHeader.particles[code];
+  }
+
+  const FourQubitHitFormat::Header& GetHeader() const { return fHeader; }
+
+  // True if "filename" starts with a binary hit or primary header
+  static bool IsBinaryFile(const std::string& filename)
+  {
+    FourQubitInputFile in(filename);
+    FourQubitHitFormat::Header hdr;
+    return in.is_open() && FourQubitHitFormat::ReadHeader(in,hdr);
+  }
+
+private:
+  static bool IsRecordType(const FourQubitHitFormat::Header& hdr)
+  {
+    if( std::is_same<Record,FourQubitHitFormat::HitRecord>::value ) return hdr.IsHits();
+    if( std::is_same<Record,FourQubitHitFormat::StepRecord>::value ) return hdr.IsSteps();
+    if( std::is_same<Record,FourQubitHitFormat::EventSumRecord>::value ) return hdr.IsEventSums();
+    if( std::is_same<Record,FourQubitHitFormat::IndexRecord>::value ) return hdr.IsIndex();
+    return hdr.IsPrimaries();
+  }
+
+  FourQubitInputFile fIn;
+  FourQubitHitFormat::Header fHeader;
+};
+
+typedef FourQubitHitReader<FourQubitHitFormat::HitRecord> FourQubitHitFileReader;
+typedef FourQubitHitReader<FourQubitHitFormat::PrimaryRecord> FourQubitPrimaryFileReader;
+typedef FourQubitHitReader<FourQubitHitFormat::StepRecord> FourQubitStepFileReader;
+typedef FourQubitHitReader<FourQubitHitFormat::EventSumRecord> FourQubitEventSumFileReader;
+typedef FourQubitHitReader<FourQubitHitFormat::IndexRecord> FourQubitIndexFileReader;
+
+#endif
@@ -0,0 +1,190 @@
+//---------------------------------------------------------
+//
+// FourQubitParallelFill.hh
+//
+// Multithreaded event loop for the analysis macros.  The
+// (hit file, primary file) pairs are cut into tasks, each
+// streamed by one thread at a time, and every thread fills
+// its own clone of each histogram; the clones are summed
+// into the originals by Merge() once the loop is done:
+//
+//   SlotHist<TH1F> h_eDep(new TH1F(...),nSlots);
+//   ProcessEvents(hitFiles,primFiles,nSlots,
+//                 [&](const Event& tE, int slot){ h_eDep[slot]->Fill(...); });
+//   h_eDep.Merge();
+//
+// A text or binary pair with event indexes (/g4cmp/EventIndex)
+// is split into ranges of events, so a single merged file
+// keeps every thread busy; each range costs one seek
+// (EventStream::SeekRange).  Pairs without indexes, and ROOT
+// files, are one task each.
+//
+//---------------------------------------------------------
+
+#ifndef FourQubitParallelFill_hh
+#define FourQubitParallelFill_hh
+
+//C++ includes
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+//ROOT includes
+#include "TROOT.h"
+
+#include "FourQubitEventStream.hh"
+
+//---------------------------------------------------------------------------------------
+// One histogram per fill slot.  Slot 0 is the original (owned by the
+// output file as usual); the others are detached clones summed into it
+template <class H>
+class SlotHist
+{
+public:
+  SlotHist(H* original, int nSlots)
+  {
+    fSlots.push_back(original);
+    for( int i = 1; i < nSlots; ++i ){
+      std::ostringstream name;
+      name << original->GetName() << "_slot" << i;
+      H* clone = (H*)original->Clone(name.str().c_str());
+      clone->SetDirectory(0);
+      fSlots.push_back(clone);
+    }
+  }
+
+  ~SlotHist() { for( size_t i = 1; i < fSlots.size(); ++i ) delete fSlots[i]; }
+
+  H* operator[](int slot) const { return fSlots[slot]; }
+  H* operator->() const { return fSlots[0]; }
+
+  void Merge()
+  {
+    for( size_t i = 1; i < fSlots.size(); ++i ){
+      fSlots[0]->Add(fSlots[i]);
+      fSlots[i]->Reset();
+    }
+  }
+
+private:
+  SlotHist(const SlotHist&);
+  SlotHist& operator=(const SlotHist&);
+
+  std::vector<H*> fSlots;
+};
+
+
+//---------------------------------------------------------------------------------------
+// Split a comma-separated list of files ("hits_t0.txt,hits_t1.txt")
+inline std::vector<std::string> SplitFileList(const std::string& list)
+{
+  std::vector<std::string> files;
+  std::stringstream ss(list);
+  std::string name;
+  while( std::getline(ss,name,',') ) if( !name.empty() ) files.push_back(name);
+  return files;
+}
+
+//---------------------------------------------------------------------------------------
+// A file pair, or nEvents of it from entry "first" of its primary index
+struct EventTask
+{
+  size_t pair;
+  size_t first, nEvents;	//nEvents 0: the whole pair, read straight through
+};
+
+// About four tasks per thread, so that threads finishing early pick up
+// the rest, but no fewer than minEvents events per seek
+inline std::vector<EventTask> PlanEventTasks(const std::vector<std::string>& hitFiles,
+					     const std::vector<std::string>& primFiles,
+					     int nThreads, size_t minEvents = 1000)
+{
+  std::vector<EventTask> tasks;
+  for( size_t iP = 0; iP < hitFiles.size() && iP < primFiles.size(); ++iP ){
+    FourQubitEventIndex hitIndex, primIndex;
+    size_t nEvents = 0;
+    if( !IsRootFile(hitFiles[iP]) && hitIndex.Open(hitFiles[iP]) && primIndex.Open(primFiles[iP]) )
+      nEvents = primIndex.Size();
+
+    size_t perTask = std::max(minEvents,(nEvents + 4*nThreads - 1)/(4*nThreads));
+    if( nEvents <= perTask ){
+      EventTask whole = { iP, 0, 0 };
+      tasks.push_back(whole);
+      continue;
+    }
+    for( size_t first = 0; first < nEvents; first += perTask ){
+      EventTask range = { iP, first, std::min(perTask,nEvents-first) };
+      tasks.push_back(range);
+    }
+  }
+  return tasks;
+}
+
+// Number of fill slots: the requested thread count, capped by the number
+// of tasks the files can be cut into (see PlanEventTasks)
+inline int NumberOfSlots(int nThreads, const std::vector<std::string>& hitFiles,
+			 const std::vector<std::string>& primFiles)
+{
+  if( nThreads <= 0 ) nThreads = std::max(1u,std::thread::hardware_concurrency());
+  size_t nTasks = PlanEventTasks(hitFiles,primFiles,nThreads).size();
+  return std::max(1,std::min(nThreads,(int)nTasks));
+}
+
+//---------------------------------------------------------------------------------------
+// Stream every file pair, calling fill(event,slot) from "nSlots" threads.
+// Events of one pair may be filled by several threads, in any order.
+// False if a pair could not be read in full (see EventStream::Failed()),
+// in which case the histograms are incomplete.
+inline bool ProcessEvents(const std::vector<std::string>& hitFiles,
+			  const std::vector<std::string>& primFiles,
+			  int nSlots,
+			  std::function<void(const Event&,int)> fill)
+{
+  if( hitFiles.size() != primFiles.size() ){
+    std::cerr << "ProcessEvents: " << hitFiles.size() << " hit files but "
+	      << primFiles.size() << " primary files." << std::endl;
+    return false;
+  }
+
+  if( nSlots > 1 ) ROOT::EnableThreadSafety();
+
+  std::vector<EventTask> tasks = PlanEventTasks(hitFiles,primFiles,nSlots);
+  std::atomic<size_t> nextTask(0);
+  std::atomic<long> nEvents(0);
+  std::atomic<bool> complete(true);
+  auto worker = [&](int slot){
+    for( size_t iT = nextTask++; iT < tasks.size(); iT = nextTask++ ){
+      const EventTask& task = tasks[iT];
+      EventStream stream;
+      if( !stream.Open(hitFiles[task.pair],primFiles[task.pair]) ||
+	  (task.nEvents > 0 && !stream.SeekRange(task.first,task.nEvents)) ){
+	complete = false;
+	continue;
+      }
+
+      Event tE;
+      while( stream.Next(tE) ){
+	fill(tE,slot);
+	long n = ++nEvents;
+	if( n % 1000 == 0 ) std::cout << "Done with " << n << " event histogram fills." << std::endl;
+      }
+      if( stream.Failed() ) complete = false;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for( int slot = 1; slot < nSlots; ++slot ) threads.push_back(std::thread(worker,slot));
+  worker(0);
+  for( size_t i = 0; i < threads.size(); ++i ) threads[i].join();
+
+  if( !complete ) std::cerr << "ProcessEvents: not every file was read in full;"
+			    << " the histograms are incomplete." << std::endl;
+  return complete;
+}
+
+#endif
@@ -0,0 +1,341 @@
+//---------------------------------------------------------
+//
+// FourQubitPulseSynth.hh
+//
+// Time-domain pulses from phonon hits.  Each hit's energy
+// is binned by its end time into a fixed-rate trace for its
+// channel (qubit or sensor), and every trace that received
+// energy is convolved with a sampled response kernel:
+//
+//   PulseSynth synth(nChannels,nBins,binWidth_ns);
+//   synth.SetKernel(PulseSynth::ExponentialKernel(rise_ns,fall_ns,binWidth_ns));
+//   synth.Clear();
+//   synth.Add(channel,t_ns,eDep_eV);   // for each hit
+//   synth.Synthesize();
+//   const float* trace = synth.Trace(channel);
+//
+// All traces of an event live in one contiguous array,
+// one row per channel.  Short kernels are applied directly
+// as a scaled copy of the kernel per filled bin, which the
+// compiler vectorizes; long ones go through an FFT, two
+// channels per transform (one as the real part, one as the
+// imaginary part), with the kernel's spectrum computed once.
+// Either way the result is the linear convolution cut to
+// the trace length, in eV per bin for a unit-area kernel.
+//
+//---------------------------------------------------------
+
+#ifndef FourQubitPulseSynth_hh
+#define FourQubitPulseSynth_hh
+
+//C++ includes
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------------------
+// In-place radix-2 FFT on split real and imaginary arrays of a fixed size
+class PulseFFT
+{
+public:
+  PulseFFT() : fN(0) {}
+
+  void Resize(size_t n)
+  {
+    if( n == fN ) return;
+    fN = n;
+    fCos.resize(n/2);
+    fSin.resize(n/2);
+    for( size_t i = 0; i < n/2; ++i ){
+      double phase = -2*M_PI*i/n;
+      fCos[i] = std::cos(phase);
+      fSin[i] = std::sin(phase);
+    }
+
+    fSwap.clear();
+    for( size_t i = 1, j = 0; i < n; ++i ){
+      size_t bit = n >> 1;
+      for( ; j & bit; bit >>= 1 ) j ^= bit;
+      j ^= bit;
+      if( i < j ) fSwap.push_back(std::make_pair(i,j));
+    }
+  }
+
+  size_t Size() const { return fN; }
+
+  // Inverse transforms are unnormalized: the caller divides by Size()
+  void Transform(double* re, double* im, bool inverse) const
+  {
+    for( size_t k = 0; k < fSwap.size(); ++k ){
+      std::swap(re[fSwap[k].first],re[fSwap[k].second]);
+      std::swap(im[fSwap[k].first],im[fSwap[k].second]);
+    }
+
+    const double sign = inverse ? -1 : 1;
+    for( size_t len = 2; len <= fN; len <<= 1 ){
+      const size_t half = len/2, stride = fN/len;
+      for( size_t start = 0; start < fN; start += len ){
+	double* aRe = re+start;
+	double* aIm = im+start;
+	double* bRe = aRe+half;
+	double* bIm = aIm+half;
+	for( size_t k = 0; k < half; ++k ){
+	  const double wRe = fCos[k*stride], wIm = sign*fSin[k*stride];
+	  const double tRe = bRe[k]*wRe - bIm[k]*wIm;
+	  const double tIm = bRe[k]*wIm + bIm[k]*wRe;
+	  bRe[k] = aRe[k] - tRe;
+	  bIm[k] = aIm[k] - tIm;
+	  aRe[k] += tRe;
+	  aIm[k] += tIm;
+	}
+      }
+    }
+  }
+
+private:
+  size_t fN;
+  std::vector<double> fCos, fSin;			//Twiddles for k < n/2
+  std::vector<std::pair<size_t,size_t> > fSwap;		//Bit-reversal permutation
+};
+
+//---------------------------------------------------------------------------------------
+class PulseSynth
+{
+public:
+  PulseSynth(int nChannels, int nBins, double binWidth_ns, double t0_ns = 0)
+    : fNChannels(std::max(0,nChannels)), fNBins(std::max(1,nBins)),
+      fBinWidth(binWidth_ns), fInvBinWidth(1.0/binWidth_ns), fT0(t0_ns),
+      fInput((size_t)fNChannels*fNBins,0.f), fTraces((size_t)fNChannels*fNBins,0.f),
+      fFilled(fNChannels,0), fEnergy(fNChannels,0.), fNHits(fNChannels,0),
+      fOutside(0), fDirect(true), fKernelSpectrumValid(false)
+  {
+    SetKernel(std::vector<float>(1,1.f));
+  }
+
+  //-----------------------------------------------------------------------------------
+  // Kernels, sampled at the trace's bin width and normalized to unit area, so
+  // a trace sums to the energy it received (less what runs off its end)
+
+  // Double exponential, exp(-t/fall) - exp(-t/rise), sampled at bin centers
+  // out to "nFall" fall times
+  static std::vector<float> ExponentialKernel(double rise_ns, double fall_ns,
+					      double binWidth_ns, double nFall = 8)
+  {
+    int n = std::max(1,(int)std::ceil(nFall*fall_ns/binWidth_ns));
+    std::vector<float> kernel(n);
+    for( int i = 0; i < n; ++i ){
+      double t = (i+0.5)*binWidth_ns;
+      double rise = (rise_ns > 0) ? std::exp(-t/rise_ns) : 0;
+      kernel[i] = (float)(std::exp(-t/fall_ns) - rise);
+    }
+    Normalize(kernel);
+    return kernel;
+  }
+
+  // One sample per line, at the trace's bin width; '#' lines are comments
+  static std::vector<float> KernelFromFile(const std::string& filename)
+  {
+    std::vector<float> kernel;
+    std::ifstream in(filename.c_str());
+    if( !in.is_open() ){
+      std::cerr << "PulseSynth: could not open kernel file " << filename << std::endl;
+      return kernel;
+    }
+
+    std::string line;
+    while( std::getline(in,line) ){
+      if( line.empty() || line[0] == '#' ) continue;
+      std::istringstream ss(line);
+      float v;
+      if( ss >> v ) kernel.push_back(v);
+    }
+    Normalize(kernel);
+    return kernel;
+  }
+
+  static void Normalize(std::vector<float>& kernel)
+  {
+    double sum = 0;
+    for( size_t i = 0; i < kernel.size(); ++i ) sum += kernel[i];
+    if( sum == 0 ) return;
+    for( size_t i = 0; i < kernel.size(); ++i ) kernel[i] = (float)(kernel[i]/sum);
+  }
+
+  //-----------------------------------------------------------------------------------
+  void SetKernel(const std::vector<float>& kernel)
+  {
+    fKernel = kernel.empty() ? std::vector<float>(1,1.f) : kernel;
+    if( (int)fKernel.size() > fNBins ) fKernel.resize(fNBins);	//The rest never lands in the trace
+    fKernelSpectrumValid = false;
+
+    //Direct costs one kernel length per filled bin, the FFT about 6 log2(M)
+    //per sample of the padded length M for each pair of channels; traces
+    //are assumed about a quarter filled
+    size_t m = PaddedLength();
+    double fftCost = 3.0*m*std::log2((double)m);
+    fDirect = (0.25*fNBins*fKernel.size() <= fftCost);
+  }
+
+  // Force one method, e.g. to compare them
+  void UseFFT(bool useFFT) { fDirect = !useFFT; }
+  bool UsesFFT() const { return !fDirect; }
+
+  //-----------------------------------------------------------------------------------
+  // Start a new event: only the traces used by the last one are cleared
+  void Clear()
+  {
+    for( int ch = 0; ch < fNChannels; ++ch ){
+      if( !fFilled[ch] ) continue;
+      std::fill(Row(fInput,ch),Row(fInput,ch)+fNBins,0.f);
+      std::fill(Row(fTraces,ch),Row(fTraces,ch)+fNBins,0.f);
+      fFilled[ch] = 0;
+      fEnergy[ch] = 0;
+      fNHits[ch] = 0;
+    }
+    fOutside = 0;
+  }
+
+  // False (and the energy counted in Outside()) if the channel is not one of
+  // the traces or the time is outside [t0, t0 + nBins*binWidth)
+  bool Add(int channel, double t_ns, double eDep_eV)
+  {
+    double x = (t_ns - fT0)*fInvBinWidth;
+    if( channel < 0 || channel >= fNChannels || !(x >= 0) || x >= fNBins ){
+      fOutside += eDep_eV;
+      return false;
+    }
+    Row(fInput,channel)[(int)x] += (float)eDep_eV;
+    fFilled[channel] = 1;
+    fEnergy[channel] += eDep_eV;
+    fNHits[channel]++;
+    return true;
+  }
+
+  // Convolve every filled trace with the kernel
+  void Synthesize()
+  {
+    if( fDirect ) SynthesizeDirect();
+    else SynthesizeFFT();
+  }
+
+  //-----------------------------------------------------------------------------------
+  int NumberOfChannels() const { return fNChannels; }
+  int NumberOfBins() const { return fNBins; }
+  double BinWidth() const { return fBinWidth; }
+  double StartTime() const { return fT0; }
+  const std::vector<float>& Kernel() const { return fKernel; }
+
+  bool Filled(int channel) const { return fFilled[channel] != 0; }
+  int NumberOfHits(int channel) const { return fNHits[channel]; }
+  double Energy(int channel) const { return fEnergy[channel]; }	//Binned, eV
+  double Outside() const { return fOutside; }			//Not binned, eV
+
+  const float* Trace(int channel) const { return Row(fTraces,channel); }
+  const float* Binned(int channel) const { return Row(fInput,channel); }
+
+private:
+  float* Row(std::vector<float>& v, int ch) const { return &v[(size_t)ch*fNBins]; }
+  const float* Row(const std::vector<float>& v, int ch) const { return &v[(size_t)ch*fNBins]; }
+
+  // Smallest power of two holding the full linear convolution
+  size_t PaddedLength() const
+  {
+    size_t need = fNBins + fKernel.size() - 1, m = 1;
+    while( m < need ) m <<= 1;
+    return m;
+  }
+
+  // Scatter form: each filled bin adds a scaled kernel to the trace
+  void SynthesizeDirect()
+  {
+    const float* k = fKernel.data();
+    const int nK = (int)fKernel.size();
+    for( int ch = 0; ch < fNChannels; ++ch ){
+      if( !fFilled[ch] ) continue;
+      const float* in = Row(fInput,ch);
+      float* out = Row(fTraces,ch);
+      for( int i = 0; i < fNBins; ++i ){
+	const float v = in[i];
+	if( v == 0.f ) continue;
+	const int n = std::min(nK,fNBins-i);
+	float* o = out+i;
+	for( int j = 0; j < n; ++j ) o[j] += v*k[j];
+      }
+    }
+  }
+
+  // The kernel is real, so its spectrum multiplies the real and imaginary
+  // parts of the packed pair independently, and they come back apart
+  void SynthesizeFFT()
+  {
+    const size_t m = PaddedLength();
+    if( !fKernelSpectrumValid || fFFT.Size() != m ){
+      fFFT.Resize(m);
+      fKernelRe.assign(m,0.);
+      fKernelIm.assign(m,0.);
+      std::copy(fKernel.begin(),fKernel.end(),fKernelRe.begin());
+      fFFT.Transform(fKernelRe.data(),fKernelIm.data(),false);
+      fKernelSpectrumValid = true;
+    }
+    fRe.resize(m);
+    fIm.resize(m);
+
+    std::vector<int> filled;
+    for( int ch = 0; ch < fNChannels; ++ch ) if( fFilled[ch] ) filled.push_back(ch);
+
+    const double scale = 1.0/m;
+    for( size_t p = 0; p < filled.size(); p += 2 ){
+      const int a = filled[p];
+      const int b = (p+1 < filled.size()) ? filled[p+1] : -1;
+
+      std::fill(fRe.begin(),fRe.end(),0.);
+      std::fill(fIm.begin(),fIm.end(),0.);
+      std::copy(Row(fInput,a),Row(fInput,a)+fNBins,fRe.begin());
+      if( b >= 0 ) std::copy(Row(fInput,b),Row(fInput,b)+fNBins,fIm.begin());
+
+      fFFT.Transform(fRe.data(),fIm.data(),false);
+      double* re = fRe.data();
+      double* im = fIm.data();
+      const double* kRe = fKernelRe.data();
+      const double* kIm = fKernelIm.data();
+      for( size_t i = 0; i < m; ++i ){
+	const double r = re[i]*kRe[i] - im[i]*kIm[i];
+	im[i] = re[i]*kIm[i] + im[i]*kRe[i];
+	re[i] = r;
+      }
+      fFFT.Transform(re,im,true);
+
+      float* outA = Row(fTraces,a);
+      for( int i = 0; i < fNBins; ++i ) outA[i] = (float)(re[i]*scale);
+      if( b < 0 ) continue;
+      float* outB = Row(fTraces,b);
+      for( int i = 0; i < fNBins; ++i ) outB[i] = (float)(im[i]*scale);
+    }
+  }
+
+  int fNChannels;
+  int fNBins;
+  double fBinWidth, fInvBinWidth;	//ns, 1/ns
+  double fT0;				//ns, start of bin 0
+
+  std::vector<float> fInput;		//Binned energy, nChannels x nBins
+  std::vector<float> fTraces;		//Convolved, same layout
+  std::vector<char> fFilled;		//Channel received energy this event
+  std::vector<double> fEnergy;
+  std::vector<int> fNHits;
+  double fOutside;
+
+  std::vector<float> fKernel;
+  bool fDirect;
+
+  PulseFFT fFFT;
+  bool fKernelSpectrumValid;
+  std::vector<double> fKernelRe, fKernelIm;	//Kernel spectrum
+  std::vector<double> fRe, fIm;			//Work arrays for a pair of channels
+};
+
+#endif
@@ -0,0 +1,159 @@
+//---------------------------------------------------------
+//
+// FourQubitQubitIndex.hh
+//
+// Hit-to-qubit assignment from the geometry description
+// file the simulation writes when it builds the chip
+// (/g4cmp/GeometryFile, default FourQubit_geometry.txt).
+// Qubit footprints are binned into a uniform XY grid, so a
+// lookup is one cell computation plus a box test against
+// the (usually single) footprint overlapping that cell:
+//
+//   QubitIndex qubits;
+//   if( qubits.Load("FourQubit_geometry.txt") ){
+//     int qubitID = qubits.Find(hitX_mm,hitY_mm);  // -1 if off every qubit
+//   }
+//
+//---------------------------------------------------------
+
+#ifndef FourQubitQubitIndex_hh
+#define FourQubitQubitIndex_hh
+
+//C++ includes
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class QubitIndex
+{
+public:
+  struct Footprint
+  {
+    int id;
+    int qubitID;
+    std::string name;
+    double xMin, xMax, yMin, yMax, zMin, zMax;	//mm
+
+    bool Contains(double x, double y) const { return x >= xMin && x <= xMax && y >= yMin && y <= yMax; }
+  };
+
+  QubitIndex() { BuildGrid(); }
+
+  // Reads the "qubit" entries (and keeps the "sensor" entries for reference)
+  bool Load(const std::string& filename)
+  {
+    fQubits.clear();
+    fSensors.clear();
+
+    std::ifstream in(filename.c_str());
+    if( !in.is_open() ){
+      std::cerr << "QubitIndex: could not open " << filename << std::endl;
+      return false;
+    }
+
+    std::string line;
+    while( std::getline(in,line) ){
+      if( line.empty() || line[0] == '#' ) continue;
+      std::istringstream ss(line);
+      std::string type;
+      Footprint f;
+      if( !(ss >> type >> f.id >> f.qubitID >> f.name >> f.xMin >> f.xMax
+	    >> f.yMin >> f.yMax >> f.zMin >> f.zMax) ) continue;
+      if( type == "qubit" ) fQubits.push_back(f);
+      else if( type == "sensor" ) fSensors.push_back(f);
+    }
+
+    BuildGrid();
+    return !fQubits.empty();
+  }
+
+  // Qubit whose footprint contains (x,y), or -1
+  int Find(double x_mm, double y_mm) const
+  {
+    if( fQubits.empty() ) return -1;
+    if( x_mm < fX0 || y_mm < fY0 || x_mm > fX1 || y_mm > fY1 ) return -1;
+    // Footprints are inclusive, so a point on the outer max edge belongs to
+    // the last cell rather than one past it
+    int iX = std::min((int)((x_mm - fX0)*fInvCell),fNX-1);
+    int iY = std::min((int)((y_mm - fY0)*fInvCell),fNY-1);
+
+    int cell = iY*fNX + iX;
+    for( int i = fCellStart[cell]; i < fCellStart[cell+1]; ++i ){
+      const Footprint& f = fQubits[fCellEntries[i]];
+      if( f.Contains(x_mm,y_mm) ) return f.qubitID;
+    }
+    return -1;
+  }
+
+  int NumberOfQubits() const { return (int)fQubits.size(); }
+  const std::vector<Footprint>& GetQubits() const { return fQubits; }
+  const std::vector<Footprint>& GetSensors() const { return fSensors; }
+
+private:
+  // Cell size is half the smallest footprint dimension, so only footprints
+  // that are actually adjacent ever share a cell.  Cells are stored in
+  // compressed form: cell c owns fCellEntries[fCellStart[c]..fCellStart[c+1])
+  void BuildGrid()
+  {
+    fNX = fNY = 0;
+    fX0 = fY0 = fX1 = fY1 = 0;
+    fInvCell = 0;
+    fCellStart.assign(1,0);
+    fCellEntries.clear();
+    if( fQubits.empty() ) return;
+
+    double xMax = fQubits[0].xMax, yMax = fQubits[0].yMax;
+    double minDim = 1e30;
+    fX0 = fQubits[0].xMin;
+    fY0 = fQubits[0].yMin;
+    for( size_t i = 0; i < fQubits.size(); ++i ){
+      const Footprint& f = fQubits[i];
+      fX0 = std::min(fX0,f.xMin);
+      fY0 = std::min(fY0,f.yMin);
+      xMax = std::max(xMax,f.xMax);
+      yMax = std::max(yMax,f.yMax);
+      minDim = std::min(minDim,std::min(f.xMax-f.xMin,f.yMax-f.yMin));
+    }
+    fX1 = xMax;
+    fY1 = yMax;
+
+    const int maxCellsPerSide = 2048;
+    double cell = std::max(0.5*minDim,std::max(xMax-fX0,yMax-fY0)/maxCellsPerSide);
+    if( cell <= 0 ) cell = 1.0;
+    fInvCell = 1.0/cell;
+    fNX = std::max(1,(int)std::ceil((xMax-fX0)*fInvCell));
+    fNY = std::max(1,(int)std::ceil((yMax-fY0)*fInvCell));
+
+    std::vector<std::vector<int> > cells(fNX*fNY);
+    for( size_t i = 0; i < fQubits.size(); ++i ){
+      const Footprint& f = fQubits[i];
+      int x0 = Clamp((int)((f.xMin-fX0)*fInvCell),fNX), x1 = Clamp((int)((f.xMax-fX0)*fInvCell),fNX);
+      int y0 = Clamp((int)((f.yMin-fY0)*fInvCell),fNY), y1 = Clamp((int)((f.yMax-fY0)*fInvCell),fNY);
+      for( int iY = y0; iY <= y1; ++iY )
+	for( int iX = x0; iX <= x1; ++iX ) cells[iY*fNX+iX].push_back((int)i);
+    }
+
+    fCellStart.resize(cells.size()+1);
+    fCellStart[0] = 0;
+    for( size_t c = 0; c < cells.size(); ++c ){
+      fCellEntries.insert(fCellEntries.end(),cells[c].begin(),cells[c].end());
+      fCellStart[c+1] = (int)fCellEntries.size();
+    }
+  }
+
+  static int Clamp(int i, int n) { return std::max(0,std::min(i,n-1)); }
+
+  std::vector<Footprint> fQubits;
+  std::vector<Footprint> fSensors;
+
+  double fX0, fY0, fX1, fY1, fInvCell;
+  int fNX, fNY;
+  std::vector<int> fCellStart;
+  std::vector<int> fCellEntries;
+};
+
+#endif
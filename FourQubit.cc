@@ -14,8 +14,17 @@
 // 20170816  Add example-specific configuration manager
 // 20220718  Remove obsolete pre-processor macros G4VIS_USE and G4UI_USE
 // 20240521  Renamed for tutorial use
+// 20261014  Use G4RunManagerFactory; thread count from "-t" or environment
+// 20261014  Add "-s scanFile" to run the macro over geometry parameter points
+// 20261014  Add "--check-geometry" for a one-off, multithreaded overlap check
+// 20261014  Add "-p physics" to choose a phonon-only, EM or full physics list
+// 20261014  Start MPI (FourQubitMPI) and merge the ranks' output at the end
+// 20261014  Batch macros run headless unless "--vis"; report startup time
 
 #include "G4RunManager.hh"
+#include "G4RunManagerFactory.hh"
+#include "G4StateManager.hh"
+#include "G4Threading.hh"
 #include "G4UIExecutive.hh"
 #include "G4UImanager.hh"
 #include "G4VisExecutive.hh"
@@ -27,25 +36,102 @@
 #include "FourQubitConfigManager.hh"
 #include "FourQubitDetectorConstruction.hh"
 #include "FourQubitDetectorParameters.hh"
-#include "FTFP_BERT.hh"
+#include "FourQubitEventTimer.hh"
+#include "FourQubitGeometryCheck.hh"
+#include "FourQubitMPI.hh"
+#include "FourQubitParameterScan.hh"
+#include "FourQubitPhysicsList.hh"
+
+#include <fstream>
+#include <stdlib.h>
 
 using namespace FourQubitDetectorParameters;
 
+namespace {
+  void PrintUsage() {
+    G4cerr << " Usage: FourQubit [-t nThreads] [-p physics] [-s scanFile | --check-geometry] [--vis] [macro]\n"
+	   << "   -t nThreads : number of worker threads (0 = all cores);\n"
+	   << "                 default is $FOURQUBIT_NTHREADS, else 1.\n"
+	   << "   -p physics  : phonon (transportation and G4CMP only), em\n"
+	   << "                 (standard EM, decays and G4CMP) or full\n"
+	   << "                 (FTFP_BERT and G4CMP); default is\n"
+	   << "                 $FOURQUBIT_PHYSICS, else full.\n"
+	   << "   -s scanFile : run the macro once per parameter point in\n"
+	   << "                 scanFile (see FourQubitParameterScan.hh)\n"
+	   << "   --check-geometry : build the geometry (after the macro, if any),\n"
+	   << "                 check all volumes for overlaps on nThreads\n"
+	   << "                 threads and record it as validated if clean\n"
+	   << "   --vis       : keep visualization in batch mode\n"
+	   << "   macro       : run in batch mode with this macro file\n"
+	   << "                 (required with more than one MPI rank);\n"
+	   << "                 headless (no visualization) unless --vis\n"
+	   << "                 or the macro has /vis/ commands\n"
+	   << G4endl;
+  }
+
+  // A batch macro that draws (throwMuon.mac) still needs the vis manager;
+  // only the macro itself is read, not the ones it executes
+  G4bool MacroUsesVis(const G4String& macroName) {
+    std::ifstream macro(macroName);
+    std::string line;
+    while (std::getline(macro, line)) {
+      size_t start = line.find_first_not_of(" \t");
+      if (start != std::string::npos && line.compare(start, 5, "/vis/") == 0)
+	return true;
+    }
+    return false;
+  }
+}
+
 int main(int argc,char** argv)
 {
- // Construct the run manager
+ FourQubitEventTimer::MarkJobStart();
+
+ // Every rank of an MPI job runs this whole program (see FourQubitMPI.hh)
+ //
+ FourQubitMPI::Init(&argc, &argv);
+
+ // Parse the command line; anything not an option is the batch macro
+ //
+ G4String macroName, scanName;
+ G4String physicsName = getenv("FOURQUBIT_PHYSICS") ? getenv("FOURQUBIT_PHYSICS") : "full";
+ G4bool checkGeometry = false, keepVis = false;
+ G4int nThreads = getenv("FOURQUBIT_NTHREADS") ? atoi(getenv("FOURQUBIT_NTHREADS")) : 1;
+
+ for (G4int i=1; i<argc; ++i) {
+   G4String arg = argv[i];
+   if (arg == "-t" && i+1<argc) nThreads = atoi(argv[++i]);
+   else if (arg == "-s" && i+1<argc) scanName = argv[++i];
+   else if (arg == "-p" && i+1<argc) physicsName = argv[++i];
+   else if (arg == "--check-geometry") checkGeometry = true;
+   else if (arg == "--vis") keepVis = true;
+   else if (arg == "-h" || arg == "--help") { PrintUsage(); FourQubitMPI::Finalize(); return 0; }
+   else if (macroName.empty()) macroName = arg;
+   else { PrintUsage(); FourQubitMPI::Finalize(); return 1; }
+ }
+
+ G4bool badArgs = ((!scanName.empty() && macroName.empty()) ||
+		   (!scanName.empty() && checkGeometry) ||
+		   !FourQubitPhysicsList::IsKnown(physicsName) ||
+		   (FourQubitMPI::GetSize() > 1 && macroName.empty()));	// No UI
+ if (badArgs) { PrintUsage(); FourQubitMPI::Finalize(); return 1; }
+
+ if (nThreads <= 0) nThreads = G4Threading::G4GetNumberOfCores();
+
+ // Construct the run manager: sequential for one thread, otherwise the
+ // default multithreaded type (tasking, unless G4RUN_MANAGER_TYPE says not)
  //
- G4RunManager * runManager = new G4RunManager;
+ G4RunManager * runManager =
+   G4RunManagerFactory::CreateRunManager(nThreads==1 ? G4RunManagerType::Serial
+					 : G4RunManagerType::Default);
+ if (nThreads > 1) runManager->SetNumberOfThreads(nThreads);
 
  // Set mandatory initialization classes
  //
  FourQubitDetectorConstruction* detector = new FourQubitDetectorConstruction();
  runManager->SetUserInitialization(detector);
 
- FTFP_BERT* physics = new FTFP_BERT;  
- physics->RegisterPhysics(new G4CMPPhysics);
- physics->SetCuts();
- runManager->SetUserInitialization(physics);
+ runManager->SetUserInitialization(FourQubitPhysicsList::Create(physicsName));
  
  // Set user action classes (different for Geant4 10.0)
  //
@@ -54,34 +140,61 @@ int main(int argc,char** argv)
  // Create configuration managers to ensure macro commands exist
  G4CMPConfigManager::Instance();
  FourQubitConfigManager::Instance();
+ FourQubitConfigManager::SetCheckGeometry(checkGeometry);
 
- // Visualization manager
+ // Visualization manager, only for an interactive session, "--vis" or a
+ // macro that draws: a headless batch job skips it, and the vis attributes
+ // of the volumes
  //
- G4VisManager* visManager = new G4VisExecutive;
- visManager->Initialize();
+ G4bool headless = (!macroName.empty() && !keepVis && !MacroUsesVis(macroName));
+ FourQubitConfigManager::SetHeadless(headless);
+
+ G4VisManager* visManager = 0;
+ if (!headless) {
+   visManager = new G4VisExecutive;
+   visManager->Initialize();
+ }
  
  // Get the pointer to the User Interface manager
  //
  G4UImanager* UImanager = G4UImanager::GetUIpointer();  
+ G4int status = 0;
 
- if (argc==1)   // Define UI session for interactive mode
+ if (checkGeometry)	// Macro only configures; no events are run
+ {
+   if (!macroName.empty()) UImanager->ApplyCommand("/control/execute "+macroName);
+   if (G4StateManager::GetStateManager()->GetCurrentState() == G4State_PreInit)
+     UImanager->ApplyCommand("/run/initialize");
+   status = FourQubitGeometryCheck::Run(nThreads);
+ }
+ else if (macroName.empty())   // Define UI session for interactive mode
  {
       G4UIExecutive * ui = new G4UIExecutive(argc,argv);
       UImanager->ApplyCommand("/control/execute init_vis.mac");
       ui->SessionStart();
       delete ui;
  }
+ else if (!scanName.empty())	// Batch mode, once per scan point
+ {
+   FourQubitParameterScan scan(scanName);
+   if (!scan.IsValid()) {
+     delete visManager; delete runManager; FourQubitMPI::Finalize(); return 1;
+   }
+   status = scan.Run(macroName);
+ }
  else           // Batch mode
  {
    G4String command = "/control/execute ";
-   G4String fileName = argv[1];
-   UImanager->ApplyCommand(command+fileName);
+   UImanager->ApplyCommand(command+macroName);
  }
 
  delete visManager;
- delete runManager;
+ delete runManager;		// Closes every output file
+
+ FourQubitMPI::MergeOutputs();
+ FourQubitMPI::Finalize();
 
- return 0;
+ return status ? 1 : 0;
 }
 
 
@@ -0,0 +1,298 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file FourQubit/FourQubitBench.cc
+/// \brief Throughput benchmark for the FourQubit example
+//
+// $Id$
+//
+// Each case is one setup macro (G4Macros/bench*.mac: sources and G4CMP
+// settings, no /run/initialize or /run/beamOn) with one output mode.  A
+// case is timed in a fresh process, since the output mode is fixed once
+// the sensitive detector exists and peak memory only ever grows; given
+// several macros or modes, FourQubitBench runs itself once per case and
+// collects the results into one JSON array.
+//
+// 20261014  First version
+// 20261014  Add -g output tag prefix, for FourQubitAnalysis ValidateFastMode
+// 20261014  Add -s random seed, recorded in the results
+
+#include "G4RunManager.hh"
+#include "G4RunManagerFactory.hh"
+#include "G4Run.hh"
+#include "G4Threading.hh"
+#include "G4Timer.hh"
+#include "G4UImanager.hh"
+
+#include "G4CMPConfigManager.hh"
+#include "FourQubitActionInitialization.hh"
+#include "FourQubitConfigManager.hh"
+#include "FourQubitDetectorConstruction.hh"
+#include "FourQubitPhysicsList.hh"
+#include "FourQubitRunCounters.hh"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <vector>
+
+namespace {
+  void PrintUsage() {
+    G4cerr << " Usage: FourQubitBench [-t nThreads] [-p physics] [-n nEvents]\n"
+	   << "                       [-m mode[,mode...]] [-g prefix] [-s seed]\n"
+	   << "                       [-o results.json] macro...\n"
+	   << "   -t nThreads : worker threads (0 = all cores); default 1\n"
+	   << "   -p physics  : phonon, em or full (see FourQubit -h); default full\n"
+	   << "   -n nEvents  : events per case; default 1000\n"
+	   << "   -m modes    : output modes to compare, any of text, binary, root,\n"
+	   << "                 event (per-sensor sums) and none; default text\n"
+	   << "   -g prefix   : output files are tagged <prefix>_<macro>_<mode>;\n"
+	   << "                 default bench\n"
+	   << "   -s seed     : /random/setSeeds seed, after the setup macro;\n"
+	   << "                 default 0, the macro's or the engine's seeds\n"
+	   << "   -o file     : JSON results; default FourQubitBench.json\n"
+	   << "   macro       : setup macro, one case per macro and mode\n"
+	   << G4endl;
+  }
+
+  struct Options {
+    G4int nThreads = 1;
+    G4String physics = "full";
+    G4int nEvents = 1000;
+    std::vector<G4String> modes;
+    std::vector<G4String> macros;
+    G4String tagPrefix = "bench";
+    G4long seed = 0;		// 0: leave the seeds alone
+    G4String output = "FourQubitBench.json";
+    G4bool singleCase = false;	// Internal: write one bare JSON object
+  };
+
+  std::vector<G4String> SplitList(const G4String& list) {
+    std::vector<G4String> items;
+    std::istringstream in(list);
+    G4String item;
+    while (std::getline(in, item, ',')) if (!item.empty()) items.push_back(item);
+    return items;
+  }
+
+  // "dir/benchMuon.mac" -> "benchMuon", for output tags
+  G4String Stem(const G4String& path) {
+    size_t start = path.find_last_of('/');
+    start = (start == std::string::npos) ? 0 : start+1;
+    size_t end = path.find_last_of('.');
+    if (end == std::string::npos || end < start) end = path.size();
+    return path.substr(start, end-start);
+  }
+
+  // Hit file format and mode for each benchmark mode; false if unknown
+  G4bool SetOutputMode(const G4String& mode) {
+    if (mode == "text" || mode == "binary" || mode == "root") {
+      FourQubitConfigManager::SetHitsFormat(mode);
+      FourQubitConfigManager::SetHitsMode("hits");
+    } else if (mode == "event" || mode == "none") {
+      FourQubitConfigManager::SetHitsFormat("text");
+      FourQubitConfigManager::SetHitsMode(mode);
+    } else return false;
+    return true;
+  }
+
+  // ru_maxrss is in kB on Linux, bytes on macOS
+  G4double PeakRSS_MB() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.;
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.*1024.);
+#else
+    return usage.ru_maxrss / 1024.;
+#endif
+  }
+
+  G4String Quoted(const G4String& arg) {
+    G4String quoted = "'";
+    for (char c : arg) {
+      if (c == '\'') quoted += "'\\''";
+      else quoted += c;
+    }
+    return quoted + "'";
+  }
+
+  G4double PerSecond(G4double count, G4double seconds) {
+    return (seconds > 0.) ? count/seconds : 0.;
+  }
+
+  // Geometry construction, timed on its own; it runs inside /run/initialize
+  class BenchDetectorConstruction : public FourQubitDetectorConstruction {
+  public:
+    BenchDetectorConstruction() : buildTime(0.) {;}
+    virtual G4VPhysicalVolume* Construct() {
+      G4Timer timer;
+      timer.Start();
+      G4VPhysicalVolume* world = FourQubitDetectorConstruction::Construct();
+      timer.Stop();
+      buildTime += timer.GetRealElapsed();
+      return world;
+    }
+
+    G4double buildTime;		// Seconds
+  };
+
+
+  // One macro and mode in this process.  Initialization covers
+  // /run/initialize and a zero-event run, which builds the physics tables;
+  // MT workers still set themselves up at the start of the timed run.
+  G4int RunCase(const Options& opt, const G4String& macro, const G4String& mode,
+		std::ostream& json) {
+    if (!SetOutputMode(mode)) {
+      G4cerr << "FourQubitBench: unknown output mode " << mode << G4endl;
+      return 1;
+    }
+    FourQubitConfigManager::SetOutputTag(opt.tagPrefix + "_" + Stem(macro) + "_" + mode);
+
+    G4int nThreads = (opt.nThreads <= 0) ? G4Threading::G4GetNumberOfCores()
+					   : opt.nThreads;
+    G4RunManager* runManager =
+      G4RunManagerFactory::CreateRunManager(nThreads==1 ? G4RunManagerType::Serial
+					    : G4RunManagerType::Default);
+    if (nThreads > 1) runManager->SetNumberOfThreads(nThreads);
+
+    BenchDetectorConstruction* detector = new BenchDetectorConstruction;
+    runManager->SetUserInitialization(detector);
+    runManager->SetUserInitialization(FourQubitPhysicsList::Create(opt.physics));
+    runManager->SetUserInitialization(new FourQubitActionInitialization);
+    G4CMPConfigManager::Instance();
+
+    G4UImanager* UImanager = G4UImanager::GetUIpointer();
+    UImanager->ApplyCommand("/control/execute " + macro);
+    if (opt.seed != 0)
+      UImanager->ApplyCommand("/random/setSeeds " + std::to_string(opt.seed));
+
+    G4Timer initTimer;
+    initTimer.Start();
+    UImanager->ApplyCommand("/run/initialize");
+    UImanager->ApplyCommand("/run/beamOn 0");
+    initTimer.Stop();
+
+    FourQubitRunCounters::Reset();
+    G4Timer runTimer;
+    runTimer.Start();
+    runManager->BeamOn(opt.nEvents);
+    runTimer.Stop();
+
+    const G4Run* run = runManager->GetCurrentRun();
+    G4int nEvents = run ? run->GetNumberOfEvent() : 0;
+    G4double runTime = runTimer.GetRealElapsed();
+    G4long nSteps = FourQubitRunCounters::GetSteps();
+    G4long nHits = FourQubitRunCounters::GetHits();
+
+    json << std::setprecision(6)
+	 << "  {\n"
+	 << "    \"macro\": \"" << macro << "\",\n"
+	 << "    \"mode\": \"" << mode << "\",\n"
+	 << "    \"physics\": \"" << opt.physics << "\",\n"
+	 << "    \"threads\": " << nThreads << ",\n"
+	 << "    \"seed\": " << opt.seed << ",\n"
+	 << "    \"events\": " << nEvents << ",\n"
+	 << "    \"geometryBuildSeconds\": " << detector->buildTime << ",\n"
+	 << "    \"initializationSeconds\": " << initTimer.GetRealElapsed() << ",\n"
+	 << "    \"runSeconds\": " << runTime << ",\n"
+	 << "    \"eventsPerSecond\": " << PerSecond(nEvents, runTime) << ",\n"
+	 << "    \"steps\": " << nSteps << ",\n"
+	 << "    \"stepsPerSecond\": " << PerSecond(nSteps, runTime) << ",\n"
+	 << "    \"hits\": " << nHits << ",\n"
+	 << "    \"hitsPerSecond\": " << PerSecond(nHits, runTime) << ",\n"
+	 << "    \"peakRSSMB\": " << PeakRSS_MB() << "\n"
+	 << "  }";
+
+    delete runManager;
+    return 0;
+  }
+
+  // Every macro and mode, each in a child FourQubitBench
+  G4int RunAll(const char* self, const Options& opt, std::ostream& json) {
+    G4int status = 0;
+    G4String caseFile = opt.output + ".case";
+
+    json << "[\n";
+    G4bool first = true;
+    for (const G4String& macro : opt.macros) {
+      for (const G4String& mode : opt.modes) {
+	std::ostringstream cmd;
+	cmd << Quoted(self) << " --case -t " << opt.nThreads
+	    << " -p " << Quoted(opt.physics) << " -n " << opt.nEvents
+	    << " -m " << Quoted(mode) << " -g " << Quoted(opt.tagPrefix)
+	    << " -s " << opt.seed
+	    << " -o " << Quoted(caseFile)
+	    << " " << Quoted(macro);
+
+	G4cout << "FourQubitBench: " << macro << ", " << mode << G4endl;
+	G4int result = system(cmd.str().c_str());
+
+	std::ifstream in(caseFile);
+	std::ostringstream report;
+	report << in.rdbuf();
+	in.close();
+	std::remove(caseFile.c_str());
+
+	if (!first) json << ",\n";
+	first = false;
+	if (result == 0 && !report.str().empty()) json << report.str();
+	else {
+	  json << "  { \"macro\": \"" << macro << "\", \"mode\": \"" << mode
+	       << "\", \"error\": \"exit status " << result << "\" }";
+	  status = 1;
+	}
+      }
+    }
+    json << "\n]\n";
+    return status;
+  }
+}
+
+
+int main(int argc,char** argv)
+{
+ Options opt;
+ for (G4int i=1; i<argc; ++i) {
+   G4String arg = argv[i];
+   if (arg == "-t" && i+1<argc) opt.nThreads = atoi(argv[++i]);
+   else if (arg == "-p" && i+1<argc) opt.physics = argv[++i];
+   else if (arg == "-n" && i+1<argc) opt.nEvents = atoi(argv[++i]);
+   else if (arg == "-m" && i+1<argc) opt.modes = SplitList(argv[++i]);
+   else if (arg == "-g" && i+1<argc) opt.tagPrefix = argv[++i];
+   else if (arg == "-s" && i+1<argc) opt.seed = atol(argv[++i]);
+   else if (arg == "-o" && i+1<argc) opt.output = argv[++i];
+   else if (arg == "--case") opt.singleCase = true;
+   else if (arg == "-h" || arg == "--help") { PrintUsage(); return 0; }
+   else opt.macros.push_back(arg);
+ }
+
+ if (opt.modes.empty()) opt.modes.push_back("text");
+ if (opt.macros.empty() || opt.nEvents <= 0 ||
+     !FourQubitPhysicsList::IsKnown(opt.physics)) { PrintUsage(); return 1; }
+
+ std::ofstream json(opt.output, std::ios_base::trunc);
+ if (!json.good()) {
+   G4cerr << "FourQubitBench: cannot write " << opt.output << G4endl;
+   return 1;
+ }
+
+ G4int status = 0;
+ if (opt.singleCase || (opt.macros.size() == 1 && opt.modes.size() == 1)) {
+   if (!opt.singleCase) json << "[\n";
+   status = RunCase(opt, opt.macros[0], opt.modes[0], json);
+   if (!opt.singleCase) json << "\n]\n";
+ } else {
+   status = RunAll(argv[0], opt, json);
+ }
+
+ json.close();
+ if (!opt.singleCase && status == 0)
+   G4cout << "FourQubitBench: results in " << opt.output << G4endl;
+ return status;
+}
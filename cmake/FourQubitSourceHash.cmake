@@ -0,0 +1,26 @@
+#----------------------------------------------------------------------------
+# Writes OUTPUT, a header defining FOURQUBIT_SOURCE_HASH: one SHA1 over the
+# contents of every FourQubit source and header under SOURCE_DIR.  Run at
+# build time (cmake -P), so a changed component builder changes the hash;
+# the header is only rewritten when the hash changes, so an unchanged tree
+# recompiles nothing.  FourQubitGeometrySnapshot puts the hash in its keys.
+#
+file(GLOB _sources ${SOURCE_DIR}/src/*.cc ${SOURCE_DIR}/include/*.hh)
+list(SORT _sources)
+
+set(_hashes "")
+foreach(_file ${_sources})
+  file(SHA1 ${_file} _hash)
+  get_filename_component(_name ${_file} NAME)
+  set(_hashes "${_hashes}${_name} ${_hash}\n")
+endforeach()
+string(SHA1 _hash "${_hashes}")
+
+set(_text "// Generated by cmake/FourQubitSourceHash.cmake; do not edit\n#define FOURQUBIT_SOURCE_HASH \"${_hash}\"\n")
+set(_old "")
+if(EXISTS ${OUTPUT})
+  file(READ ${OUTPUT} _old)
+endif()
+if(NOT "${_old}" STREQUAL "${_text}")
+  file(WRITE ${OUTPUT} "${_text}")
+endif()
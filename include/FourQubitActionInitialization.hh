@@ -14,7 +14,8 @@ class FourQubitActionInitialization : public G4VUserActionInitialization {
 public:
   FourQubitActionInitialization() {;}
   virtual ~FourQubitActionInitialization() {;}
-  virtual void Build() const;
+  virtual void BuildForMaster() const;	// Run-level actions only
+  virtual void Build() const;		// Per-worker (or sequential) actions
 };
 
 #endif	/* FourQubitActionInitialization_hh */
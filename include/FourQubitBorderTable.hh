@@ -0,0 +1,92 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitBorderTable_hh
+#define FourQubitBorderTable_hh 1
+
+// $Id$
+// File:  FourQubitBorderTable.hh
+//
+// Description:	Singleton index of the G4CMPLogicalBorderSurfaces made by
+//		FourQubitDetectorConstruction.  Component sub-volumes are
+//		queued as they are placed (once each, however many times a
+//		shared logical tree is placed) and every surface is created
+//		in one pass at the end of the build.  Every surface is also
+//		kept in a hash table keyed on its (volume, volume) pair, for
+//		lookups during the run such as the /g4cmp/StepProfile
+//		border names.
+
+#include "FourQubitSubVolume.hh"
+#include "globals.hh"
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class G4CMPLogicalBorderSurface;
+class G4CMPSurfaceProperty;
+class G4VPhysicalVolume;
+
+
+class FourQubitBorderTable {
+public:
+  static FourQubitBorderTable* Instance();
+
+  // Drop everything from the previous geometry build (the surfaces
+  // themselves belong to G4CMP's table)
+  void Clear();
+
+  // Queue a surface from "from" to each sub-volume, named prefix+name and
+  // with the interface for its material tag; repeats are skipped
+  void Queue(const G4String& prefix, G4VPhysicalVolume* from,
+	     const FourQubitSubVolumeList& subVolumes,
+	     G4CMPSurfaceProperty* niobium, G4CMPSurfaceProperty* vacuum);
+
+  // Create every queued surface; returns the number made
+  size_t CreateQueued();
+
+  // Create one surface immediately
+  G4CMPLogicalBorderSurface* Create(const G4String& name,
+				    G4VPhysicalVolume* from, G4VPhysicalVolume* to,
+				    G4CMPSurfaceProperty* property);
+
+  // One hash lookup; read-only during the run, so safe from worker threads
+  G4CMPLogicalBorderSurface* Find(const G4VPhysicalVolume* from,
+				  const G4VPhysicalVolume* to) const {
+    auto entry = surfaces.find(Border(from, to));
+    return (entry == surfaces.end()) ? 0 : entry->second;
+  }
+
+  size_t size() const { return surfaces.size(); }
+
+  // Every surface made since Clear(), in order, for geometry snapshots
+  struct Entry {
+    G4String name;
+    G4VPhysicalVolume* from;
+    G4VPhysicalVolume* to;
+    G4CMPSurfaceProperty* property;
+  };
+  const std::vector<Entry>& GetCreated() const { return created; }
+
+private:
+  FourQubitBorderTable() {;}
+  FourQubitBorderTable(const FourQubitBorderTable&) = delete;
+  FourQubitBorderTable& operator=(const FourQubitBorderTable&) = delete;
+
+  typedef std::pair<const G4VPhysicalVolume*,const G4VPhysicalVolume*> Border;
+  struct BorderHash {
+    size_t operator()(const Border& b) const {
+      return std::hash<const void*>()(b.first) * 31u
+	+ std::hash<const void*>()(b.second);
+    }
+  };
+
+  std::vector<Entry> pending;
+  std::vector<Entry> created;
+  std::unordered_map<Border,G4CMPLogicalBorderSurface*,BorderHash> surfaces;
+  std::unordered_map<Border,size_t,BorderHash> queued;	// Index into pending
+};
+
+#endif	/* FourQubitBorderTable_hh */
@@ -0,0 +1,87 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitCheckpoint_hh
+#define FourQubitCheckpoint_hh 1
+
+// $Id$
+// File:  FourQubitCheckpoint.hh
+//
+// Description:	Checkpoints of a long run (/g4cmp/CheckpointInterval), and
+//		its continuation in a new job (/g4cmp/ResumeRun).  Every N
+//		events each thread's FourQubitSensitivity flushes its output
+//		and this writes a small text file next to it
+//		(/g4cmp/CheckpointFile, one "_t<N>" file per MT worker):
+//		the run ID, the thread's finished event count and highest
+//		event ID, the byte length of its hit and primary files, and
+//		its random engine state.  The file is replaced atomically,
+//		so a job killed at any point leaves the last complete one.
+//
+//		/g4cmp/ResumeRun <total> reads every thread's checkpoint,
+//		and runs the events not yet done under the same run ID.
+//		Each thread cuts its files back to the checkpointed length
+//		and appends to them.  Resumed events are numbered after the
+//		highest checkpointed event ID.  A sequential job restores
+//		its engine and so continues its random sequence.  MT
+//		engines are reseeded by the master every event, so the
+//		master is reseeded from the saved states instead, which
+//		keeps it from replaying the first job's events.
+
+#include "globals.hh"
+#include <string>
+#include <vector>
+
+
+class FourQubitCheckpoint {
+public:
+  // One thread's checkpoint, as written
+  struct State {
+    G4int runID = -1;
+    G4long nEvents = 0;			// Finished and flushed
+    G4int lastEventID = -1;		// Highest of those, as written
+    G4long hitBytes = 0, primaryBytes = 0;	// File lengths at that point
+    G4String hitFile, primaryFile;	// "" if not written
+    std::string engine;			// CLHEP HepRandomEngine::put()
+  };
+
+  FourQubitCheckpoint();
+  ~FourQubitCheckpoint() {;}
+
+  // Per-thread writer, driven by FourQubitSensitivity.  The interval and
+  // file come from FourQubitConfigManager; a resumed thread carries on
+  // from its own checkpoint.
+  void BeginOfRun(G4int runID, G4int threadID);
+  G4bool IsActive() const { return interval > 0; }
+
+  // Count one finished event; true when a checkpoint is due
+  G4bool EndOfEvent(G4int eventID);
+
+  // Write the checkpoint for the events so far; the outputs must be
+  // flushed, with these lengths
+  void Write(const G4String& hitFile, G4long hitBytes,
+	     const G4String& primaryFile, G4long primaryBytes);
+
+  // Checkpoint file of a thread (-1 for a sequential job)
+  static G4String FileName(G4int threadID);
+
+  // /g4cmp/ResumeRun (master or sequential): load the checkpoints and run
+  // the rest of "nEventsTotal"
+  static void Resume(G4int nEventsTotal);
+
+  // During a resumed run only: this thread's checkpoint (null if none),
+  // and the amount added to event IDs
+  static const State* ResumeState(G4int threadID);
+  static G4int GetEventOffset();
+
+  static G4bool Read(const G4String& filename, State& state);
+
+private:
+  G4int interval;		// Events between checkpoints; 0 = off
+  G4String fileName;
+  State state;
+  G4long sinceLast;		// Events since the last checkpoint
+};
+
+#endif	/* FourQubitCheckpoint_hh */
@@ -0,0 +1,189 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitCompressedInput_hh
+#define FourQubitCompressedInput_hh 1
+
+// $Id$
+// File:  FourQubitCompressedInput.hh
+//
+// Description:	Input file stream that reads the hit and primary output
+//		whether or not it was compressed (/g4cmp/OutputCompression
+//		zstd, see FourQubitOutputWriter).  A compressed file is a
+//		series of zstd frames, and is decompressed as it is read;
+//		any other file is read as it is.  Shared by the shard
+//		merger and the readers in AnalysisTools, so it has no
+//		Geant4 dependencies.  Compressed files need FOURQUBIT_ZSTD
+//		defined and libzstd linked in; without them they fail to
+//		open, with a message on std::cerr.
+//
+//		  FourQubitInputFile in("FourQubit_hits.txt.zst");
+//		  std::string line;
+//		  while (std::getline(in, line)) { ... }
+//
+//		Seek() goes to an event from the file's event index
+//		(FourQubitHitFormat::IndexRecord): in a compressed file,
+//		to the start of a frame, then forward within it.
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#ifdef FOURQUBIT_ZSTD
+#include <zstd.h>
+#endif
+
+namespace FourQubitCompression {
+  // First four bytes of every zstd frame
+  const char kZstdMagic[4] = { '\x28', '\xB5', '\x2F', '\xFD' };
+
+  inline bool Available() {
+#ifdef FOURQUBIT_ZSTD
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  // True if "filename" starts with a zstd frame
+  inline bool IsCompressed(const std::string& filename) {
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    char magic[4];
+    return in.read(magic, 4) && std::memcmp(magic, kZstdMagic, 4) == 0;
+  }
+
+#ifdef FOURQUBIT_ZSTD
+  // Decompresses everything read from "source", frame after frame
+  class DecompressBuffer : public std::streambuf {
+  public:
+    explicit DecompressBuffer(std::streambuf* source)
+      : fSource(source), fStream(ZSTD_createDStream()),
+	fIn(ZSTD_DStreamInSize()), fOut(ZSTD_DStreamOutSize()) {
+      ZSTD_initDStream(fStream);
+      fInput.src = fIn.data();
+      fInput.size = fInput.pos = 0;
+    }
+    ~DecompressBuffer() { ZSTD_freeDStream(fStream); }
+
+    DecompressBuffer(const DecompressBuffer&) = delete;
+    DecompressBuffer& operator=(const DecompressBuffer&) = delete;
+
+  protected:
+    int_type underflow() {
+      if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+      for (;;) {
+	if (fInput.pos == fInput.size) {
+	  std::streamsize n = fSource->sgetn(fIn.data(), fIn.size());
+	  if (n <= 0) return traits_type::eof();	// A cut frame ends here too
+	  fInput.size = size_t(n);
+	  fInput.pos = 0;
+	}
+
+	ZSTD_outBuffer output = { fOut.data(), fOut.size(), 0 };
+	size_t result = ZSTD_decompressStream(fStream, &output, &fInput);
+	if (ZSTD_isError(result)) {
+	  std::cerr << "FourQubitInputFile: " << ZSTD_getErrorName(result) << std::endl;
+	  return traits_type::eof();
+	}
+	if (output.pos > 0) {
+	  setg(fOut.data(), fOut.data(), fOut.data()+output.pos);
+	  return traits_type::to_int_type(*gptr());
+	}
+      }
+    }
+
+  private:
+    std::streambuf* fSource;
+    ZSTD_DStream* fStream;
+    std::vector<char> fIn, fOut;
+    ZSTD_inBuffer fInput;
+  };
+#endif
+}
+
+
+// Drop-in for the std::ifstream of a reader: open(), is_open(), close()
+class FourQubitInputFile : public std::istream {
+public:
+  FourQubitInputFile() : std::istream(0) {}
+  explicit FourQubitInputFile(const std::string& filename) : std::istream(0) {
+    open(filename);
+  }
+
+  // Always binary, so compressed and plain files are read byte for byte
+  void open(const std::string& filename,
+	    std::ios_base::openmode mode = std::ios_base::in) {
+    close();
+    if (!fFile.open(filename.c_str(), mode | std::ios_base::in | std::ios_base::binary)) {
+      setstate(std::ios_base::failbit);
+      return;
+    }
+
+    char magic[4];
+    fCompressed = (fFile.sgetn(magic, 4) == 4 &&
+		   std::memcmp(magic, FourQubitCompression::kZstdMagic, 4) == 0);
+    fFile.pubseekpos(0, std::ios_base::in);
+
+    if (!fCompressed) {
+      rdbuf(&fFile);				// Also clears the state
+      return;
+    }
+#ifdef FOURQUBIT_ZSTD
+    fDecompress.reset(new FourQubitCompression::DecompressBuffer(&fFile));
+    rdbuf(fDecompress.get());
+#else
+    std::cerr << "FourQubitInputFile: " << filename << " is zstd-compressed;"
+	      << " rebuild with FOURQUBIT_ZSTD defined and libzstd." << std::endl;
+    close();
+    setstate(std::ios_base::failbit);
+#endif
+  }
+
+  // Go to byte "offset" of the file, then skip "skip" bytes of what is
+  // read from there (decompressed bytes, if compressed)
+  bool Seek(std::streamoff offset, std::streamoff skip=0) {
+    if (!is_open()) return false;
+    if (fFile.pubseekpos(offset, std::ios_base::in) != std::streampos(offset)) {
+      setstate(std::ios_base::failbit);
+      return false;
+    }
+#ifdef FOURQUBIT_ZSTD
+    if (fCompressed) {			// Decompression starts afresh
+      fDecompress.reset(new FourQubitCompression::DecompressBuffer(&fFile));
+      rdbuf(fDecompress.get());
+    }
+#endif
+    clear();
+    if (skip > 0) ignore(skip);
+    return good();
+  }
+
+  bool is_open() const { return fFile.is_open(); }
+  bool IsCompressed() const { return fCompressed; }
+
+  void close() {
+    rdbuf(0);					// Sets badbit until reopened
+#ifdef FOURQUBIT_ZSTD
+    fDecompress.reset();
+#endif
+    if (fFile.is_open()) fFile.close();
+    fCompressed = false;
+  }
+
+private:
+  std::filebuf fFile;
+#ifdef FOURQUBIT_ZSTD
+  std::unique_ptr<FourQubitCompression::DecompressBuffer> fDecompress;
+#endif
+  bool fCompressed = false;
+};
+
+#endif	/* FourQubitCompressedInput_hh */
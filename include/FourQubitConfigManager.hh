@@ -15,30 +15,303 @@
 //		changed via macro commands (see FourQubitConfigMessenger).
 //
 // 20170816  M. Kelsey -- Extract hit filename from G4CMPConfigManager.
+// 20261014  Add output buffer size for per-thread hit writers
+// 20261014  Add hit file format selection (text, binary or ROOT)
+// 20261014  Add geometry description (sensor footprint) filename
+// 20261014  Add target-volume name patterns for hit selection
+// 20261014  Add step profiling switch
+// 20261014  Add sampled step trace settings
+// 20261014  Output filenames no longer rebuild the geometry; defer rebuilds
+// 20261014  Add runtime geometry parameters (FourQubitDetectorParameters)
+// 20261014  Add output tag for parameter-scan points
+// 20261014  Add layout file of extra ground-plane traces
+// 20261014  Add overlap-check switch, check-geometry mode and validation file
+// 20261014  Add hit output mode (every hit, or per-event sensor sums)
+// 20261014  Add in-run PCE map file, binning and quantities; hit mode none
+// 20261014  Add stratified / quasi-random primary position sampling
+// 20261014  Add qubit-biased primary sampling fraction and margin
+// 20261014  Add pre-sampled primary vertex bank file
+// 20261014  Add phonon culling cuts and bounce roulette
+// 20261014  Add per-event timing switch, slowest-event count and heartbeat
+// 20261014  Add event watchdog step and track budgets
+// 20261014  Add checkpoint interval and file
+// 20261014  Tag output names with the MPI rank (FourQubitMPI)
+// 20261014  Add asynchronous output writer and zstd compression
+// 20261014  Add headless batch mode (no visualization)
+// 20261014  Add event index sidecar switch
+// 20261014  Add geometry snapshot directory
+// 20261014  Add per-region production cuts and user limits
 
 #include "globals.hh"
+#include <vector>
 
 class FourQubitConfigMessenger;
 
 
 class FourQubitConfigManager {
 public:
+  // XY binning of the in-run maps (/g4cmp/PCEMapBinning), world frame
+  struct MapBinning {
+    G4int nX, nY;
+    G4double xMin, xMax, yMin, yMax;
+  };
+
+  // Production cut and user limits of one of the FourQubitRegions; a
+  // limit of zero is no limit
+  struct RegionSettings {
+    G4double cut;		// For gammas, electrons, positrons and protons
+    G4double maxStep;
+    G4double minEnergy;		// Tracks below are killed, phonons included
+  };
+
   ~FourQubitConfigManager();	// Must be public for end-of-job cleanup
   static FourQubitConfigManager* Instance();   // Only needed by static accessors
 
   // Access current values
-  static const G4String& GetHitOutput()  { return Instance()->Hit_file; }
-  static const G4String& GetPrimaryOutput()  { return Instance()->Primary_file; }
+  // Output filenames carry the /g4cmp/OutputTag, if any; compressed hit
+  // and primary files also get ".zst"
+  static G4String GetHitOutput()  { return Compressed(Tagged(Instance()->Hit_file)); }
+  static G4String GetPrimaryOutput()  { return Compressed(Tagged(Instance()->Primary_file)); }
+  static size_t GetOutputBufferSize() { return Instance()->Buffer_size; }
+  static G4bool GetAsyncOutput() { return Instance()->Async_output; }
+  static const G4String& GetOutputCompression() { return Instance()->Output_compression; }
+  static G4int GetCompressionLevel() { return Instance()->Compression_level; }
+  static size_t GetOutputQueueSize() { return Instance()->Queue_size; }
+  static G4bool GetEventIndex() { return Instance()->Event_index; }
+  static G4bool GetCompressedOutput();	// zstd asked for, built in, not ROOT
+  static const G4String& GetHitsFormat() { return Instance()->Hits_format; }
+  static const G4String& GetHitsMode() { return Instance()->Hits_mode; }
+  static G4String GetGeometryFile() { return Tagged(Instance()->Geometry_file); }
+  static const std::vector<G4String>& GetTargetVolumes()
+    { return Instance()->Target_volumes; }
+  static G4bool GetStepProfile() { return Instance()->Step_profile; }
+  static const G4String& GetOutputTag() { return Instance()->Output_tag; }
+  static const G4String& GetLayoutFile() { return Instance()->Layout_file; }
+  static G4bool GetCheckOverlaps() { return Instance()->Check_overlaps; }
+  static G4bool GetCheckGeometry() { return Instance()->Check_geometry; }
+  static G4bool GetHeadless() { return Instance()->Headless; }
+  static const G4String& GetValidationFile() { return Instance()->Validation_file; }
+  static const G4String& GetGeometrySnapshot() { return Instance()->Snapshot_dir; }
+  static const RegionSettings& GetRegionSettings(G4int region)
+    { return Instance()->Region_settings[region]; }
+  static G4String GetPCEMapFile() { return Tagged(Instance()->PCE_file); }
+  static const MapBinning& GetPCEMapBinning() { return Instance()->PCE_binning; }
+  static const std::vector<G4String>& GetPCEMapQuantities()
+    { return Instance()->PCE_quantities; }
+  static const G4String& GetPrimarySampling() { return Instance()->Primary_sampling; }
+  static G4int GetPrimaryStrata(G4int axis) { return Instance()->Primary_strata[axis]; }
+  static G4double GetPrimaryBiasFraction() { return Instance()->Bias_fraction; }
+  static G4double GetPrimaryBiasMargin() { return Instance()->Bias_margin; }
+  static const G4String& GetVertexBank() { return Instance()->Vertex_bank; }
+  static G4double GetPhononCullEnergy() { return Instance()->Cull_energy; }
+  static G4double GetPhononCullTime() { return Instance()->Cull_time; }
+  static G4int GetPhononRouletteBounces() { return Instance()->Roulette_bounces; }
+  static G4double GetPhononRouletteSurvival() { return Instance()->Roulette_survival; }
+  static G4bool GetEventTiming() { return Instance()->Event_timing; }
+  static G4int GetEventTimingSlowest() { return Instance()->Event_slowest; }
+  static G4double GetHeartbeatInterval() { return Instance()->Heartbeat_interval; }
+  static G4int GetEventStepBudget() { return Instance()->Step_budget; }
+  static G4int GetEventTrackBudget() { return Instance()->Track_budget; }
+  static G4int GetCheckpointInterval() { return Instance()->Checkpoint_interval; }
+  static G4String GetCheckpointFile() { return Tagged(Instance()->Checkpoint_file); }
+
+  // Names as written by one MPI rank, or (rank -1) as merged
+  static G4String GetHitOutputOfRank(G4int rank)
+    { return Compressed(Tagged(Instance()->Hit_file, rank)); }
+  static G4String GetPrimaryOutputOfRank(G4int rank)
+    { return Compressed(Tagged(Instance()->Primary_file, rank)); }
+  static G4String GetPCEMapFileOfRank(G4int rank)
+    { return Tagged(Instance()->PCE_file, rank); }
+  static G4String GetStepTraceFile() { return Tagged(Instance()->Trace_file); }
+  static G4double GetStepTraceEventFraction() { return Instance()->Trace_event_fraction; }
+  static G4double GetStepTraceTrackFraction() { return Instance()->Trace_track_fraction; }
+  static const std::vector<G4String>& GetStepTraceFilter()
+    { return Instance()->Trace_filter; }
 
-  // Change values (e.g., via Messenger)
+  // Change values (e.g., via Messenger).  Output files are reopened by
+  // FourQubitSensitivity at the start of the next run; the geometry is
+  // not touched.
   static void SetHitOutput(const G4String& name)
-    { Instance()->Hit_file=name; UpdateGeometry(); }
+    { Instance()->Hit_file=name; }
 
-  // Change values (e.g., via Messenger)
   static void SetPrimaryOutput(const G4String& name)
-    { Instance()->Hit_file=name; UpdateGeometry(); }
+    { Instance()->Primary_file=name; }
+
+  static void SetOutputBufferSize(size_t bytes)
+    { Instance()->Buffer_size=bytes; }
+
+  // Output stage (FourQubitOutputWriter), used when the files are opened:
+  // a writer thread shared by every thread's hit and primary files, with
+  // at most "bytes" queued; and "none" or "zstd" compression of them
+  static void SetAsyncOutput(G4bool async)
+    { Instance()->Async_output=async; }
+
+  static void SetOutputQueueSize(size_t bytes)
+    { Instance()->Queue_size=bytes; }
+
+  static void SetOutputCompression(const G4String& method)
+    { Instance()->Output_compression=method; }
+
+  static void SetCompressionLevel(G4int level)
+    { Instance()->Compression_level=level; }
+
+  // Write a ".idx" of (run, event) offsets beside each hit and primary file
+  static void SetEventIndex(G4bool index)
+    { Instance()->Event_index=index; }
+
+  static void SetHitsFormat(const G4String& format)
+    { Instance()->Hits_format=format; }
+
+  // "hits" writes every hit; "event" one sum per sensor hit in each event;
+  // "none" no hit or primary files at all (e.g. with /g4cmp/PCEMapFile)
+  static void SetHitsMode(const G4String& mode)
+    { Instance()->Hits_mode=mode; }
+
+  static void SetGeometryFile(const G4String& name)
+    { Instance()->Geometry_file=name; }
+
+  // Whitespace- or comma-separated name patterns; "" or "none" clears
+  static void SetTargetVolumes(const G4String& patterns);
+
+  static void SetStepProfile(G4bool enable)
+    { Instance()->Step_profile=enable; }
+
+  // Step traces are configured at the start of each run
+  static void SetStepTraceFile(const G4String& name)
+    { Instance()->Trace_file=name; }
+
+  static void SetStepTraceEventFraction(G4double fraction)
+    { Instance()->Trace_event_fraction=fraction; }
+
+  static void SetStepTraceTrackFraction(G4double fraction)
+    { Instance()->Trace_track_fraction=fraction; }
+
+  static void SetStepTraceFilter(const G4String& patterns);
+
+  // In-run maps (FourQubitPCEMap), configured at the start of each run.
+  // Binning is "nX xMin xMax nY yMin yMax [unit]"; quantities a list as
+  // for SetTargetVolumes.
+  static void SetPCEMapFile(const G4String& name)
+    { Instance()->PCE_file=(name=="none" ? G4String() : name); }
+
+  static void SetPCEMapBinning(const G4String& spec);
+  static void SetPCEMapQuantities(const G4String& names);
+
+  // Primary positions (FourQubitPrimaryGeneratorAction): "gps" leaves them
+  // to /gps/pos; "stratified" or "halton" fill the /gps/pos box, on a grid
+  // of "nX nY nZ" strata; "biased" sends the given fraction of primaries
+  // into the qubit footprints (widened by the margin) and weights them
+  static void SetPrimarySampling(const G4String& mode)
+    { Instance()->Primary_sampling=mode; }
+
+  static void SetPrimaryStrata(const G4String& counts);
+
+  static void SetPrimaryBiasFraction(G4double fraction)
+    { Instance()->Bias_fraction=fraction; }
+
+  static void SetPrimaryBiasMargin(G4double margin)
+    { Instance()->Bias_margin=margin; }
 
-  
+  // Pre-sampled vertices (FourQubitVertexBank) replace GPS entirely;
+  // "" or "none" goes back to GPS
+  static void SetVertexBank(const G4String& name)
+    { Instance()->Vertex_bank=(name=="none" ? G4String() : name); }
+
+  // Phonon culling (FourQubitStackingAction, FourQubitSteppingAction):
+  // phonons below the energy or past the time are killed; every "bounces"
+  // reflections a phonon survives with the given probability, its weight
+  // raised to match.  Zero turns each one off.
+  static void SetPhononCullEnergy(G4double energy)
+    { Instance()->Cull_energy=energy; }
+
+  static void SetPhononCullTime(G4double time)
+    { Instance()->Cull_time=time; }
+
+  static void SetPhononRouletteBounces(G4int bounces)
+    { Instance()->Roulette_bounces=bounces; }
+
+  static void SetPhononRouletteSurvival(G4double survival)
+    { Instance()->Roulette_survival=survival; }
+
+  // Event timing (FourQubitEventTimer), configured at the start of each
+  // run: per-event statistics and the slowest events at end of run, and a
+  // progress line each thread prints at most once per interval (0 = off)
+  static void SetEventTiming(G4bool enable)
+    { Instance()->Event_timing=enable; }
+
+  static void SetEventTimingSlowest(G4int n)
+    { Instance()->Event_slowest=n; }
+
+  static void SetHeartbeatInterval(G4double interval)
+    { Instance()->Heartbeat_interval=interval; }
+
+  // Event watchdog (FourQubitSteppingAction): an event is stopped and
+  // flagged once it reaches either budget; 0 = no limit
+  static void SetEventStepBudget(G4int steps)
+    { Instance()->Step_budget=steps; }
+
+  static void SetEventTrackBudget(G4int tracks)
+    { Instance()->Track_budget=tracks; }
+
+  // Checkpoints (FourQubitCheckpoint), every so many events on each
+  // thread (0 = off); the file gets a "_t<N>" per MT worker
+  static void SetCheckpointInterval(G4int events)
+    { Instance()->Checkpoint_interval=events; }
+
+  static void SetCheckpointFile(const G4String& name)
+    { Instance()->Checkpoint_file=name; }
+
+  // Appended to every output filename, e.g. for points of a scan
+  static void SetOutputTag(const G4String& tag)
+    { Instance()->Output_tag=(tag=="none" ? G4String() : tag); }
+
+  // Traces described in a layout file (see FourQubitLayout); "" or "none"
+  // for no layout.  Changes the volumes, so schedules a rebuild
+  static void SetLayoutFile(const G4String& name);
+
+  // Overlap checks while placing volumes; used at the next geometry build
+  static void SetCheckOverlaps(G4bool check)
+    { Instance()->Check_overlaps=check; }
+
+  // Set by "FourQubit --check-geometry": build without placement checks,
+  // then check everything once (see FourQubitGeometryCheck)
+  static void SetCheckGeometry(G4bool check)
+    { Instance()->Check_geometry=check; }
+
+  // Set by FourQubit for a batch macro without "--vis": no vis manager,
+  // and the geometry is built without vis attributes
+  static void SetHeadless(G4bool headless)
+    { Instance()->Headless=headless; }
+
+  // Hashes of geometries that passed --check-geometry; "" or "none" for
+  // no record and no warning
+  static void SetValidationFile(const G4String& name)
+    { Instance()->Validation_file=(name=="none" ? G4String() : name); }
+
+  // Directory of geometry snapshots (see FourQubitGeometrySnapshot); ""
+  // or "none" to always build the geometry.  Used at the next build
+  static void SetGeometrySnapshot(const G4String& dir)
+    { Instance()->Snapshot_dir=(dir=="none" ? G4String() : dir); }
+
+  // Region settings, each "region value [unit]" with the region as named
+  // by FourQubitRegions (World, Housing, Chip, Films); applied at once,
+  // and to every later build
+  static void SetRegionCut(const G4String& spec);
+  static void SetRegionMaxStep(const G4String& spec);
+  static void SetRegionMinEnergy(const G4String& spec);
+
+  // "name.ext" -> "name_tag.ext"; "name.ext.zst" -> "name_tag.ext.zst"
+  static G4String TaggedFileName(const G4String& name, const G4String& tag);
+
+  // Geometry parameters ("name value [unit]", or a file of such lines);
+  // a successful change schedules a geometry rebuild
+  static void SetGeometryParameter(const G4String& nameValue);
+  static void LoadGeometryParameters(const G4String& filename);
+
+  // Only for settings that change the volumes themselves: flags the
+  // geometry for rebuilding at the next /run/beamOn, so that several
+  // changes in a row cost a single rebuild (nothing to do before
+  // /run/initialize)
   static void UpdateGeometry();
 
 private:
@@ -50,9 +323,59 @@ private:
 
   static FourQubitConfigManager* theInstance;
 
+  // Output tag, then "r<rank>" if given (>= 0); the one-argument form
+  // uses this process's rank when there is more than one
+  static G4String Tagged(const G4String& name);
+  static G4String Tagged(const G4String& name, G4int rank);
+
+  // Adds ".zst" if GetCompressedOutput()
+  static G4String Compressed(const G4String& name);
+
 private:
   G4String Hit_file;	// Output file of e/h hits ($G4CMP_HIT_FILE)
   G4String Primary_file;	// Output file of primaries
+  size_t Buffer_size;		// Per-thread output buffer ($G4CMP_OUTPUT_BUFFER_MB)
+  G4bool Async_output;		// Writer thread for hits, primaries ($G4CMP_ASYNC_OUTPUT)
+  size_t Queue_size;		// Queued bytes before writers wait ($G4CMP_OUTPUT_QUEUE_MB)
+  G4String Output_compression;	// "none" or "zstd" ($G4CMP_OUTPUT_COMPRESSION)
+  G4int Compression_level;	// zstd level, 1 (fast) to 19
+  G4bool Event_index;		// Offset index sidecars ($G4CMP_EVENT_INDEX)
+  G4String Geometry_file;	// Qubit/sensor footprints ($G4CMP_GEOMETRY_FILE)
+  std::vector<G4String> Target_volumes;	// Hit volume name patterns
+  G4String Hits_format;		// "text", "binary" or "root" ($G4CMP_HITS_FORMAT)
+  G4String Hits_mode;		// "hits", "event" or "none" ($G4CMP_HITS_MODE)
+  G4bool Step_profile;		// Per-thread step counters ($G4CMP_STEP_PROFILE)
+  G4String Trace_file;		// Binary step trace, "" for none ($G4CMP_STEP_TRACE)
+  G4double Trace_event_fraction;	// Fraction of events traced
+  G4double Trace_track_fraction;	// Fraction of tracks in those events
+  std::vector<G4String> Trace_filter;	// Particle or volume name patterns
+  G4String PCE_file;		// In-run maps, "" for none ($G4CMP_PCE_MAP)
+  MapBinning PCE_binning;
+  std::vector<G4String> PCE_quantities;	// FourQubitPCEMap quantity names
+  G4String Primary_sampling;	// "gps", "stratified", "halton" or "biased" ($G4CMP_PRIMARY_SAMPLING)
+  G4int Primary_strata[3];	// Strata along x, y, z
+  G4double Bias_fraction;	// Share of biased primaries sent to qubits
+  G4double Bias_margin;		// Added around each qubit footprint
+  G4String Vertex_bank;		// Binary vertex file, "" for GPS ($G4CMP_VERTEX_BANK)
+  G4double Cull_energy;		// Phonons below are not tracked
+  G4double Cull_time;		// Phonons are killed after this global time
+  G4int Roulette_bounces;	// Reflections between roulette rounds
+  G4double Roulette_survival;	// Survival probability in each round
+  G4bool Event_timing;		// Per-event statistics ($G4CMP_EVENT_TIMING)
+  G4int Event_slowest;		// Slowest events listed at end of run
+  G4double Heartbeat_interval;	// Between progress lines, 0 for none
+  G4int Step_budget;		// Steps before an event is stopped ($G4CMP_EVENT_STEP_BUDGET)
+  G4int Track_budget;		// Tracks before an event is stopped ($G4CMP_EVENT_TRACK_BUDGET)
+  G4int Checkpoint_interval;	// Events per checkpoint ($G4CMP_CHECKPOINT_INTERVAL)
+  G4String Checkpoint_file;	// Checkpoint name ($G4CMP_CHECKPOINT_FILE)
+  G4String Output_tag;		// Added to output filenames ("" for none)
+  G4String Layout_file;		// Ground-plane trace layout ($G4CMP_LAYOUT_FILE)
+  G4bool Check_overlaps;	// Check each placement ($G4CMP_CHECK_OVERLAPS)
+  G4bool Check_geometry;	// In --check-geometry mode
+  G4bool Headless;		// Batch job without visualization
+  G4String Validation_file;	// Checked geometry hashes ($G4CMP_GEOMETRY_VALIDATION)
+  G4String Snapshot_dir;	// Geometry snapshots ($G4CMP_GEOMETRY_SNAPSHOT)
+  std::vector<RegionSettings> Region_settings;	// By FourQubitRegions index
 
   FourQubitConfigMessenger* messenger;
 };
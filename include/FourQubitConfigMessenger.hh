@@ -13,11 +13,38 @@
 //		FourQubitConfigManager.
 //
 // 20170816  Michael Kelsey
+// 20261014  Add /g4cmp/OutputBufferSize and /g4cmp/HitsFormat
+// 20261014  Add /g4cmp/GeometryFile, /g4cmp/TargetVolumes
+// 20261014  Add /g4cmp/StepProfile
+// 20261014  Add /g4cmp/StepTraceFile and its sampling, filter commands
+// 20261014  Add /g4cmp/GeometryParameter, GeometryParameterFile, ListGeometryParameters
+// 20261014  Add /g4cmp/OutputTag
+// 20261014  Add /g4cmp/LayoutFile
+// 20261014  Add /g4cmp/CheckOverlaps and /g4cmp/GeometryValidationFile
+// 20261014  Add /g4cmp/HitsMode
+// 20261014  Add /g4cmp/PCEMapFile, PCEMapBinning, PCEMapQuantities
+// 20261014  Add /g4cmp/PrimarySampling and /g4cmp/PrimaryStrata
+// 20261014  Add /g4cmp/PrimaryBiasFraction and /g4cmp/PrimaryBiasMargin
+// 20261014  Add /g4cmp/VertexBank
+// 20261014  Add /g4cmp/PhononCullEnergy, PhononCullTime and phonon roulette
+// 20261014  Add /g4cmp/EventTiming, EventTimingSlowest and HeartbeatInterval
+// 20261014  Add /g4cmp/EventStepBudget and /g4cmp/EventTrackBudget
+// 20261014  Add /g4cmp/CheckpointInterval, CheckpointFile and ResumeRun
+// 20261014  Add /g4cmp/BeamOnRanks
+// 20261014  Add /g4cmp/AsyncOutput, OutputQueueSize, OutputCompression, CompressionLevel
+// 20261014  Add /g4cmp/EventIndex
+// 20261014  Add /g4cmp/GeometrySnapshot
+// 20261014  Add /g4cmp/RegionCut, RegionMaxStep and RegionMinEnergy
 
 #include "G4UImessenger.hh"
 
 class FourQubitConfigManager;
+class G4UIcmdWithABool;
 class G4UIcmdWithAString;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithoutParameter;
 class G4UIcommand;
 
 
@@ -31,6 +58,53 @@ public:
 private:
   FourQubitConfigManager* theManager;
   G4UIcmdWithAString* hitsCmd;
+  G4UIcmdWithAnInteger* bufferCmd;
+  G4UIcmdWithABool* asyncCmd;
+  G4UIcmdWithAnInteger* queueCmd;
+  G4UIcmdWithAString* compressionCmd;
+  G4UIcmdWithAnInteger* levelCmd;
+  G4UIcmdWithABool* indexCmd;
+  G4UIcmdWithAString* formatCmd;
+  G4UIcmdWithAString* modeCmd;
+  G4UIcmdWithAString* geometryCmd;
+  G4UIcmdWithAString* targetCmd;
+  G4UIcmdWithABool* profileCmd;
+  G4UIcmdWithAString* traceCmd;
+  G4UIcmdWithADouble* traceEventCmd;
+  G4UIcmdWithADouble* traceTrackCmd;
+  G4UIcmdWithAString* traceFilterCmd;
+  G4UIcmdWithAString* pceFileCmd;
+  G4UIcmdWithAString* pceBinningCmd;
+  G4UIcmdWithAString* pceQuantityCmd;
+  G4UIcmdWithAString* samplingCmd;
+  G4UIcmdWithAString* strataCmd;
+  G4UIcmdWithADouble* biasFractionCmd;
+  G4UIcmdWithADoubleAndUnit* biasMarginCmd;
+  G4UIcmdWithAString* bankCmd;
+  G4UIcmdWithADoubleAndUnit* cullEnergyCmd;
+  G4UIcmdWithADoubleAndUnit* cullTimeCmd;
+  G4UIcmdWithAnInteger* rouletteBouncesCmd;
+  G4UIcmdWithADouble* rouletteSurvivalCmd;
+  G4UIcmdWithABool* timingCmd;
+  G4UIcmdWithAnInteger* slowestCmd;
+  G4UIcmdWithADoubleAndUnit* heartbeatCmd;
+  G4UIcmdWithAnInteger* stepBudgetCmd;
+  G4UIcmdWithAnInteger* trackBudgetCmd;
+  G4UIcmdWithAnInteger* checkpointCmd;
+  G4UIcmdWithAString* checkpointFileCmd;
+  G4UIcmdWithAnInteger* resumeCmd;
+  G4UIcmdWithAnInteger* beamOnRanksCmd;
+  G4UIcmdWithAString* paramCmd;
+  G4UIcmdWithAString* paramFileCmd;
+  G4UIcmdWithoutParameter* paramListCmd;
+  G4UIcmdWithAString* tagCmd;
+  G4UIcmdWithAString* layoutCmd;
+  G4UIcmdWithABool* overlapCmd;
+  G4UIcmdWithAString* validationCmd;
+  G4UIcmdWithAString* snapshotCmd;
+  G4UIcmdWithAString* regionCutCmd;
+  G4UIcmdWithAString* regionStepCmd;
+  G4UIcmdWithAString* regionEnergyCmd;
 
 private:
   FourQubitConfigMessenger(const FourQubitConfigMessenger&);	// Copying is forbidden
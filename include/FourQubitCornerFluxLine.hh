@@ -13,6 +13,7 @@
 #include "FourQubitDetectorParameters.hh"
 #include "FourQubitPad.hh"
 #include "globals.hh"
+#include "FourQubitSubVolume.hh"
 
 class G4VPhysicalVolume;
 class G4LogicalVolume;
@@ -49,7 +50,7 @@ class FourQubitCornerFluxLine
 				   G4int pCopyNo,
 				   G4bool pSurfChk=false);
 
-    std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > GetListOfAllFundamentalSubVolumes();
+    const FourQubitSubVolumeList& GetListOfAllFundamentalSubVolumes() const;
     void AddComplexGeometryPadSubVolumesToThisList(FourQubitPad * pad); 
 
   
@@ -60,7 +61,7 @@ class FourQubitCornerFluxLine
     //The final G4PVPlacement
     G4LogicalVolume * fLog_output;
     G4VPhysicalVolume * fPhys_output;
-    std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > fFundamentalVolumeList;
+    FourQubitSubVolumeList fFundamentalVolumeList;
   
 };
 
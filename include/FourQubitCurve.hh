@@ -9,6 +9,7 @@
 #include "G4UnionSolid.hh"
 #include "FourQubitDetectorParameters.hh"
 #include "globals.hh"
+#include "FourQubitSubVolume.hh"
 
 class G4VPhysicalVolume;
 class G4LogicalVolume;
@@ -49,7 +50,7 @@ class FourQubitCurve
            G4float pStart=1.0,
            G4float pAngle=1.0);
 
-    std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > GetListOfAllFundamentalSubVolumes();  
+    const FourQubitSubVolumeList& GetListOfAllFundamentalSubVolumes() const;  
   
   protected:
 
@@ -58,7 +59,7 @@ class FourQubitCurve
     //The final G4PVPlacement
     G4LogicalVolume * fLog_output;
     G4VPhysicalVolume * fPhys_output;
-    std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > fFundamentalVolumeList;
+    FourQubitSubVolumeList fFundamentalVolumeList;
   
 };
 
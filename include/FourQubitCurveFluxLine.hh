@@ -37,6 +37,7 @@
 #include "FourQubitDetectorParameters.hh"
 #include "FourQubitPad.hh"
 #include "globals.hh"
+#include "FourQubitSubVolume.hh"
 
 class G4VPhysicalVolume;
 class G4LogicalVolume;
@@ -60,6 +61,17 @@ class FourQubitCurveFluxLine
 					 G4int pCopyNo,
 					 G4bool pSurfChk=false);
   
+    //Place another copy of an already-built flux line: the solids, logical volumes and vis
+    //attributes are shared, and only the top-level G4PVPlacement is new.
+    FourQubitCurveFluxLine(const FourQubitCurveFluxLine * pShared,
+                           G4RotationMatrix * pRot,
+                           const G4ThreeVector & tLate,
+                           const G4String & pName,
+                           G4LogicalVolume * pMotherLogical,
+                           G4bool pMany,
+                           G4int pCopyNo,
+                           G4bool pSurfChk=false);
+  
     //Access functions
     G4VPhysicalVolume * GetPhysicalVolume(){ return fPhys_output; }
     G4LogicalVolume * GetLogicalVolume(){ return fLog_output; }
@@ -73,7 +85,7 @@ class FourQubitCurveFluxLine
 				   G4int pCopyNo,
 				   G4bool pSurfChk=false);
 
-    std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > GetListOfAllFundamentalSubVolumes();
+    const FourQubitSubVolumeList& GetListOfAllFundamentalSubVolumes() const;
     void AddComplexGeometryPadSubVolumesToThisList(FourQubitPad * pad); 
   
   
@@ -84,7 +96,7 @@ class FourQubitCurveFluxLine
     //The final G4PVPlacement
     G4LogicalVolume * fLog_output;
     G4VPhysicalVolume * fPhys_output;
-    std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > fFundamentalVolumeList;
+    FourQubitSubVolumeList fFundamentalVolumeList;
   
 };
 
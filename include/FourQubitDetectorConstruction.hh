@@ -6,9 +6,17 @@
 #ifndef FourQubitDetectorConstruction_h
 #define FourQubitDetectorConstruction_h 1
 
+#include "FourQubitGeometrySnapshot.hh"
 #include "G4VUserDetectorConstruction.hh"
+#include "G4Cache.hh"
 #include "globals.hh"
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
 
+class G4LatticeLogical;
+class G4LatticePhysical;
 class G4Material;
 class G4VPhysicalVolume;
 class G4CMPSurfaceProperty;
@@ -21,11 +29,16 @@ public:
   
 public:
   virtual G4VPhysicalVolume* Construct();
+  virtual void ConstructSDandField();
   
 private:
   void DefineMaterials();
+  void DefineSurfaces();
   void SetupGeometry();
   void AttachPhononSensor(G4CMPSurfaceProperty * surfProp);
+  G4LatticeLogical* GetLogicalLattice(G4Material* mat, const G4String& latDir);
+  G4LatticePhysical* GetPhysicalLattice(G4LatticeLogical* lattice, G4int h, G4int k, G4int l);
+  void RegisterLattice(G4VPhysicalVolume* pv, const G4String& latDir, G4int h, G4int k, G4int l);
   void LogicalBorderCreation(auto * ComponentModel, G4VPhysicalVolume * PhysicalSiVolume, G4CMPSurfaceProperty * SiNbInterface, G4CMPSurfaceProperty * SiVacuumInterface);
 
   
@@ -42,9 +55,16 @@ private:
   G4CMPSurfaceProperty* fSiCopperInterface;
   G4CMPSurfaceProperty* fSiVacuumInterface;
 
+  // Logical lattices are loaded once and kept through geometry rebuilds,
+  // keyed by material and config directory; physical lattices, by lattice
+  // and Miller orientation, are owned by G4LatticeManager and made per build
+  std::map<std::pair<const G4Material*,G4String>,G4LatticeLogical*> fLogicalLattices;
+  std::map<std::tuple<const G4LatticeLogical*,G4int,G4int,G4int>,G4LatticePhysical*> fPhysicalLattices;
+  std::vector<FourQubitGeometrySnapshot::Lattice> fLattices;	// Registered this build
   
-  G4CMPElectrodeSensitivity* fSuperconductorSensitivity;
+  G4Cache<G4CMPElectrodeSensitivity*> fSuperconductorSensitivity;	// One per thread
   G4bool fConstructed;
+  G4bool fBuildingFlatSource;	// Components go to the stand-in ground plane
 };
 
 #endif
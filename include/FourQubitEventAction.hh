@@ -0,0 +1,44 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitEventAction_hh
+#define FourQubitEventAction_hh 1
+
+// $Id$
+// File:  FourQubitEventAction.hh
+//
+// Description:	Event boundaries for /g4cmp/EventTiming and the
+//		/g4cmp/HeartbeatInterval progress line (FourQubitEventTimer).
+//		Steps and tracks per event are the differences of
+//		FourQubitSteppingAction's running counts; hits are the
+//		entries in the event's hit collections.  Each event also
+//		restarts the stepping action's event watchdog.
+
+#include "G4UserEventAction.hh"
+#include "FourQubitEventTimer.hh"
+
+class G4Event;
+class FourQubitSteppingAction;
+
+
+class FourQubitEventAction : public G4UserEventAction {
+public:
+  FourQubitEventAction();
+  virtual ~FourQubitEventAction() {;}
+
+  virtual void BeginOfEventAction(const G4Event* event);
+  virtual void EndOfEventAction(const G4Event* event);
+
+  // Called by FourQubitRunAction on worker (or sequential) threads
+  void BeginOfRun(G4int runID);
+  void EndOfRun();
+
+private:
+  FourQubitEventTimer timer;
+  FourQubitSteppingAction* stepping;	// Found at start of run
+  G4long stepsAtStart, tracksAtStart;
+};
+
+#endif	/* FourQubitEventAction_hh */
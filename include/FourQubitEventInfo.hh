@@ -0,0 +1,56 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitEventInfo_hh
+#define FourQubitEventInfo_hh 1
+
+// $Id$
+// File:  FourQubitEventInfo.hh
+//
+// Description:	Flags attached to an event by FourQubitSteppingAction when
+//		the event watchdog (/g4cmp/EventStepBudget,
+//		/g4cmp/EventTrackBudget) cuts it short, and written with the
+//		primary by FourQubitSensitivity.  Also the event number as
+//		written, which continues past other jobs' events.
+
+#include "FourQubitCheckpoint.hh"
+#include "FourQubitMPI.hh"
+#include "G4VUserEventInformation.hh"
+#include "G4Event.hh"
+#include "G4ios.hh"
+
+
+class FourQubitEventInfo : public G4VUserEventInformation {
+public:
+  // Bits of the primary record's flags word
+  enum Flag { kStepBudget=1, kTrackBudget=2 };
+
+  FourQubitEventInfo() : flags(0) {;}
+  virtual ~FourQubitEventInfo() {;}
+
+  G4int GetFlags() const { return flags; }
+  void SetFlag(Flag f) { flags |= f; }
+
+  virtual void Print() const { G4cout << "Event flags " << flags << G4endl; }
+
+  // 0 if the event carries no FourQubitEventInfo (not cut short)
+  static G4int Flags(const G4Event* event) {
+    const FourQubitEventInfo* info =
+      dynamic_cast<const FourQubitEventInfo*>(event->GetUserInformation());
+    return info ? info->flags : 0;
+  }
+
+  // Geant4's event ID, after the events of a checkpointed job
+  // (/g4cmp/ResumeRun) or of the lower MPI ranks (/g4cmp/BeamOnRanks)
+  static G4int EventNumber(const G4Event* event) {
+    return event->GetEventID() + FourQubitCheckpoint::GetEventOffset()
+      + FourQubitMPI::GetEventOffset();
+  }
+
+private:
+  G4int flags;
+};
+
+#endif	/* FourQubitEventInfo_hh */
@@ -0,0 +1,79 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitEventTimer_hh
+#define FourQubitEventTimer_hh 1
+
+// $Id$
+// File:  FourQubitEventTimer.hh
+//
+// Description:	Per-thread event statistics for /g4cmp/EventTiming: wall
+//		time, steps, tracks and hits of every event, and the process
+//		RSS at its end.  Each thread keeps the per-event values as
+//		floats (16 bytes an event) and its slowest events in full;
+//		workers add them to shared totals at end of run, and the
+//		master (or the sequential run action) prints p50, p99 and max
+//		of each, with the /g4cmp/EventTimingSlowest slowest events.
+//		/g4cmp/HeartbeatInterval prints a progress line from each
+//		thread that often, timing on or not.  The job's startup
+//		time, from main() to the first run, is printed once.
+
+#include "globals.hh"
+#include <chrono>
+#include <vector>
+
+
+class FourQubitEventTimer {
+public:
+  FourQubitEventTimer();
+  ~FourQubitEventTimer() {;}
+
+  // Take the settings from FourQubitConfigManager
+  void BeginOfRun(G4int runID);
+  G4bool IsActive() const { return timing || heartbeat > 0.; }
+
+  // Hot path, once per event each
+  void BeginOfEvent();
+  void EndOfEvent(G4int eventID, G4long steps, G4long tracks, G4long hits);
+
+  // Add this thread's values to the shared totals, then reset
+  void EndOfRun();
+
+  // Print and clear the shared totals (master or sequential only)
+  static void PrintSummary(G4int runID);
+
+  // Startup: main() marks the start, each geometry build adds its time,
+  // and the first run prints the total (master or sequential only)
+  static void MarkJobStart();
+  static void AddGeometryTime(G4double seconds);
+  static void PrintStartup();
+
+  // Resident set size of the process now, in MB (peak RSS if the current
+  // value is not available)
+  static G4double ResidentMB();
+
+  struct EventInfo {
+    G4int eventID, threadID;
+    G4double seconds;
+    G4long steps, tracks, hits;
+    G4double rssMB;
+  };
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  G4bool timing;		// /g4cmp/EventTiming
+  size_t nSlowest;		// /g4cmp/EventTimingSlowest
+  G4double heartbeat;		// /g4cmp/HeartbeatInterval, seconds; 0 = none
+  G4int runID;
+
+  Clock::time_point runStart, eventStart, lastBeat;
+  G4long nEvents;
+  std::vector<float> seconds, steps, tracks, hits;
+  std::vector<EventInfo> slowest;	// Min-heap on seconds, nSlowest long
+  G4double peakRSS;
+};
+
+#endif	/* FourQubitEventTimer_hh */
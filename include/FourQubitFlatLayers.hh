@@ -0,0 +1,52 @@
+//
+/// \file FourQubitFlatLayers.hh
+/// \brief Definition of the class merging the ground-plane features into
+///        one solid per material layer
+///
+/// With dp_flattenConductors, the components are built as usual but into a
+/// stand-in for the ground plane that is never placed. This class then
+/// walks that tree and collects every volume whose material differs from
+/// its mother's. The first level is the gaps cut into the ground plane,
+/// the second the conductors inside them, and so on. Each level becomes
+/// one G4MultiUnion volume, placed in the level above. Same-material
+/// wrappers such as the components' base niobium layers are dropped.
+///
+/// The few merged volumes replace hundreds of small ones, so a phonon
+/// reaching the film sees one boundary instead of several nested ones.
+/// Each union node keeps the volume it came from in FourQubitSensorTable,
+/// so hits still get their sensor and qubit IDs and /g4cmp/TargetVolumes
+/// still matches the original volume names.
+
+#ifndef FourQubitFlatLayers_h
+#define FourQubitFlatLayers_h 1
+
+#include "FourQubitSubVolume.hh"
+#include "globals.hh"
+#include <vector>
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+
+class FourQubitFlatLayers
+{
+  public:
+    //Merge everything placed in pSourceLogical, which has the same frame as
+    //the ground plane pMotherPhysical; the layers are placed in the latter
+    FourQubitFlatLayers(G4LogicalVolume * pSourceLogical,
+                        const G4String & pName,
+                        G4VPhysicalVolume * pMotherPhysical,
+                        G4bool pSurfChk=false);
+
+    size_t GetNumberOfNodes() const { return fNodeCount; }
+
+    //One entry per merged layer
+    const FourQubitSubVolumeList& GetListOfAllFundamentalSubVolumes() const;
+
+  private:
+    size_t fNodeCount;
+    FourQubitSubVolumeList fFundamentalVolumeList;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
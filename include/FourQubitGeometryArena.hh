@@ -0,0 +1,86 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitGeometryArena_hh
+#define FourQubitGeometryArena_hh 1
+
+// $Id$
+// File:  FourQubitGeometryArena.hh
+//
+// Description:	Owner of everything a geometry build allocates outside the
+//		Geant4 solid, logical and physical volume stores: the
+//		FourQubit component builders, the rotation matrices given
+//		to placements, and the array parameterisation.  They live
+//		in one monotonic memory pool and are destroyed together by
+//		Release(), which FourQubitDetectorConstruction calls once
+//		the previous build's stores have been cleaned, so repeated
+//		rebuilds in a scan reuse the same memory instead of
+//		leaking it.  The geometry is built on the master thread
+//		only, so the arena is not locked.
+//
+//		  FourQubitGeometryArena* arena = FourQubitGeometryArena::Instance();
+//		  G4RotationMatrix* rot = arena->Rotation();
+//		  FourQubitPad* pad = arena->Make<FourQubitPad>(rot, ...);
+
+#include "G4RotationMatrix.hh"
+#include "globals.hh"
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+class FourQubitGeometryArena {
+public:
+  static FourQubitGeometryArena* Instance();
+  ~FourQubitGeometryArena() { Release(); }
+
+  // A new T, owned by the arena until the next Release()
+  template <class T, class... Args>
+  T* Make(Args&&... args) {
+    T* object = new (pool.allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    if (!std::is_trivially_destructible<T>::value)
+      owned.push_back(Owned{ object, [](void* p) { static_cast<T*>(p)->~T(); } });
+    nObjects++;
+    nBytes += sizeof(T);
+    return object;
+  }
+
+  // Identity rotation, for the caller to turn
+  G4RotationMatrix* Rotation() { nRotations++; return Make<G4RotationMatrix>(); }
+
+  // Destroy everything made since the last Release(), newest first, and
+  // hand the pool's memory back
+  void Release();
+
+  // This build so far, and the builds already released
+  size_t GetNumberOfObjects() const { return nObjects; }
+  size_t GetNumberOfRotations() const { return nRotations; }
+  size_t GetBytes() const { return nBytes; }
+  size_t GetNumberReleased() const { return nReleased; }
+
+  void Report() const;		// One line on G4cout
+
+private:
+  FourQubitGeometryArena();
+  FourQubitGeometryArena(const FourQubitGeometryArena&) = delete;
+  FourQubitGeometryArena& operator=(const FourQubitGeometryArena&) = delete;
+
+  struct Owned {
+    void* object;
+    void (*destroy)(void*);
+  };
+
+  std::pmr::monotonic_buffer_resource pool;
+  std::vector<Owned> owned;		// Objects with destructors to run
+  size_t nObjects;
+  size_t nRotations;
+  size_t nBytes;
+  size_t nReleased;			// Objects destroyed by earlier releases
+  G4int nBuilds;
+};
+
+#endif	/* FourQubitGeometryArena_hh */
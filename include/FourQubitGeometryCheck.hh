@@ -0,0 +1,56 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitGeometryCheck_hh
+#define FourQubitGeometryCheck_hh 1
+
+// $Id$
+// File:  FourQubitGeometryCheck.hh
+//
+// Description:	One-off overlap check of the whole geometry, for the
+//		"--check-geometry" mode of the FourQubit executable.  Every
+//		placed volume is checked once, several volumes at a time,
+//		after the geometry is built without /g4cmp/CheckOverlaps.
+//		A geometry that passes has its hash (names, placements,
+//		materials and solid parameters of every volume) added to
+//		the /g4cmp/GeometryValidationFile.  Production runs build
+//		without overlap checks and only warn if their geometry's
+//		hash is not in that file.
+
+#include "globals.hh"
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+
+class FourQubitGeometryCheck {
+public:
+  // Check the current geometry with nThreads threads, print a report, and
+  // record the hash if nothing overlaps; returns the number of volumes
+  // that overlap
+  static G4int Run(G4int nThreads, G4int nPoints=10000);
+
+  // Overlap check alone; volumes that overlap are listed on "report"
+  static G4int CheckOverlaps(G4int nThreads, G4int nPoints, std::ostream& report);
+
+  // Hex digest of the geometry as currently built
+  static G4String GeometryHash();
+
+  // FNV-1a, stable across builds and platforms unlike std::hash: fold
+  // "bytes" into "hash", starting from kHashBasis, then print it as hex.
+  // Also used for the FourQubitGeometrySnapshot keys.
+  static const uint64_t kHashBasis = 14695981039346656037ULL;
+  static void HashBytes(uint64_t& hash, const std::string& bytes);
+  static G4String HexDigest(uint64_t hash);
+
+  // Validation file: one hash per line, '#' starts a comment
+  static G4bool IsValidated(const G4String& file, const G4String& hash);
+  static void RecordValidated(const G4String& file, const G4String& hash);
+
+  // Called after each production build; a warning, never a failure
+  static void WarnIfNotValidated(const G4String& file);
+};
+
+#endif	/* FourQubitGeometryCheck_hh */
@@ -0,0 +1,66 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitGeometrySnapshot_hh
+#define FourQubitGeometrySnapshot_hh 1
+
+// $Id$
+// File:  FourQubitGeometrySnapshot.hh
+//
+// Description:	Saved copies of a fully built geometry, for
+//		/g4cmp/GeometrySnapshot.  A snapshot is a GDML file of the
+//		volumes, solids and materials (needs Geant4 with GDML and
+//		cmake -DWITH_GDML=ON), plus a text sidecar with what GDML
+//		does not hold: lattice orientations, border surfaces and
+//		the sensor table.  Both are named by a key hashed from
+//		every dp_ parameter, the layout file and the hash of the
+//		FourQubit sources that CMake generates at build time, so
+//		the same build with the same parameters loads the snapshot
+//		instead of running the component constructors,
+//		LogicalBorderCreation and any overlap checks, and a
+//		snapshot from other construction code is never loaded.
+//		Builds with a qubit array or flattened conductors are not
+//		saved: their sensor lookups depend on the build itself.
+
+#include "globals.hh"
+#include <vector>
+
+class G4CMPSurfaceProperty;
+class G4VPhysicalVolume;
+
+
+class FourQubitGeometrySnapshot {
+public:
+  // A lattice as registered: the volume, the config directory of its
+  // logical lattice, and its Miller orientation
+  struct Lattice {
+    G4VPhysicalVolume* volume;
+    G4String latticeDir;
+    G4int h, k, l;
+  };
+
+  static G4bool Available();		// Built with GDML
+
+  // Hex key of the current dp_ parameters and layout file
+  static G4String Key();
+
+  // "<dir>/FourQubit_<key>.gdml"; the sidecar adds ".fq"
+  static G4String FileName(const G4String& dir, const G4String& key);
+
+  // Save the geometry under "world", with the border and sensor tables as
+  // they are now; an existing snapshot for the key is replaced
+  static G4bool Save(const G4String& dir, G4VPhysicalVolume* world,
+		     const std::vector<Lattice>& lattices);
+
+  // Load the snapshot for the current key, recreating its border surfaces
+  // from "properties" (matched by name) and restoring the sensor table;
+  // the lattices are returned for registering.  Null if there is no usable
+  // snapshot, with nothing left behind.
+  static G4VPhysicalVolume* Load(const G4String& dir,
+				 const std::vector<G4CMPSurfaceProperty*>& properties,
+				 std::vector<Lattice>& lattices);
+};
+
+#endif	/* FourQubitGeometrySnapshot_hh */
@@ -0,0 +1,431 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitHitFormat_hh
+#define FourQubitHitFormat_hh 1
+
+// $Id$
+// File:  FourQubitHitFormat.hh
+//
+// Description:	Layout of the binary hit and primary output files written
+//		by FourQubitSensitivity (/g4cmp/HitsFormat binary), and of
+//		the step traces written by FourQubitStepTrace, shared with
+//		the reader in AnalysisTools/FourQubitHitReader.hh.  No
+//		Geant4 dependencies, so analysis code can include it alone.
+//
+//		File = header + fixed-width little-endian records.  Header:
+//		  char     magic[8]         "FQHITS", "FQPRIM", "FQSTEP",
+//					    "FQEVNT", "FQVTXS" or "FQINDX"
+//		  uint32   version          kFormatVersion
+//		  uint32   recordSize       bytes per record
+//		  uint32   nFields          followed by nFields FieldInfo
+//		  uint32   nParticles       followed by nParticles names
+//					    (char[32]); a record's particle
+//					    code indexes this table, -1 if
+//					    the particle was not listed
+//		Every output record begins with int32 runID, int32 eventID.
+//
+//		Step traces use the name table for particles, processes
+//		and volumes alike; each code in a StepRecord indexes it.
+//
+//		Version 2 appends int32 sensorID, qubitID to hit records
+//		(see FourQubitSensorTable); fields are only ever appended,
+//		so a version 1 record is a prefix of the current one.
+//		Version 3 puts the primary's /g4cmp/PrimaryStrata cell in
+//		the primary record's spare int32 (-1 if not stratified);
+//		earlier files hold 0 there.  Version 4 appends the
+//		primary's float64 weight (/g4cmp/PrimarySampling biased).
+//		Version 5 appends the primary's int32 event flags
+//		(FourQubitEventInfo: 1 = step budget, 2 = track budget hit)
+//		and a spare int32.
+//
+//		With /g4cmp/HitsMode event the hit file holds EventSumRecords
+//		instead ("FQEVNT"): one per sensor hit in an event, in sensor
+//		order, with the event's records contiguous.  Hits off every
+//		sensor are summed per qubit (sensorID -1), then all together
+//		(sensorID and qubitID -1).
+//
+//		Vertex banks ("FQVTXS", /g4cmp/VertexBank) are inputs, made
+//		by converters outside the simulation: one VertexRecord per
+//		event, record i going to event i.  The particle code indexes
+//		the name table; -1 means look up the PDG code instead (ions).
+//
+//		Event indexes ("FQINDX", /g4cmp/EventIndex) sit beside a hit
+//		or primary file as "<file>.idx": one IndexRecord per event
+//		with records in that file, in file order.  The event's first
+//		record is found by going to byte "offset" of the file, then
+//		skipping "skip" bytes of what is read from there; skip is 0
+//		unless the file is compressed, where offset is the start of
+//		the zstd frame and skip counts decompressed bytes.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace FourQubitHitFormat {
+  constexpr uint32_t kFormatVersion = 5;
+  constexpr size_t kNameLength = 32;
+
+  const char kHitMagic[8]     = { 'F','Q','H','I','T','S','\0','\0' };
+  const char kPrimaryMagic[8] = { 'F','Q','P','R','I','M','\0','\0' };
+  const char kStepMagic[8]    = { 'F','Q','S','T','E','P','\0','\0' };
+  const char kEventMagic[8]   = { 'F','Q','E','V','N','T','\0','\0' };
+  const char kGridMagic[8]    = { 'F','Q','G','R','I','D','\0','\0' };
+  const char kVertexMagic[8]  = { 'F','Q','V','T','X','S','\0','\0' };
+  const char kIndexMagic[8]   = { 'F','Q','I','N','D','X','\0','\0' };
+
+  enum FieldType : uint8_t { kInt32=0, kFloat64=1, kInt64=2 };
+
+  struct FieldInfo {			// As stored in the header
+    char name[kNameLength];
+    uint8_t type;
+    uint8_t pad[3];
+    uint32_t offset;
+  };
+
+  // Units are those of the text output: eV, mm, ns
+  struct HitRecord {
+    int32_t runID, eventID, trackID, particle;
+    double startEnergy, startX, startY, startZ, startTime;
+    double energyDeposit, weight;
+    double finalX, finalY, finalZ, finalTime;
+    int32_t sensorID, qubitID;		// -1 if not on a sensor / qubit
+  };
+  static_assert(sizeof(HitRecord) == 112, "HitRecord must be unpadded");
+
+  struct PrimaryRecord {
+    int32_t runID, eventID, particle, stratum;
+    double energy, x, y, z, time;
+    double weight;
+    int32_t flags, reserved;		// Event watchdog flags
+  };
+  static_assert(sizeof(PrimaryRecord) == 72, "PrimaryRecord must be unpadded");
+
+  struct StepRecord {
+    int32_t runID, eventID, trackID, particle;
+    int32_t process, volume;		// Post-step process, pre-step volume
+    double preX, preY, preZ, preEnergy, preKinEnergy;
+    double postX, postY, postZ, postEnergy, postKinEnergy, postTime;
+  };
+  static_assert(sizeof(StepRecord) == 112, "StepRecord must be unpadded");
+
+  // Hits summed per sensor over one event.  Counts and energies ignore the
+  // track weights: apply the primary record's event weight when summing
+  // events, and don't use these sums with the phonon roulette on.
+  struct EventSumRecord {
+    int32_t runID, eventID, sensorID, qubitID;
+    int32_t nHits, reserved;
+    double energyDeposit, firstTime, lastTime;	// Of the hits' final times
+  };
+  static_assert(sizeof(EventSumRecord) == 48, "EventSumRecord must be unpadded");
+
+  // One primary for the vertex bank; the direction need not be normalized
+  struct VertexRecord {
+    int32_t particle, pdg;
+    double kineticEnergy, x, y, z;
+    double dirX, dirY, dirZ, time, weight;
+  };
+  static_assert(sizeof(VertexRecord) == 80, "VertexRecord must be unpadded");
+
+  // Where one event's records start in a hit or primary file
+  struct IndexRecord {
+    int32_t runID, eventID;
+    int32_t nRecords, reserved;		// Lines, or fixed-width records
+    int64_t offset, skip;		// Bytes; see above
+  };
+  static_assert(sizeof(IndexRecord) == 32, "IndexRecord must be unpadded");
+
+  inline std::string IndexFileName(const std::string& dataFile) {
+    return dataFile + ".idx";
+  }
+
+  // Field tables, in record order: a FieldSpec per field, turned into
+  // header entries by MakeFields()
+  struct FieldSpec {
+    const char* name;
+    uint8_t type;
+    size_t offset;
+  };
+
+  template <size_t N>
+  inline std::vector<FieldInfo> MakeFields(const FieldSpec (&specs)[N]) {
+    std::vector<FieldInfo> fields;
+    for (const FieldSpec& spec : specs) {
+      FieldInfo info{};
+      std::strncpy(info.name, spec.name, kNameLength-1);
+      info.type = spec.type;
+      info.offset = uint32_t(spec.offset);
+      fields.push_back(info);
+    }
+    return fields;
+  }
+
+  inline std::vector<FieldInfo> HitFields() {
+    const FieldSpec f[] = {
+      { "runID", kInt32, offsetof(HitRecord,runID) },
+      { "eventID", kInt32, offsetof(HitRecord,eventID) },
+      { "trackID", kInt32, offsetof(HitRecord,trackID) },
+      { "particle", kInt32, offsetof(HitRecord,particle) },
+      { "startEnergy_eV", kFloat64, offsetof(HitRecord,startEnergy) },
+      { "startX_mm", kFloat64, offsetof(HitRecord,startX) },
+      { "startY_mm", kFloat64, offsetof(HitRecord,startY) },
+      { "startZ_mm", kFloat64, offsetof(HitRecord,startZ) },
+      { "startTime_ns", kFloat64, offsetof(HitRecord,startTime) },
+      { "energyDeposit_eV", kFloat64, offsetof(HitRecord,energyDeposit) },
+      { "weight", kFloat64, offsetof(HitRecord,weight) },
+      { "finalX_mm", kFloat64, offsetof(HitRecord,finalX) },
+      { "finalY_mm", kFloat64, offsetof(HitRecord,finalY) },
+      { "finalZ_mm", kFloat64, offsetof(HitRecord,finalZ) },
+      { "finalTime_ns", kFloat64, offsetof(HitRecord,finalTime) },
+      { "sensorID", kInt32, offsetof(HitRecord,sensorID) },
+      { "qubitID", kInt32, offsetof(HitRecord,qubitID) },
+    };
+    return MakeFields(f);
+  }
+
+  inline std::vector<FieldInfo> PrimaryFields() {
+    const FieldSpec f[] = {
+      { "runID", kInt32, offsetof(PrimaryRecord,runID) },
+      { "eventID", kInt32, offsetof(PrimaryRecord,eventID) },
+      { "particle", kInt32, offsetof(PrimaryRecord,particle) },
+      { "stratum", kInt32, offsetof(PrimaryRecord,stratum) },
+      { "energy_eV", kFloat64, offsetof(PrimaryRecord,energy) },
+      { "x_mm", kFloat64, offsetof(PrimaryRecord,x) },
+      { "y_mm", kFloat64, offsetof(PrimaryRecord,y) },
+      { "z_mm", kFloat64, offsetof(PrimaryRecord,z) },
+      { "time_ns", kFloat64, offsetof(PrimaryRecord,time) },
+      { "weight", kFloat64, offsetof(PrimaryRecord,weight) },
+      { "flags", kInt32, offsetof(PrimaryRecord,flags) },
+      { "reserved", kInt32, offsetof(PrimaryRecord,reserved) },
+    };
+    return MakeFields(f);
+  }
+
+  inline std::vector<FieldInfo> StepFields() {
+    const FieldSpec f[] = {
+      { "runID", kInt32, offsetof(StepRecord,runID) },
+      { "eventID", kInt32, offsetof(StepRecord,eventID) },
+      { "trackID", kInt32, offsetof(StepRecord,trackID) },
+      { "particle", kInt32, offsetof(StepRecord,particle) },
+      { "process", kInt32, offsetof(StepRecord,process) },
+      { "volume", kInt32, offsetof(StepRecord,volume) },
+      { "preX_mm", kFloat64, offsetof(StepRecord,preX) },
+      { "preY_mm", kFloat64, offsetof(StepRecord,preY) },
+      { "preZ_mm", kFloat64, offsetof(StepRecord,preZ) },
+      { "preEnergy_eV", kFloat64, offsetof(StepRecord,preEnergy) },
+      { "preKinEnergy_eV", kFloat64, offsetof(StepRecord,preKinEnergy) },
+      { "postX_mm", kFloat64, offsetof(StepRecord,postX) },
+      { "postY_mm", kFloat64, offsetof(StepRecord,postY) },
+      { "postZ_mm", kFloat64, offsetof(StepRecord,postZ) },
+      { "postEnergy_eV", kFloat64, offsetof(StepRecord,postEnergy) },
+      { "postKinEnergy_eV", kFloat64, offsetof(StepRecord,postKinEnergy) },
+      { "postTime_ns", kFloat64, offsetof(StepRecord,postTime) },
+    };
+    return MakeFields(f);
+  }
+
+  inline std::vector<FieldInfo> EventSumFields() {
+    const FieldSpec f[] = {
+      { "runID", kInt32, offsetof(EventSumRecord,runID) },
+      { "eventID", kInt32, offsetof(EventSumRecord,eventID) },
+      { "sensorID", kInt32, offsetof(EventSumRecord,sensorID) },
+      { "qubitID", kInt32, offsetof(EventSumRecord,qubitID) },
+      { "nHits", kInt32, offsetof(EventSumRecord,nHits) },
+      { "reserved", kInt32, offsetof(EventSumRecord,reserved) },
+      { "energyDeposit_eV", kFloat64, offsetof(EventSumRecord,energyDeposit) },
+      { "firstTime_ns", kFloat64, offsetof(EventSumRecord,firstTime) },
+      { "lastTime_ns", kFloat64, offsetof(EventSumRecord,lastTime) },
+    };
+    return MakeFields(f);
+  }
+
+  inline std::vector<FieldInfo> VertexFields() {
+    const FieldSpec f[] = {
+      { "particle", kInt32, offsetof(VertexRecord,particle) },
+      { "pdg", kInt32, offsetof(VertexRecord,pdg) },
+      { "kineticEnergy_eV", kFloat64, offsetof(VertexRecord,kineticEnergy) },
+      { "x_mm", kFloat64, offsetof(VertexRecord,x) },
+      { "y_mm", kFloat64, offsetof(VertexRecord,y) },
+      { "z_mm", kFloat64, offsetof(VertexRecord,z) },
+      { "dirX", kFloat64, offsetof(VertexRecord,dirX) },
+      { "dirY", kFloat64, offsetof(VertexRecord,dirY) },
+      { "dirZ", kFloat64, offsetof(VertexRecord,dirZ) },
+      { "time_ns", kFloat64, offsetof(VertexRecord,time) },
+      { "weight", kFloat64, offsetof(VertexRecord,weight) },
+    };
+    return MakeFields(f);
+  }
+
+  inline std::vector<FieldInfo> IndexFields() {
+    const FieldSpec f[] = {
+      { "runID", kInt32, offsetof(IndexRecord,runID) },
+      { "eventID", kInt32, offsetof(IndexRecord,eventID) },
+      { "nRecords", kInt32, offsetof(IndexRecord,nRecords) },
+      { "reserved", kInt32, offsetof(IndexRecord,reserved) },
+      { "offset", kInt64, offsetof(IndexRecord,offset) },
+      { "skip", kInt64, offsetof(IndexRecord,skip) },
+    };
+    return MakeFields(f);
+  }
+
+  // Byte order: records are stored little-endian.  On a big-endian host
+  // every 4- or 8-byte field is swapped on the way in and out.
+  inline bool HostIsLittleEndian() {
+    const uint16_t one = 1;
+    return *reinterpret_cast<const uint8_t*>(&one) == 1;
+  }
+
+  inline void SwapBytes(void* p, size_t n) {
+    uint8_t* b = static_cast<uint8_t*>(p);
+    for (size_t i=0; i<n/2; i++) std::swap(b[i], b[n-1-i]);
+  }
+
+  inline void SwapRecord(void* rec, const std::vector<FieldInfo>& fields) {
+    for (const FieldInfo& f : fields)
+      SwapBytes(static_cast<char*>(rec)+f.offset, f.type==kInt32 ? 4 : 8);
+  }
+
+  inline void PutU32(std::string& buf, uint32_t v) {
+    if (!HostIsLittleEndian()) SwapBytes(&v, sizeof(v));
+    buf.append(reinterpret_cast<const char*>(&v), sizeof(v));
+  }
+
+  inline bool GetU32(std::istream& in, uint32_t& v) {
+    if (!in.read(reinterpret_cast<char*>(&v), sizeof(v))) return false;
+    if (!HostIsLittleEndian()) SwapBytes(&v, sizeof(v));
+    return true;
+  }
+
+  // Serialize a complete header into "buf"
+  inline void AppendHeader(std::string& buf, const char magic[8],
+			   uint32_t recordSize,
+			   const std::vector<FieldInfo>& fields,
+			   const std::vector<std::string>& particles) {
+    buf.append(magic, 8);
+    PutU32(buf, kFormatVersion);
+    PutU32(buf, recordSize);
+    PutU32(buf, uint32_t(fields.size()));
+    for (FieldInfo f : fields) {
+      if (!HostIsLittleEndian()) SwapBytes(&f.offset, sizeof(f.offset));
+      buf.append(reinterpret_cast<const char*>(&f), sizeof(f));
+    }
+    PutU32(buf, uint32_t(particles.size()));
+    for (const std::string& p : particles) {
+      char name[kNameLength] = {};
+      std::strncpy(name, p.c_str(), kNameLength-1);
+      buf.append(name, kNameLength);
+    }
+  }
+
+  inline void PutF64(std::string& buf, double v) {
+    if (!HostIsLittleEndian()) SwapBytes(&v, sizeof(v));
+    buf.append(reinterpret_cast<const char*>(&v), sizeof(v));
+  }
+
+  inline bool GetF64(std::istream& in, double& v) {
+    if (!in.read(reinterpret_cast<char*>(&v), sizeof(v))) return false;
+    if (!HostIsLittleEndian()) SwapBytes(&v, sizeof(v));
+    return true;
+  }
+
+  struct GridHeader {
+    uint32_t version = kFormatVersion;
+    uint32_t nX = 0, nY = 0;
+    double xMin = 0., xMax = 0., yMin = 0., yMax = 0.;	// mm
+    std::vector<std::string> names;			// One per map
+  };
+
+  inline void AppendGridHeader(std::string& buf, const GridHeader& hdr) {
+    buf.append(kGridMagic, 8);
+    PutU32(buf, kFormatVersion);
+    PutU32(buf, hdr.nX);
+    PutU32(buf, hdr.nY);
+    PutU32(buf, uint32_t(hdr.names.size()));
+    PutF64(buf, hdr.xMin);
+    PutF64(buf, hdr.xMax);
+    PutF64(buf, hdr.yMin);
+    PutF64(buf, hdr.yMax);
+    for (const std::string& n : hdr.names) {
+      char name[kNameLength] = {};
+      std::strncpy(name, n.c_str(), kNameLength-1);
+      buf.append(name, kNameLength);
+    }
+  }
+
+  // Leaves the stream at the first map's bins
+  inline bool ReadGridHeader(std::istream& in, GridHeader& hdr) {
+    char magic[8];
+    if (!in.read(magic, 8) || std::memcmp(magic, kGridMagic, 8) != 0)
+      return false;
+
+    uint32_t nMaps = 0;
+    if (!GetU32(in, hdr.version) || !GetU32(in, hdr.nX) ||
+	!GetU32(in, hdr.nY) || !GetU32(in, nMaps) ||
+	!GetF64(in, hdr.xMin) || !GetF64(in, hdr.xMax) ||
+	!GetF64(in, hdr.yMin) || !GetF64(in, hdr.yMax)) return false;
+
+    hdr.names.resize(nMaps);
+    for (std::string& n : hdr.names) {
+      char name[kNameLength];
+      if (!in.read(name, kNameLength)) return false;
+      n.assign(name, strnlen(name, kNameLength));
+    }
+    return true;
+  }
+
+  struct Header {
+    char magic[8];
+    uint32_t version = 0;
+    uint32_t recordSize = 0;
+    std::vector<FieldInfo> fields;
+    std::vector<std::string> particles;
+    size_t size = 0;			// Bytes occupied in the file
+
+    bool IsHits() const { return std::memcmp(magic, kHitMagic, 8) == 0; }
+    bool IsPrimaries() const { return std::memcmp(magic, kPrimaryMagic, 8) == 0; }
+    bool IsSteps() const { return std::memcmp(magic, kStepMagic, 8) == 0; }
+    bool IsEventSums() const { return std::memcmp(magic, kEventMagic, 8) == 0; }
+    bool IsVertices() const { return std::memcmp(magic, kVertexMagic, 8) == 0; }
+    bool IsIndex() const { return std::memcmp(magic, kIndexMagic, 8) == 0; }
+  };
+
+  // Read a header; returns false (stream position undefined) if the
+  // stream does not start with a FourQubit binary header
+  inline bool ReadHeader(std::istream& in, Header& hdr) {
+    if (!in.read(hdr.magic, 8) ||
+	(!hdr.IsHits() && !hdr.IsPrimaries() && !hdr.IsSteps() &&
+	 !hdr.IsEventSums() && !hdr.IsVertices() && !hdr.IsIndex()))
+      return false;
+
+    uint32_t nFields = 0, nParticles = 0;
+    if (!GetU32(in, hdr.version) || !GetU32(in, hdr.recordSize) ||
+	!GetU32(in, nFields)) return false;
+
+    hdr.fields.resize(nFields);
+    for (FieldInfo& f : hdr.fields) {
+      if (!in.read(reinterpret_cast<char*>(&f), sizeof(f))) return false;
+      if (!HostIsLittleEndian()) SwapBytes(&f.offset, sizeof(f.offset));
+    }
+
+    if (!GetU32(in, nParticles)) return false;
+    hdr.particles.resize(nParticles);
+    for (std::string& p : hdr.particles) {
+      char name[kNameLength];
+      if (!in.read(name, kNameLength)) return false;
+      p.assign(name, strnlen(name, kNameLength));
+    }
+
+    hdr.size = 8 + 4*sizeof(uint32_t) + nFields*sizeof(FieldInfo)
+      + nParticles*kNameLength;
+    return true;
+  }
+}
+
+#endif	/* FourQubitHitFormat_hh */
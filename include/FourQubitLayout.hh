@@ -0,0 +1,73 @@
+//
+/// \file FourQubitLayout.hh
+/// \brief Definition of the class building ground-plane traces from a
+///        layout file
+///
+/// A layout file is a small netlist of coplanar-waveguide traces cut into
+/// the ground plane, one per line ('#' starts a comment):
+///
+///   unit    um                                   (lengths below; default um)
+///   width   <conductor> <empty>                  (defaults from the
+///                                                 dp_tlCoupling*DimY values)
+///   straight <name> <x> <y> <angleDeg> <length>
+///   curve    <name> <x> <y> <radius> <startDeg> <spanDeg>
+///
+/// A straight is centred on (x,y) with its length along angleDeg. A curve
+/// is centred on (x,y) with inner radius as in FourQubitCurve. Any length
+/// may also be the name of a geometry parameter, e.g. dp_resonatorCurveCentralRadius.
+///
+/// Each trace becomes an Empty (vacuum) volume placed straight into the
+/// ground plane, holding its Conductor, with no base layer around it.
+/// Straights of equal width that lie end to end on one line are merged
+/// into a single pair of boxes before anything is placed.
+
+#ifndef FourQubitLayout_h
+#define FourQubitLayout_h 1
+
+#include "FourQubitSubVolume.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+#include <vector>
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+
+class FourQubitLayout
+{
+  public:
+    FourQubitLayout(const G4String & fileName);
+    ~FourQubitLayout();
+
+    G4bool IsValid() const { return fValid; }
+    size_t GetNumberOfTraces() const { return fTraces.size(); }
+
+    //Place every trace in the ground plane, offset by tLate
+    void Place(const G4String & pName,
+               G4LogicalVolume * pMotherLogical,
+               const G4ThreeVector & tLate,
+               G4bool pSurfChk=false);
+
+    const FourQubitSubVolumeList& GetListOfAllFundamentalSubVolumes() const;
+
+  private:
+    struct Trace {
+      G4bool curve;
+      G4String name;
+      G4double x, y;
+      G4double angle, length;			// Straight
+      G4double radius, start, span;		// Curve
+      G4double conductorWidth, emptyWidth;
+    };
+
+    G4bool Load(const G4String & fileName);
+    void MergeStraights();
+    G4bool Mergeable(const Trace & a, const Trace & b, G4double & lo, G4double & hi) const;
+
+    std::vector<Trace> fTraces;
+    G4bool fValid;
+    FourQubitSubVolumeList fFundamentalVolumeList;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
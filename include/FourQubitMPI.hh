@@ -0,0 +1,65 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitMPI_hh
+#define FourQubitMPI_hh 1
+
+// $Id$
+// File:  FourQubitMPI.hh
+//
+// Description:	Thin MPI layer for running one FourQubit job on several
+//		nodes (cmake -DWITH_MPI=ON, then mpirun).  Each rank is an
+//		ordinary (MT) FourQubit process running the same macro.
+//		/g4cmp/BeamOnRanks N splits the N events into contiguous
+//		blocks, one per rank.  It reseeds each rank's engine from the
+//		macro's seeds and the rank number, so the streams are
+//		distinct and the job repeats exactly for a given rank count.
+//		Each rank's block of event IDs follows the ranks below it.
+//
+//		With more than one rank every output name gets "_r<rank>"
+//		(after any /g4cmp/OutputTag).  At the end of the job rank 0
+//		merges the ranks' hit and primary files into the untagged
+//		names, in (run, event) order, and writes a manifest of the
+//		ranks, their event counts and files.  This assumes a shared
+//		file system.  ROOT files and /g4cmp/PCEMapFile maps stay per
+//		rank, listed in the manifest.
+//
+//		Built without MPI, there is one rank and BeamOnRanks is
+//		just /run/beamOn.
+
+#include "globals.hh"
+
+
+class FourQubitMPI {
+public:
+  // Start and stop MPI (no-ops without it); Finalize after the run manager
+  // is deleted, so every output file is closed
+  static void Init(int* argc, char*** argv);
+  static void Finalize();
+
+  static G4bool IsEnabled();		// Built with MPI
+  static G4int GetRank() { return rank; }
+  static G4int GetSize() { return size; }
+
+  // /g4cmp/BeamOnRanks: this rank's share of "nEventsTotal"
+  static void BeamOn(G4int nEventsTotal);
+
+  // During BeamOn only: the ID of this rank's first event
+  static G4int GetEventOffset() { return inSplitRun ? eventOffset : 0; }
+  static G4bool InSplitRun() { return inSplitRun; }
+
+  // Rank 0 merges every rank's output and writes the manifest; all ranks
+  // must call this
+  static void MergeOutputs();
+
+private:
+  static G4int rank;
+  static G4int size;
+  static G4bool inSplitRun;
+  static G4int eventOffset;
+  static G4long eventsRun;		// By this rank, over the job
+};
+
+#endif	/* FourQubitMPI_hh */
@@ -0,0 +1,109 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitOutputWriter_hh
+#define FourQubitOutputWriter_hh 1
+
+// $Id$
+// File:  FourQubitOutputWriter.hh
+//
+// Description:	Output stage for the hit and primary files.  Each file is
+//		a FourQubitOutputFile, to which FourQubitSensitivity hands
+//		whole blocks of formatted records at event boundaries.
+//
+//		With /g4cmp/AsyncOutput the blocks of every file on every
+//		thread go onto one queue, and a single writer thread
+//		compresses and writes them, in order for each file.  The
+//		event loop only waits when more than /g4cmp/OutputQueueSize
+//		is queued.  Without it, each block is compressed and
+//		written on the thread that hands it over, as before.
+//
+//		With /g4cmp/OutputCompression zstd (cmake -DWITH_ZSTD=ON)
+//		each block becomes one zstd frame and the files get ".zst".
+//		A file of frames is still a standard zstd file ("zstd -d"
+//		reads it); it can be cut at any block (checkpoints) and
+//		appended to (later runs, shard merging).  The readers open
+//		it through FourQubitInputFile.
+//
+//		With /g4cmp/EventIndex the file also keeps "<file>.idx"
+//		(FourQubitHitFormat::IndexRecord), where each event's first
+//		record is, so readers can go straight to it.  The writer
+//		gives each event's position in the bytes it has handed
+//		over; entries are written at Flush(), when the compressed
+//		frame holding that position is known.
+
+#include "FourQubitHitFormat.hh"
+#include "globals.hh"
+#include <fstream>
+#include <ios>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+class FourQubitOutputFile {
+public:
+  FourQubitOutputFile();
+  ~FourQubitOutputFile();		// Close()
+  FourQubitOutputFile(const FourQubitOutputFile&) = delete;
+  FourQubitOutputFile& operator=(const FourQubitOutputFile&) = delete;
+
+  // Compression and the writer thread are taken from the configuration
+  // here; "mode" as for std::ofstream, so app resumes a checkpointed file.
+  // An indexed file appended to keeps its index entries for the bytes
+  // already there, and drops the rest.
+  G4bool Open(const G4String& fn, std::ios_base::openmode mode,
+	      G4bool indexed=false);
+  G4bool IsOpen() const { return file.is_open(); }
+  G4bool Good() const { return !failed; }	// No error so far
+
+  // Everything handed over is written before the file is closed
+  void Close();
+
+  // Takes the contents of "block", which is left empty (its storage may
+  // be swapped for an earlier block's); blocks if the queue is full
+  void Write(std::string& block);
+
+  // Waits until every block is written, then flushes the file
+  void Flush();
+
+  // File length so far; exact after Flush()
+  G4long Length() const { return length; }
+
+  // Bytes handed over since Open(), before compression
+  G4long Position() const { return handed; }
+
+  // Index an event whose "nRecords" records start at "position" (handed
+  // over or still to be); ignored unless the file is indexed
+  void IndexEvent(G4int runID, G4int eventID, G4long position, G4int nRecords);
+
+  static G4bool CompressionAvailable();	// Built with zstd
+
+private:
+  friend class FourQubitOutputQueue;
+  void WriteBlock(std::string& block);	// Owning thread or writer thread
+  void OpenIndex(const G4String& fn);
+  void WriteIndex();			// Entries for blocks already written
+
+  std::ofstream file;
+  G4bool compress;
+  G4int level;			// zstd compression level
+  G4bool async;			// Blocks go to the writer thread
+  G4bool failed;
+  G4long length;		// Bytes in the file, as written
+  G4long startLength;		// Bytes in the file at Open()
+  G4long handed;		// Bytes handed over, owning thread
+  G4long written;		// Of those, bytes written (before compression)
+  size_t pending;		// Blocks queued, guarded by the queue
+  std::string frame;		// Compressed block
+  void* context;		// ZSTD_CCtx, reused for every block
+
+  G4bool indexed;		// /g4cmp/EventIndex
+  std::ofstream indexFile;
+  std::vector<FourQubitHitFormat::IndexRecord> pendingIndex;	// Unresolved
+  std::vector<std::pair<G4long,G4long> > frames;	// Written, file offset
+};
+
+#endif	/* FourQubitOutputWriter_hh */
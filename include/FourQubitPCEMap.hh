@@ -0,0 +1,68 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitPCEMap_hh
+#define FourQubitPCEMap_hh 1
+
+// $Id$
+// File:  FourQubitPCEMap.hh
+//
+// Description:	In-run XY maps for /g4cmp/PCEMapFile, so a phonon
+//		collection efficiency map needs no hit files.  Each thread's
+//		FourQubitSensitivity fills dense arrays (one per quantity
+//		in /g4cmp/PCEMapQuantities, on the /g4cmp/PCEMapBinning
+//		grid) at the end of every event.  Workers add them to shared
+//		totals at end of run, and the master (or the sequential run
+//		action) writes those: ROOT histograms if the file name ends
+//		in ".root", otherwise a FourQubitHitFormat grid file.  The
+//		histogram names match PCEStudy's, and h_pceVsXY is added
+//		whenever both energies are collected.
+
+#include "FourQubitConfigManager.hh"
+#include "globals.hh"
+#include <vector>
+
+class G4CMPElectrodeHit;
+class G4PrimaryVertex;
+
+
+class FourQubitPCEMap {
+public:
+  // Binned at the primary vertex XY, except the last
+  enum Quantity { kHitEnergy=0, kPrimaryEnergy, kPrimaries, kHits,
+		  kHitEnergyAtHitXY, kNQuantities };
+
+  FourQubitPCEMap() : active(false) {;}
+  ~FourQubitPCEMap() {;}
+
+  // Take the file, binning and quantities from FourQubitConfigManager
+  void BeginOfRun();
+  G4bool IsActive() const { return active; }
+
+  // One event, weighted as in PCEStudy: primary quantities by the primary's
+  // weight (/g4cmp/PrimarySampling biased), hit quantities by the hit's
+  // track weight, which carries that weight and any phonon roulette
+  void Fill(const G4PrimaryVertex* vertex,
+	    const std::vector<G4CMPElectrodeHit*>& hits);
+
+  // Add this thread's maps to the shared totals, then reset
+  void EndOfRun();
+
+  // Write and clear the shared totals (master or sequential only); one
+  // file per run, "_run<N>" added after the first
+  static void WriteTotals(G4int runID);
+
+  static const char* QuantityName(Quantity q);		// For the commands
+  static const char* HistogramName(Quantity q);
+
+private:
+  G4int Bin(G4double x, G4double y) const;		// -1 if outside
+
+  G4bool active;
+  FourQubitConfigManager::MapBinning binning;
+  std::vector<std::vector<G4double> > maps;		// Empty if not collected
+};
+
+#endif	/* FourQubitPCEMap_hh */
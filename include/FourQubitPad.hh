@@ -35,6 +35,7 @@
 //#include "G4PVPlacement.hh"
 #include "FourQubitDetectorParameters.hh"
 #include "globals.hh"
+#include "FourQubitSubVolume.hh"
 
 class G4VPhysicalVolume;
 class G4LogicalVolume;
@@ -71,7 +72,7 @@ class FourQubitPad
 		      G4int pCopyNo,
 		      G4bool pSurfChk=false);
   
-    std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > GetListOfAllFundamentalSubVolumes();
+    const FourQubitSubVolumeList& GetListOfAllFundamentalSubVolumes() const;
   
   protected:
 
@@ -80,7 +81,7 @@ class FourQubitPad
     //The final G4PVPlacement
     G4LogicalVolume * fLog_output;
     G4VPhysicalVolume * fPhys_output;
-    std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > fFundamentalVolumeList; //List of all fundamental sub-volumes in the pad
+    FourQubitSubVolumeList fFundamentalVolumeList; //List of all fundamental sub-volumes in the pad
 
   
   
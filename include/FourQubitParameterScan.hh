@@ -0,0 +1,57 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitParameterScan_hh
+#define FourQubitParameterScan_hh 1
+
+// $Id$
+// File:  FourQubitParameterScan.hh
+//
+// Description:	Batch driver for "FourQubit -s scanFile macro".  The scan
+//		file lists parameter points, each a "point <tag>" line
+//		followed by "name value [unit]" geometry parameter lines
+//		('#' starts a comment):
+//
+//		  point gap20
+//		  dp_qubitGapWidth 20 um
+//		  point gap30
+//		  dp_qubitGapWidth 30 um
+//
+//		For every point the parameters are reset to their defaults,
+//		the point's values applied, and the macro executed with the
+//		point's tag on every output file (/g4cmp/OutputTag).  Physics
+//		tables and lattices stay loaded in the one process; only the
+//		geometry is rebuilt between points.
+
+#include "globals.hh"
+#include <utility>
+#include <vector>
+
+
+class FourQubitParameterScan {
+public:
+  FourQubitParameterScan(const G4String& scanFile);
+  ~FourQubitParameterScan() {;}
+
+  G4bool IsValid() const { return valid; }
+  size_t GetNumberOfPoints() const { return points.size(); }
+
+  // Execute the macro once per point; returns the number of points skipped
+  G4int Run(const G4String& macroName);
+
+private:
+  G4bool Load(const G4String& scanFile);
+  G4bool Apply(size_t index) const;
+
+  struct Point {
+    G4String tag;
+    std::vector<std::pair<G4String,G4String> > values;	// Name, "value [unit]"
+  };
+
+  std::vector<Point> points;
+  G4bool valid;
+};
+
+#endif	/* FourQubitParameterScan_hh */
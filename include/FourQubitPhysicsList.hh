@@ -0,0 +1,34 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitPhysicsList_hh
+#define FourQubitPhysicsList_hh 1
+
+// $Id$
+// File:  FourQubitPhysicsList.hh
+//
+// Description:	The physics lists selectable with "FourQubit -p", each
+//		with G4CMPPhysics on top:
+//		  phonon  transportation only, for phonon or charge primaries
+//		  em      G4EmStandardPhysics and G4DecayPhysics (muons, gammas)
+//		  full    FTFP_BERT
+//		The lighter lists skip building tables those runs never use.
+//		Every list has G4StepLimiterPhysics, for the user limits of
+//		the FourQubitRegions.
+
+#include "globals.hh"
+
+class G4VModularPhysicsList;
+
+
+class FourQubitPhysicsList {
+public:
+  static G4bool IsKnown(const G4String& name);
+
+  // New list, owned by the caller (i.e. the run manager); null if unknown
+  static G4VModularPhysicsList* Create(const G4String& name);
+};
+
+#endif	/* FourQubitPhysicsList_hh */
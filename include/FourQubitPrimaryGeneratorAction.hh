@@ -13,12 +13,16 @@
 #define FourQubitPrimaryGeneratorAction_h 1
 
 #include "G4VUserPrimaryGeneratorAction.hh"
+#include "G4ThreeVector.hh"
 #include "globals.hh"
+#include <vector>
 
 
 class G4ParticleGun;
 class G4GeneralParticleSource;
 class G4Event;
+class G4ParticleDefinition;
+class FourQubitVertexBank;
 
 class FourQubitPrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
@@ -30,8 +34,28 @@ public:
     virtual void GeneratePrimaries(G4Event*);
 
   private:
+    // /g4cmp/PrimarySampling stratified or halton: a point in the /gps/pos
+    // box for this event, and the /g4cmp/PrimaryStrata cell it falls in
+    G4int SamplePosition(G4int eventID, G4ThreeVector& pos) const;
+
+    // /g4cmp/PrimarySampling biased: a point in the /gps/pos box, sent into
+    // a qubit footprint with probability /g4cmp/PrimaryBiasFraction; returns
+    // the statistical weight that undoes the bias
+    G4double SampleBiasedPosition(G4ThreeVector& pos) const;
+
+    // /g4cmp/VertexBank: the primary for this event, from record eventID
+    // after the earlier runs' records; aborts the run once the bank runs
+    // out, leaving that event without a vertex
+    void GenerateFromBank(G4Event* anEvent);
+
     G4GeneralParticleSource*                fParticleGun;
 
+    // This thread's view of the bank, refreshed when the file name changes
+    const FourQubitVertexBank* fBank;
+    G4String fBankFile;
+    std::vector<G4ParticleDefinition*> fBankParticles;	// By name-table index
+    G4long fPrefetchBegin, fPrefetchEnd;		// Records already requested
+
 };
 
 
@@ -0,0 +1,84 @@
+//
+/// \file FourQubitQubitArray.hh
+/// \brief Definition of the class placing an N x M array of qubit units
+///        with a single G4PVParameterised
+///
+/// Each cell is one whole qubit, as on the hand-built chip: a readout
+/// resonator, its coupler and an Xmon island, in a ground-plane box just
+/// large enough to hold them. The unit is built once and its logical tree
+/// is placed nColumns x nRows times by one G4PVParameterised, so the
+/// geometry holds one copy of its volumes whatever the array size. All
+/// cells share the unit's daughter volumes, so one set of border surfaces
+/// serves all of them. FourQubitSensorTable tells the cells apart by copy
+/// number (see FourQubitSensorTable::AddQubitArray), so qubit IDs count
+/// qubits and sensor IDs count their conductors.
+
+#ifndef FourQubitQubitArray_h
+#define FourQubitQubitArray_h 1
+
+#include "G4ThreeVector.hh"
+#include "G4VPVParameterisation.hh"
+#include "FourQubitSubVolume.hh"
+#include "globals.hh"
+#include <vector>
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+
+/// Cell positions on a regular grid centred on the mother's origin; copy
+/// numbers run along a row first
+class FourQubitArrayParameterisation : public G4VPVParameterisation
+{
+  public:
+    FourQubitArrayParameterisation(G4int nColumns, G4int nRows, G4double pitchX, G4double pitchY);
+    virtual ~FourQubitArrayParameterisation() {;}
+
+    virtual void ComputeTransformation(const G4int copyNo, G4VPhysicalVolume * physVol) const;
+
+    G4ThreeVector GetCellPosition(G4int copyNo) const;
+    G4int GetNumberOfCells() const { return fColumns * fRows; }
+
+  private:
+    G4int fColumns, fRows;
+    G4double fPitchX, fPitchY;
+};
+
+class FourQubitQubitArray
+{
+  public:
+    FourQubitQubitArray(G4int nColumns,
+                        G4int nRows,
+                        G4double pitchX,
+                        G4double pitchY,
+                        G4double gap,			// Used for a pitch <= 0: cell size plus gap
+                        const G4String & pName,
+                        G4LogicalVolume * pMotherLogical,
+                        G4bool pSurfChk=false);
+    ~FourQubitQubitArray();
+
+    //Access functions
+    G4VPhysicalVolume * GetPhysicalVolume(){ return fPhys_output; }
+    G4LogicalVolume * GetLogicalVolume(){ return fLog_output; }
+    std::vector<G4ThreeVector> GetCellPositions() const;
+    G4double GetCellDimX() const { return fCellDimX; }
+    G4double GetCellDimY() const { return fCellDimY; }
+
+    const FourQubitSubVolumeList& GetListOfAllFundamentalSubVolumes() const;
+
+  private:
+    void ConstructQubitUnit(const G4String & pName, G4LogicalVolume * log_unit, G4bool pSurfChk,
+                            std::vector<const FourQubitSubVolumeList *> & pieces);
+    void CheckFit(G4int nColumns, G4int nRows, G4double pitchX, G4double pitchY,
+                  const G4ThreeVector & motherMin, const G4ThreeVector & motherMax) const;
+
+    //The final G4PVParameterised, and the logical tree it repeats
+    G4LogicalVolume * fLog_output;
+    G4VPhysicalVolume * fPhys_output;
+    FourQubitArrayParameterisation * fParameterisation;	// Owned by the arena
+    FourQubitSubVolumeList fFundamentalVolumeList;
+    G4double fCellDimX, fCellDimY;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
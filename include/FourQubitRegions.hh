@@ -0,0 +1,47 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitRegions_hh
+#define FourQubitRegions_hh 1
+
+// $Id$
+// File:  FourQubitRegions.hh
+//
+// Description:	Geant4 regions of the chip geometry, each with its own
+//		production cut and user limits (/g4cmp/RegionCut,
+//		RegionMaxStep, RegionMinEnergy):
+//		  World    the default region: helium and anything not below
+//		  Housing  the copper housing
+//		  Chip     the silicon substrate, where phonons are made
+//		  Films    the ground plane and every film inside it
+//		The regions are found by logical volume name, so they cover
+//		a loaded geometry snapshot as well as a new build.  A
+//		region whose volume is not in the geometry (e.g. no
+//		housing) is left out.  The cuts and limits are set on the
+//		master only; the limits need G4StepLimiterPhysics, which
+//		every FourQubitPhysicsList has, applied to all particles
+//		(phonons, charge carriers and gammas too).
+
+#include "globals.hh"
+
+
+class FourQubitRegions {
+public:
+  enum { kWorld, kHousing, kChip, kFilms, kNumberOfRegions };
+
+  static const char* Name(G4int region);	// "World", "Housing", ...
+  static G4int Find(const G4String& name);	// Any case; -1 if none
+
+  // Regions for the geometry just built, replacing the last build's
+  static void Define();
+
+  // Cuts and limits from FourQubitConfigManager onto the regions; cut
+  // changes are picked up at the next /run/beamOn
+  static void Apply();
+
+  static void Print();		// One line per region on G4cout
+};
+
+#endif	/* FourQubitRegions_hh */
@@ -9,6 +9,7 @@
 #include "G4UnionSolid.hh"
 #include "FourQubitDetectorParameters.hh"
 #include "globals.hh"
+#include "FourQubitSubVolume.hh"
 
 class G4VPhysicalVolume;
 class G4LogicalVolume;
@@ -48,7 +49,7 @@ public:
                           G4int pLines = 6,
                           G4float pLlineLen = 10.0);
 
-  std::vector<std::tuple<std::string, G4String, G4VPhysicalVolume *>> GetListOfAllFundamentalSubVolumes();
+  const FourQubitSubVolumeList& GetListOfAllFundamentalSubVolumes() const;
 
 protected:
 
@@ -58,7 +59,7 @@ private:
   G4VPhysicalVolume *fPhys_output;
   G4ThreeVector fEndVect_output;
 
-  std::vector<std::tuple<std::string, G4String, G4VPhysicalVolume *>> fFundamentalVolumeList;
+  FourQubitSubVolumeList fFundamentalVolumeList;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -36,6 +36,7 @@
 #include "FourQubitDetectorParameters.hh"
 #include "FourQubitPad.hh"
 #include "globals.hh"
+#include "FourQubitSubVolume.hh"
 
 class G4VPhysicalVolume;
 class G4LogicalVolume;
@@ -59,6 +60,17 @@ class FourQubitResonatorAssembly
 					  G4int pCopyNo,
 					  G4bool pSurfChk=false);
   
+    //Place another copy of an already-built assembly: the solids, logical volumes and vis
+    //attributes are shared, and only the top-level G4PVPlacement is new.
+    FourQubitResonatorAssembly(const FourQubitResonatorAssembly * pShared,
+                               G4RotationMatrix * pRot,
+                               const G4ThreeVector & tLate,
+                               const G4String & pName,
+                               G4LogicalVolume * pMotherLogical,
+                               G4bool pMany,
+                               G4int pCopyNo,
+                               G4bool pSurfChk=false);
+  
     //Access functions
     G4VPhysicalVolume * GetPhysicalVolume(){ return fPhys_output; }
     G4LogicalVolume * GetLogicalVolume(){ return fLog_output; }
@@ -73,10 +85,10 @@ class FourQubitResonatorAssembly
 				    G4bool pSurfChk=false);
 
   
-  void MakeResonatorLine(G4String pName, G4LogicalVolume * log_baseNbLayer);
-  void MakeShuntCapacitorCross(G4String pName, G4LogicalVolume * log_baseNbLayer);
+  void MakeResonatorLine(G4String pName, G4LogicalVolume * log_baseNbLayer, G4bool pSurfChk);
+  void MakeShuntCapacitorCross(G4String pName, G4LogicalVolume * log_baseNbLayer, G4bool pSurfChk);
 
-  std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > GetListOfAllFundamentalSubVolumes();
+  const FourQubitSubVolumeList& GetListOfAllFundamentalSubVolumes() const;
   
   protected:
 
@@ -85,7 +97,7 @@ class FourQubitResonatorAssembly
     //The final G4PVPlacement
     G4LogicalVolume * fLog_output;
     G4VPhysicalVolume * fPhys_output;
-    std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > fFundamentalVolumeList; //List of all fundamental sub-volumes in the transmission line. String 1 is "material_description", String 2 should be unique identifier (name of the sub-physical volume)
+    FourQubitSubVolumeList fFundamentalVolumeList; //List of all fundamental sub-volumes in the transmission line. String 1 is "material_description", String 2 should be unique identifier (name of the sub-physical volume)
   
 };
 
@@ -0,0 +1,57 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitRunAction_hh
+#define FourQubitRunAction_hh 1
+
+// $Id$
+// File:  FourQubitRunAction.hh
+//
+// Description:	Run boundaries for the hit and primary output.  Worker (or
+//		sequential) instances open and flush the thread's output in
+//		FourQubitSensitivity; the MT master instance merges the
+//		per-thread shards once all workers have finished the run.
+//		With /g4cmp/HitsFormat root every instance books the ntuples
+//		and G4AnalysisManager does the opening and merging.
+//		FourQubitSteppingAction is told about run boundaries too:
+//		with /g4cmp/StepProfile each thread's step counters are
+//		collected at end of run and the summary printed once, and
+//		/g4cmp/StepTraceFile traces are flushed.  The
+//		/g4cmp/PCEMapFile maps are written once all threads' maps
+//		have been added up (FourQubitPCEMap), and the
+//		/g4cmp/EventTiming summary printed once all threads' events
+//		have been collected (FourQubitEventAction).
+
+#include "G4UserRunAction.hh"
+#include "FourQubitShardMerger.hh"
+
+class G4Run;
+class FourQubitSensitivity;
+class FourQubitSteppingAction;
+class FourQubitEventAction;
+
+
+class FourQubitRunAction : public G4UserRunAction {
+public:
+  FourQubitRunAction();
+  virtual ~FourQubitRunAction() {;}
+
+  virtual void BeginOfRunAction(const G4Run* run);
+  virtual void EndOfRunAction(const G4Run* run);
+
+private:
+  FourQubitSensitivity* GetSensitivity() const;
+  FourQubitSteppingAction* GetSteppingAction() const;
+  FourQubitEventAction* GetEventAction() const;
+  G4bool IsMTMaster() const;
+  void MergeShards();
+
+  FourQubitShardMerger merger;
+  G4bool rootOutput;
+  G4bool hitFiles;		// Not /g4cmp/HitsMode none
+  G4bool profiling;		// /g4cmp/StepProfile for the current run
+};
+
+#endif	/* FourQubitRunAction_hh */
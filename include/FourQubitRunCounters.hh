@@ -0,0 +1,32 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitRunCounters_hh
+#define FourQubitRunCounters_hh 1
+
+// $Id$
+// File:  FourQubitRunCounters.hh
+//
+// Description:	Job-wide step and hit totals, always on, for throughput
+//		reports (FourQubitBench).  FourQubitSteppingAction and
+//		FourQubitSensitivity count in plain per-thread members and
+//		add them here at end of run, so the hot path never touches
+//		shared state.
+
+#include "globals.hh"
+
+
+class FourQubitRunCounters {
+public:
+  static void AddSteps(G4long n);
+  static void AddHits(G4long n);
+
+  // Totals of every thread's finished runs since the last Reset()
+  static G4long GetSteps();
+  static G4long GetHits();
+  static void Reset();
+};
+
+#endif	/* FourQubitRunCounters_hh */
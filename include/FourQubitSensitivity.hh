@@ -7,6 +7,16 @@
 #define FourQubitSensitivity_h 1
 
 #include "G4CMPElectrodeSensitivity.hh"
+#include "FourQubitCheckpoint.hh"
+#include "FourQubitOutputWriter.hh"
+#include "FourQubitPCEMap.hh"
+#include "FourQubitSensorTable.hh"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class G4CMPElectrodeHit;
+class G4PrimaryVertex;
 
 class FourQubitSensitivity final : public G4CMPElectrodeSensitivity {
 public:
@@ -23,20 +33,105 @@ public:
   FourQubitSensitivity(FourQubitSensitivity&&) = delete;
   FourQubitSensitivity& operator=(FourQubitSensitivity&&) = delete;
 
+  virtual void Initialize(G4HCofThisEvent*);
   virtual void EndOfEvent(G4HCofThisEvent*);
 
-  void SetHitOutputFile(const G4String& fn);
-  void SetPrimaryOutputFile(const G4String& fn);
+  // Called from FourQubitRunAction: open this run's output (a per-thread
+  // shard on MT workers), then flush and close it so the master can merge.
+  // The /g4cmp/PCEMapFile maps are started and added to the totals here.
+  // A /g4cmp/ResumeRun run appends to the checkpointed output instead.
+  // FlushOutput() returns once everything so far is on disk, along with
+  // the /g4cmp/EventIndex entries of the events in it.
+  void BeginOfRun();
+  void EndOfRun();
+  void FlushOutput();
+
+  // A nonzero "resumeAt" cuts an existing file back to that many bytes and
+  // appends to it (FourQubitCheckpoint); otherwise the file is replaced
+  void SetHitOutputFile(const G4String& fn, G4long resumeAt=0);
+  void SetPrimaryOutputFile(const G4String& fn, G4long resumeAt=0);
+
+  static G4String ShardFileName(const G4String& fn, G4int threadID);
+
+  // /g4cmp/HitsFormat root: hits and primaries go to two ntuples in one
+  // file through G4AnalysisManager, booked by every FourQubitRunAction.
+  // With /g4cmp/HitsMode event the hit ntuple holds the sensor sums.
+  enum { kHitNtuple=0, kPrimaryNtuple=1 };
+  static void BookNtuples();
+  static G4String RootFileName(G4int runID);
 
 protected:
+  virtual G4bool ProcessHits(G4Step*, G4TouchableHistory*);
   virtual G4bool IsHit(const G4Step*, const G4TouchableHistory*) const;
 
 private:
-  std::ofstream primaryOutput;
-  std::ofstream hitOutput;
+  G4bool WritesShards() const;
+  void Flush(std::string& buffer, FourQubitOutputFile& output);
+  void OpenOutput(FourQubitOutputFile& output, const G4String& fn,
+		  const char* method, G4long resumeAt);
+  void WriteCheckpoint();
+
+  // Text and binary (FourQubitHitFormat.hh) record formatting
+  void WritePrimaryText(G4int runID, G4int eventID, const G4PrimaryVertex* v,
+			G4int flags);
+  void WritePrimaryBinary(G4int runID, G4int eventID, const G4PrimaryVertex* v,
+			  G4int flags);
+  void WriteHitText(G4int runID, G4int eventID, const G4CMPElectrodeHit* hit,
+		    const FourQubitSensorTable::VolumeID& volID);
+  void WriteHitBinary(G4int runID, G4int eventID, const G4CMPElectrodeHit* hit,
+		      const FourQubitSensorTable::VolumeID& volID);
+  void FillPrimaryNtuple(G4int runID, G4int eventID, const G4PrimaryVertex* v,
+			 G4int flags);
+  void FillHitNtuple(G4int runID, G4int eventID, const G4CMPElectrodeHit* hit,
+		     const FourQubitSensorTable::VolumeID& volID);
+
+  // /g4cmp/HitsMode event: the event's hits summed per sensor, written as
+  // one record per sensor hit (FourQubitHitFormat::EventSumRecord)
+  struct SensorSum {
+    G4int sensorID, qubitID;
+    G4int nHits;
+    G4double energy, firstTime, lastTime;
+  };
+  void ResetSensorSums();
+  size_t SensorSumSlot(const FourQubitSensorTable::VolumeID& volID) const;
+  void AddToSensorSums(const G4CMPElectrodeHit* hit,
+		       const FourQubitSensorTable::VolumeID& volID);
+  void WriteSensorSums(G4int runID, G4int eventID);
+
+  const FourQubitSensorTable::VolumeID& HitVolumeID(size_t iHit) const;
+
+  // Particle codes for binary records: index into the header's table
+  void FillParticleTable();
+  G4int ParticleCode(const G4String& name) const;
+
+  FourQubitOutputFile primaryOutput;	// /g4cmp/AsyncOutput, OutputCompression
+  FourQubitOutputFile hitOutput;
   G4String primaryFileName;
   G4String hitFileName;
-  
+
+  std::string primaryBuffer;	// Formatted records waiting to be written
+  std::string hitBuffer;
+  size_t bufferSize;		// Flush threshold, from config
+  G4bool binaryOutput;		// /g4cmp/HitsFormat binary
+  G4bool rootOutput;		// /g4cmp/HitsFormat root
+  G4bool eventSums;		// /g4cmp/HitsMode event
+  G4bool hitFiles;		// Not /g4cmp/HitsMode none
+
+  // Sensor and qubit of each hit in this event's collection, same order
+  std::vector<FourQubitSensorTable::VolumeID> hitVolumeIDs;
+
+  // One slot per sensor, then one per qubit for its hits off every sensor,
+  // then one for hits outside any qubit.  Sized once per run; only the
+  // slots an event touched are written and cleared.
+  std::vector<SensorSum> sensorSums;
+  std::vector<size_t> touchedSums;
+
+  FourQubitPCEMap pceMap;	// /g4cmp/PCEMapFile
+  G4long nHitsThisRun;		// For FourQubitRunCounters
+  FourQubitCheckpoint checkpoint;	// /g4cmp/CheckpointInterval
+
+  std::vector<std::string> particleNames;
+  std::unordered_map<std::string,G4int> particleCodes;
 };
 
 #endif
@@ -0,0 +1,155 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitSensorTable_hh
+#define FourQubitSensorTable_hh 1
+
+// $Id$
+// File:  FourQubitSensorTable.hh
+//
+// Description:	Singleton registry of the qubits placed on the chip, filled
+//		by FourQubitDetectorConstruction while the geometry is built.
+//		Each qubit has an overall footprint, and each of its niobium
+//		sub-volumes is a sensor with its own footprint.  Footprints
+//		are axis-aligned boxes in world coordinates, written to the
+//		geometry description file (/g4cmp/GeometryFile) for analysis.
+//		Every volume belonging to a qubit is also mapped by pointer to
+//		its sensor and qubit IDs, which FourQubitSensitivity writes
+//		into each hit record, and flagged if it matches one of the
+//		/g4cmp/TargetVolumes patterns used to filter hits.  Volumes
+//		merged by FourQubitFlatLayers keep a node map, so a point in
+//		a merged volume resolves to the original volume's IDs.
+//		A FourQubitQubitArray is one parameterised volume whose
+//		cells share their daughters; each cell is a qubit, and the
+//		copy number on the step's touchable picks its IDs.
+
+#include "FourQubitSubVolume.hh"
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4Transform3D.hh"
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+class G4StepPoint;
+class G4VPhysicalVolume;
+class G4VSolid;
+
+
+class FourQubitSensorTable {
+public:
+  static FourQubitSensorTable* Instance();
+
+  struct Footprint {
+    G4int id;			// Qubit or sensor index, from zero
+    G4int qubitID;		// Owning qubit (same as id for qubits)
+    G4String name;
+    G4ThreeVector min, max;
+  };
+
+  typedef FourQubitSubVolumeList SubVolumeList;
+
+  // Per-volume lookup, filled for every volume inside a qubit; -1 if the
+  // volume is not a sensor or not part of any qubit
+  struct VolumeID {
+    G4int sensorID;
+    G4int qubitID;
+    G4bool target;		// Matches /g4cmp/TargetVolumes
+  };
+
+  // Drop everything from the previous geometry build
+  void Clear();
+
+  // Register a qubit component placed as "pv" inside "motherPV", which must
+  // itself sit unrotated in the world; returns the new qubit ID
+  G4int AddQubit(const G4String& name, G4VPhysicalVolume* pv,
+		 const SubVolumeList& subVolumes, G4VPhysicalVolume* motherPV);
+
+  // Register every cell of a FourQubitQubitArray as its own qubit, with
+  // cellPositions (mother frame) in copy-number order; returns the first
+  // qubit ID.  The cells' daughters are walked once, whatever the count.
+  G4int AddQubitArray(const G4String& name, G4VPhysicalVolume* arrayPV,
+		      const SubVolumeList& subVolumes, G4VPhysicalVolume* motherPV,
+		      const std::vector<G4ThreeVector>& cellPositions);
+
+  // One hash lookup, safe to call from worker threads during the run
+  const VolumeID& Find(const G4VPhysicalVolume* pv) const {
+    static const VolumeID none = { -1, -1, false };
+    auto entry = volumeIDs.find(pv);
+    return (entry == volumeIDs.end()) ? none : entry->second;
+  }
+
+  // Merged volumes: the point (world frame, e.g. the post-step position)
+  // picks the union node, then the volume that node was made from
+  const VolumeID& Find(const G4VPhysicalVolume* pv, const G4ThreeVector& pos) const {
+    if (flatVolumes.empty()) return Find(pv);
+    auto flat = flatVolumes.find(pv);
+    return (flat == flatVolumes.end()) ? Find(pv) : FindNode(pv, flat->second, pos);
+  }
+
+  // Full lookup for a hit: array cells by copy number, then merged volumes
+  // by position, then the volume itself
+  VolumeID Find(const G4StepPoint* point) const;
+
+  // One node of a merged solid; toNode takes world points into its frame
+  struct FlatNode {
+    const G4VSolid* solid;
+    G4Transform3D toNode;
+    const G4VPhysicalVolume* original;
+  };
+
+  void AddFlatVolume(const G4VPhysicalVolume* pv, const std::vector<FlatNode>& nodes)
+    { flatVolumes[pv] = nodes; }
+
+  // Flag every physical volume whose name contains one of the patterns;
+  // call after each geometry build, or when the patterns change.  An empty
+  // list turns target selection off.
+  void ResolveTargets(const std::vector<G4String>& patterns);
+  G4bool HasTargets() const { return selectTargets; }
+
+  const std::vector<Footprint>& GetQubits() const { return qubits; }
+  const std::vector<Footprint>& GetSensors() const { return sensors; }
+
+  // Geometry snapshots (FourQubitGeometrySnapshot) save the table with the
+  // volumes and restore it onto the loaded ones.  Array cells and merged
+  // volumes are found by copy number or position, which is not saved.
+  G4bool HasPositionLookups() const { return !arrays.empty() || !flatVolumes.empty(); }
+  const std::unordered_map<const G4VPhysicalVolume*,VolumeID>& GetVolumeIDs() const
+    { return volumeIDs; }
+  void Restore(const std::vector<Footprint>& qubitList,
+	       const std::vector<Footprint>& sensorList,
+	       const std::unordered_map<const G4VPhysicalVolume*,VolumeID>& ids);
+
+  // Geometry description file: one whitespace-separated line per entry,
+  //   qubit|sensor  id  qubitID  name  xMin xMax yMin yMax zMin zMax  [mm]
+  void Write(const G4String& filename) const;
+
+private:
+  FourQubitSensorTable() : selectTargets(false) {;}
+  FourQubitSensorTable(const FourQubitSensorTable&) = delete;
+  FourQubitSensorTable& operator=(const FourQubitSensorTable&) = delete;
+
+  std::vector<Footprint> qubits;
+  std::vector<Footprint> sensors;
+  const VolumeID& FindNode(const G4VPhysicalVolume* pv,
+			   const std::vector<FlatNode>& nodes,
+			   const G4ThreeVector& pos) const;
+
+  std::unordered_map<const G4VPhysicalVolume*,VolumeID> volumeIDs;
+  std::unordered_map<const G4VPhysicalVolume*,std::vector<FlatNode> > flatVolumes;
+
+  // IDs in cell c are firstQubit+c, and firstSensor+c*sensorsPerCell plus
+  // the shared daughter's index within the cell
+  struct QubitArray {
+    G4int firstQubit;
+    G4int firstSensor;
+    G4int sensorsPerCell;
+    std::unordered_map<const G4VPhysicalVolume*,G4int> localSensors;
+  };
+  std::unordered_map<const G4VPhysicalVolume*,QubitArray> arrays;
+  G4bool selectTargets;
+};
+
+#endif	/* FourQubitSensorTable_hh */
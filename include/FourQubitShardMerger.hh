@@ -0,0 +1,35 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitShardMerger_hh
+#define FourQubitShardMerger_hh 1
+
+// $Id$
+// File:  FourQubitShardMerger.hh
+//
+// Description:	Master-thread merge of the per-worker output shards written
+//		by FourQubitSensitivity during an MT run.  Each shard is
+//		already ordered by (run, event); the shards are k-way merged
+//		into the final output file, which is created on the first
+//		run of the job and appended to on later runs.
+
+#include "globals.hh"
+#include <set>
+#include <vector>
+
+
+class FourQubitShardMerger {
+public:
+  FourQubitShardMerger() {;}
+  ~FourQubitShardMerger() {;}
+
+  // Merge all existing shards into "output", then delete the shards
+  void Merge(const G4String& output, const std::vector<G4String>& shards);
+
+private:
+  std::set<G4String> created;	// Output files started during this job
+};
+
+#endif	/* FourQubitShardMerger_hh */
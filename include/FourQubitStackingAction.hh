@@ -0,0 +1,36 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitStackingAction_hh
+#define FourQubitStackingAction_hh 1
+
+// $Id$
+// File:  FourQubitStackingAction.hh
+//
+// Description:	G4CMPStackingAction plus the birth-time half of phonon
+//		culling: new phonons below /g4cmp/PhononCullEnergy, or born
+//		after /g4cmp/PhononCullTime, are never tracked.  Phonons only
+//		lose energy as they decay, so one below the cut can never
+//		make a hit once the cut is at or below the sensors' 2*gap.
+//		FourQubitSteppingAction applies the time cut and the bounce
+//		roulette to tracks already in flight.
+
+#include "G4CMPStackingAction.hh"
+
+
+class FourQubitStackingAction : public G4CMPStackingAction {
+public:
+  FourQubitStackingAction();
+  virtual ~FourQubitStackingAction() {;}
+
+  virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track);
+  virtual void PrepareNewEvent();
+
+private:
+  G4double cullEnergy;		// Settings for the current event; 0 = no cut
+  G4double cullTime;
+};
+
+#endif	/* FourQubitStackingAction_hh */
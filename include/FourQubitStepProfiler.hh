@@ -0,0 +1,89 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitStepProfiler_hh
+#define FourQubitStepProfiler_hh 1
+
+// $Id$
+// File:  FourQubitStepProfiler.hh
+//
+// Description:	Per-thread step counters for /g4cmp/StepProfile.  Each step
+//		is tallied by process, by volume and by particle type (with
+//		the summed step time), and each boundary crossing by its
+//		(pre, post) volume pair, i.e. by border surface.  Keys are
+//		the Geant4 object pointers, interned to dense indices, so no
+//		strings are touched until the end of the run.  Workers add
+//		their counters to a shared total which the master (or the
+//		sequential run action) prints as a summary table.
+
+#include "globals.hh"
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class G4ParticleDefinition;
+class G4Step;
+class G4VPhysicalVolume;
+class G4VProcess;
+
+
+class FourQubitStepProfiler {
+public:
+  FourQubitStepProfiler() {;}
+  ~FourQubitStepProfiler() {;}
+
+  // Hot path, called from FourQubitSteppingAction for every step
+  void Record(const G4Step* step);
+
+  // Add this thread's counters to the shared totals, then reset
+  void EndOfRun();
+
+  // Print and clear the shared totals (master or sequential only)
+  static void PrintSummary();
+
+private:
+  struct Tally {
+    G4long steps;
+    G4double time;
+    Tally() : steps(0), time(0.) {;}
+  };
+
+  // Pointer keys mapped to dense counter indices
+  template <class Key, class Hash=std::hash<Key> >
+  class Interned {
+  public:
+    Tally& operator[](const Key& key) {
+      auto entry = index.emplace(key, keys.size());
+      if (entry.second) { keys.push_back(key); tallies.emplace_back(); }
+      return tallies[entry.first->second];
+    }
+
+    size_t size() const { return keys.size(); }
+    const Key& key(size_t i) const { return keys[i]; }
+    const Tally& tally(size_t i) const { return tallies[i]; }
+    void clear() { index.clear(); keys.clear(); tallies.clear(); }
+
+  private:
+    std::unordered_map<Key,size_t,Hash> index;
+    std::vector<Key> keys;
+    std::vector<Tally> tallies;
+  };
+
+  typedef std::pair<const G4VPhysicalVolume*,const G4VPhysicalVolume*> Border;
+  struct BorderHash {
+    size_t operator()(const Border& b) const {
+      return std::hash<const void*>()(b.first) * 31u
+	+ std::hash<const void*>()(b.second);
+    }
+  };
+
+  Interned<const G4VProcess*> processes;
+  Interned<const G4VPhysicalVolume*> volumes;
+  Interned<Border,BorderHash> borders;
+  Interned<const G4ParticleDefinition*> particles;
+};
+
+#endif	/* FourQubitStepProfiler_hh */
@@ -0,0 +1,104 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitStepTrace_hh
+#define FourQubitStepTrace_hh 1
+
+// $Id$
+// File:  FourQubitStepTrace.hh
+//
+// Description:	Sampled binary step traces for /g4cmp/StepTraceFile, used
+//		by FourQubitSteppingAction::ExportStepInformation.  Events
+//		and tracks are kept with the /g4cmp/StepTraceEventFraction
+//		and /g4cmp/StepTraceTrackFraction probabilities, using a
+//		hash of (run, event, track) so a rerun selects the same
+//		steps.  /g4cmp/StepTraceFilter further restricts the trace
+//		to particles or pre-step volumes matching a name pattern.
+//		Event IDs are numbered as in the hit and primary files
+//		(FourQubitEventInfo::EventNumber), resumed runs included.
+//
+//		Records (FourQubitHitFormat::StepRecord) are packed into a
+//		small ring of blocks on the stepping thread; a writer thread
+//		per recorder drains full blocks to the file, so the stepping
+//		thread only waits if the disk falls a whole ring behind.
+//		Each MT worker writes its own _t<N> file for the whole job.
+
+#include "globals.hh"
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class G4Step;
+class G4Track;
+
+
+class FourQubitStepTrace {
+public:
+  FourQubitStepTrace();
+  ~FourQubitStepTrace();		// Drains the ring and closes the file
+
+  // Pick up the current /g4cmp/StepTrace* settings, opening or closing
+  // the trace file as needed
+  void BeginOfRun(G4int runID);
+
+  // Wait for everything recorded so far to reach the file
+  void EndOfRun();
+
+  G4bool IsActive() const { return out.is_open(); }
+
+  // Apply sampling and filters, then queue a record for the step
+  void Record(const G4Step* step);
+
+private:
+  FourQubitStepTrace(const FourQubitStepTrace&) = delete;
+  FourQubitStepTrace& operator=(const FourQubitStepTrace&) = delete;
+
+  G4bool Open(const G4String& filename);
+  void Close();
+  void BuildNameTable(std::vector<std::string>& names);
+
+  G4bool SampleTrack(const G4Track* track);
+  G4bool MatchesFilter(const void* key, const G4String& name);
+  G4int Code(const void* key, const G4String& name);
+
+  void Submit();			// Hand the current block to the writer
+  void Drain();				// Wait until the writer is idle
+  void WriterLoop();
+
+  // Sampling and filter state
+  G4int runID;
+  G4double eventFraction;
+  G4double trackFraction;
+  std::vector<G4String> filter;
+  G4int lastEventID;
+  G4bool eventSampled;
+  G4bool trackSampled;
+  std::unordered_map<const void*,G4bool> filterCache;
+
+  // Name table codes, looked up by name once per object
+  std::unordered_map<std::string,G4int> nameCodes;
+  std::unordered_map<const void*,G4int> codeCache;
+
+  // Ring of blocks shared with the writer thread
+  G4String fileName;
+  std::ofstream out;
+  size_t blockSize;
+  std::vector<std::string> blocks;
+  size_t current;
+  std::deque<size_t> fullBlocks;
+  std::deque<size_t> freeBlocks;
+  G4bool writing;
+  G4bool stopping;
+  std::mutex ringMutex;
+  std::condition_variable ringCond;
+  std::thread writer;
+};
+
+#endif	/* FourQubitStepTrace_hh */
@@ -7,8 +7,8 @@
 #define FourQubitSteppingAction_hh 1
 
 #include "G4UserSteppingAction.hh"
-
-#include <fstream>
+#include "FourQubitStepProfiler.hh"
+#include "FourQubitStepTrace.hh"
 
 class G4Step;
 
@@ -20,15 +20,51 @@ public:
   virtual ~FourQubitSteppingAction();
   virtual void UserSteppingAction(const G4Step* step);
   void ExportStepInformation( const G4Step * step );
+
+  //Called by FourQubitRunAction on worker (or sequential) threads: pick up
+  ///g4cmp/StepProfile, /g4cmp/StepTrace* and phonon culling settings, then
+  //hand the step counters to the run summary and flush the trace
+  void BeginOfRun( G4int runID );
+  void EndOfRun();
+
+  //Called by FourQubitEventAction: restart the event watchdog's counts
+  void BeginOfEvent();
+
+  //Running counts for this run, for FourQubitEventAction; a track is
+  //counted at its first step
+  G4long GetStepCount() const { return fNSteps; }
+  G4long GetTrackCount() const { return fNTracks; }
   
 private:
 
-  //Step info output file
-  std::ofstream fOutputFile;
-  
-  
-  
-  
+  //Steps and tracks this run, for FourQubitRunCounters
+  G4long fNSteps;
+  G4long fNTracks;
+
+  //Step counters for /g4cmp/StepProfile
+  G4bool fProfiling;
+  FourQubitStepProfiler fProfiler;
+
+  //Sampled binary step trace for /g4cmp/StepTraceFile
+  FourQubitStepTrace fTrace;
+
+  //Phonons in flight: killed after /g4cmp/PhononCullTime, and every
+  ///g4cmp/PhononRouletteBounces reflections kept with probability
+  ///g4cmp/PhononRouletteSurvival, their weight divided by it (0 = off)
+  void CullPhonon( const G4Step * step );
+  G4double fCullTime;
+  G4int fRouletteBounces;
+  G4double fRouletteSurvival;
+
+  //Event watchdog: once an event has taken /g4cmp/EventStepBudget steps or
+  //started /g4cmp/EventTrackBudget tracks (0 = no limit), everything still
+  //waiting to be tracked is dropped and the event flagged
+  void CapEvent( const G4Step * step );
+  G4long fStepBudget;
+  G4long fTrackBudget;
+  G4long fEventFirstStep;
+  G4long fEventFirstTrack;
+  G4bool fEventCapped;
 };
 
 #endif
@@ -9,6 +9,7 @@
 #include "G4UnionSolid.hh"
 #include "FourQubitDetectorParameters.hh"
 #include "globals.hh"
+#include "FourQubitSubVolume.hh"
 
 class G4VPhysicalVolume;
 class G4LogicalVolume;
@@ -45,7 +46,7 @@ class FourQubitStraight
 				   G4bool pSurfChk=false,
            G4float pLength=0.0);
 
-    std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > GetListOfAllFundamentalSubVolumes();  
+    const FourQubitSubVolumeList& GetListOfAllFundamentalSubVolumes() const;  
   
   protected:
 
@@ -54,7 +55,7 @@ class FourQubitStraight
     //The final G4PVPlacement
     G4LogicalVolume * fLog_output;
     G4VPhysicalVolume * fPhys_output;
-    std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > fFundamentalVolumeList;
+    FourQubitSubVolumeList fFundamentalVolumeList;
   
 };
 
@@ -37,6 +37,7 @@
 #include "FourQubitDetectorParameters.hh"
 #include "FourQubitPad.hh"
 #include "globals.hh"
+#include "FourQubitSubVolume.hh"
 
 class G4VPhysicalVolume;
 class G4LogicalVolume;
@@ -73,7 +74,7 @@ class FourQubitStraightFluxLine
 				   G4int pCopyNo,
 				   G4bool pSurfChk=false);
 
-    std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > GetListOfAllFundamentalSubVolumes();
+    const FourQubitSubVolumeList& GetListOfAllFundamentalSubVolumes() const;
     void AddComplexGeometryPadSubVolumesToThisList(FourQubitPad * pad); 
   
   
@@ -84,7 +85,7 @@ class FourQubitStraightFluxLine
     //The final G4PVPlacement
     G4LogicalVolume * fLog_output;
     G4VPhysicalVolume * fPhys_output;
-    std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > fFundamentalVolumeList;
+    FourQubitSubVolumeList fFundamentalVolumeList;
   
 };
 
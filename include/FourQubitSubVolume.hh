@@ -0,0 +1,33 @@
+//
+/// \file FourQubitSubVolume.hh
+/// \brief Definition of the sub-volume list shared by all chip components
+///
+/// Every component lists its fundamental sub-volumes: material tag, unique
+/// name, and physical volume. FourQubitDetectorConstruction makes a border
+/// surface to the chip for each entry, and FourQubitSensorTable treats the
+/// niobium ones as sensors. Components hand the list out by const
+/// reference, so walking it never copies it.
+
+#ifndef FourQubitSubVolume_h
+#define FourQubitSubVolume_h 1
+
+#include "globals.hh"
+#include <tuple>
+#include <vector>
+
+class G4VPhysicalVolume;
+
+/// Which chip/film interface a sub-volume's border surface uses
+enum class FourQubitMaterialTag { Niobium, Vacuum };
+
+typedef std::tuple<FourQubitMaterialTag,G4String,G4VPhysicalVolume*> FourQubitSubVolume;
+typedef std::vector<FourQubitSubVolume> FourQubitSubVolumeList;
+
+inline const char* MaterialTagName(FourQubitMaterialTag tag)
+{
+  return (tag == FourQubitMaterialTag::Niobium) ? "Niobium" : "Vacuum";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -37,6 +37,7 @@
 #include "FourQubitDetectorParameters.hh"
 #include "FourQubitPad.hh"
 #include "globals.hh"
+#include "FourQubitSubVolume.hh"
 
 class G4VPhysicalVolume;
 class G4LogicalVolume;
@@ -74,7 +75,7 @@ class FourQubitTransmissionLine
 				   G4bool pSurfChk=false);
   G4UnionSolid * CreatePieceBasedNbLayer(G4String nameSolid);
   
-  std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > GetListOfAllFundamentalSubVolumes();
+  const FourQubitSubVolumeList& GetListOfAllFundamentalSubVolumes() const;
   void AddComplexGeometryPadSubVolumesToThisList(FourQubitPad * pad);
   
   protected:
@@ -84,7 +85,7 @@ class FourQubitTransmissionLine
     //The final G4PVPlacement
     G4LogicalVolume * fLog_output;
     G4VPhysicalVolume * fPhys_output;
-    std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > fFundamentalVolumeList; //List of all fundamental sub-volumes in the transmission line. String 1 is "material_description", String 2 should be unique identifier (name of the sub-physical volume)
+    FourQubitSubVolumeList fFundamentalVolumeList; //List of all fundamental sub-volumes in the transmission line. String 1 is "material_description", String 2 should be unique identifier (name of the sub-physical volume)
   
   
   
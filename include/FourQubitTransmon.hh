@@ -9,6 +9,7 @@
 #include "G4UnionSolid.hh"
 #include "FourQubitDetectorParameters.hh"
 #include "globals.hh"
+#include "FourQubitSubVolume.hh"
 
 class G4VPhysicalVolume;
 class G4LogicalVolume;
@@ -43,7 +44,7 @@ class FourQubitTransmon
 				   G4int pCopyNo,
 				   G4bool pSurfChk=false);
 
-    std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > GetListOfAllFundamentalSubVolumes();  
+    const FourQubitSubVolumeList& GetListOfAllFundamentalSubVolumes() const;  
   
   protected:
 
@@ -52,7 +53,7 @@ class FourQubitTransmon
     //The final G4PVPlacement
     G4LogicalVolume * fLog_output;
     G4VPhysicalVolume * fPhys_output;
-    std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > fFundamentalVolumeList;
+    FourQubitSubVolumeList fFundamentalVolumeList;
   
 };
 
@@ -0,0 +1,70 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitVertexBank_hh
+#define FourQubitVertexBank_hh 1
+
+// $Id$
+// File:  FourQubitVertexBank.hh
+//
+// Description:	Read-only memory mapping of a pre-sampled vertex file
+//		(/g4cmp/VertexBank; layout in FourQubitHitFormat.hh), shared
+//		by every thread.  Record i belongs to event i, so MT workers
+//		read disjoint slices of the file, one block of event IDs
+//		(/run/eventModulo) at a time, with no locking or coordination.
+//		Pages are read in by the kernel on demand and dropped behind
+//		the readers, so the file may be larger than memory.  Each run
+//		carries on where the previous run with the same bank stopped,
+//		so a second /run/beamOn reads new vertices.
+
+#include "FourQubitHitFormat.hh"
+#include "globals.hh"
+#include <string>
+#include <vector>
+
+
+class FourQubitVertexBank {
+public:
+  // The shared mapping of "filename", replaced if the name differs from the
+  // current one; null (with a warning) if the file is not a vertex bank.
+  // Call between runs, or at the first event of a run: the previous mapping
+  // is released, so no thread may still be reading from it.
+  static const FourQubitVertexBank* Open(const G4String& filename);
+
+  const G4String& GetFileName() const { return fileName; }
+  G4long GetNumberOfRecords() const { return nRecords; }
+  const std::vector<std::string>& GetParticleNames() const { return header.particles; }
+
+  // Copy out record i, in host byte order; false past the end
+  G4bool Read(G4long i, FourQubitHitFormat::VertexRecord& rec) const;
+
+  // Ask the kernel to start reading records [first, first+n) now, so the
+  // event using them does not wait on the disk
+  void Prefetch(G4long first, G4long n) const;
+
+  // Record of the first event of this run: the events of the job's earlier
+  // runs with "filename", 0 if the bank was changed since
+  static G4long GetRunOffset(const G4String& filename);
+
+  // Called by the master once a run of "span" events has ended (for a split
+  // or resumed run, the events of the whole run); nothing if no bank is set
+  static void EndOfRun(const G4String& filename, G4long span);
+
+  ~FourQubitVertexBank();
+
+private:
+  FourQubitVertexBank(const G4String& filename);
+  FourQubitVertexBank(const FourQubitVertexBank&) = delete;
+  FourQubitVertexBank& operator=(const FourQubitVertexBank&) = delete;
+
+  G4String fileName;
+  FourQubitHitFormat::Header header;
+  std::vector<FourQubitHitFormat::FieldInfo> fields;	// For byte swapping
+  const char* base;		// Start of the mapping; null if not usable
+  size_t length;		// Bytes mapped (the whole file)
+  G4long nRecords;
+};
+
+#endif	/* FourQubitVertexBank_hh */
@@ -0,0 +1,42 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitVertexInfo_hh
+#define FourQubitVertexInfo_hh 1
+
+// $Id$
+// File:  FourQubitVertexInfo.hh
+//
+// Description:	Sampling details attached to each primary vertex by
+//		FourQubitPrimaryGeneratorAction, and written alongside the
+//		vertex in the primary output by FourQubitSensitivity.
+
+#include "G4VUserPrimaryVertexInformation.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4ios.hh"
+
+
+class FourQubitVertexInfo : public G4VUserPrimaryVertexInformation {
+public:
+  FourQubitVertexInfo(G4int theStratum) : stratum(theStratum) {;}
+  virtual ~FourQubitVertexInfo() {;}
+
+  // Cell of the /g4cmp/PrimaryStrata grid the vertex was placed in
+  G4int GetStratum() const { return stratum; }
+
+  virtual void Print() const { G4cout << "Stratum " << stratum << G4endl; }
+
+  // -1 if the vertex carries no FourQubitVertexInfo (/g4cmp/PrimarySampling gps)
+  static G4int Stratum(const G4PrimaryVertex* vertex) {
+    const FourQubitVertexInfo* info =
+      dynamic_cast<const FourQubitVertexInfo*>(vertex->GetUserInformation());
+    return info ? info->stratum : -1;
+  }
+
+private:
+  G4int stratum;
+};
+
+#endif	/* FourQubitVertexInfo_hh */
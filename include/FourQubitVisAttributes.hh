@@ -0,0 +1,28 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef FourQubitVisAttributes_hh
+#define FourQubitVisAttributes_hh 1
+
+// $Id$
+// File:  FourQubitVisAttributes.hh
+//
+// Description:	Shared vis attributes for the geometry components: one
+//		visible G4VisAttributes per colour for the whole job,
+//		instead of a new one in every component built.  In a
+//		headless batch job (FourQubitConfigManager::GetHeadless())
+//		none are made, and volumes are left without attributes.
+
+#include "G4Colour.hh"
+
+class G4VisAttributes;
+
+
+namespace FourQubitVisAttributes {
+  // Visible attributes in "colour", or null when headless
+  const G4VisAttributes* Get(const G4Colour& colour);
+}
+
+#endif	/* FourQubitVisAttributes_hh */
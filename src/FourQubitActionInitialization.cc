@@ -6,12 +6,23 @@
 // $Id: 539f524339ae53ad098a07cfa3bebd07784d23dd $
 
 #include "FourQubitActionInitialization.hh"
+#include "FourQubitEventAction.hh"
 #include "FourQubitPrimaryGeneratorAction.hh"
+#include "FourQubitRunAction.hh"
+#include "FourQubitStackingAction.hh"
 #include "FourQubitSteppingAction.hh"
-#include "G4CMPStackingAction.hh"
+
+// The master thread does no event processing; its run action merges the
+// per-thread output shards at the end of each run.
+
+void FourQubitActionInitialization::BuildForMaster() const {
+  SetUserAction(new FourQubitRunAction);
+}
 
 void FourQubitActionInitialization::Build() const {
+  SetUserAction(new FourQubitRunAction);
   SetUserAction(new FourQubitPrimaryGeneratorAction);
-  SetUserAction(new G4CMPStackingAction);
+  SetUserAction(new FourQubitEventAction);
+  SetUserAction(new FourQubitStackingAction);
   SetUserAction(new FourQubitSteppingAction);
 } 
@@ -0,0 +1,78 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitBorderTable.cc
+//
+// Description:	Batched creation and hashed lookup of the chip's border
+//		surfaces.
+
+#include "FourQubitBorderTable.hh"
+#include "G4CMPLogicalBorderSurface.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4ios.hh"
+
+
+FourQubitBorderTable* FourQubitBorderTable::Instance() {
+  static FourQubitBorderTable theTable;
+  return &theTable;
+}
+
+void FourQubitBorderTable::Clear() {
+  pending.clear();
+  created.clear();
+  surfaces.clear();
+  queued.clear();
+}
+
+
+// Components placed from a shared logical tree list the same daughter
+// volumes as the original, so most repeats are caught here
+
+void FourQubitBorderTable::Queue(const G4String& prefix,
+				 G4VPhysicalVolume* from,
+				 const FourQubitSubVolumeList& subVolumes,
+				 G4CMPSurfaceProperty* niobium,
+				 G4CMPSurfaceProperty* vacuum) {
+  pending.reserve(pending.size() + subVolumes.size());
+
+  for (const FourQubitSubVolume& sub : subVolumes) {
+    G4VPhysicalVolume* to = std::get<2>(sub);
+    Border key(from, to);
+    if (surfaces.count(key) || !queued.emplace(key, pending.size()).second)
+      continue;
+
+    Entry border;
+    border.name = prefix + std::get<1>(sub);
+    border.from = from;
+    border.to = to;
+    border.property = (std::get<0>(sub) == FourQubitMaterialTag::Niobium) ? niobium : vacuum;
+    pending.push_back(border);
+  }
+}
+
+size_t FourQubitBorderTable::CreateQueued() {
+  surfaces.reserve(surfaces.size() + pending.size());
+  for (const Entry& border : pending)
+    Create(border.name, border.from, border.to, border.property);
+
+  size_t nMade = pending.size();
+  pending.clear();
+  queued.clear();
+  return nMade;
+}
+
+G4CMPLogicalBorderSurface*
+FourQubitBorderTable::Create(const G4String& name, G4VPhysicalVolume* from,
+			     G4VPhysicalVolume* to,
+			     G4CMPSurfaceProperty* property) {
+  G4CMPLogicalBorderSurface* surface =
+    new G4CMPLogicalBorderSurface(name, from, to, property);
+  surfaces[Border(from, to)] = surface;
+
+  Entry entry = { name, from, to, property };
+  created.push_back(entry);
+  return surface;
+}
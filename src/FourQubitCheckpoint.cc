@@ -0,0 +1,239 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitCheckpoint.cc
+//
+// Description:	Per-thread checkpoints and /g4cmp/ResumeRun.
+
+#include "FourQubitCheckpoint.hh"
+#include "FourQubitConfigManager.hh"
+#include "FourQubitMPI.hh"
+#include "G4MTRunManager.hh"
+#include "G4RunManager.hh"
+#include "G4Threading.hh"
+#include "G4ios.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+
+// Set by Resume() before the run starts and cleared after it ends, so the
+// workers only ever read these
+
+namespace {
+  G4bool resuming = false;
+  G4int eventOffset = 0;
+  std::vector<FourQubitCheckpoint::State> resumeStates;	// By thread ID
+
+  const char* const kCheckpointMagic = "FourQubitCheckpoint";
+  const G4int kCheckpointVersion = 1;
+}
+
+
+FourQubitCheckpoint::FourQubitCheckpoint() : interval(0), sinceLast(0) {;}
+
+G4String FourQubitCheckpoint::FileName(G4int threadID) {
+  G4String name = FourQubitConfigManager::GetCheckpointFile();
+  if (threadID < 0) return name;
+  return FourQubitConfigManager::TaggedFileName(name, "t" + std::to_string(threadID));
+}
+
+
+// Writer
+
+void FourQubitCheckpoint::BeginOfRun(G4int runID, G4int threadID) {
+  interval = FourQubitConfigManager::GetCheckpointInterval();
+  if (interval > 0 && FourQubitConfigManager::GetHitsFormat() == "root") {
+    if (threadID <= 0) {
+      G4Exception("FourQubitCheckpoint::BeginOfRun", "Checkpoint001",
+		  JustWarning, "ROOT output cannot be resumed; no checkpoints written.");
+    }
+    interval = 0;
+  }
+
+  fileName = FileName(threadID);
+  sinceLast = 0;
+
+  const State* resumed = ResumeState(threadID);
+  state = resumed ? *resumed : State();
+  state.runID = runID;
+}
+
+G4bool FourQubitCheckpoint::EndOfEvent(G4int eventID) {
+  state.nEvents++;
+  state.lastEventID = std::max(state.lastEventID, eventID);
+  return (interval > 0 && ++sinceLast >= interval);
+}
+
+// Written to a scratch file first: rename() replaces the old checkpoint in
+// one step, so there is always a complete one on disk
+
+void FourQubitCheckpoint::Write(const G4String& hitFile, G4long hitBytes,
+				const G4String& primaryFile, G4long primaryBytes) {
+  sinceLast = 0;
+  state.hitFile = hitFile;
+  state.hitBytes = hitBytes;
+  state.primaryFile = primaryFile;
+  state.primaryBytes = primaryBytes;
+
+  std::ostringstream engine;
+  G4Random::getTheEngine()->put(engine);
+  state.engine = engine.str();
+
+  G4String scratch = fileName + ".tmp";
+  std::ofstream out(scratch, std::ios_base::trunc);
+  out << kCheckpointMagic << " " << kCheckpointVersion << "\n"
+      << "run " << state.runID << "\n"
+      << "events " << state.nEvents << "\n"
+      << "lastEvent " << state.lastEventID << "\n"
+      << "hits " << state.hitBytes << " " << state.hitFile << "\n"
+      << "primaries " << state.primaryBytes << " " << state.primaryFile << "\n"
+      << "engine\n" << state.engine << "\n";
+  out.close();
+
+  if (!out.good() || std::rename(scratch.c_str(), fileName.c_str()) != 0) {
+    G4ExceptionDescription msg;
+    msg << "Error writing checkpoint " << fileName;
+    G4Exception("FourQubitCheckpoint::Write", "Checkpoint002", JustWarning, msg);
+  }
+}
+
+
+// Reader
+
+namespace {
+  // "<bytes> <filename>", the name running to the end of the line
+  G4bool ReadFileEntry(std::istream& in, const char* key,
+		       G4long& bytes, G4String& name) {
+    std::string word;
+    if (!(in >> word >> bytes) || word != key) return false;
+    std::getline(in, name);
+    if (!name.empty() && name[0] == ' ') name.erase(0, 1);
+    return true;
+  }
+}
+
+G4bool FourQubitCheckpoint::Read(const G4String& filename, State& state) {
+  std::ifstream in(filename);
+  if (!in.good()) return false;
+
+  std::string word;
+  G4int version = 0;
+  if (!(in >> word >> version) || word != kCheckpointMagic ||
+      version != kCheckpointVersion) return false;
+
+  if (!(in >> word >> state.runID) || word != "run" ||
+      !(in >> word >> state.nEvents) || word != "events" ||
+      !(in >> word >> state.lastEventID) || word != "lastEvent" ||
+      !ReadFileEntry(in, "hits", state.hitBytes, state.hitFile) ||
+      !ReadFileEntry(in, "primaries", state.primaryBytes, state.primaryFile) ||
+      !(in >> word) || word != "engine") return false;
+
+  std::ostringstream engine;
+  engine << in.rdbuf();
+  state.engine = engine.str();
+  return !state.engine.empty();
+}
+
+
+// Resumed run
+
+const FourQubitCheckpoint::State* FourQubitCheckpoint::ResumeState(G4int threadID) {
+  size_t i = (threadID < 0) ? 0 : size_t(threadID);
+  if (!resuming || i >= resumeStates.size() || resumeStates[i].runID < 0)
+    return nullptr;
+  return &resumeStates[i];
+}
+
+G4int FourQubitCheckpoint::GetEventOffset() {
+  return resuming ? eventOffset : 0;
+}
+
+void FourQubitCheckpoint::Resume(G4int nEventsTotal) {
+  G4ExceptionDescription msg;
+  if (FourQubitConfigManager::GetHitsFormat() == "root") {
+    msg << "ROOT output cannot be resumed; use /g4cmp/HitsFormat text or binary.";
+    G4Exception("FourQubitCheckpoint::Resume", "Checkpoint003", JustWarning, msg);
+    return;
+  }
+
+  if (FourQubitMPI::GetSize() > 1) {
+    msg << "An MPI job cannot be resumed; rerun the missing ranks' events instead.";
+    G4Exception("FourQubitCheckpoint::Resume", "Checkpoint006", JustWarning, msg);
+    return;
+  }
+
+  G4bool mt = G4Threading::IsMultithreadedApplication();
+  G4int nThreads = mt ? G4MTRunManager::GetMasterRunManager()->GetNumberOfThreads() : 1;
+
+  // Every thread's checkpoint must belong to the same run; a thread with
+  // none starts its files afresh
+  std::vector<State> states(nThreads);
+  G4int runID = -1, lastEventID = -1;
+  G4long nDone = 0;
+  for (G4int i=0; i<nThreads; i++) {
+    G4String fn = FileName(mt ? i : -1);
+    if (!Read(fn, states[i]) || (runID >= 0 && states[i].runID != runID)) {
+      msg.str("");
+      msg << "No usable checkpoint " << fn << "; that thread starts over.";
+      G4Exception("FourQubitCheckpoint::Resume", "Checkpoint004", JustWarning, msg);
+      states[i] = State();
+      continue;
+    }
+    runID = states[i].runID;
+    nDone += states[i].nEvents;
+    lastEventID = std::max(lastEventID, states[i].lastEventID);
+  }
+
+  if (runID < 0) {
+    msg.str("");
+    msg << "No checkpoint found (" << FileName(mt ? 0 : -1) << "); nothing resumed.";
+    G4Exception("FourQubitCheckpoint::Resume", "Checkpoint004", JustWarning, msg);
+    return;
+  }
+
+  if (mt && std::ifstream(FileName(nThreads)).good()) {
+    msg.str("");
+    msg << FileName(nThreads) << " exists: the first job had more threads,"
+	<< " and their events are not resumed.  Use the same /run/numberOfThreads.";
+    G4Exception("FourQubitCheckpoint::Resume", "Checkpoint005", JustWarning, msg);
+  }
+
+  G4long nLeft = nEventsTotal - nDone;
+  G4cout << "FourQubitCheckpoint: run " << runID << " has " << nDone << " of "
+	 << nEventsTotal << " events; " << std::max(nLeft, G4long(0))
+	 << " left to run" << G4endl;
+  if (nLeft <= 0) return;
+
+  // A sequential engine carries on exactly; MT workers are reseeded by the
+  // master each event, so the master gets fresh seeds from the saved states
+  if (!mt) {
+    std::istringstream engine(states[0].engine);
+    G4Random::getTheEngine()->get(engine);
+  } else {
+    std::string all;
+    for (const State& s : states) all += s.engine;
+    size_t hash = std::hash<std::string>()(all);
+    long seeds[3] = { long(hash & 0x7fffffff) | 1,
+		      long((hash >> 31) & 0x7fffffff) | 1, 0 };
+    G4Random::setTheSeeds(seeds);
+  }
+
+  resumeStates = states;
+  eventOffset = lastEventID + 1;
+  resuming = true;
+
+  G4RunManager* runManager = G4RunManager::GetRunManager();
+  runManager->SetRunIDCounter(runID);
+  runManager->BeamOn(G4int(nLeft));
+
+  resuming = false;
+  resumeStates.clear();
+  eventOffset = 0;
+}
@@ -12,11 +12,46 @@
 //		changed via macro commands (see FourQubitConfigMessenger).
 //
 // 20170816  M. Kelsey -- Extract hit filename from G4CMPConfigManager.
+// 20261014  Add output buffer size for per-thread hit writers
+// 20261014  Add hit file format selection (text, binary or ROOT)
+// 20261014  Add geometry description (sensor footprint) filename
+// 20261014  Add target-volume name patterns for hit selection
+// 20261014  Add step profiling switch
+// 20261014  Add sampled step trace settings
+// 20261014  Output filenames no longer rebuild the geometry; defer rebuilds
+// 20261014  Add runtime geometry parameters (FourQubitDetectorParameters)
+// 20261014  Add output tag for parameter-scan points
+// 20261014  Add layout file of extra ground-plane traces
+// 20261014  Add overlap-check switch, check-geometry mode and validation file
+// 20261014  Add hit output mode (every hit, or per-event sensor sums)
+// 20261014  Add in-run PCE map file, binning and quantities; hit mode none
+// 20261014  Add stratified / quasi-random primary position sampling
+// 20261014  Add qubit-biased primary sampling fraction and margin
+// 20261014  Add pre-sampled primary vertex bank file
+// 20261014  Add phonon culling cuts and bounce roulette
+// 20261014  Add per-event timing switch, slowest-event count and heartbeat
+// 20261014  Add event watchdog step and track budgets
+// 20261014  Add checkpoint interval and file
+// 20261014  Tag output names with the MPI rank (FourQubitMPI)
+// 20261014  Add asynchronous output writer and zstd compression
+// 20261014  Add headless batch mode (no visualization)
+// 20261014  Add event index sidecar switch
+// 20261014  Add geometry snapshot directory
+// 20261014  Add per-region production cuts and user limits
 
 #include "FourQubitConfigManager.hh"
 #include "FourQubitConfigMessenger.hh"
+#include "FourQubitDetectorParameters.hh"
+#include "FourQubitMPI.hh"
+#include "FourQubitOutputWriter.hh"
+#include "FourQubitRegions.hh"
+#include "FourQubitSensorTable.hh"
 #include "G4RunManager.hh"
+#include "G4StateManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
 #include <stdlib.h>
+#include <sstream>
 
 
 // Constructor and Singleton Initializer
@@ -31,7 +66,44 @@ FourQubitConfigManager* FourQubitConfigManager::Instance() {
 FourQubitConfigManager::FourQubitConfigManager()
   : Hit_file(getenv("G4CMP_HIT_FILE")?getenv("G4CMP_HIT_FILE"):"FourQubit_hits.txt"),
     Primary_file("FourQubit_primary.txt"),
-    messenger(new FourQubitConfigMessenger(this)) {;}
+    Buffer_size((getenv("G4CMP_OUTPUT_BUFFER_MB")?atoi(getenv("G4CMP_OUTPUT_BUFFER_MB")):16)*1024*1024),
+    Async_output(getenv("G4CMP_ASYNC_OUTPUT")?atoi(getenv("G4CMP_ASYNC_OUTPUT"))!=0:false),
+    Queue_size(size_t(getenv("G4CMP_OUTPUT_QUEUE_MB")?atoi(getenv("G4CMP_OUTPUT_QUEUE_MB")):256)*1024*1024),
+    Output_compression(getenv("G4CMP_OUTPUT_COMPRESSION")?getenv("G4CMP_OUTPUT_COMPRESSION"):"none"),
+    Compression_level(3),
+    Event_index(getenv("G4CMP_EVENT_INDEX")?atoi(getenv("G4CMP_EVENT_INDEX"))!=0:true),
+    Geometry_file(getenv("G4CMP_GEOMETRY_FILE")?getenv("G4CMP_GEOMETRY_FILE"):"FourQubit_geometry.txt"),
+    Hits_format(getenv("G4CMP_HITS_FORMAT")?getenv("G4CMP_HITS_FORMAT"):"text"),
+    Hits_mode(getenv("G4CMP_HITS_MODE")?getenv("G4CMP_HITS_MODE"):"hits"),
+    Step_profile(getenv("G4CMP_STEP_PROFILE")?atoi(getenv("G4CMP_STEP_PROFILE"))!=0:false),
+    Trace_file(getenv("G4CMP_STEP_TRACE")?getenv("G4CMP_STEP_TRACE"):""),
+    Trace_event_fraction(1.), Trace_track_fraction(1.),
+    PCE_file(getenv("G4CMP_PCE_MAP")?getenv("G4CMP_PCE_MAP"):""),
+    PCE_binning({ 50, -5.*mm, 5.*mm, 50, -5.*mm, 5.*mm }),
+    PCE_quantities({ "hitEnergy", "primaryEnergy" }),
+    Primary_sampling(getenv("G4CMP_PRIMARY_SAMPLING")?getenv("G4CMP_PRIMARY_SAMPLING"):"gps"),
+    Primary_strata{ 50, 50, 1 }, Bias_fraction(0.5), Bias_margin(0.),
+    Vertex_bank(getenv("G4CMP_VERTEX_BANK")?getenv("G4CMP_VERTEX_BANK"):""),
+    Cull_energy(0.), Cull_time(0.), Roulette_bounces(0), Roulette_survival(0.5),
+    Event_timing(getenv("G4CMP_EVENT_TIMING")?atoi(getenv("G4CMP_EVENT_TIMING"))!=0:false),
+    Event_slowest(10), Heartbeat_interval(0.),
+    Step_budget(getenv("G4CMP_EVENT_STEP_BUDGET")?atoi(getenv("G4CMP_EVENT_STEP_BUDGET")):0),
+    Track_budget(getenv("G4CMP_EVENT_TRACK_BUDGET")?atoi(getenv("G4CMP_EVENT_TRACK_BUDGET")):0),
+    Checkpoint_interval(getenv("G4CMP_CHECKPOINT_INTERVAL")?atoi(getenv("G4CMP_CHECKPOINT_INTERVAL")):0),
+    Checkpoint_file(getenv("G4CMP_CHECKPOINT_FILE")?getenv("G4CMP_CHECKPOINT_FILE"):"FourQubit_checkpoint.txt"),
+    Layout_file(getenv("G4CMP_LAYOUT_FILE")?getenv("G4CMP_LAYOUT_FILE"):""),
+    Check_overlaps(getenv("G4CMP_CHECK_OVERLAPS")?atoi(getenv("G4CMP_CHECK_OVERLAPS"))!=0:false),
+    Check_geometry(false), Headless(false),
+    Validation_file(getenv("G4CMP_GEOMETRY_VALIDATION")?getenv("G4CMP_GEOMETRY_VALIDATION"):"FourQubit_validated.txt"),
+    Snapshot_dir(getenv("G4CMP_GEOMETRY_SNAPSHOT")?getenv("G4CMP_GEOMETRY_SNAPSHOT"):""),
+    Region_settings({ { 10.*mm, 0., 0. },	// World: helium far from the chip
+		      { 1.*mm, 0., 0. },	// Housing
+		      { 10.*um, 0., 0. },	// Chip: where the phonons come from
+		      { 100.*um, 0., 0. } }),	// Films: far thinner than any cut
+    messenger(new FourQubitConfigMessenger(this)) {
+  if (getenv("G4CMP_GEOMETRY_PARAMS"))
+    FourQubitDetectorParameters::LoadParameterFile(getenv("G4CMP_GEOMETRY_PARAMS"));
+}
 
 FourQubitConfigManager::~FourQubitConfigManager() {
   delete messenger; messenger=0;
@@ -40,6 +112,218 @@ FourQubitConfigManager::~FourQubitConfigManager() {
 
 // Trigger rebuild of geometry if parameters change
 
+// The stores are left in place here; FourQubitDetectorConstruction::Construct
+// cleans them when the rebuild actually happens
+
 void FourQubitConfigManager::UpdateGeometry() {
-  G4RunManager::GetRunManager()->ReinitializeGeometry(true);
+  if (G4StateManager::GetStateManager()->GetCurrentState() != G4State_Idle)
+    return;			// Not built yet; /run/initialize will see the change
+
+  G4RunManager::GetRunManager()->ReinitializeGeometry(false);
+}
+
+
+void FourQubitConfigManager::SetLayoutFile(const G4String& name) {
+  G4String layout = (name == "none") ? G4String() : name;
+  if (layout == Instance()->Layout_file) return;
+
+  Instance()->Layout_file = layout;
+  UpdateGeometry();
+}
+
+
+// Tag goes before the extension, unless the name has none (or the last
+// dot belongs to a directory)
+
+G4String FourQubitConfigManager::TaggedFileName(const G4String& name,
+						const G4String& tag) {
+  if (tag.empty()) return name;
+
+  const G4String zst = ".zst";
+  if (name.size() > zst.size() &&
+      name.compare(name.size()-zst.size(), zst.size(), zst) == 0)
+    return TaggedFileName(name.substr(0, name.size()-zst.size()), tag) + zst;
+
+  size_t dot = name.rfind('.');
+  if (dot == std::string::npos || name.find('/', dot) != std::string::npos)
+    return name + "_" + tag;
+  return G4String(name.substr(0,dot) + "_" + tag + name.substr(dot));
+}
+
+G4String FourQubitConfigManager::Tagged(const G4String& name) {
+  return Tagged(name, FourQubitMPI::GetSize() > 1 ? FourQubitMPI::GetRank() : -1);
+}
+
+G4String FourQubitConfigManager::Tagged(const G4String& name, G4int rank) {
+  if (name.empty() || name == "none") return name;
+  G4String tagged = TaggedFileName(name, Instance()->Output_tag);
+  if (rank >= 0) tagged = TaggedFileName(tagged, "r" + std::to_string(rank));
+  return tagged;
+}
+
+
+// Compressed hit and primary files (FourQubitOutputWriter); ROOT output
+// is compressed by ROOT itself
+
+G4bool FourQubitConfigManager::GetCompressedOutput() {
+  return (Instance()->Output_compression == "zstd" &&
+	  Instance()->Hits_format != "root" &&
+	  FourQubitOutputFile::CompressionAvailable());
+}
+
+G4String FourQubitConfigManager::Compressed(const G4String& name) {
+  if (name.empty() || name == "none" || !GetCompressedOutput()) return name;
+  return name + ".zst";
+}
+
+
+// Name pattern lists: whitespace- or comma-separated, "none" clears
+
+namespace {
+  void SplitPatterns(const G4String& patterns, std::vector<G4String>& list) {
+    list.clear();
+
+    std::string names(patterns);
+    for (char& c : names) if (c == ',') c = ' ';
+    std::istringstream tokens(names);
+    std::string name;
+    while (tokens >> name) {
+      if (name != "none") list.push_back(name);
+    }
+  }
+}
+
+// Target volumes are resolved to volume pointers once, here if the geometry
+// already exists and otherwise when FourQubitDetectorConstruction builds it
+
+void FourQubitConfigManager::SetTargetVolumes(const G4String& patterns) {
+  SplitPatterns(patterns, Instance()->Target_volumes);
+  FourQubitSensorTable::Instance()->ResolveTargets(Instance()->Target_volumes);
+}
+
+void FourQubitConfigManager::SetStepTraceFilter(const G4String& patterns) {
+  SplitPatterns(patterns, Instance()->Trace_filter);
+}
+
+void FourQubitConfigManager::SetPCEMapQuantities(const G4String& names) {
+  SplitPatterns(names, Instance()->PCE_quantities);
+}
+
+
+// Map binning, defaulting to the PCEStudy one (50 x 50 bins over the chip)
+
+void FourQubitConfigManager::SetPCEMapBinning(const G4String& spec) {
+  std::istringstream fields(spec);
+  MapBinning bins;
+  std::string unit = "mm";
+  G4bool good = bool(fields >> bins.nX >> bins.xMin >> bins.xMax
+		     >> bins.nY >> bins.yMin >> bins.yMax);
+  if (good && !(fields >> unit)) unit = "mm";
+  good &= (bins.nX > 0 && bins.nY > 0 && bins.xMax > bins.xMin &&
+	   bins.yMax > bins.yMin && G4UnitDefinition::IsUnitDefined(unit));
+
+  if (!good) {
+    G4ExceptionDescription msg;
+    msg << "Cannot read map binning \"" << spec << "\"; expected"
+	<< " nX xMin xMax nY yMin yMax [unit].";
+    G4Exception("FourQubitConfigManager::SetPCEMapBinning", "Config001",
+		JustWarning, msg, "Binning left unchanged.");
+    return;
+  }
+
+  const G4double scale = G4UnitDefinition::GetValueOf(unit);
+  bins.xMin *= scale; bins.xMax *= scale;
+  bins.yMin *= scale; bins.yMax *= scale;
+  Instance()->PCE_binning = bins;
+}
+
+
+// Strata default to the PCE map's 50 x 50 bins, one layer deep
+
+void FourQubitConfigManager::SetPrimaryStrata(const G4String& counts) {
+  std::istringstream fields(counts);
+  G4int n[3] = { 0, 0, 1 };
+  G4bool good = bool(fields >> n[0] >> n[1]);
+  if (good && !(fields >> n[2])) n[2] = 1;
+  good &= (n[0] > 0 && n[1] > 0 && n[2] > 0);
+
+  if (!good) {
+    G4ExceptionDescription msg;
+    msg << "Cannot read primary strata \"" << counts << "\"; expected nX nY [nZ].";
+    G4Exception("FourQubitConfigManager::SetPrimaryStrata", "Config002",
+		JustWarning, msg, "Strata left unchanged.");
+    return;
+  }
+
+  for (G4int i=0; i<3; i++) Instance()->Primary_strata[i] = n[i];
+}
+
+
+// Region settings are checked here, so that a bad command changes nothing
+
+namespace {
+  G4bool ReadRegionValue(const G4String& spec, const char* category,
+			 const char* defaultUnit, G4int& region, G4double& value) {
+    std::istringstream fields(spec);
+    std::string name, unit;
+    G4bool good = bool(fields >> name >> value);
+    if (good && !(fields >> unit)) unit = defaultUnit;
+    region = FourQubitRegions::Find(name);
+    good &= (region >= 0 && value >= 0. && G4UnitDefinition::IsUnitDefined(unit) &&
+	     G4UnitDefinition::GetCategory(unit) == category);
+
+    if (!good) {
+      G4ExceptionDescription msg;
+      msg << "Cannot read region setting \"" << spec << "\"; expected"
+	  << " World, Housing, Chip or Films, then a " << category << " [unit].";
+      G4Exception("FourQubitConfigManager::ReadRegionValue", "Config003",
+		  JustWarning, msg, "Region left unchanged.");
+      return false;
+    }
+
+    value *= G4UnitDefinition::GetValueOf(unit);
+    return true;
+  }
+}
+
+void FourQubitConfigManager::SetRegionCut(const G4String& spec) {
+  G4int region;
+  G4double cut;
+  if (!ReadRegionValue(spec, "Length", "mm", region, cut)) return;
+  Instance()->Region_settings[region].cut = cut;
+  FourQubitRegions::Apply();
+}
+
+void FourQubitConfigManager::SetRegionMaxStep(const G4String& spec) {
+  G4int region;
+  G4double step;
+  if (!ReadRegionValue(spec, "Length", "mm", region, step)) return;
+  Instance()->Region_settings[region].maxStep = step;
+  FourQubitRegions::Apply();
+}
+
+void FourQubitConfigManager::SetRegionMinEnergy(const G4String& spec) {
+  G4int region;
+  G4double energy;
+  if (!ReadRegionValue(spec, "Energy", "keV", region, energy)) return;
+  Instance()->Region_settings[region].minEnergy = energy;
+  FourQubitRegions::Apply();
+}
+
+
+// Geometry parameters live in FourQubitDetectorParameters; the component
+// classes read them when the geometry is next built
+
+void FourQubitConfigManager::SetGeometryParameter(const G4String& nameValue) {
+  std::istringstream fields(nameValue);
+  std::string name, value;
+  fields >> name;
+  std::getline(fields, value);
+
+  if (FourQubitDetectorParameters::SetParameter(name, value)) UpdateGeometry();
+}
+
+void FourQubitConfigManager::LoadGeometryParameters(const G4String& filename) {
+  FourQubitDetectorParameters::LoadParameterFile(filename);
+  UpdateGeometry();
 }
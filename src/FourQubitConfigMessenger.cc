@@ -10,24 +10,415 @@
 //		FourQubitConfigManager.
 //
 // 20170816  Michael Kelsey
+// 20261014  Add /g4cmp/OutputBufferSize and /g4cmp/HitsFormat
+// 20261014  Add /g4cmp/GeometryFile, /g4cmp/TargetVolumes
+// 20261014  Add /g4cmp/StepProfile
+// 20261014  Add /g4cmp/StepTraceFile and its sampling, filter commands
+// 20261014  Add /g4cmp/GeometryParameter, GeometryParameterFile, ListGeometryParameters
+// 20261014  Add /g4cmp/OutputTag
+// 20261014  Add /g4cmp/LayoutFile
+// 20261014  Add /g4cmp/CheckOverlaps and /g4cmp/GeometryValidationFile
+// 20261014  Add /g4cmp/HitsMode
+// 20261014  Add /g4cmp/PCEMapFile, PCEMapBinning, PCEMapQuantities
+// 20261014  Add /g4cmp/PrimarySampling and /g4cmp/PrimaryStrata
+// 20261014  Add /g4cmp/PrimaryBiasFraction and /g4cmp/PrimaryBiasMargin
+// 20261014  Add /g4cmp/VertexBank
+// 20261014  Add /g4cmp/PhononCullEnergy, PhononCullTime and phonon roulette
+// 20261014  Add /g4cmp/EventTiming, EventTimingSlowest and HeartbeatInterval
+// 20261014  Add /g4cmp/EventStepBudget and /g4cmp/EventTrackBudget
+// 20261014  Add /g4cmp/CheckpointInterval, CheckpointFile and ResumeRun
+// 20261014  Add /g4cmp/BeamOnRanks
+// 20261014  Add /g4cmp/AsyncOutput, OutputQueueSize, OutputCompression, CompressionLevel
+// 20261014  Add /g4cmp/EventIndex
+// 20261014  Add /g4cmp/GeometrySnapshot
+// 20261014  Add /g4cmp/RegionCut, RegionMaxStep and RegionMinEnergy
 
 #include "FourQubitConfigMessenger.hh"
 #include "FourQubitConfigManager.hh"
+#include "FourQubitCheckpoint.hh"
+#include "FourQubitMPI.hh"
+#include "G4UIcmdWithABool.hh"
 #include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "FourQubitDetectorParameters.hh"
+#include "G4ios.hh"
 
 
 // Constructor and destructor
 
 FourQubitConfigMessenger::FourQubitConfigMessenger(FourQubitConfigManager* mgr)
   : G4UImessenger("/g4cmp/", "User configuration for G4CMP phonon example"),
-    theManager(mgr), hitsCmd(0) {
+    theManager(mgr), hitsCmd(0), bufferCmd(0), asyncCmd(0), queueCmd(0),
+    compressionCmd(0), levelCmd(0), indexCmd(0), formatCmd(0), modeCmd(0), geometryCmd(0),
+    targetCmd(0), profileCmd(0), traceCmd(0), traceEventCmd(0), traceTrackCmd(0),
+    traceFilterCmd(0), pceFileCmd(0), pceBinningCmd(0), pceQuantityCmd(0),
+    samplingCmd(0), strataCmd(0), biasFractionCmd(0), biasMarginCmd(0), bankCmd(0),
+    cullEnergyCmd(0), cullTimeCmd(0), rouletteBouncesCmd(0), rouletteSurvivalCmd(0),
+    timingCmd(0), slowestCmd(0), heartbeatCmd(0), stepBudgetCmd(0), trackBudgetCmd(0),
+    checkpointCmd(0), checkpointFileCmd(0), resumeCmd(0), beamOnRanksCmd(0),
+    paramCmd(0), paramFileCmd(0), paramListCmd(0), tagCmd(0), layoutCmd(0), overlapCmd(0), validationCmd(0),
+    snapshotCmd(0), regionCutCmd(0), regionStepCmd(0), regionEnergyCmd(0) {
   hitsCmd = CreateCommand<G4UIcmdWithAString>("HitsFile",
 			      "Set filename for output of phonon hit locations");
+
+  bufferCmd = CreateCommand<G4UIcmdWithAnInteger>("OutputBufferSize",
+			      "Per-thread hit buffer size (MB) before flushing");
+  bufferCmd->SetParameterName("MB", false);
+  bufferCmd->SetRange("MB>0");
+  bufferCmd->AvailableForStates(G4State_PreInit);
+
+  asyncCmd = CreateCommand<G4UIcmdWithABool>("AsyncOutput",
+			      "Write hit and primary files on a separate writer thread");
+  asyncCmd->SetParameterName("async", true);
+  asyncCmd->SetDefaultValue(true);
+  asyncCmd->AvailableForStates(G4State_PreInit);
+
+  queueCmd = CreateCommand<G4UIcmdWithAnInteger>("OutputQueueSize",
+			      "Output (MB) queued for the writer thread before the event loop waits");
+  queueCmd->SetParameterName("MB", false);
+  queueCmd->SetRange("MB>0");
+  queueCmd->AvailableForStates(G4State_PreInit);
+
+  compressionCmd = CreateCommand<G4UIcmdWithAString>("OutputCompression",
+			      "Compress hit and primary files (adds .zst)");
+  compressionCmd->SetParameterName("method", false);
+  compressionCmd->SetCandidates("none zstd");
+  compressionCmd->SetDefaultValue("none");
+  compressionCmd->AvailableForStates(G4State_PreInit);
+
+  levelCmd = CreateCommand<G4UIcmdWithAnInteger>("CompressionLevel",
+			      "zstd compression level, 1 (fastest) to 19");
+  levelCmd->SetParameterName("level", false);
+  levelCmd->SetRange("level>=1 && level<=19");
+  levelCmd->AvailableForStates(G4State_PreInit);
+
+  indexCmd = CreateCommand<G4UIcmdWithABool>("EventIndex",
+			      "Write a .idx of (run, event) offsets beside hit and primary files");
+  indexCmd->SetParameterName("index", true);
+  indexCmd->SetDefaultValue(true);
+  indexCmd->AvailableForStates(G4State_PreInit);
+
+  formatCmd = CreateCommand<G4UIcmdWithAString>("HitsFormat",
+			      "Format of hit and primary output files");
+  formatCmd->SetParameterName("format", false);
+  formatCmd->SetCandidates("text binary root");
+  formatCmd->SetDefaultValue("text");
+  formatCmd->AvailableForStates(G4State_PreInit);
+
+  modeCmd = CreateCommand<G4UIcmdWithAString>("HitsMode",
+			      "Write every hit, one sum per sensor hit in each event, or no hit files");
+  modeCmd->SetParameterName("mode", false);
+  modeCmd->SetCandidates("hits event none");
+  modeCmd->SetDefaultValue("hits");
+  modeCmd->AvailableForStates(G4State_PreInit);
+
+  geometryCmd = CreateCommand<G4UIcmdWithAString>("GeometryFile",
+			      "Set filename for qubit and sensor footprints");
+
+  targetCmd = CreateCommand<G4UIcmdWithAString>("TargetVolumes",
+			      "Only record hits on volumes whose names contain one of these patterns (none = all)");
+  targetCmd->SetParameterName("patterns", false);
+  targetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  targetCmd->SetToBeBroadcasted(false);	// Shared table, resolved on master
+
+  profileCmd = CreateCommand<G4UIcmdWithABool>("StepProfile",
+			      "Count steps by process, volume, border and particle; print at end of run");
+  profileCmd->SetParameterName("enable", true);
+  profileCmd->SetDefaultValue(true);
+  profileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  profileCmd->SetToBeBroadcasted(false);
+
+  traceCmd = CreateCommand<G4UIcmdWithAString>("StepTraceFile",
+			      "Write sampled binary step traces to this file (none = off)");
+  traceCmd->SetParameterName("file", false);
+  traceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  traceCmd->SetToBeBroadcasted(false);
+
+  traceEventCmd = CreateCommand<G4UIcmdWithADouble>("StepTraceEventFraction",
+			      "Fraction of events included in the step trace");
+  traceEventCmd->SetParameterName("fraction", false);
+  traceEventCmd->SetRange("fraction>=0 && fraction<=1");
+  traceEventCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  traceEventCmd->SetToBeBroadcasted(false);
+
+  traceTrackCmd = CreateCommand<G4UIcmdWithADouble>("StepTraceTrackFraction",
+			      "Fraction of tracks in each traced event included in the step trace");
+  traceTrackCmd->SetParameterName("fraction", false);
+  traceTrackCmd->SetRange("fraction>=0 && fraction<=1");
+  traceTrackCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  traceTrackCmd->SetToBeBroadcasted(false);
+
+  traceFilterCmd = CreateCommand<G4UIcmdWithAString>("StepTraceFilter",
+			      "Only trace steps whose particle or volume name contains one of these patterns (none = all)");
+  traceFilterCmd->SetParameterName("patterns", false);
+  traceFilterCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  traceFilterCmd->SetToBeBroadcasted(false);
+
+  pceFileCmd = CreateCommand<G4UIcmdWithAString>("PCEMapFile",
+			      "Accumulate XY maps during the run and write them here (.root or grid; none = off)");
+  pceFileCmd->SetParameterName("file", false);
+  pceFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  pceFileCmd->SetToBeBroadcasted(false);
+
+  pceBinningCmd = CreateCommand<G4UIcmdWithAString>("PCEMapBinning",
+			      "Map binning: nX xMin xMax nY yMin yMax [unit]");
+  pceBinningCmd->SetParameterName("binning", false);
+  pceBinningCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  pceBinningCmd->SetToBeBroadcasted(false);
+
+  pceQuantityCmd = CreateCommand<G4UIcmdWithAString>("PCEMapQuantities",
+			      "Maps to fill: hitEnergy primaryEnergy primaries hits hitEnergyAtHitXY");
+  pceQuantityCmd->SetParameterName("names", false);
+  pceQuantityCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  pceQuantityCmd->SetToBeBroadcasted(false);
+
+  samplingCmd = CreateCommand<G4UIcmdWithAString>("PrimarySampling",
+			      "Primary positions: gps (/gps/pos), or stratified, halton or biased over the /gps/pos box");
+  samplingCmd->SetParameterName("mode", false);
+  samplingCmd->SetCandidates("gps stratified halton biased");
+  samplingCmd->SetDefaultValue("gps");
+  samplingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  samplingCmd->SetToBeBroadcasted(false);
+
+  strataCmd = CreateCommand<G4UIcmdWithAString>("PrimaryStrata",
+			      "Strata of the primary position box: nX nY [nZ]");
+  strataCmd->SetParameterName("counts", false);
+  strataCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  strataCmd->SetToBeBroadcasted(false);
+
+  biasFractionCmd = CreateCommand<G4UIcmdWithADouble>("PrimaryBiasFraction",
+			      "Fraction of biased primaries placed inside the qubit footprints");
+  biasFractionCmd->SetParameterName("fraction", false);
+  biasFractionCmd->SetRange("fraction>=0 && fraction<1");
+  biasFractionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  biasFractionCmd->SetToBeBroadcasted(false);
+
+  biasMarginCmd = CreateCommand<G4UIcmdWithADoubleAndUnit>("PrimaryBiasMargin",
+			      "Widen each qubit footprint by this much for biased primaries");
+  biasMarginCmd->SetParameterName("margin", false);
+  biasMarginCmd->SetRange("margin>=0");
+  biasMarginCmd->SetDefaultUnit("mm");
+  biasMarginCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  biasMarginCmd->SetToBeBroadcasted(false);
+
+  bankCmd = CreateCommand<G4UIcmdWithAString>("VertexBank",
+			      "Take primaries from a binary vertex file instead of GPS (none for GPS)");
+  bankCmd->SetParameterName("file", false);
+  bankCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  bankCmd->SetToBeBroadcasted(false);
+
+  cullEnergyCmd = CreateCommand<G4UIcmdWithADoubleAndUnit>("PhononCullEnergy",
+			      "Do not track phonons below this energy (0 = no cut)");
+  cullEnergyCmd->SetParameterName("energy", false);
+  cullEnergyCmd->SetRange("energy>=0");
+  cullEnergyCmd->SetDefaultUnit("eV");
+  cullEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  cullEnergyCmd->SetToBeBroadcasted(false);
+
+  cullTimeCmd = CreateCommand<G4UIcmdWithADoubleAndUnit>("PhononCullTime",
+			      "Kill phonons after this global time (0 = no cut)");
+  cullTimeCmd->SetParameterName("time", false);
+  cullTimeCmd->SetRange("time>=0");
+  cullTimeCmd->SetDefaultUnit("ns");
+  cullTimeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  cullTimeCmd->SetToBeBroadcasted(false);
+
+  rouletteBouncesCmd = CreateCommand<G4UIcmdWithAnInteger>("PhononRouletteBounces",
+			      "Russian roulette for phonons every this many reflections (0 = off)");
+  rouletteBouncesCmd->SetParameterName("bounces", false);
+  rouletteBouncesCmd->SetRange("bounces>=0");
+  rouletteBouncesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  rouletteBouncesCmd->SetToBeBroadcasted(false);
+
+  rouletteSurvivalCmd = CreateCommand<G4UIcmdWithADouble>("PhononRouletteSurvival",
+			      "Survival probability in each phonon roulette round");
+  rouletteSurvivalCmd->SetParameterName("survival", false);
+  rouletteSurvivalCmd->SetRange("survival>0 && survival<=1");
+  rouletteSurvivalCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  rouletteSurvivalCmd->SetToBeBroadcasted(false);
+
+  timingCmd = CreateCommand<G4UIcmdWithABool>("EventTiming",
+			      "Report per-event time, steps, tracks and hits at end of run");
+  timingCmd->SetParameterName("enable", true);
+  timingCmd->SetDefaultValue(true);
+  timingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  timingCmd->SetToBeBroadcasted(false);
+
+  slowestCmd = CreateCommand<G4UIcmdWithAnInteger>("EventTimingSlowest",
+			      "Number of slowest events listed with /g4cmp/EventTiming");
+  slowestCmd->SetParameterName("n", false);
+  slowestCmd->SetRange("n>=0");
+  slowestCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  slowestCmd->SetToBeBroadcasted(false);
+
+  heartbeatCmd = CreateCommand<G4UIcmdWithADoubleAndUnit>("HeartbeatInterval",
+			      "Print run progress from each thread at this interval (0 = off)");
+  heartbeatCmd->SetParameterName("interval", false);
+  heartbeatCmd->SetRange("interval>=0");
+  heartbeatCmd->SetDefaultUnit("s");
+  heartbeatCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  heartbeatCmd->SetToBeBroadcasted(false);
+
+  stepBudgetCmd = CreateCommand<G4UIcmdWithAnInteger>("EventStepBudget",
+			      "Stop and flag an event after this many steps (0 = no limit)");
+  stepBudgetCmd->SetParameterName("steps", false);
+  stepBudgetCmd->SetRange("steps>=0");
+  stepBudgetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  stepBudgetCmd->SetToBeBroadcasted(false);
+
+  trackBudgetCmd = CreateCommand<G4UIcmdWithAnInteger>("EventTrackBudget",
+			      "Stop and flag an event after this many tracks (0 = no limit)");
+  trackBudgetCmd->SetParameterName("tracks", false);
+  trackBudgetCmd->SetRange("tracks>=0");
+  trackBudgetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  trackBudgetCmd->SetToBeBroadcasted(false);
+
+  checkpointCmd = CreateCommand<G4UIcmdWithAnInteger>("CheckpointInterval",
+			      "Write a checkpoint every this many events on each thread (0 = off)");
+  checkpointCmd->SetParameterName("events", false);
+  checkpointCmd->SetRange("events>=0");
+  checkpointCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  checkpointCmd->SetToBeBroadcasted(false);
+
+  checkpointFileCmd = CreateCommand<G4UIcmdWithAString>("CheckpointFile",
+			      "Checkpoint file name (\"_t<N>\" added per MT worker)");
+  checkpointFileCmd->SetParameterName("file", false);
+  checkpointFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  checkpointFileCmd->SetToBeBroadcasted(false);
+
+  resumeCmd = CreateCommand<G4UIcmdWithAnInteger>("ResumeRun",
+			      "Finish a checkpointed run of this many events in total");
+  resumeCmd->SetParameterName("events", false);
+  resumeCmd->SetRange("events>0");
+  resumeCmd->AvailableForStates(G4State_Idle);
+  resumeCmd->SetToBeBroadcasted(false);
+
+  beamOnRanksCmd = CreateCommand<G4UIcmdWithAnInteger>("BeamOnRanks",
+			      "Run this many events in total, split across the MPI ranks");
+  beamOnRanksCmd->SetParameterName("events", false);
+  beamOnRanksCmd->SetRange("events>=0");
+  beamOnRanksCmd->AvailableForStates(G4State_Idle);
+  beamOnRanksCmd->SetToBeBroadcasted(false);
+
+  paramCmd = CreateCommand<G4UIcmdWithAString>("GeometryParameter",
+			      "Set a geometry parameter: name value [unit], or name default");
+  paramCmd->SetParameterName("nameValue", false);
+  paramCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  paramCmd->SetToBeBroadcasted(false);
+
+  paramFileCmd = CreateCommand<G4UIcmdWithAString>("GeometryParameterFile",
+			      "Read geometry parameters from a file of name value [unit] lines");
+  paramFileCmd->SetParameterName("file", false);
+  paramFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  paramFileCmd->SetToBeBroadcasted(false);
+
+  paramListCmd = CreateCommand<G4UIcmdWithoutParameter>("ListGeometryParameters",
+			      "Print all geometry parameters and their current values");
+  paramListCmd->SetToBeBroadcasted(false);
+
+  tagCmd = CreateCommand<G4UIcmdWithAString>("OutputTag",
+			      "Add _tag to every output filename (none to remove)");
+  tagCmd->SetParameterName("tag", false);
+  tagCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  tagCmd->SetToBeBroadcasted(false);
+
+  layoutCmd = CreateCommand<G4UIcmdWithAString>("LayoutFile",
+			      "Add the ground-plane traces listed in a layout file (none to remove)");
+  layoutCmd->SetParameterName("file", false);
+  layoutCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  layoutCmd->SetToBeBroadcasted(false);
+
+  overlapCmd = CreateCommand<G4UIcmdWithABool>("CheckOverlaps",
+			      "Check every volume for overlaps as it is placed (slow; see --check-geometry)");
+  overlapCmd->SetParameterName("check", true);
+  overlapCmd->SetDefaultValue(true);
+  overlapCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  overlapCmd->SetToBeBroadcasted(false);
+
+  validationCmd = CreateCommand<G4UIcmdWithAString>("GeometryValidationFile",
+			      "File of geometry hashes that passed --check-geometry (none = no warning)");
+  validationCmd->SetParameterName("file", false);
+  validationCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  validationCmd->SetToBeBroadcasted(false);
+
+  snapshotCmd = CreateCommand<G4UIcmdWithAString>("GeometrySnapshot",
+			      "Directory of saved geometries, loaded instead of building (none = always build)");
+  snapshotCmd->SetParameterName("dir", false);
+  snapshotCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  snapshotCmd->SetToBeBroadcasted(false);
+
+  regionCutCmd = CreateCommand<G4UIcmdWithAString>("RegionCut",
+			      "Production cut of a region: World, Housing, Chip or Films, value [unit]");
+  regionCutCmd->SetParameterName("spec", false);
+  regionCutCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  regionCutCmd->SetToBeBroadcasted(false);
+
+  regionStepCmd = CreateCommand<G4UIcmdWithAString>("RegionMaxStep",
+			      "Longest step in a region: region value [unit] (0 = no limit)");
+  regionStepCmd->SetParameterName("spec", false);
+  regionStepCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  regionStepCmd->SetToBeBroadcasted(false);
+
+  regionEnergyCmd = CreateCommand<G4UIcmdWithAString>("RegionMinEnergy",
+			      "Kill tracks below this energy in a region, phonons too: region value [unit] (0 = off)");
+  regionEnergyCmd->SetParameterName("spec", false);
+  regionEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  regionEnergyCmd->SetToBeBroadcasted(false);
 }
 
 
 FourQubitConfigMessenger::~FourQubitConfigMessenger() {
   delete hitsCmd; hitsCmd=0;
+  delete bufferCmd; bufferCmd=0;
+  delete asyncCmd; asyncCmd=0;
+  delete queueCmd; queueCmd=0;
+  delete compressionCmd; compressionCmd=0;
+  delete levelCmd; levelCmd=0;
+  delete indexCmd; indexCmd=0;
+  delete formatCmd; formatCmd=0;
+  delete modeCmd; modeCmd=0;
+  delete geometryCmd; geometryCmd=0;
+  delete targetCmd; targetCmd=0;
+  delete profileCmd; profileCmd=0;
+  delete traceCmd; traceCmd=0;
+  delete traceEventCmd; traceEventCmd=0;
+  delete traceTrackCmd; traceTrackCmd=0;
+  delete traceFilterCmd; traceFilterCmd=0;
+  delete pceFileCmd; pceFileCmd=0;
+  delete pceBinningCmd; pceBinningCmd=0;
+  delete pceQuantityCmd; pceQuantityCmd=0;
+  delete samplingCmd; samplingCmd=0;
+  delete strataCmd; strataCmd=0;
+  delete biasFractionCmd; biasFractionCmd=0;
+  delete biasMarginCmd; biasMarginCmd=0;
+  delete bankCmd; bankCmd=0;
+  delete cullEnergyCmd; cullEnergyCmd=0;
+  delete cullTimeCmd; cullTimeCmd=0;
+  delete rouletteBouncesCmd; rouletteBouncesCmd=0;
+  delete rouletteSurvivalCmd; rouletteSurvivalCmd=0;
+  delete timingCmd; timingCmd=0;
+  delete slowestCmd; slowestCmd=0;
+  delete heartbeatCmd; heartbeatCmd=0;
+  delete stepBudgetCmd; stepBudgetCmd=0;
+  delete trackBudgetCmd; trackBudgetCmd=0;
+  delete checkpointCmd; checkpointCmd=0;
+  delete checkpointFileCmd; checkpointFileCmd=0;
+  delete resumeCmd; resumeCmd=0;
+  delete beamOnRanksCmd; beamOnRanksCmd=0;
+  delete paramCmd; paramCmd=0;
+  delete paramFileCmd; paramFileCmd=0;
+  delete paramListCmd; paramListCmd=0;
+  delete tagCmd; tagCmd=0;
+  delete layoutCmd; layoutCmd=0;
+  delete overlapCmd; overlapCmd=0;
+  delete validationCmd; validationCmd=0;
+  delete snapshotCmd; snapshotCmd=0;
+  delete regionCutCmd; regionCutCmd=0;
+  delete regionStepCmd; regionStepCmd=0;
+  delete regionEnergyCmd; regionEnergyCmd=0;
 }
 
 
@@ -35,4 +426,69 @@ FourQubitConfigMessenger::~FourQubitConfigMessenger() {
 
 void FourQubitConfigMessenger::SetNewValue(G4UIcommand* cmd, G4String value) {
   if (cmd == hitsCmd) theManager->SetHitOutput(value);
+  if (cmd == bufferCmd)
+    theManager->SetOutputBufferSize(size_t(StoI(value))*1024*1024);
+  if (cmd == asyncCmd) theManager->SetAsyncOutput(asyncCmd->GetNewBoolValue(value));
+  if (cmd == queueCmd)
+    theManager->SetOutputQueueSize(size_t(StoI(value))*1024*1024);
+  if (cmd == compressionCmd) theManager->SetOutputCompression(value);
+  if (cmd == levelCmd) theManager->SetCompressionLevel(levelCmd->GetNewIntValue(value));
+  if (cmd == indexCmd) theManager->SetEventIndex(indexCmd->GetNewBoolValue(value));
+  if (cmd == formatCmd) theManager->SetHitsFormat(value);
+  if (cmd == modeCmd) theManager->SetHitsMode(value);
+  if (cmd == geometryCmd) theManager->SetGeometryFile(value);
+  if (cmd == targetCmd) theManager->SetTargetVolumes(value);
+  if (cmd == profileCmd)
+    theManager->SetStepProfile(profileCmd->GetNewBoolValue(value));
+  if (cmd == traceCmd) theManager->SetStepTraceFile(value);
+  if (cmd == traceEventCmd)
+    theManager->SetStepTraceEventFraction(traceEventCmd->GetNewDoubleValue(value));
+  if (cmd == traceTrackCmd)
+    theManager->SetStepTraceTrackFraction(traceTrackCmd->GetNewDoubleValue(value));
+  if (cmd == traceFilterCmd) theManager->SetStepTraceFilter(value);
+  if (cmd == pceFileCmd) theManager->SetPCEMapFile(value);
+  if (cmd == pceBinningCmd) theManager->SetPCEMapBinning(value);
+  if (cmd == pceQuantityCmd) theManager->SetPCEMapQuantities(value);
+  if (cmd == samplingCmd) theManager->SetPrimarySampling(value);
+  if (cmd == strataCmd) theManager->SetPrimaryStrata(value);
+  if (cmd == biasFractionCmd)
+    theManager->SetPrimaryBiasFraction(biasFractionCmd->GetNewDoubleValue(value));
+  if (cmd == biasMarginCmd)
+    theManager->SetPrimaryBiasMargin(biasMarginCmd->GetNewDoubleValue(value));
+  if (cmd == bankCmd) theManager->SetVertexBank(value);
+  if (cmd == cullEnergyCmd)
+    theManager->SetPhononCullEnergy(cullEnergyCmd->GetNewDoubleValue(value));
+  if (cmd == cullTimeCmd)
+    theManager->SetPhononCullTime(cullTimeCmd->GetNewDoubleValue(value));
+  if (cmd == rouletteBouncesCmd)
+    theManager->SetPhononRouletteBounces(rouletteBouncesCmd->GetNewIntValue(value));
+  if (cmd == rouletteSurvivalCmd)
+    theManager->SetPhononRouletteSurvival(rouletteSurvivalCmd->GetNewDoubleValue(value));
+  if (cmd == timingCmd)
+    theManager->SetEventTiming(timingCmd->GetNewBoolValue(value));
+  if (cmd == slowestCmd)
+    theManager->SetEventTimingSlowest(slowestCmd->GetNewIntValue(value));
+  if (cmd == heartbeatCmd)
+    theManager->SetHeartbeatInterval(heartbeatCmd->GetNewDoubleValue(value));
+  if (cmd == stepBudgetCmd)
+    theManager->SetEventStepBudget(stepBudgetCmd->GetNewIntValue(value));
+  if (cmd == trackBudgetCmd)
+    theManager->SetEventTrackBudget(trackBudgetCmd->GetNewIntValue(value));
+  if (cmd == checkpointCmd)
+    theManager->SetCheckpointInterval(checkpointCmd->GetNewIntValue(value));
+  if (cmd == checkpointFileCmd) theManager->SetCheckpointFile(value);
+  if (cmd == resumeCmd) FourQubitCheckpoint::Resume(resumeCmd->GetNewIntValue(value));
+  if (cmd == beamOnRanksCmd) FourQubitMPI::BeamOn(beamOnRanksCmd->GetNewIntValue(value));
+  if (cmd == paramCmd) theManager->SetGeometryParameter(value);
+  if (cmd == paramFileCmd) theManager->LoadGeometryParameters(value);
+  if (cmd == paramListCmd) FourQubitDetectorParameters::ListParameters(G4cout);
+  if (cmd == tagCmd) theManager->SetOutputTag(value);
+  if (cmd == layoutCmd) theManager->SetLayoutFile(value);
+  if (cmd == overlapCmd)
+    theManager->SetCheckOverlaps(overlapCmd->GetNewBoolValue(value));
+  if (cmd == validationCmd) theManager->SetValidationFile(value);
+  if (cmd == snapshotCmd) theManager->SetGeometrySnapshot(value);
+  if (cmd == regionCutCmd) theManager->SetRegionCut(value);
+  if (cmd == regionStepCmd) theManager->SetRegionMaxStep(value);
+  if (cmd == regionEnergyCmd) theManager->SetRegionMinEnergy(value);
 }
@@ -46,6 +46,8 @@
 #include "FourQubitCornerFluxLine.hh"
 #include "FourQubitPad.hh"
 #include "FourQubitDetectorParameters.hh"
+#include "FourQubitGeometryArena.hh"
+#include "FourQubitVisAttributes.hh"
 
 using namespace FourQubitDetectorParameters;
 
@@ -101,13 +103,11 @@ void FourQubitCornerFluxLine::ConstructCornerFluxLine(G4RotationMatrix * pRot,
   G4NistManager* nist = G4NistManager::Instance();
   G4Material* niobium_mat = nist->FindOrBuildMaterial("G4_Nb");
   G4Material* air_mat = nist->FindOrBuildMaterial("G4_AIR");
-  bool checkOverlaps = true;
+  bool checkOverlaps = pSurfChk;
 
   //Set up the niobium visualization
-  G4VisAttributes* niobium_vis= new G4VisAttributes(G4Colour(0.0,1.0,1.0,0.5));
-  niobium_vis->SetVisibility(true);
-  G4VisAttributes* air_vis= new G4VisAttributes(G4Colour(0.5,0.5,0.5,0.5));
-  air_vis->SetVisibility(true);
+  const G4VisAttributes* niobium_vis= FourQubitVisAttributes::Get(G4Colour(0.0,1.0,1.0,0.5));
+  const G4VisAttributes* air_vis= FourQubitVisAttributes::Get(G4Colour(0.5,0.5,0.5,0.5));
   
 
   
@@ -138,7 +138,7 @@ void FourQubitCornerFluxLine::ConstructCornerFluxLine(G4RotationMatrix * pRot,
 							  pMany,
 							  pCopyNo,
 							  pSurfChk);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",baseNbLayerName,phys_baseNbLayer));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,baseNbLayerName,phys_baseNbLayer));
 
 
 
@@ -151,9 +151,9 @@ void FourQubitCornerFluxLine::ConstructCornerFluxLine(G4RotationMatrix * pRot,
   double cornerFluxLinePadOffsetY = 0.5*dp_cornerFluxLineBaseNbLayerDimY - cornerFluxLinePadCenterOffsetFromTopOrSide;
   double cornerFluxLinePadOffsetX = -0.5*dp_cornerFluxLineBaseNbLayerDimX + cornerFluxLinePadCenterOffsetFromTopOrSide;
   G4String pad1Name = pName + "_FluxLinePad1";
-  G4RotationMatrix * pad1Rot = new G4RotationMatrix();
+  G4RotationMatrix * pad1Rot = FourQubitGeometryArena::Instance()->Rotation();
   pad1Rot->rotateZ(45.*deg);
-  FourQubitPad * pad1 = new FourQubitPad(pad1Rot,
+  FourQubitPad * pad1 = FourQubitGeometryArena::Instance()->Make<FourQubitPad>(pad1Rot,
 							       G4ThreeVector(cornerFluxLinePadOffsetX,cornerFluxLinePadOffsetY,0),
 							       pad1Name,
 							       log_baseNbLayer,
@@ -186,9 +186,9 @@ void FourQubitCornerFluxLine::ConstructCornerFluxLine(G4RotationMatrix * pRot,
 
   G4LogicalVolume * log_curve1Empty = new G4LogicalVolume(solid_curve1Empty,air_mat,curve1NameEmptyLog);  
   G4ThreeVector curve1EmptyWrtBaseLayerCenter(cornerFluxLineCurve1WrtBaseLayerX,cornerFluxLineCurve1WrtBaseLayerY,0.0);
-  G4VPhysicalVolume * curve1Empty = new G4PVPlacement(0,curve1EmptyWrtBaseLayerCenter,log_curve1Empty,curve1NameEmpty,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * curve1Empty = new G4PVPlacement(0,curve1EmptyWrtBaseLayerCenter,log_curve1Empty,curve1NameEmpty,log_baseNbLayer,false,0,checkOverlaps);
   log_curve1Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",curve1NameEmpty,curve1Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,curve1NameEmpty,curve1Empty));
 
 
   //Curve 1, conductor part
@@ -198,9 +198,9 @@ void FourQubitCornerFluxLine::ConstructCornerFluxLine(G4RotationMatrix * pRot,
   G4Tubs * solid_curve1Conductor = new G4Tubs(curve1NameConductorSolid,dp_cornerFluxLineCurveRadius - dp_fluxLineConductorDimX/2.0, dp_cornerFluxLineCurveRadius + dp_fluxLineConductorDimX/2.0,dp_curveEmptyDimZ/2.0,225.0*deg,45.0*deg);
 
   G4LogicalVolume * log_curve1Conductor = new G4LogicalVolume(solid_curve1Conductor,niobium_mat,curve1NameConductorLog);  
-  G4VPhysicalVolume * curve1Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_curve1Conductor,curve1NameConductor,log_curve1Empty,false,0,true);
+  G4VPhysicalVolume * curve1Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_curve1Conductor,curve1NameConductor,log_curve1Empty,false,0,checkOverlaps);
   log_curve1Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",curve1NameConductor,curve1Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,curve1NameConductor,curve1Conductor));
 
 
 
@@ -212,9 +212,9 @@ void FourQubitCornerFluxLine::ConstructCornerFluxLine(G4RotationMatrix * pRot,
 
   G4LogicalVolume * log_horizontalEmpty = new G4LogicalVolume(solid_horizontalEmpty,air_mat,horizontalNameEmptyLog);  
   G4ThreeVector horizontalEmptyWrtCurve1Empty(0.5*dp_cornerFluxLineHorizontalEmptyDimX,-dp_cornerFluxLineCurveRadius,0.0);
-  G4VPhysicalVolume * horizontalEmpty = new G4PVPlacement(0,horizontalEmptyWrtCurve1Empty+curve1EmptyWrtBaseLayerCenter,log_horizontalEmpty,horizontalNameEmpty,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * horizontalEmpty = new G4PVPlacement(0,horizontalEmptyWrtCurve1Empty+curve1EmptyWrtBaseLayerCenter,log_horizontalEmpty,horizontalNameEmpty,log_baseNbLayer,false,0,checkOverlaps);
   log_horizontalEmpty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",horizontalNameEmpty,horizontalEmpty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,horizontalNameEmpty,horizontalEmpty));
 
 
   //Horizontal line, conductor part
@@ -224,9 +224,9 @@ void FourQubitCornerFluxLine::ConstructCornerFluxLine(G4RotationMatrix * pRot,
   G4Box * solid_horizontalConductor = new G4Box(horizontalNameConductorSolid,0.5*dp_cornerFluxLineHorizontalConductorDimX,0.5*dp_cornerFluxLineHorizontalConductorDimY,0.5*dp_cornerFluxLineHorizontalConductorDimZ);
 
   G4LogicalVolume * log_horizontalConductor = new G4LogicalVolume(solid_horizontalConductor,niobium_mat,horizontalNameConductorLog);  
-  G4VPhysicalVolume * horizontalConductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_horizontalConductor,horizontalNameConductor,log_horizontalEmpty,false,0,true);
+  G4VPhysicalVolume * horizontalConductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_horizontalConductor,horizontalNameConductor,log_horizontalEmpty,false,0,checkOverlaps);
   log_horizontalConductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",horizontalNameConductor,horizontalConductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,horizontalNameConductor,horizontalConductor));
 
 
   //Curve 2, empty part
@@ -237,9 +237,9 @@ void FourQubitCornerFluxLine::ConstructCornerFluxLine(G4RotationMatrix * pRot,
 
   G4LogicalVolume * log_curve2Empty = new G4LogicalVolume(solid_curve2Empty,air_mat,curve2NameEmptyLog);  
   G4ThreeVector curve2EmptyWrtHorizontalEmpty(0.5*dp_cornerFluxLineHorizontalEmptyDimX,-dp_cornerFluxLineCurveRadius,0.0);
-  G4VPhysicalVolume * curve2Empty = new G4PVPlacement(0,curve2EmptyWrtHorizontalEmpty+horizontalEmptyWrtCurve1Empty+curve1EmptyWrtBaseLayerCenter,log_curve2Empty,curve2NameEmpty,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * curve2Empty = new G4PVPlacement(0,curve2EmptyWrtHorizontalEmpty+horizontalEmptyWrtCurve1Empty+curve1EmptyWrtBaseLayerCenter,log_curve2Empty,curve2NameEmpty,log_baseNbLayer,false,0,checkOverlaps);
   log_curve2Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",curve2NameEmpty,curve2Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,curve2NameEmpty,curve2Empty));
 
 
 
@@ -250,9 +250,9 @@ void FourQubitCornerFluxLine::ConstructCornerFluxLine(G4RotationMatrix * pRot,
   G4Tubs * solid_curve2Conductor = new G4Tubs(curve2NameConductorSolid,dp_cornerFluxLineCurveRadius - dp_fluxLineConductorDimX/2.0, dp_cornerFluxLineCurveRadius + dp_fluxLineConductorDimX/2.0,dp_curveEmptyDimZ/2.0,0.0*deg,90.0*deg);
 
   G4LogicalVolume * log_curve2Conductor = new G4LogicalVolume(solid_curve2Conductor,niobium_mat,curve2NameConductorLog);  
-  G4VPhysicalVolume * curve2Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_curve2Conductor,curve2NameConductor,log_curve2Empty,false,0,true);
+  G4VPhysicalVolume * curve2Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_curve2Conductor,curve2NameConductor,log_curve2Empty,false,0,checkOverlaps);
   log_curve2Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",curve2NameConductor,curve2Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,curve2NameConductor,curve2Conductor));
 
 
 
@@ -266,9 +266,9 @@ void FourQubitCornerFluxLine::ConstructCornerFluxLine(G4RotationMatrix * pRot,
 
   G4LogicalVolume * log_verticalEmpty = new G4LogicalVolume(solid_verticalEmpty,air_mat,verticalNameEmptyLog);  
   G4ThreeVector verticalEmptyWrtCurve2Empty(dp_cornerFluxLineCurveRadius,-0.5*dp_cornerFluxLineVerticalEmptyDimY,0.0);
-  G4VPhysicalVolume * verticalEmpty = new G4PVPlacement(0,verticalEmptyWrtCurve2Empty+curve2EmptyWrtHorizontalEmpty+horizontalEmptyWrtCurve1Empty+curve1EmptyWrtBaseLayerCenter,log_verticalEmpty,verticalNameEmpty,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * verticalEmpty = new G4PVPlacement(0,verticalEmptyWrtCurve2Empty+curve2EmptyWrtHorizontalEmpty+horizontalEmptyWrtCurve1Empty+curve1EmptyWrtBaseLayerCenter,log_verticalEmpty,verticalNameEmpty,log_baseNbLayer,false,0,checkOverlaps);
   log_verticalEmpty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",verticalNameEmpty,verticalEmpty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,verticalNameEmpty,verticalEmpty));
 
   /*
   std::cout << "---...............^^^^^" << std::endl;
@@ -285,9 +285,9 @@ void FourQubitCornerFluxLine::ConstructCornerFluxLine(G4RotationMatrix * pRot,
   G4Box * solid_verticalConductor = new G4Box(verticalNameConductorSolid,0.5*dp_cornerFluxLineVerticalConductorDimX,0.5*dp_cornerFluxLineVerticalConductorDimY,0.5*dp_cornerFluxLineVerticalConductorDimZ);
 
   G4LogicalVolume * log_verticalConductor = new G4LogicalVolume(solid_verticalConductor,niobium_mat,verticalNameConductorLog);  
-  G4VPhysicalVolume * verticalConductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_verticalConductor,verticalNameConductor,log_verticalEmpty,false,0,true);
+  G4VPhysicalVolume * verticalConductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_verticalConductor,verticalNameConductor,log_verticalEmpty,false,0,checkOverlaps);
   log_verticalConductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",verticalNameConductor,verticalConductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,verticalNameConductor,verticalConductor));
 
 
 
@@ -312,7 +312,7 @@ void FourQubitCornerFluxLine::ConstructCornerFluxLine(G4RotationMatrix * pRot,
   G4Tubs * solid_curve1Empty = new G4Tubs(curve1EmptyNameSolid,dp_resonatorAssemblyCurveSmallestRadius,dp_resonatorAssemblyCurveSmallestRadius + dp_tlCouplingEmptyDimY,dp_curveEmptyDimZ/2.0,180.*deg,90.*deg);
   G4LogicalVolume * log_curve1Empty = new G4LogicalVolume(solid_curve1Empty,air_mat,curve1EmptyNameLog);  
   G4ThreeVector curve1WrtBRCorner(-1*dp_tlCouplingEmptyDimX,0.5*dp_tlCouplingEmptyDimY + dp_resonatorAssemblyBaseNbEdgeBottomDimY + dp_resonatorAssemblyCurveCentralRadius,0.0); //Good for empty or conductor
-  G4VPhysicalVolume * curve1Empty = new G4PVPlacement(0,curve1WrtBRCorner+brCornerOfBaseNbLayer,log_curve1Empty,curve1EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * curve1Empty = new G4PVPlacement(0,curve1WrtBRCorner+brCornerOfBaseNbLayer,log_curve1Empty,curve1EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_curve1Empty->SetVisAttributes(air_vis);
 
 
@@ -332,7 +332,7 @@ void FourQubitCornerFluxLine::ConstructCornerFluxLine(G4RotationMatrix * pRot,
 							     log_baseNbLayer,
 							     false,
 							     0,
-							     true);
+							     checkOverlaps);
   log_fluxLineEmpty->SetVisAttributes(air_vis);
   
   
@@ -353,7 +353,7 @@ void FourQubitCornerFluxLine::ConstructCornerFluxLine(G4RotationMatrix * pRot,
 								 log_fluxLineEmpty,
 								 false,
 								 0,
-								 true);
+								 checkOverlaps);
   log_fluxLineConductor->SetVisAttributes(niobium_vis);  
   */  
   
@@ -370,8 +370,7 @@ void FourQubitCornerFluxLine::ConstructCornerFluxLine(G4RotationMatrix * pRot,
 
   /*
 
-  G4VisAttributes* simpleBoxVisAtt= new G4VisAttributes(G4Colour(1.0,0.647,0.0,0.9));
-  simpleBoxVisAtt->SetVisibility(true);
+  const G4VisAttributes* simpleBoxVisAtt= FourQubitVisAttributes::Get(G4Colour(1.0,0.647,0.0,0.9));
   log_QubitHousing->SetVisAttributes(simpleBoxVisAtt);
   */
 
@@ -382,7 +381,7 @@ void FourQubitCornerFluxLine::ConstructCornerFluxLine(G4RotationMatrix * pRot,
 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > FourQubitCornerFluxLine::GetListOfAllFundamentalSubVolumes()
+const FourQubitSubVolumeList& FourQubitCornerFluxLine::GetListOfAllFundamentalSubVolumes() const
 {
   return fFundamentalVolumeList;
 }
@@ -390,11 +389,7 @@ std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > FourQubitCorne
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 void FourQubitCornerFluxLine::AddComplexGeometryPadSubVolumesToThisList(FourQubitPad * pad)
 {
-  for( int iSubVol = 0; iSubVol < pad->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol){
-    std::tuple<std::string,G4String,G4VPhysicalVolume*> theTuple(std::get<0>(pad->GetListOfAllFundamentalSubVolumes()[iSubVol]),
-								 std::get<1>(pad->GetListOfAllFundamentalSubVolumes()[iSubVol]),
-								 std::get<2>(pad->GetListOfAllFundamentalSubVolumes()[iSubVol]));
-    fFundamentalVolumeList.push_back(theTuple);
-  }
+  const FourQubitSubVolumeList& padVolumes = pad->GetListOfAllFundamentalSubVolumes();
+  fFundamentalVolumeList.insert(fFundamentalVolumeList.end(), padVolumes.begin(), padVolumes.end());
 }
 
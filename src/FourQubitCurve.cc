@@ -22,6 +22,7 @@
 // Includes (specific to this project)
 #include "FourQubitCurve.hh"
 #include "FourQubitDetectorParameters.hh"
+#include "FourQubitVisAttributes.hh"
 
 using namespace FourQubitDetectorParameters;
 
@@ -84,15 +85,12 @@ void FourQubitCurve::ConstructCurve(G4RotationMatrix *pRot,
   G4NistManager *nist = G4NistManager::Instance();
   G4Material *niobium_mat = nist->FindOrBuildMaterial("G4_Nb");
   G4Material *air_mat = nist->FindOrBuildMaterial("G4_AIR");
-  bool checkOverlaps = true;
+  bool checkOverlaps = pSurfChk;
 
   // Set up the visualization
-  G4VisAttributes *niobium_vis = new G4VisAttributes(G4Colour(0.0, 1.0, 1.0, 0.5));
-  niobium_vis->SetVisibility(true);
-  G4VisAttributes *air_vis = new G4VisAttributes(G4Colour(0.5, 0.5, 0.5, 0.5));
-  air_vis->SetVisibility(true);
-  G4VisAttributes *attention_vis = new G4VisAttributes(G4Colour(1.0, 0.0, 0.0, 1.0)); // used for debuging
-  attention_vis->SetVisibility(true);
+  const G4VisAttributes *niobium_vis = FourQubitVisAttributes::Get(G4Colour(0.0, 1.0, 1.0, 0.5));
+  const G4VisAttributes *air_vis = FourQubitVisAttributes::Get(G4Colour(0.5, 0.5, 0.5, 0.5));
+  const G4VisAttributes *attention_vis = FourQubitVisAttributes::Get(G4Colour(1.0, 0.0, 0.0, 1.0)); // used for debuging
 
   //------------------------------------------------------------------------------------------
   // Start with a base layer of niobium into which our objects will fit. We'll return this in the end.
@@ -124,7 +122,7 @@ void FourQubitCurve::ConstructCurve(G4RotationMatrix *pRot,
                                                           pMany,
                                                           pCopyNo,
                                                           pSurfChk);
-  fFundamentalVolumeList.push_back(std::tuple<std::string, G4String, G4VPhysicalVolume *>("Niobium", baseNbLayerName, phys_baseNbLayer));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium, baseNbLayerName, phys_baseNbLayer));
 
   //------------------------------------------------------------------------------------------
   // Curve
@@ -155,9 +153,9 @@ void FourQubitCurve::ConstructCurve(G4RotationMatrix *pRot,
                                                            log_baseNbLayer,
                                                            false,
                                                            0,
-                                                           true);
+                                                           checkOverlaps);
     log_halfCircleEmpty->SetVisAttributes(air_vis);
-    fFundamentalVolumeList.push_back(std::tuple<std::string, G4String, G4VPhysicalVolume *>("Vacuum", halfCircleEmptyName, halfCircleEmpty));
+    fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum, halfCircleEmptyName, halfCircleEmpty));
 
     //------------------------------------------------------
     // HalfCircle (conductor)
@@ -180,9 +178,9 @@ void FourQubitCurve::ConstructCurve(G4RotationMatrix *pRot,
                                                                log_halfCircleEmpty,
                                                                false,
                                                                0,
-                                                               true);
+                                                               checkOverlaps);
     log_halfCircleConductor->SetVisAttributes(niobium_vis);
-    fFundamentalVolumeList.push_back(std::tuple<std::string, G4String, G4VPhysicalVolume *>("Niobium", halfCircleConductorName, halfCircleConductor));
+    fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium, halfCircleConductorName, halfCircleConductor));
 
   
 
@@ -195,7 +193,7 @@ void FourQubitCurve::ConstructCurve(G4RotationMatrix *pRot,
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-std::vector<std::tuple<std::string, G4String, G4VPhysicalVolume *>> FourQubitCurve::GetListOfAllFundamentalSubVolumes()
+const FourQubitSubVolumeList& FourQubitCurve::GetListOfAllFundamentalSubVolumes() const
 {
   return fFundamentalVolumeList;
 }
@@ -46,6 +46,8 @@
 #include "FourQubitCurveFluxLine.hh"
 #include "FourQubitPad.hh"
 #include "FourQubitDetectorParameters.hh"
+#include "FourQubitGeometryArena.hh"
+#include "FourQubitVisAttributes.hh"
 
 using namespace FourQubitDetectorParameters;
 
@@ -72,6 +74,32 @@ FourQubitCurveFluxLine::FourQubitCurveFluxLine(G4RotationMatrix * pRot,
 			    pSurfChk);
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Shared-tree constructor: every daughter of the base Nb layer is the same physical volume in
+// all copies, so the sub-volume list is the original's with only the top volume replaced
+FourQubitCurveFluxLine::FourQubitCurveFluxLine(const FourQubitCurveFluxLine * pShared,
+                                               G4RotationMatrix * pRot,
+                                               const G4ThreeVector & tLate,
+                                               const G4String & pName,
+                                               G4LogicalVolume * pMotherLogical,
+                                               G4bool pMany,
+                                               G4int pCopyNo,
+                                               G4bool pSurfChk)
+{
+  fLog_output = pShared->fLog_output;
+  fPhys_output = new G4PVPlacement(pRot,
+				   tLate,
+				   fLog_output,
+				   pName,
+				   pMotherLogical,
+				   pMany,
+				   pCopyNo,
+				   pSurfChk);
+
+  fFundamentalVolumeList = pShared->fFundamentalVolumeList;
+  fFundamentalVolumeList[0] = FourQubitSubVolume(FourQubitMaterialTag::Niobium,pName,fPhys_output);
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 // Default Constructor
 FourQubitCurveFluxLine::FourQubitCurveFluxLine()
@@ -99,15 +127,12 @@ void FourQubitCurveFluxLine::ConstructCurveFluxLine(G4RotationMatrix * pRot,
   G4NistManager* nist = G4NistManager::Instance();
   G4Material* niobium_mat = nist->FindOrBuildMaterial("G4_Nb");
   G4Material* air_mat = nist->FindOrBuildMaterial("G4_AIR");
-  bool checkOverlaps = true;
+  bool checkOverlaps = pSurfChk;
 
   //Set up the niobium visualization
-  G4VisAttributes* niobium_vis= new G4VisAttributes(G4Colour(0.0,1.0,1.0,0.5));
-  niobium_vis->SetVisibility(true);
-  G4VisAttributes* air_vis= new G4VisAttributes(G4Colour(0.5,0.5,0.5,0.5));
-  air_vis->SetVisibility(true);
-  G4VisAttributes* attention_vis= new G4VisAttributes(G4Colour(1.0,0.0,0.0,1.0));
-  attention_vis->SetVisibility(true);
+  const G4VisAttributes* niobium_vis= FourQubitVisAttributes::Get(G4Colour(0.0,1.0,1.0,0.5));
+  const G4VisAttributes* air_vis= FourQubitVisAttributes::Get(G4Colour(0.5,0.5,0.5,0.5));
+  const G4VisAttributes* attention_vis= FourQubitVisAttributes::Get(G4Colour(1.0,0.0,0.0,1.0));
   
 
 
@@ -138,7 +163,7 @@ void FourQubitCurveFluxLine::ConstructCurveFluxLine(G4RotationMatrix * pRot,
 							  pMany,
 							  pCopyNo,
 							  pSurfChk);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",baseNbLayerName,phys_baseNbLayer));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,baseNbLayerName,phys_baseNbLayer));
 
 
   //------------------------------------------------------------------------------------------
@@ -147,9 +172,9 @@ void FourQubitCurveFluxLine::ConstructCurveFluxLine(G4RotationMatrix * pRot,
   
   //Pad 1:
   G4String pad1Name = pName + "_FluxLinePad1";
-  G4RotationMatrix * pad1Rot = new G4RotationMatrix();
+  G4RotationMatrix * pad1Rot = FourQubitGeometryArena::Instance()->Rotation();
   pad1Rot->rotateZ(90.*deg);
-  FourQubitPad * pad1 = new FourQubitPad(pad1Rot,
+  FourQubitPad * pad1 = FourQubitGeometryArena::Instance()->Make<FourQubitPad>(pad1Rot,
 							       G4ThreeVector(dp_cfluxLinePadOffsetX,dp_cfluxLinePadOffsetY,0),
 							       pad1Name,
 							       log_baseNbLayer,
@@ -188,9 +213,9 @@ void FourQubitCurveFluxLine::ConstructCurveFluxLine(G4RotationMatrix * pRot,
 							     log_baseNbLayer,
 							     false,
 							     0,
-							     true);
+							     checkOverlaps);
   log_fluxLine1Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",fl1NameEmpty,phys_fluxLine1Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,fl1NameEmpty,phys_fluxLine1Empty));
   
   
   G4String fl1NameConductor = pName + "_FluxLine1Conductor";
@@ -210,9 +235,9 @@ void FourQubitCurveFluxLine::ConstructCurveFluxLine(G4RotationMatrix * pRot,
 								 log_fluxLine1Empty,
 								 false,
 								 0,
-								 true);
+								 checkOverlaps);
   log_fluxLine1Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",fl1NameConductor,phys_fluxLine1Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,fl1NameConductor,phys_fluxLine1Conductor));
   
   // Curve  
   //Some mathematical things to help (can't put these in the dp file because they can't be executed as constexpr)
@@ -235,9 +260,9 @@ void FourQubitCurveFluxLine::ConstructCurveFluxLine(G4RotationMatrix * pRot,
                     log_baseNbLayer,
                     false,
                     0,
-                    true);
+                    checkOverlaps);
   log_curve1Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",curve1NameEmpty,phys_curve1Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,curve1NameEmpty,phys_curve1Empty));
 
 
   //Curve, conductor part
@@ -254,9 +279,9 @@ void FourQubitCurveFluxLine::ConstructCurveFluxLine(G4RotationMatrix * pRot,
                     log_curve1Empty,
                     false,
                     0,
-                    true);
+                    checkOverlaps);
   log_curve1Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",curve1NameConductor,phys_curve1Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,curve1NameConductor,phys_curve1Conductor));
 
   // straight 2
   G4String fl2NameEmpty = pName + "_FluxLine2Empty";
@@ -277,9 +302,9 @@ void FourQubitCurveFluxLine::ConstructCurveFluxLine(G4RotationMatrix * pRot,
 							     log_baseNbLayer,
 							     false,
 							     0,
-							     true);
+							     checkOverlaps);
   log_fluxLine2Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",fl2NameEmpty,phys_fluxLine2Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,fl2NameEmpty,phys_fluxLine2Empty));
   
   
   G4String fl2NameConductor = pName + "_FluxLine2Conductor";
@@ -299,9 +324,9 @@ void FourQubitCurveFluxLine::ConstructCurveFluxLine(G4RotationMatrix * pRot,
 								 log_fluxLine2Empty,
 								 false,
 								 0,
-								 true);
+								 checkOverlaps);
   log_fluxLine2Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",fl2NameConductor,phys_fluxLine2Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,fl2NameConductor,phys_fluxLine2Conductor));
   
 
   ///////////////////////////////////////////
@@ -314,8 +339,7 @@ void FourQubitCurveFluxLine::ConstructCurveFluxLine(G4RotationMatrix * pRot,
 
   /*
 
-  G4VisAttributes* simpleBoxVisAtt= new G4VisAttributes(G4Colour(1.0,0.647,0.0,0.9));
-  simpleBoxVisAtt->SetVisibility(true);
+  const G4VisAttributes* simpleBoxVisAtt= FourQubitVisAttributes::Get(G4Colour(1.0,0.647,0.0,0.9));
   log_QubitHousing->SetVisAttributes(simpleBoxVisAtt);
   */
 
@@ -326,7 +350,7 @@ void FourQubitCurveFluxLine::ConstructCurveFluxLine(G4RotationMatrix * pRot,
 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > FourQubitCurveFluxLine::GetListOfAllFundamentalSubVolumes()
+const FourQubitSubVolumeList& FourQubitCurveFluxLine::GetListOfAllFundamentalSubVolumes() const
 {
   return fFundamentalVolumeList;
 }
@@ -334,11 +358,7 @@ std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > FourQubitCurve
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 void FourQubitCurveFluxLine::AddComplexGeometryPadSubVolumesToThisList(FourQubitPad * pad)
 {
-  for( int iSubVol = 0; iSubVol < pad->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol){
-    std::tuple<std::string,G4String,G4VPhysicalVolume*> theTuple(std::get<0>(pad->GetListOfAllFundamentalSubVolumes()[iSubVol]),
-								 std::get<1>(pad->GetListOfAllFundamentalSubVolumes()[iSubVol]),
-								 std::get<2>(pad->GetListOfAllFundamentalSubVolumes()[iSubVol]));
-    fFundamentalVolumeList.push_back(theTuple);
-  }
+  const FourQubitSubVolumeList& padVolumes = pad->GetListOfAllFundamentalSubVolumes();
+  fFundamentalVolumeList.insert(fFundamentalVolumeList.end(), padVolumes.begin(), padVolumes.end());
 }
 
@@ -8,7 +8,14 @@
 //
 
 #include "FourQubitDetectorConstruction.hh"
+#include "FourQubitConfigManager.hh"
+#include "FourQubitEventTimer.hh"
+#include "FourQubitGeometryArena.hh"
+#include "FourQubitGeometryCheck.hh"
+#include "FourQubitGeometrySnapshot.hh"
 #include "FourQubitSensitivity.hh"
+#include "FourQubitSensorTable.hh"
+#include "FourQubitBorderTable.hh"
 #include "FourQubitQubitHousing.hh"
 #include "FourQubitPad.hh"
 #include "FourQubitTransmissionLine.hh"
@@ -16,11 +23,16 @@
 #include "FourQubitCurveFluxLine.hh"
 #include "FourQubitCornerFluxLine.hh"
 #include "FourQubitResonatorAssembly.hh"
+#include "FourQubitQubitArray.hh"
+#include "FourQubitRegions.hh"
 #include "FourQubitTransmon.hh"
 #include "FourQubitXmon.hh"
 #include "FourQubitResonator.hh"
 #include "FourQubitStraight.hh"
 #include "FourQubitCurve.hh"
+#include "FourQubitFlatLayers.hh"
+#include "FourQubitLayout.hh"
+#include "FourQubitVisAttributes.hh"
 
 #include "G4CMPPhononElectrode.hh"
 #include "G4CMPElectrodeSensitivity.hh"
@@ -34,6 +46,7 @@
 #include "G4LatticeLogical.hh"
 #include "G4LatticeManager.hh"
 #include "G4LatticePhysical.hh"
+#include "G4LatticeReader.hh"
 #include "G4CMPLogicalBorderSurface.hh"
 #include "G4LogicalVolume.hh"
 #include "G4LogicalVolumeStore.hh"
@@ -51,6 +64,7 @@
 #include "G4UniformMagField.hh"
 #include "G4UserLimits.hh"
 #include "G4VisAttributes.hh"
+#include <chrono>
 
 using namespace FourQubitDetectorParameters;
 
@@ -59,65 +73,129 @@ using namespace FourQubitDetectorParameters;
 FourQubitDetectorConstruction::FourQubitDetectorConstruction()
     : fLiquidHelium(0), fGermanium(0), fAluminum(0), fTungsten(0),
       fWorldPhys(0),
-      fSuperconductorSensitivity(0), fConstructed(false) { ; }
+      fSuperconductorSensitivity(nullptr), fConstructed(false), fBuildingFlatSource(false) { ; }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 
-FourQubitDetectorConstruction::~FourQubitDetectorConstruction() { ; }
+FourQubitDetectorConstruction::~FourQubitDetectorConstruction()
+{
+   // The physical lattices belong to the lattice manager; the logical ones are ours
+   for (auto &entry : fLogicalLattices)
+      delete entry.second;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 
 G4VPhysicalVolume *FourQubitDetectorConstruction::Construct()
 {
+   const auto start = std::chrono::steady_clock::now();
+
    if (fConstructed)
    {
+      // Forget the previous build's volumes, since a new volume at a freed
+      // address would otherwise be given that volume's lattice. Reset()
+      // deletes the physical lattices it holds; the logical ones were never
+      // registered with it and are kept
+      G4LatticeManager::GetLatticeManager()->Reset();
+      fPhysicalLattices.clear();
+      fLattices.clear();
+
       if (!G4RunManager::IfGeometryHasBeenDestroyed())
       {
-         // Run manager hasn't cleaned volume stores. This code shouldn't execute
+         // Run manager hasn't cleaned volume stores: a deferred rebuild from
+         // FourQubitConfigManager::UpdateGeometry() ends up here
          G4GeometryManager::GetInstance()->OpenGeometry();
          G4PhysicalVolumeStore::GetInstance()->Clean();
          G4LogicalVolumeStore::GetInstance()->Clean();
          G4SolidStore::GetInstance()->Clean();
       }
-      // Have to completely remove all lattices to avoid warning on reconstruction
-      G4LatticeManager::GetLatticeManager()->Reset();
+      // Logical lattices and G4CMPSurfaceProperties are kept: the cached
+      // lattices are registered again against the new volumes in SetupGeometry()
       // Clear all LogicalSurfaces
-      // NOTE: No need to redefine the G4CMPSurfaceProperties
       G4CMPLogicalBorderSurface::CleanSurfaceTable();
+
+      // The previous build's components and rotations, now that no volume refers to them
+      FourQubitGeometryArena::Instance()->Release();
    }
 
+   FourQubitSensorTable::Instance()->Clear();
+   FourQubitBorderTable::Instance()->Clear();
+
    DefineMaterials();
-   SetupGeometry();
+   DefineSurfaces();
+
+   // A saved geometry for these parameters replaces the whole build; a new
+   // build is saved for next time
+   const G4String &snapshotDir = FourQubitConfigManager::GetGeometrySnapshot();
+   std::vector<FourQubitGeometrySnapshot::Lattice> savedLattices;
+   fWorldPhys = 0;
+   if (!snapshotDir.empty())
+      fWorldPhys = FourQubitGeometrySnapshot::Load(snapshotDir,
+                                                   {fSiNbInterface, fSiCopperInterface, fSiVacuumInterface},
+                                                   savedLattices);
+   if (fWorldPhys)
+   {
+      for (const FourQubitGeometrySnapshot::Lattice &lat : savedLattices)
+         RegisterLattice(lat.volume, lat.latticeDir, lat.h, lat.k, lat.l);
+   }
+   else
+   {
+      SetupGeometry();
+      FourQubitGeometryArena::Instance()->Report();
+      if (!snapshotDir.empty())
+         FourQubitGeometrySnapshot::Save(snapshotDir, fWorldPhys, fLattices);
+   }
    fConstructed = true;
 
+   // World, housing, chip and film regions, with the cuts and limits of /g4cmp/RegionCut etc.
+   FourQubitRegions::Define();
+
+   // Qubit and sensor footprints for the analysis, and the volumes selected
+   // by /g4cmp/TargetVolumes for hit filtering (see FourQubitSensorTable)
+   FourQubitSensorTable* sensors = FourQubitSensorTable::Instance();
+   sensors->ResolveTargets(FourQubitConfigManager::GetTargetVolumes());
+   sensors->Write(FourQubitConfigManager::GetGeometryFile());
+
+   // Without placement checks, at least say if this geometry was never checked
+   if (!FourQubitConfigManager::GetCheckOverlaps() && !FourQubitConfigManager::GetCheckGeometry())
+      FourQubitGeometryCheck::WarnIfNotValidated(FourQubitConfigManager::GetValidationFile());
+
+   FourQubitEventTimer::AddGeometryTime(
+       std::chrono::duration<G4double>(std::chrono::steady_clock::now() - start).count());
    return fWorldPhys;
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+// Sensitive detectors are thread-local: every worker (and the master) calls
+// this after Construct(), so each thread gets its own sensitivity object and
+// output stream. Lattices and border surfaces are shared, read-only geometry
+// data and are registered once by the master in SetupGeometry().
+
+void FourQubitDetectorConstruction::ConstructSDandField()
+{
+   G4SDManager *SDman = G4SDManager::GetSDMpointer();
+   if (!fSuperconductorSensitivity.Get())
+   {
+      G4CMPElectrodeSensitivity *sensitivity = new FourQubitSensitivity("PhononElectrode");
+      SDman->AddNewDetector(sensitivity);
+      fSuperconductorSensitivity.Put(sensitivity);
+   }
+   SetSensitiveDetector("SiliconChip_log", fSuperconductorSensitivity.Get());
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 void FourQubitDetectorConstruction::LogicalBorderCreation(auto *ComponentModel,
                                                           G4VPhysicalVolume *PhysicalSiVolume, G4CMPSurfaceProperty *SiNbInterface,
                                                           G4CMPSurfaceProperty *SiVacuumInterface)
 {
-   // Do the logical border creation now
-   for (int iSubVol = 0; iSubVol < ComponentModel->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol)
-   {
-      std::cout << "Sub volume names (to be used for boundaries): " << std::get<1>(ComponentModel->GetListOfAllFundamentalSubVolumes()[iSubVol])
-                << " with material " << std::get<0>(ComponentModel->GetListOfAllFundamentalSubVolumes()[iSubVol]) << std::endl;
+   // Components built for flattening are not in the world; the merged layers get the borders instead
+   if (fBuildingFlatSource)
+      return;
 
-      std::string tempName = "border_siliconChip_" + std::get<1>(ComponentModel->GetListOfAllFundamentalSubVolumes()[iSubVol]);
-      if (std::get<0>(ComponentModel->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Vacuum") != std::string::npos)
-      {
-         G4CMPLogicalBorderSurface *border_siliconChip_Empty = new G4CMPLogicalBorderSurface(tempName, PhysicalSiVolume,
-                                                                                             std::get<2>(ComponentModel->GetListOfAllFundamentalSubVolumes()[iSubVol]), 
-                                                                                             fSiVacuumInterface);
-      }
-      if (std::get<0>(ComponentModel->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Niobium") != std::string::npos)
-      {
-         G4CMPLogicalBorderSurface *border_siliconChip_Conductor = new G4CMPLogicalBorderSurface(tempName, PhysicalSiVolume,
-                                                                                                 std::get<2>(ComponentModel->GetListOfAllFundamentalSubVolumes()[iSubVol]), 
-                                                                                                 fSiNbInterface);
-      }
-   }
+   // Only queued here: SetupGeometry() creates every surface in one pass at the end
+   FourQubitBorderTable::Instance()->Queue("border_siliconChip_", PhysicalSiVolume,
+                                           ComponentModel->GetListOfAllFundamentalSubVolumes(),
+                                           SiNbInterface, SiVacuumInterface);
 }
 
 void FourQubitDetectorConstruction::DefineMaterials()
@@ -133,12 +211,16 @@ void FourQubitDetectorConstruction::DefineMaterials()
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+// Made on the first build and kept through rebuilds
 
-void FourQubitDetectorConstruction::SetupGeometry()
+void FourQubitDetectorConstruction::DefineSurfaces()
 {
+   if (fConstructed)
+      return;
+
    //---------------------------------------------------------------------------------------------------------------------
    //---------------------------------------------------------------------------------------------------------------------
-   // First, define border surface properties that can be referenced later
+   // Border surface properties, referenced by the build or a loaded snapshot
    const G4double GHz = 1e9 * hertz;
 
    // the following coefficients and cutoff values are not well-motivated
@@ -150,28 +232,34 @@ void FourQubitDetectorConstruction::SetupGeometry()
 
    // These are just the definitions of the interface TYPES, not the interfaces themselves. These must be called in a set of loops
    // below, and invoke these surface definitions.
-   if (!fConstructed)
-   {
-      fSiNbInterface = new G4CMPSurfaceProperty("SiNbInterface",
-                                                1.0, 0.0, 0.0, 0.0,
-                                                0.1, 1.0, 0.0, 0.0);
-      fSiCopperInterface = new G4CMPSurfaceProperty("SiCopperInterface",
-                                                    1.0, 0.0, 0.0, 0.0,
-                                                    1.0, 0.0, 0.0, 0.0);
-      fSiVacuumInterface = new G4CMPSurfaceProperty("SiVacuumInterface",
-                                                    0.0, 1.0, 0.0, 0.0,
-                                                    0.0, 1.0, 0.0, 0.0);
-
-      fSiNbInterface->AddScatteringProperties(anhCutoff, reflCutoff, anhCoeffs,
-                                              diffCoeffs, specCoeffs, GHz, GHz, GHz);
-      fSiCopperInterface->AddScatteringProperties(anhCutoff, reflCutoff, anhCoeffs,
-                                                  diffCoeffs, specCoeffs, GHz, GHz, GHz);
-      fSiVacuumInterface->AddScatteringProperties(anhCutoff, reflCutoff, anhCoeffs,
-                                                  diffCoeffs, specCoeffs, GHz, GHz, GHz);
-
-      // Add a phonon sensor to the interface properties here.
-      AttachPhononSensor(fSiNbInterface);
-   }
+   fSiNbInterface = new G4CMPSurfaceProperty("SiNbInterface",
+                                             1.0, 0.0, 0.0, 0.0,
+                                             0.1, 1.0, 0.0, 0.0);
+   fSiCopperInterface = new G4CMPSurfaceProperty("SiCopperInterface",
+                                                 1.0, 0.0, 0.0, 0.0,
+                                                 1.0, 0.0, 0.0, 0.0);
+   fSiVacuumInterface = new G4CMPSurfaceProperty("SiVacuumInterface",
+                                                 0.0, 1.0, 0.0, 0.0,
+                                                 0.0, 1.0, 0.0, 0.0);
+
+   fSiNbInterface->AddScatteringProperties(anhCutoff, reflCutoff, anhCoeffs,
+                                           diffCoeffs, specCoeffs, GHz, GHz, GHz);
+   fSiCopperInterface->AddScatteringProperties(anhCutoff, reflCutoff, anhCoeffs,
+                                               diffCoeffs, specCoeffs, GHz, GHz, GHz);
+   fSiVacuumInterface->AddScatteringProperties(anhCutoff, reflCutoff, anhCoeffs,
+                                               diffCoeffs, specCoeffs, GHz, GHz, GHz);
+
+   // Add a phonon sensor to the interface properties here.
+   AttachPhononSensor(fSiNbInterface);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+
+void FourQubitDetectorConstruction::SetupGeometry()
+{
+   // The component builders and every rotation below belong to the arena, and go with the
+   // volumes at the next rebuild
+   FourQubitGeometryArena* arena = FourQubitGeometryArena::Instance();
 
    //---------------------------------------------------------------------------------------------------------------------
    //---------------------------------------------------------------------------------------------------------------------
@@ -181,7 +269,7 @@ void FourQubitDetectorConstruction::SetupGeometry()
    //
    G4VSolid *solid_world = new G4Box("World", 55. * cm, 55. * cm, 55. * cm);
    G4LogicalVolume *log_world = new G4LogicalVolume(solid_world, fLiquidHelium, "World");
-   //  worldLogical->SetUserLimits(new G4UserLimits(10*mm, DBL_MAX, DBL_MAX, 0, 0));
+   // Production cuts and step limits are set per region (FourQubitRegions) once the build is done
    log_world->SetVisAttributes(G4VisAttributes::Invisible);
    fWorldPhys = new G4PVPlacement(0,
                                   G4ThreeVector(),
@@ -191,7 +279,8 @@ void FourQubitDetectorConstruction::SetupGeometry()
                                   false,
                                   0);
 
-   bool checkOverlaps = true;
+   // Placement checks are off by default; --check-geometry does them all at once afterwards
+   bool checkOverlaps = FourQubitConfigManager::GetCheckOverlaps() && !FourQubitConfigManager::GetCheckGeometry();
 
    //-------------------------------------------------------------------------------------------------------------------
    // First, set up the qubit chip substrate. By default, assume that we're using this. Otherwise, it's hard to establish
@@ -217,40 +306,33 @@ void FourQubitDetectorConstruction::SetupGeometry()
                                                            0,
                                                            checkOverlaps);
 
-   G4VisAttributes *siliconChipVisAtt = new G4VisAttributes(G4Colour(0.5, 0.5, 0.5));
-   siliconChipVisAtt->SetVisibility(true);
+   const G4VisAttributes *siliconChipVisAtt = FourQubitVisAttributes::Get(G4Colour(0.5, 0.5, 0.5));
    log_siliconChip->SetVisAttributes(siliconChipVisAtt);
 
-   // Set up the G4CMP silicon lattice information using the G4LatticeManager
-   //  G4LatticeManager gives physics processes access to lattices by volume
-   G4LatticeManager *LM = G4LatticeManager::GetLatticeManager();
-   G4LatticeLogical *log_siliconLattice = LM->LoadLattice(fSilicon, "Si");
-
-   // G4LatticePhysical assigns G4LatticeLogical a physical orientation
-   G4LatticePhysical *phys_siliconLattice = new G4LatticePhysical(log_siliconLattice);
-   phys_siliconLattice->SetMillerOrientation(1, 0, 0);
-   LM->RegisterLattice(phys_siliconChip, phys_siliconLattice);
+   // Set up the G4CMP silicon lattice information, in the (1,0,0) orientation
+   RegisterLattice(phys_siliconChip, "Si", 1, 0, 0);
 
    // Set up border surfaces
-   G4CMPLogicalBorderSurface *border_siliconChip_world = new G4CMPLogicalBorderSurface("border_siliconChip_world", phys_siliconChip, fWorldPhys, fSiVacuumInterface);
+   FourQubitBorderTable *borders = FourQubitBorderTable::Instance();
+   borders->Create("border_siliconChip_world", phys_siliconChip, fWorldPhys, fSiVacuumInterface);
 
    //-------------------------------------------------------------------------------------------------------------------
    // If desired, set up the copper qubit housing
    if (dp_useQubitHousing)
    {
 
-      FourQubitQubitHousing *qubitHousing = new FourQubitQubitHousing(0,
-                                                                      G4ThreeVector(0, 0, 0),
-                                                                      "QubitHousing",
-                                                                      log_world,
-                                                                      false,
-                                                                      0,
-                                                                      checkOverlaps);
+      FourQubitQubitHousing *qubitHousing = arena->Make<FourQubitQubitHousing>(nullptr,
+                                                                               G4ThreeVector(0, 0, 0),
+                                                                               "QubitHousing",
+                                                                               log_world,
+                                                                               false,
+                                                                               0,
+                                                                               checkOverlaps);
       G4LogicalVolume *log_qubitHousing = qubitHousing->GetLogicalVolume();
       G4VPhysicalVolume *phys_qubitHousing = qubitHousing->GetPhysicalVolume();
 
       // Set up the logical border surface
-      G4CMPLogicalBorderSurface *border_siliconChip_qubitHousing = new G4CMPLogicalBorderSurface("border_siliconChip_qubitHousing", phys_siliconChip, phys_qubitHousing, fSiCopperInterface);
+      borders->Create("border_siliconChip_qubitHousing", phys_siliconChip, phys_qubitHousing, fSiCopperInterface);
    }
 
    //-------------------------------------------------------------------------------------------------------------------
@@ -279,737 +361,629 @@ void FourQubitDetectorConstruction::SetupGeometry()
                                                               0,
                                                               checkOverlaps);
 
-      G4VisAttributes *groundPlaneVisAtt = new G4VisAttributes(G4Colour(0.0, 1.0, 1.0, 0.5));
-      groundPlaneVisAtt->SetVisibility(true);
+      const G4VisAttributes *groundPlaneVisAtt = FourQubitVisAttributes::Get(G4Colour(0.0, 1.0, 1.0, 0.5));
       log_groundPlane->SetVisAttributes(groundPlaneVisAtt);
 
+      // With dp_flattenConductors the components are built in a stand-in for the ground plane, then
+      // merged into a few layer volumes inside the real one by FourQubitFlatLayers (at the end)
+      G4LogicalVolume *log_components = log_groundPlane;
+      fBuildingFlatSource = dp_flattenConductors;
+      if (fBuildingFlatSource)
+         log_components = new G4LogicalVolume(solid_groundPlane, fNiobium, "GroundPlaneComponents_log");
+
       // Set up the logical border surface
-      G4CMPLogicalBorderSurface *border_siliconChip_groundPlane = new G4CMPLogicalBorderSurface("border_siliconChip_groundPlane", phys_siliconChip, phys_groundPlane, fSiNbInterface);
+      borders->Create("border_siliconChip_groundPlane", phys_siliconChip, phys_groundPlane, fSiNbInterface);
 
       //-------------------------------------------------------------------------------------------------------------------
-      // Now set up the transmission line
-      if (dp_useTransmissionLine)
+      // A regular N x M array of qubit units, one G4PVParameterised in place of the hand-built chip.
+      // The cells share one logical tree, so the borders below are made once and cover every copy
+      if (dp_useQubitArray)
       {
-
-         G4ThreeVector transmissionLineTranslate(0, 0, 0.0); // Since it's within the ground plane exactly; 0.5*(dp_housingDimZ) + dp_eps + dp_groundPlaneDimZ*0.5 );
-         FourQubitTransmissionLine *tLine = new FourQubitTransmissionLine(0,
-                                                                          transmissionLineTranslate,
-                                                                          "TransmissionLine",
-                                                                          log_groundPlane,
-                                                                          false,
-                                                                          0,
-                                                                          checkOverlaps);
-         G4LogicalVolume *log_tLine = tLine->GetLogicalVolume();
-         G4VPhysicalVolume *phys_tLine = tLine->GetPhysicalVolume();
-
-         // Now, if we're using the chip and ground plane AND the transmission line
-         // This gets a bit hairy, since the transmission line is composite of both Nb and vacuum.
-         // So we'll access the list of physical objects present in it and link those one-by-one to the
-         // silicon chip.
-         LogicalBorderCreation(tLine, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
-         // for (int iSubVol = 0; iSubVol < tLine->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol)
-         // {
-         //    std::cout << "TLine sub volume names (to be used for boundaries): " << std::get<1>(tLine->GetListOfAllFundamentalSubVolumes()[iSubVol]) << " with material " << std::get<0>(tLine->GetListOfAllFundamentalSubVolumes()[iSubVol]) << std::endl;
-
-         //    std::string tempName = "border_siliconChip_" + std::get<1>(tLine->GetListOfAllFundamentalSubVolumes()[iSubVol]);
-         //    if (std::get<0>(tLine->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Vacuum") != std::string::npos)
-         //    {
-         //       G4CMPLogicalBorderSurface *border_siliconChip_transmissionLineEmpty = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip, std::get<2>(tLine->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiVacuumInterface);
-         //    }
-         //    if (std::get<0>(tLine->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Niobium") != std::string::npos)
-         //    {
-         //       G4CMPLogicalBorderSurface *border_siliconChip_transmissionLineConductor = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip, std::get<2>(tLine->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiNbInterface);
-         //    }
-         // }
+         FourQubitQubitArray *qubitArray = arena->Make<FourQubitQubitArray>(dp_qubitArrayColumns,
+                                                                            dp_qubitArrayRows,
+                                                                            dp_qubitArrayPitchX,
+                                                                            dp_qubitArrayPitchY,
+                                                                            dp_qubitArrayGap,
+                                                                            "QubitArray",
+                                                                            log_components,
+                                                                            checkOverlaps);
+         LogicalBorderCreation(qubitArray, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
+
+         // A replicated volume can't be merged, so a flattened build leaves the array out
+         if (!fBuildingFlatSource)
+            FourQubitSensorTable::Instance()->AddQubitArray("QubitArray", qubitArray->GetPhysicalVolume(),
+                                                            qubitArray->GetListOfAllFundamentalSubVolumes(), phys_groundPlane,
+                                                            qubitArray->GetCellPositions());
+         G4cout << "Placed a " << dp_qubitArrayColumns << " x " << dp_qubitArrayRows << " qubit array" << G4endl;
       }
-
-      //-------------------------------------------------------------------------------------------------------------------
-      // Now set up a set of 6 resonator assemblies
-      if (dp_useResonatorAssembly)
+      else
       {
-         int nR = 6;
-         for (int iR = 0; iR < nR; ++iR)
+         //-------------------------------------------------------------------------------------------------------------------
+         // Now set up the transmission line
+         if (dp_useTransmissionLine)
          {
 
-            // First, get the translation vector for the resonator assembly
-            // For the top three, don't do a rotation. For the bottom three, do
-            G4ThreeVector resonatorAssemblyTranslate(0, 0, 0);
-            G4RotationMatrix *rotAssembly = 0;
-            if (iR <= 2)
-            {
-               resonatorAssemblyTranslate = G4ThreeVector(dp_resonatorLateralSpacing * (iR - 1) + dp_centralResonatorOffsetX,
-                                                          0.5 * dp_resonatorAssemblyBaseNbDimY + 0.5 * dp_transmissionLineCavityFullWidth,
-                                                          0.0);
-               rotAssembly = 0;
-            }
-            else
+            G4ThreeVector transmissionLineTranslate(0, 0, 0.0); // Since it's within the ground plane exactly; 0.5*(dp_housingDimZ) + dp_eps + dp_groundPlaneDimZ*0.5 );
+            FourQubitTransmissionLine *tLine = arena->Make<FourQubitTransmissionLine>(nullptr,
+                                                                                      transmissionLineTranslate,
+                                                                                      "TransmissionLine",
+                                                                                      log_components,
+                                                                                      false,
+                                                                                      0,
+                                                                                      checkOverlaps);
+            G4LogicalVolume *log_tLine = tLine->GetLogicalVolume();
+            G4VPhysicalVolume *phys_tLine = tLine->GetPhysicalVolume();
+
+            // Now, if we're using the chip and ground plane AND the transmission line
+            // This gets a bit hairy, since the transmission line is composite of both Nb and vacuum.
+            // So we'll access the list of physical objects present in it and link those one-by-one to the
+            // silicon chip.
+            LogicalBorderCreation(tLine, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
+         }
+
+         //-------------------------------------------------------------------------------------------------------------------
+         // Now set up a set of 6 resonator assemblies. They are identical, so the first one's
+         // logical tree is built and the others are further placements of it
+         if (dp_useResonatorAssembly)
+         {
+            int nR = 6;
+            FourQubitResonatorAssembly *sharedAssembly = 0;
+            for (int iR = 0; iR < nR; ++iR)
             {
-               resonatorAssemblyTranslate = G4ThreeVector(dp_resonatorLateralSpacing * (iR - 4) - dp_centralResonatorOffsetX, // Negative offset because qubit is mirrored on underside
-                                                          -1 * (0.5 * dp_resonatorAssemblyBaseNbDimY + 0.5 * dp_transmissionLineCavityFullWidth),
-                                                          0.0);
-               rotAssembly = new G4RotationMatrix();
-               rotAssembly->rotateZ(180 * deg);
+
+               // First, get the translation vector for the resonator assembly
+               // For the top three, don't do a rotation. For the bottom three, do
+               G4ThreeVector resonatorAssemblyTranslate(0, 0, 0);
+               G4RotationMatrix *rotAssembly = 0;
+               if (iR <= 2)
+               {
+                  resonatorAssemblyTranslate = G4ThreeVector(dp_resonatorLateralSpacing * (iR - 1) + dp_centralResonatorOffsetX,
+                                                             0.5 * dp_resonatorAssemblyBaseNbDimY + 0.5 * dp_transmissionLineCavityFullWidth,
+                                                             0.0);
+                  rotAssembly = 0;
+               }
+               else
+               {
+                  resonatorAssemblyTranslate = G4ThreeVector(dp_resonatorLateralSpacing * (iR - 4) - dp_centralResonatorOffsetX, // Negative offset because qubit is mirrored on underside
+                                                             -1 * (0.5 * dp_resonatorAssemblyBaseNbDimY + 0.5 * dp_transmissionLineCavityFullWidth),
+                                                             0.0);
+                  rotAssembly = arena->Rotation();
+                  rotAssembly->rotateZ(180 * deg);
+               }
+
+               char name[400];
+               sprintf(name, "ResonatorAssembly_%d", iR);
+               G4String resonatorAssemblyName(name);
+               FourQubitResonatorAssembly *resonatorAssembly = 0;
+               if (!sharedAssembly)
+               {
+                  resonatorAssembly = arena->Make<FourQubitResonatorAssembly>(rotAssembly,
+                                                                              resonatorAssemblyTranslate,
+                                                                              resonatorAssemblyName,
+                                                                              log_components,
+                                                                              false,
+                                                                              iR,
+                                                                              checkOverlaps);
+                  sharedAssembly = resonatorAssembly;
+               }
+               else
+               {
+                  resonatorAssembly = arena->Make<FourQubitResonatorAssembly>(sharedAssembly,
+                                                                              rotAssembly,
+                                                                              resonatorAssemblyTranslate,
+                                                                              resonatorAssemblyName,
+                                                                              log_components,
+                                                                              false,
+                                                                              iR,
+                                                                              checkOverlaps);
+               }
+               G4LogicalVolume *log_resonatorAssembly = resonatorAssembly->GetLogicalVolume();
+               G4VPhysicalVolume *phys_resonatorAssembly = resonatorAssembly->GetPhysicalVolume();
+
+               // Do the logical border creation now
+               LogicalBorderCreation(resonatorAssembly, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
+
             }
+         }
+
+         //-------------------------------------------------------------------------------------------------------------------
+         // Flux lines: all three are the same curved line, placed from one logical tree
+         if (dp_useFluxLines)
+         {
 
-            char name[400];
-            sprintf(name, "ResonatorAssembly_%d", iR);
-            G4String resonatorAssemblyName(name);
-            FourQubitResonatorAssembly *resonatorAssembly = new FourQubitResonatorAssembly(rotAssembly,
-                                                                                           resonatorAssemblyTranslate,
-                                                                                           resonatorAssemblyName,
-                                                                                           log_groundPlane,
+            //--------------------
+            G4ThreeVector topStraightFluxLineTranslate(dp_topCenterFluxLineOffsetX, dp_topCenterFluxLineOffsetY, 0);
+            G4RotationMatrix *rotation = arena->Rotation();
+            rotation->rotateY(dp_topCenterFluxLineRotY);
+            // FourQubitStraightFluxLine * topStraightFLine = new FourQubitStraightFluxLine(0,
+            FourQubitCurveFluxLine *topStraightFLine = arena->Make<FourQubitCurveFluxLine>(rotation,
+                                                                                           topStraightFluxLineTranslate,
+                                                                                           "TopStraightFluxLine",
+                                                                                           log_components,
                                                                                            false,
                                                                                            0,
                                                                                            checkOverlaps);
-            G4LogicalVolume *log_resonatorAssembly = resonatorAssembly->GetLogicalVolume();
-            G4VPhysicalVolume *phys_resonatorAssembly = resonatorAssembly->GetPhysicalVolume();
+            G4LogicalVolume *log_topStraightFline = topStraightFLine->GetLogicalVolume();
+            G4VPhysicalVolume *phys_topStraightFline = topStraightFLine->GetPhysicalVolume();
+
+            // Do the logical border creation now
+            LogicalBorderCreation(topStraightFLine, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
+
+            //-------------------- bottom left
+            G4ThreeVector bottomStraightFluxLineTranslate(dp_bottomLeftFluxLineOffsetX, -1 * dp_bottomLeftFluxLineOffsetY, 0);
+            G4RotationMatrix *rotBottomCenter = arena->Rotation();
+            rotBottomCenter->rotateZ(180. * deg);
+            rotBottomCenter->rotateY(180. * deg);
+
+            FourQubitCurveFluxLine *bottomStraightFLine = arena->Make<FourQubitCurveFluxLine>(topStraightFLine,
+                                                                                                    rotBottomCenter,
+                                                                                                    bottomStraightFluxLineTranslate,
+                                                                                                    "BottomStraightFluxLine",
+                                                                                                    log_components,
+                                                                                                    false,
+                                                                                                    1,
+                                                                                                    checkOverlaps);
+            G4LogicalVolume *log_bottomStraightFline = bottomStraightFLine->GetLogicalVolume();
+            G4VPhysicalVolume *phys_bottomStraightFline = bottomStraightFLine->GetPhysicalVolume();
+
+            // Do the logical border creation now
+            LogicalBorderCreation(bottomStraightFLine, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
+
+            //-------------------- bottom right
+            G4ThreeVector bottomRightFluxLineTranslate(dp_bottomRightFluxLineOffsetX, -1 * dp_bottomRightFluxLineOffsetY, 0);
+            G4RotationMatrix *rotBottomRight = arena->Rotation();
+            rotBottomRight->rotateZ(180. * deg);
+            FourQubitCurveFluxLine *bottomRightFLine = arena->Make<FourQubitCurveFluxLine>(topStraightFLine,
+                                                                                                    rotBottomRight,
+                                                                                                    bottomRightFluxLineTranslate,
+                                                                                                    "bottomRightFluxLine",
+                                                                                                    log_components,
+                                                                                                    false,
+                                                                                                    2,
+                                                                                                    checkOverlaps);
+            G4LogicalVolume *log_bottomRightFline = bottomRightFLine->GetLogicalVolume();
+            G4VPhysicalVolume *phys_bottomRightFline = bottomRightFLine->GetPhysicalVolume();
 
             // Do the logical border creation now
-            LogicalBorderCreation(resonatorAssembly, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
-
-            // for (int iSubVol = 0; iSubVol < resonatorAssembly->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol)
-            // {
-            //    std::cout << "TLine sub volume names (to be used for boundaries): " << std::get<1>(resonatorAssembly->GetListOfAllFundamentalSubVolumes()[iSubVol]) << " with material " << std::get<0>(resonatorAssembly->GetListOfAllFundamentalSubVolumes()[iSubVol]) << std::endl;
-
-            //    std::string tempName = "border_siliconChip_" + std::get<1>(resonatorAssembly->GetListOfAllFundamentalSubVolumes()[iSubVol]);
-            //    if (std::get<0>(resonatorAssembly->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Vacuum") != std::string::npos)
-            //    {
-            //       G4CMPLogicalBorderSurface *border_siliconChip_resonatorAssemblyEmpty = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip, std::get<2>(resonatorAssembly->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiVacuumInterface);
-            //    }
-            //    if (std::get<0>(resonatorAssembly->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Niobium") != std::string::npos)
-            //    {
-            //       G4CMPLogicalBorderSurface *border_siliconChip_resonatorAssemblyConductor = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip, std::get<2>(resonatorAssembly->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiNbInterface);
-            //    }
-            // }
+            LogicalBorderCreation(bottomRightFLine, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
          }
-      }
 
-      //-------------------------------------------------------------------------------------------------------------------
-      // Flux lines
-      if (dp_useFluxLines)
-      {
 
+         // Resonator
          //--------------------
-         G4ThreeVector topStraightFluxLineTranslate(dp_topCenterFluxLineOffsetX, dp_topCenterFluxLineOffsetY, 0);
-         G4RotationMatrix *rotation = new G4RotationMatrix();
-         rotation->rotateY(dp_topCenterFluxLineRotY);
-         // FourQubitStraightFluxLine * topStraightFLine = new FourQubitStraightFluxLine(0,
-         FourQubitCurveFluxLine *topStraightFLine = new FourQubitCurveFluxLine(rotation,
-                                                                               topStraightFluxLineTranslate,
-                                                                               "TopStraightFluxLine",
-                                                                               log_groundPlane,
-                                                                               false,
-                                                                               0,
-                                                                               checkOverlaps);
-         G4LogicalVolume *log_topStraightFline = topStraightFLine->GetLogicalVolume();
-         G4VPhysicalVolume *phys_topStraightFline = topStraightFLine->GetPhysicalVolume();
+         G4ThreeVector locatetopResonator0(-0.39 * mm, 0.39 * mm, 0);
+
+         FourQubitResonator *topResonator0 = arena->Make<FourQubitResonator>(nullptr,
+                                                                             locatetopResonator0,
+                                                                             "Resonator0",
+                                                                             log_components,
+                                                                             false,
+                                                                             0,
+                                                                             checkOverlaps,
+                                                                             7,
+                                                                             546 * um);
+         G4LogicalVolume *log_topResonator0 = topResonator0->GetLogicalVolume();
+         G4VPhysicalVolume *phys_topResonator0 = topResonator0->GetPhysicalVolume();
+         G4ThreeVector anchorq0 =  topResonator0->GetResEndVector() + locatetopResonator0;
 
          // Do the logical border creation now
-         LogicalBorderCreation(topStraightFLine, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
-         // for (int iSubVol = 0; iSubVol < topStraightFLine->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol)
-         // {
-         //    std::cout << "TLine sub volume names (to be used for boundaries): " << std::get<1>(topStraightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]) << " with material " << std::get<0>(topStraightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]) << std::endl;
-
-         //    std::string tempName = "border_siliconChip_" + std::get<1>(topStraightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]);
-         //    if (std::get<0>(topStraightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Vacuum") != std::string::npos)
-         //    {
-         //       G4CMPLogicalBorderSurface *border_siliconChip_topStraightFluxLineEmpty = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip, std::get<2>(topStraightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiVacuumInterface);
-         //    }
-         //    if (std::get<0>(topStraightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Niobium") != std::string::npos)
-         //    {
-         //       G4CMPLogicalBorderSurface *border_siliconChip_topStraightFluxLineConductor = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip, std::get<2>(topStraightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiNbInterface);
-         //    }
-         // }
-
-         //-------------------- bottom left
-         G4ThreeVector bottomStraightFluxLineTranslate(dp_bottomLeftFluxLineOffsetX, -1 * dp_bottomLeftFluxLineOffsetY, 0);
-         G4RotationMatrix *rotBottomCenter = new G4RotationMatrix();
-         rotBottomCenter->rotateZ(180. * deg);
-         rotBottomCenter->rotateY(180. * deg);
-
-         FourQubitCurveFluxLine *bottomStraightFLine = new FourQubitCurveFluxLine(rotBottomCenter,
-                                                                                        bottomStraightFluxLineTranslate,
-                                                                                        "BottomStraightFluxLine",
-                                                                                        log_groundPlane,
-                                                                                        false,
-                                                                                        0,
-                                                                                        checkOverlaps);
-         G4LogicalVolume *log_bottomStraightFline = bottomStraightFLine->GetLogicalVolume();
-         G4VPhysicalVolume *phys_bottomStraightFline = bottomStraightFLine->GetPhysicalVolume();
+         LogicalBorderCreation(topResonator0, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
+
+         G4ThreeVector locatetopResonator1(1.17 * mm, 0.39 * mm, 0);
+
+         FourQubitResonator *topResonator1 = arena->Make<FourQubitResonator>(nullptr,
+                                                                             locatetopResonator1,
+                                                                             "Resonator1",
+                                                                             log_components,
+                                                                             false,
+                                                                             0,
+                                                                             checkOverlaps,
+                                                                             7,
+                                                                             312 * um);
+         G4LogicalVolume *log_topResonator1 = topResonator1->GetLogicalVolume();
+         G4VPhysicalVolume *phys_topResonator1 = topResonator1->GetPhysicalVolume();
+         G4ThreeVector anchorq1 =  topResonator1->GetResEndVector() + locatetopResonator1;
 
-         // Do the logical border creation now
-         LogicalBorderCreation(bottomStraightFLine, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
-         // for (int iSubVol = 0; iSubVol < bottomStraightFLine->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol)
-         // {
-         //    std::cout << "TLine sub volume names (to be used for boundaries): " << std::get<1>(bottomStraightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]) << " with material " << std::get<0>(bottomStraightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]) << std::endl;
-
-         //    std::string tempName = "border_siliconChip_" + std::get<1>(bottomStraightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]);
-         //    if (std::get<0>(bottomStraightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Vacuum") != std::string::npos)
-         //    {
-         //       G4CMPLogicalBorderSurface *border_siliconChip_bottomStraightFluxLineEmpty = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip, std::get<2>(bottomStraightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiVacuumInterface);
-         //    }
-         //    if (std::get<0>(bottomStraightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Niobium") != std::string::npos)
-         //    {
-         //       G4CMPLogicalBorderSurface *border_siliconChip_bottomStraightFluxLineConductor = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip, std::get<2>(bottomStraightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiNbInterface);
-         //    }
-         // }
-
-         //-------------------- bottom right
-         G4ThreeVector bottomRightFluxLineTranslate(dp_bottomRightFluxLineOffsetX, -1 * dp_bottomRightFluxLineOffsetY, 0);
-         G4RotationMatrix *rotBottomRight = new G4RotationMatrix();
-         rotBottomRight->rotateZ(180. * deg);
-         FourQubitCurveFluxLine *bottomRightFLine = new FourQubitCurveFluxLine(rotBottomRight,
-                                                                                        bottomRightFluxLineTranslate,
-                                                                                        "bottomRightFluxLine",
-                                                                                        log_groundPlane,
-                                                                                        false,
-                                                                                        0,
-                                                                                        checkOverlaps);
-         G4LogicalVolume *log_bottomRightFline = bottomRightFLine->GetLogicalVolume();
-         G4VPhysicalVolume *phys_bottomRightFline = bottomRightFLine->GetPhysicalVolume();
 
          // Do the logical border creation now
-         LogicalBorderCreation(bottomRightFLine, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
-         // for (int iSubVol = 0; iSubVol < bottomRightFLine->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol)
-         // {
-         //    std::cout << "TLine sub volume names (to be used for boundaries): " << std::get<1>(bottomRightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]) << " with material " << std::get<0>(bottomRightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]) << std::endl;
-
-         //    std::string tempName = "border_siliconChip_" + std::get<1>(bottomRightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]);
-         //    if (std::get<0>(bottomRightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Vacuum") != std::string::npos)
-         //    {
-         //       G4CMPLogicalBorderSurface *border_siliconChip_bottomRightFluxLineEmpty = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip, std::get<2>(bottomRightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiVacuumInterface);
-         //    }
-         //    if (std::get<0>(bottomRightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Niobium") != std::string::npos)
-         //    {
-         //       G4CMPLogicalBorderSurface *border_siliconChip_bottomRightFluxLineConductor = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip, std::get<2>(bottomRightFLine->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiNbInterface);
-         //    }
-         // }
-      }
+         LogicalBorderCreation(topResonator1, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
+
+         // bottom resonators
+         G4ThreeVector locatebottomResonator0(-1.17 * mm, -0.39 * mm, 0);
+         G4RotationMatrix *rotBottomResonator0 = arena->Rotation();
+         rotBottomResonator0->rotateZ(180. * deg);
+
+         FourQubitResonator *bottomResonator0 = arena->Make<FourQubitResonator>(rotBottomResonator0,
+                                                                             locatebottomResonator0,
+                                                                             "Resonator0",
+                                                                             log_components,
+                                                                             false,
+                                                                             0,
+                                                                             checkOverlaps,
+                                                                             7,
+                                                                             dp_shlConductorDimX);
+         G4LogicalVolume *log_bottomResonator0 = bottomResonator0->GetLogicalVolume();
+         G4VPhysicalVolume *phys_bottomResonator0 = bottomResonator0->GetPhysicalVolume();
+         G4ThreeVector anchorq2 = *rotBottomResonator0 * ( bottomResonator0->GetResEndVector() ) + locatebottomResonator0;
 
 
-      // Resonator
-      //--------------------
-      G4ThreeVector locatetopResonator0(-0.39 * mm, 0.39 * mm, 0);
-
-      FourQubitResonator *topResonator0 = new FourQubitResonator(0,
-                                                                 locatetopResonator0,
-                                                                 "Resonator0",
-                                                                 log_groundPlane,
-                                                                 false,
-                                                                 0,
-                                                                 checkOverlaps,
-                                                                 7,
-                                                                 546 * um);
-      G4LogicalVolume *log_topResonator0 = topResonator0->GetLogicalVolume();
-      G4VPhysicalVolume *phys_topResonator0 = topResonator0->GetPhysicalVolume();
-      G4ThreeVector anchorq0 =  topResonator0->GetResEndVector() + locatetopResonator0;
-
-      // Do the logical border creation now
-      LogicalBorderCreation(topResonator0, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
-      // for (int iSubVol = 0; iSubVol < topResonator0->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol)
-      // {
-      //    std::cout << "TLine sub volume names (to be used for boundaries): " << std::get<1>(topResonator0->GetListOfAllFundamentalSubVolumes()[iSubVol])
-      //              << " with material " << std::get<0>(topResonator0->GetListOfAllFundamentalSubVolumes()[iSubVol]) << std::endl;
-
-      //    std::string tempName = "border_siliconChip_" + std::get<1>(topResonator0->GetListOfAllFundamentalSubVolumes()[iSubVol]);
-      //    if (std::get<0>(topResonator0->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Vacuum") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_topResonator0Empty = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip,
-      //                                                                                                        std::get<2>(topResonator0->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiVacuumInterface);
-      //    }
-      //    if (std::get<0>(topResonator0->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Niobium") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_topResonator0Conductor = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip,
-      //                                                                                                            std::get<2>(topResonator0->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiNbInterface);
-      //    }
-      // }
-
-      G4ThreeVector locatetopResonator1(1.17 * mm, 0.39 * mm, 0);
-
-      FourQubitResonator *topResonator1 = new FourQubitResonator(0,
-                                                                 locatetopResonator1,
-                                                                 "Resonator1",
-                                                                 log_groundPlane,
-                                                                 false,
-                                                                 0,
-                                                                 checkOverlaps,
-                                                                 7,
-                                                                 312 * um);
-      G4LogicalVolume *log_topResonator1 = topResonator1->GetLogicalVolume();
-      G4VPhysicalVolume *phys_topResonator1 = topResonator1->GetPhysicalVolume();
-      G4ThreeVector anchorq1 =  topResonator1->GetResEndVector() + locatetopResonator1;
-
-
-      // Do the logical border creation now
-      LogicalBorderCreation(topResonator1, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
-      // for (int iSubVol = 0; iSubVol < topResonator1->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol)
-      // {
-      //    std::cout << "TLine sub volume names (to be used for boundaries): " << std::get<1>(topResonator1->GetListOfAllFundamentalSubVolumes()[iSubVol])
-      //              << " with material " << std::get<0>(topResonator1->GetListOfAllFundamentalSubVolumes()[iSubVol]) << std::endl;
-
-      //    std::string tempName = "border_siliconChip_" + std::get<1>(topResonator1->GetListOfAllFundamentalSubVolumes()[iSubVol]);
-      //    if (std::get<0>(topResonator1->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Vacuum") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_topResonator1Empty = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip,
-      //                                                                                                        std::get<2>(topResonator1->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiVacuumInterface);
-      //    }
-      //    if (std::get<0>(topResonator1->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Niobium") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_topResonator1Conductor = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip,
-      //                                                                                                            std::get<2>(topResonator1->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiNbInterface);
-      //    }
-      // }
-
-      // bottom resonators
-      G4ThreeVector locatebottomResonator0(-1.17 * mm, -0.39 * mm, 0);
-      G4RotationMatrix *rotBottomResonator0 = new G4RotationMatrix();
-      rotBottomResonator0->rotateZ(180. * deg);
-
-      FourQubitResonator *bottomResonator0 = new FourQubitResonator(rotBottomResonator0,
-                                                                 locatebottomResonator0,
-                                                                 "Resonator0",
-                                                                 log_groundPlane,
-                                                                 false,
-                                                                 0,
-                                                                 checkOverlaps,
-                                                                 7,
-                                                                 dp_shlConductorDimX);
-      G4LogicalVolume *log_bottomResonator0 = bottomResonator0->GetLogicalVolume();
-      G4VPhysicalVolume *phys_bottomResonator0 = bottomResonator0->GetPhysicalVolume();
-      G4ThreeVector anchorq2 = *rotBottomResonator0 * ( bottomResonator0->GetResEndVector() ) + locatebottomResonator0;
-
-
-      // Do the logical border creation now
-      LogicalBorderCreation(bottomResonator0, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
-      // for (int iSubVol = 0; iSubVol < bottomResonator0->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol)
-      // {
-      //    std::cout << "TLine sub volume names (to be used for boundaries): " << std::get<1>(bottomResonator0->GetListOfAllFundamentalSubVolumes()[iSubVol])
-      //              << " with material " << std::get<0>(bottomResonator0->GetListOfAllFundamentalSubVolumes()[iSubVol]) << std::endl;
-
-      //    std::string tempName = "border_siliconChip_" + std::get<1>(bottomResonator0->GetListOfAllFundamentalSubVolumes()[iSubVol]);
-      //    if (std::get<0>(bottomResonator0->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Vacuum") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_bottomResonator0Empty = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip,
-      //                                                                                                        std::get<2>(bottomResonator0->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiVacuumInterface);
-      //    }
-      //    if (std::get<0>(bottomResonator0->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Niobium") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_bottomResonator0Conductor = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip,
-      //                                                                                                            std::get<2>(bottomResonator0->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiNbInterface);
-      //    }
-      // }
+         // Do the logical border creation now
+         LogicalBorderCreation(bottomResonator0, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
    
-      G4ThreeVector locatebottomResonator1(0.39 * mm, -0.39 * mm, 0);
-      G4RotationMatrix *rotBottomResonator1 = new G4RotationMatrix();
-      rotBottomResonator1->rotateZ(180. * deg);
-
-      FourQubitResonator *bottomResonator1 = new FourQubitResonator(rotBottomResonator1,
-                                                                 locatebottomResonator1,
-                                                                 "Resonator1",
-                                                                 log_groundPlane,
-                                                                 false,
-                                                                 0,
-                                                                 checkOverlaps,
-                                                                 6,
-                                                                 624*um);
-      G4LogicalVolume *log_bottomResonator1 = bottomResonator1->GetLogicalVolume();
-      G4VPhysicalVolume *phys_bottomResonator1 = bottomResonator1->GetPhysicalVolume();
-      G4ThreeVector anchorq3 =  *rotBottomResonator1 * bottomResonator1->GetResEndVector() + locatebottomResonator1;
-
-      // Do the logical border creation now
-      LogicalBorderCreation(bottomResonator1, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
-      // for (int iSubVol = 0; iSubVol < bottomResonator1->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol)
-      // {
-      //    std::cout << "TLine sub volume names (to be used for boundaries): " << std::get<1>(bottomResonator1->GetListOfAllFundamentalSubVolumes()[iSubVol])
-      //              << " with material " << std::get<0>(bottomResonator1->GetListOfAllFundamentalSubVolumes()[iSubVol]) << std::endl;
-
-      //    std::string tempName = "border_siliconChip_" + std::get<1>(bottomResonator1->GetListOfAllFundamentalSubVolumes()[iSubVol]);
-      //    if (std::get<0>(bottomResonator1->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Vacuum") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_bottomResonator1Empty = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip,
-      //                                                                                                        std::get<2>(bottomResonator1->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiVacuumInterface);
-      //    }
-      //    if (std::get<0>(bottomResonator1->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Niobium") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_bottomResonator1Conductor = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip,
-      //                                                                                                            std::get<2>(bottomResonator1->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiNbInterface);
-      //    }
-      // }
-
-      // other pieces
-      /////
-      // top q0
-      // q0c0
-      G4RotationMatrix *rotq0c0 = new G4RotationMatrix();
-      rotq0c0->rotateZ(0.0 * deg);
-      
-      anchorq0 = anchorq0 + G4ThreeVector(0, dp_resonatorCurveCentralRadius + (0.5*dp_tlCouplingEmptyDimY), 0);  // fix later
-      FourQubitCurve *q0c0 = new FourQubitCurve(rotq0c0,
-                                                anchorq0,
-                                                "q0c0",
-                                                log_groundPlane,
-                                                false,
-                                                0,
-                                                checkOverlaps, dp_resonatorCurveCentralRadius, 180, 90);
-
-      G4LogicalVolume *log_q0c0 = q0c0->GetLogicalVolume();
-      G4VPhysicalVolume *phys_q0c0 = q0c0->GetPhysicalVolume();
-
-      // q0l0
-      G4RotationMatrix *rotq0s0 = new G4RotationMatrix();
-      rotq0s0->rotateZ(90. * deg);
-
-      anchorq0 = anchorq0 + G4ThreeVector(-1.0*(dp_resonatorCurveCentralRadius + (0.5*dp_tlCouplingEmptyDimY)), 0.5 * 130 * um, 0);
-
-      FourQubitStraight *q0s0 = new FourQubitStraight(rotq0s0,
-                                                      anchorq0,
-                                                      "q0s0",
-                                                      log_groundPlane,
-                                                      false,
-                                                      0,
-                                                      checkOverlaps, 130 * um);
-      G4LogicalVolume *log_q0s0 = q0s0->GetLogicalVolume();
-      G4VPhysicalVolume *phys_q0s0 = q0s0->GetPhysicalVolume();
-
-      // Xmon
-      //--------------------
-      //G4ThreeVector locateXmon0(-1.0 * mm, 1.0 * mm, 0);
-      G4ThreeVector locateXmon0 = anchorq0 + G4ThreeVector(0.0, (0.5 * 130 * um)+(0.5*dp_xmonBaseNbLayerDimY), 0);
-
-      FourQubitXmon *topXmon = new FourQubitXmon(0,
-                                                 locateXmon0,
-                                                 "Xmon",
-                                                 log_groundPlane,
-                                                 false,
-                                                 0,
-                                                 checkOverlaps);
-      G4LogicalVolume *log_Xmon = topXmon->GetLogicalVolume();
-      G4VPhysicalVolume *phys_Xmon = topXmon->GetPhysicalVolume();
-
-      // Do the logical border creation now
-      LogicalBorderCreation(topXmon, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
-      // for (int iSubVol = 0; iSubVol < topXmon->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol)
-      // {
-      //    std::cout << "TLine sub volume names (to be used for boundaries): " << std::get<1>(topXmon->GetListOfAllFundamentalSubVolumes()[iSubVol])
-      //              << " with material " << std::get<0>(topXmon->GetListOfAllFundamentalSubVolumes()[iSubVol]) << std::endl;
-
-      //    std::string tempName = "border_siliconChip_" + std::get<1>(topXmon->GetListOfAllFundamentalSubVolumes()[iSubVol]);
-      //    if (std::get<0>(topXmon->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Vacuum") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_topXmonEmpty = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip,
-      //                                                                                                  std::get<2>(topXmon->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiVacuumInterface);
-      //    }
-      //    if (std::get<0>(topXmon->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Niobium") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_topXmonConductor = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip,
-      //                                                                                                      std::get<2>(topXmon->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiNbInterface);
-      //    }
-      // }
-
-
-      // q1
-
-      // q1c0
-      anchorq1 = anchorq1 + G4ThreeVector(0.0, dp_resonatorCurveCentralRadius, 0);
-      G4RotationMatrix *rotq1c0 = new G4RotationMatrix();
-      rotq1c0->rotateZ(180. * deg);
-
-      FourQubitCurve *q1c0 = new FourQubitCurve(rotq1c0,
-                                                anchorq1,
-                                                "q1c0",
-                                                log_groundPlane,
-                                                false,
-                                                0,
-                                                checkOverlaps, 45 * um, 0, 90);
-      G4LogicalVolume *log_q1c0 = q1c0->GetLogicalVolume();
-      G4VPhysicalVolume *phys_q1c0 = q1c0->GetPhysicalVolume();
-
-      // q1s0
-      anchorq1 = anchorq1 + G4ThreeVector(-1.0 * dp_resonatorCurveCentralRadius, 0.5 * 320 * um, 0);
-      G4RotationMatrix *rotq1s0 = new G4RotationMatrix();
-      rotq1s0->rotateZ(90. * deg);
-
-      FourQubitStraight *q1s0 = new FourQubitStraight(rotq1s0,
-                                                      anchorq1,
-                                                      "q1s0",
-                                                      log_groundPlane,
-                                                      false,
-                                                      0,
-                                                      checkOverlaps, 320 * um);
-      G4LogicalVolume *log_q1s0 = q1s0->GetLogicalVolume();
-      G4VPhysicalVolume *phys_q1s0 = q1s0->GetPhysicalVolume();
-
-      // q1c1
-      anchorq1 = anchorq1 + G4ThreeVector(dp_resonatorCurveCentralRadius, 0.5 * 320 * um, 0);
-      G4RotationMatrix *rotq1c1 = new G4RotationMatrix();
-      rotq1c1->rotateZ(270. * deg);
-
-      FourQubitCurve *q1c1 = new FourQubitCurve(rotq1c1,
-                                                anchorq1,
-                                                "q1c1",
-                                                log_groundPlane,
-                                                false,
-                                                0,
-                                                checkOverlaps, 45 * um, 0, 90);
-      G4LogicalVolume *log_q1c1 = q1c1->GetLogicalVolume();
-      G4VPhysicalVolume *phys_q1c1 = q1c1->GetPhysicalVolume();
-
-      // q1s1
-      G4float q1s1len = 200 * um;
-      anchorq1 = anchorq1 + G4ThreeVector(0.5 * q1s1len, dp_resonatorCurveCentralRadius, 0);
-
-      G4RotationMatrix *rotq1s1 = new G4RotationMatrix();
-      rotq1s1->rotateZ(180. * deg);
-
-      FourQubitStraight *q1s1 = new FourQubitStraight(rotq1s1,
-                                                      anchorq1,
-                                                      "q1s1",
-                                                      log_groundPlane,
-                                                      false,
-                                                      0,
-                                                      checkOverlaps, q1s1len);
-      G4LogicalVolume *log_q1s1 = q1s1->GetLogicalVolume();
-      G4VPhysicalVolume *phys_q1s1 = q1s1->GetPhysicalVolume();
-
-      // transmon
-      //--------------------
-      G4ThreeVector locateTransmon0 =  anchorq1 + G4ThreeVector(0.5 * q1s1len + (0.5*dp_transmonFieldDimX), 0, 0);
+         G4ThreeVector locatebottomResonator1(0.39 * mm, -0.39 * mm, 0);
+         G4RotationMatrix *rotBottomResonator1 = arena->Rotation();
+         rotBottomResonator1->rotateZ(180. * deg);
+
+         FourQubitResonator *bottomResonator1 = arena->Make<FourQubitResonator>(rotBottomResonator1,
+                                                                             locatebottomResonator1,
+                                                                             "Resonator1",
+                                                                             log_components,
+                                                                             false,
+                                                                             0,
+                                                                             checkOverlaps,
+                                                                             6,
+                                                                             624*um);
+         G4LogicalVolume *log_bottomResonator1 = bottomResonator1->GetLogicalVolume();
+         G4VPhysicalVolume *phys_bottomResonator1 = bottomResonator1->GetPhysicalVolume();
+         G4ThreeVector anchorq3 =  *rotBottomResonator1 * bottomResonator1->GetResEndVector() + locatebottomResonator1;
+
+         // Do the logical border creation now
+         LogicalBorderCreation(bottomResonator1, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
+
+         // other pieces
+         /////
+         // top q0
+         // q0c0
+         G4RotationMatrix *rotq0c0 = arena->Rotation();
+         rotq0c0->rotateZ(0.0 * deg);
       
-      FourQubitTransmon *topTransmon = new FourQubitTransmon(0,
-                                                            locateTransmon0,
-                                                            "Transmon",
-                                                            log_groundPlane,
+         anchorq0 = anchorq0 + G4ThreeVector(0, dp_resonatorCurveCentralRadius + (0.5*dp_tlCouplingEmptyDimY), 0);  // fix later
+         FourQubitCurve *q0c0 = arena->Make<FourQubitCurve>(rotq0c0,
+                                                            anchorq0,
+                                                            "q0c0",
+                                                            log_components,
+                                                            false,
+                                                            0,
+                                                            checkOverlaps, dp_resonatorCurveCentralRadius, 180, 90);
+
+         G4LogicalVolume *log_q0c0 = q0c0->GetLogicalVolume();
+         G4VPhysicalVolume *phys_q0c0 = q0c0->GetPhysicalVolume();
+
+         // q0l0
+         G4RotationMatrix *rotq0s0 = arena->Rotation();
+         rotq0s0->rotateZ(90. * deg);
+
+         anchorq0 = anchorq0 + G4ThreeVector(-1.0*(dp_resonatorCurveCentralRadius + (0.5*dp_tlCouplingEmptyDimY)), 0.5 * 130 * um, 0);
+
+         FourQubitStraight *q0s0 = arena->Make<FourQubitStraight>(rotq0s0,
+                                                                  anchorq0,
+                                                                  "q0s0",
+                                                                  log_components,
+                                                                  false,
+                                                                  0,
+                                                                  checkOverlaps, 130 * um);
+         G4LogicalVolume *log_q0s0 = q0s0->GetLogicalVolume();
+         G4VPhysicalVolume *phys_q0s0 = q0s0->GetPhysicalVolume();
+
+         // Xmon
+         //--------------------
+         //G4ThreeVector locateXmon0(-1.0 * mm, 1.0 * mm, 0);
+         G4ThreeVector locateXmon0 = anchorq0 + G4ThreeVector(0.0, (0.5 * 130 * um)+(0.5*dp_xmonBaseNbLayerDimY), 0);
+
+         FourQubitXmon *topXmon = arena->Make<FourQubitXmon>(nullptr,
+                                                             locateXmon0,
+                                                             "Xmon",
+                                                             log_components,
+                                                             false,
+                                                             0,
+                                                             checkOverlaps);
+         G4LogicalVolume *log_Xmon = topXmon->GetLogicalVolume();
+         G4VPhysicalVolume *phys_Xmon = topXmon->GetPhysicalVolume();
+
+         // Do the logical border creation now
+         LogicalBorderCreation(topXmon, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
+         FourQubitSensorTable::Instance()->AddQubit("Xmon", topXmon->GetPhysicalVolume(),
+                                                    topXmon->GetListOfAllFundamentalSubVolumes(), phys_groundPlane);
+
+
+         // q1
+
+         // q1c0
+         anchorq1 = anchorq1 + G4ThreeVector(0.0, dp_resonatorCurveCentralRadius, 0);
+         G4RotationMatrix *rotq1c0 = arena->Rotation();
+         rotq1c0->rotateZ(180. * deg);
+
+         FourQubitCurve *q1c0 = arena->Make<FourQubitCurve>(rotq1c0,
+                                                            anchorq1,
+                                                            "q1c0",
+                                                            log_components,
                                                             false,
                                                             0,
-                                                            checkOverlaps);
-      G4LogicalVolume *log_topTransmon = topTransmon->GetLogicalVolume();
-      G4VPhysicalVolume *phys_topTransmon = topTransmon->GetPhysicalVolume();
-
-      // Do the logical border creation now
-      LogicalBorderCreation(topTransmon, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
-      // for (int iSubVol = 0; iSubVol < topTransmon->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol)
-      // {
-      //    std::cout << "TLine sub volume names (to be used for boundaries): " << std::get<1>(topTransmon->GetListOfAllFundamentalSubVolumes()[iSubVol]) 
-      //              << " with material " << std::get<0>(topTransmon->GetListOfAllFundamentalSubVolumes()[iSubVol]) << std::endl;
-
-      //    std::string tempName = "border_siliconChip_" + std::get<1>(topTransmon->GetListOfAllFundamentalSubVolumes()[iSubVol]);
-      //    if (std::get<0>(topTransmon->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Vacuum") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_topTransmonEmpty = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip, 
-      //                                        std::get<2>(topTransmon->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiVacuumInterface);
-      //    }
-      //    if (std::get<0>(topTransmon->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Niobium") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_topTransmonConductor = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip, 
-      //                                        std::get<2>(topTransmon->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiNbInterface);
-      //    }
-      // }
-
-
-
-      // // Do the logical border creation now
-      // for (int iSubVol = 0; iSubVol < bottomCurve1->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol)
-      // {
-      //    std::cout << "TLine sub volume names (to be used for boundaries): " << std::get<1>(bottomCurve1->GetListOfAllFundamentalSubVolumes()[iSubVol])
-      //              << " with material " << std::get<0>(bottomCurve1->GetListOfAllFundamentalSubVolumes()[iSubVol]) << std::endl;
-
-      //    std::string tempName = "border_siliconChip_" + std::get<1>(bottomCurve1->GetListOfAllFundamentalSubVolumes()[iSubVol]);
-      //    if (std::get<0>(bottomCurve1->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Vacuum") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_bottomCurve1Empty = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip,
-      //                                                                                                           std::get<2>(bottomCurve1->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiVacuumInterface);
-      //    }
-      //    if (std::get<0>(bottomCurve1->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Niobium") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_bottomCurve1Conductor = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip,
-      //                                                                                                               std::get<2>(bottomCurve1->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiNbInterface);
-      //    }
-      // }
-
-      // bq1
-      //////
-      // q2c0
-      G4RotationMatrix *rotq2c0 = new G4RotationMatrix();
-      rotq2c0->rotateZ(0.0 * deg);
+                                                            checkOverlaps, 45 * um, 0, 90);
+         G4LogicalVolume *log_q1c0 = q1c0->GetLogicalVolume();
+         G4VPhysicalVolume *phys_q1c0 = q1c0->GetPhysicalVolume();
+
+         // q1s0
+         anchorq1 = anchorq1 + G4ThreeVector(-1.0 * dp_resonatorCurveCentralRadius, 0.5 * 320 * um, 0);
+         G4RotationMatrix *rotq1s0 = arena->Rotation();
+         rotq1s0->rotateZ(90. * deg);
+
+         FourQubitStraight *q1s0 = arena->Make<FourQubitStraight>(rotq1s0,
+                                                                  anchorq1,
+                                                                  "q1s0",
+                                                                  log_components,
+                                                                  false,
+                                                                  0,
+                                                                  checkOverlaps, 320 * um);
+         G4LogicalVolume *log_q1s0 = q1s0->GetLogicalVolume();
+         G4VPhysicalVolume *phys_q1s0 = q1s0->GetPhysicalVolume();
+
+         // q1c1
+         anchorq1 = anchorq1 + G4ThreeVector(dp_resonatorCurveCentralRadius, 0.5 * 320 * um, 0);
+         G4RotationMatrix *rotq1c1 = arena->Rotation();
+         rotq1c1->rotateZ(270. * deg);
+
+         FourQubitCurve *q1c1 = arena->Make<FourQubitCurve>(rotq1c1,
+                                                            anchorq1,
+                                                            "q1c1",
+                                                            log_components,
+                                                            false,
+                                                            0,
+                                                            checkOverlaps, 45 * um, 0, 90);
+         G4LogicalVolume *log_q1c1 = q1c1->GetLogicalVolume();
+         G4VPhysicalVolume *phys_q1c1 = q1c1->GetPhysicalVolume();
+
+         // q1s1
+         G4float q1s1len = 200 * um;
+         anchorq1 = anchorq1 + G4ThreeVector(0.5 * q1s1len, dp_resonatorCurveCentralRadius, 0);
+
+         G4RotationMatrix *rotq1s1 = arena->Rotation();
+         rotq1s1->rotateZ(180. * deg);
+
+         FourQubitStraight *q1s1 = arena->Make<FourQubitStraight>(rotq1s1,
+                                                                  anchorq1,
+                                                                  "q1s1",
+                                                                  log_components,
+                                                                  false,
+                                                                  0,
+                                                                  checkOverlaps, q1s1len);
+         G4LogicalVolume *log_q1s1 = q1s1->GetLogicalVolume();
+         G4VPhysicalVolume *phys_q1s1 = q1s1->GetPhysicalVolume();
+
+         // transmon
+         //--------------------
+         G4ThreeVector locateTransmon0 =  anchorq1 + G4ThreeVector(0.5 * q1s1len + (0.5*dp_transmonFieldDimX), 0, 0);
       
-      anchorq2 = anchorq2 - G4ThreeVector(0, dp_resonatorCurveCentralRadius + (0.5*dp_tlCouplingEmptyDimY), 0);  // fix later
-      FourQubitCurve *q2c0 = new FourQubitCurve(rotq2c0,
-                                                anchorq2,
-                                                "q2c0",
-                                                log_groundPlane,
-                                                false,
-                                                0,
-                                                checkOverlaps, dp_resonatorCurveCentralRadius, 0, 90);
-
-      G4LogicalVolume *log_q2c0 = q2c0->GetLogicalVolume();
-      G4VPhysicalVolume *phys_q2c0 = q2c0->GetPhysicalVolume();
-
-      // q2l0
-      G4RotationMatrix *rotq2s0 = new G4RotationMatrix();
-      rotq2s0->rotateZ(90. * deg);
-
-      anchorq2 = anchorq2 - G4ThreeVector(-1.0*(dp_resonatorCurveCentralRadius + (0.5*dp_tlCouplingEmptyDimY)), 0.5 * 130 * um, 0);
-
-      FourQubitStraight *q2s0 = new FourQubitStraight(rotq2s0,
-                                                      anchorq2,
-                                                      "q2s0",
-                                                      log_groundPlane,
-                                                      false,
-                                                      0,
-                                                      checkOverlaps, 130 * um);
-      G4LogicalVolume *log_q2s0 = q2s0->GetLogicalVolume();
-      G4VPhysicalVolume *phys_q2s0 = q2s0->GetPhysicalVolume();
-
-      G4ThreeVector locateXmon1 = anchorq2 - G4ThreeVector(0.0, (0.5 * 130 * um)+(0.5*dp_xmonBaseNbLayerDimY), 0);
-      G4RotationMatrix *rotBottomRightXmon = new G4RotationMatrix();
-      rotBottomRightXmon->rotateX(180. * deg);
-
-      FourQubitXmon *bottomXmon = new FourQubitXmon(rotBottomRightXmon,
-                                                 locateXmon1,
-                                                 "Xmon",
-                                                 log_groundPlane,
-                                                 false,
-                                                 0,
-                                                 checkOverlaps);
-      G4LogicalVolume *log_bottomXmon = bottomXmon->GetLogicalVolume();
-      G4VPhysicalVolume *phys_bottomXmon = bottomXmon->GetPhysicalVolume();
-
-      // Do the logical border creation now
-      LogicalBorderCreation(bottomXmon, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
-      // for (int iSubVol = 0; iSubVol < bottomXmon->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol)
-      // {
-      //    std::cout << "TLine sub volume names (to be used for boundaries): " << std::get<1>(bottomXmon->GetListOfAllFundamentalSubVolumes()[iSubVol])
-      //              << " with material " << std::get<0>(bottomXmon->GetListOfAllFundamentalSubVolumes()[iSubVol]) << std::endl;
-
-      //    std::string tempName = "border_siliconChip_" + std::get<1>(bottomXmon->GetListOfAllFundamentalSubVolumes()[iSubVol]);
-      //    if (std::get<0>(bottomXmon->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Vacuum") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_bottomXomEmpty = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip,
-      //                                                                                                  std::get<2>(bottomXmon->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiVacuumInterface);
-      //    }
-      //    if (std::get<0>(bottomXmon->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Niobium") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_bottomXomConductor = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip,
-      //                                                                                                      std::get<2>(bottomXmon->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiNbInterface);
-      //    }
-      // }
-
-
-      //
-      // q3
-      // q3c0
-      G4RotationMatrix *rotq3c0 = new G4RotationMatrix();
-      rotq3c0->rotateZ(0.0 * deg);
+         FourQubitTransmon *topTransmon = arena->Make<FourQubitTransmon>(nullptr,
+                                                                        locateTransmon0,
+                                                                        "Transmon",
+                                                                        log_components,
+                                                                        false,
+                                                                        0,
+                                                                        checkOverlaps);
+         G4LogicalVolume *log_topTransmon = topTransmon->GetLogicalVolume();
+         G4VPhysicalVolume *phys_topTransmon = topTransmon->GetPhysicalVolume();
+
+         // Do the logical border creation now
+         LogicalBorderCreation(topTransmon, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
+         FourQubitSensorTable::Instance()->AddQubit("Transmon", topTransmon->GetPhysicalVolume(),
+                                                    topTransmon->GetListOfAllFundamentalSubVolumes(), phys_groundPlane);
+
+
+
+         // // Do the logical border creation now
+
+         // bq1
+         //////
+         // q2c0
+         G4RotationMatrix *rotq2c0 = arena->Rotation();
+         rotq2c0->rotateZ(0.0 * deg);
       
-      anchorq3 = anchorq3 - G4ThreeVector(0, dp_resonatorCurveCentralRadius + (0.5*dp_tlCouplingEmptyDimY), 0);  // fix later
-      FourQubitCurve *q3c0 = new FourQubitCurve(rotq3c0,
-                                                anchorq3,
-                                                "q3c0",
-                                                log_groundPlane,
-                                                false,
-                                                0,
-                                                checkOverlaps, dp_resonatorCurveCentralRadius, 90, 90);
-
-      G4LogicalVolume *log_q3c0 = q3c0->GetLogicalVolume();
-      G4VPhysicalVolume *phys_q3c0 = q3c0->GetPhysicalVolume();
-
-      // q2l0
-      G4RotationMatrix *rotq3s0 = new G4RotationMatrix();
-      rotq3s0->rotateZ(90. * deg);
-
-      G4float q3s0len =  350 * um;
-      anchorq3 = anchorq3 - G4ThreeVector(1.0*(dp_resonatorCurveCentralRadius + (0.5*dp_tlCouplingEmptyDimY)), 0.5 * q3s0len, 0);
-
-      FourQubitStraight *q3s0 = new FourQubitStraight(rotq3s0,
-                                                      anchorq3,
-                                                      "q3s0",
-                                                      log_groundPlane,
-                                                      false,
-                                                      0,
-                                                      checkOverlaps, q3s0len);
-      G4LogicalVolume *log_q3s0 = q3s0->GetLogicalVolume();
-      G4VPhysicalVolume *phys_q3s0 = q3s0->GetPhysicalVolume();
-
-      // q3c1
-      G4RotationMatrix *rotq3c1 = new G4RotationMatrix();
-      rotq3c1->rotateZ(0.0 * deg);
+         anchorq2 = anchorq2 - G4ThreeVector(0, dp_resonatorCurveCentralRadius + (0.5*dp_tlCouplingEmptyDimY), 0);  // fix later
+         FourQubitCurve *q2c0 = arena->Make<FourQubitCurve>(rotq2c0,
+                                                            anchorq2,
+                                                            "q2c0",
+                                                            log_components,
+                                                            false,
+                                                            0,
+                                                            checkOverlaps, dp_resonatorCurveCentralRadius, 0, 90);
+
+         G4LogicalVolume *log_q2c0 = q2c0->GetLogicalVolume();
+         G4VPhysicalVolume *phys_q2c0 = q2c0->GetPhysicalVolume();
+
+         // q2l0
+         G4RotationMatrix *rotq2s0 = arena->Rotation();
+         rotq2s0->rotateZ(90. * deg);
+
+         anchorq2 = anchorq2 - G4ThreeVector(-1.0*(dp_resonatorCurveCentralRadius + (0.5*dp_tlCouplingEmptyDimY)), 0.5 * 130 * um, 0);
+
+         FourQubitStraight *q2s0 = arena->Make<FourQubitStraight>(rotq2s0,
+                                                                  anchorq2,
+                                                                  "q2s0",
+                                                                  log_components,
+                                                                  false,
+                                                                  0,
+                                                                  checkOverlaps, 130 * um);
+         G4LogicalVolume *log_q2s0 = q2s0->GetLogicalVolume();
+         G4VPhysicalVolume *phys_q2s0 = q2s0->GetPhysicalVolume();
+
+         G4ThreeVector locateXmon1 = anchorq2 - G4ThreeVector(0.0, (0.5 * 130 * um)+(0.5*dp_xmonBaseNbLayerDimY), 0);
+         G4RotationMatrix *rotBottomRightXmon = arena->Rotation();
+         rotBottomRightXmon->rotateX(180. * deg);
+
+         FourQubitXmon *bottomXmon = arena->Make<FourQubitXmon>(rotBottomRightXmon,
+                                                             locateXmon1,
+                                                             "Xmon",
+                                                             log_components,
+                                                             false,
+                                                             0,
+                                                             checkOverlaps);
+         G4LogicalVolume *log_bottomXmon = bottomXmon->GetLogicalVolume();
+         G4VPhysicalVolume *phys_bottomXmon = bottomXmon->GetPhysicalVolume();
+
+         // Do the logical border creation now
+         LogicalBorderCreation(bottomXmon, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
+         FourQubitSensorTable::Instance()->AddQubit("Xmon", bottomXmon->GetPhysicalVolume(),
+                                                    bottomXmon->GetListOfAllFundamentalSubVolumes(), phys_groundPlane);
+
+
+         //
+         // q3
+         // q3c0
+         G4RotationMatrix *rotq3c0 = arena->Rotation();
+         rotq3c0->rotateZ(0.0 * deg);
       
-      //anchorq3 = anchorq3 - G4ThreeVector(0, dp_resonatorCurveCentralRadius + (0.5*dp_tlCouplingEmptyDimY), 0);  // fix later
-      anchorq3 = anchorq3 + G4ThreeVector(dp_resonatorCurveCentralRadius + 0.5*dp_tlCouplingEmptyDimY, -0.5 * q3s0len, 0);  // fix later
-
-      FourQubitCurve *q3c1 = new FourQubitCurve(rotq3c1,
-                                                anchorq3,
-                                                "q3c1",
-                                                log_groundPlane,
-                                                false,
-                                                0,
-                                                checkOverlaps, dp_resonatorCurveCentralRadius, 180, 90);
-
-      G4LogicalVolume *log_q3c1 = q3c1->GetLogicalVolume();
-      G4VPhysicalVolume *phys_q3c1 = q3c1->GetPhysicalVolume();
-
-      // q2l1
-      G4RotationMatrix *rotq3s1 = new G4RotationMatrix();
-      rotq3s1->rotateZ(0. * deg);
-
-      G4float q3s1len =  350 * um;
-      anchorq3 = anchorq3 + G4ThreeVector(0.5 * q3s1len, -1.0*(dp_resonatorCurveCentralRadius + (0.5*dp_tlCouplingEmptyDimY)), 0);
-
-      FourQubitStraight *q3s1 = new FourQubitStraight(rotq3s1,
-                                                      anchorq3,
-                                                      "q3s1",
-                                                      log_groundPlane,
-                                                      false,
-                                                      0,
-                                                      checkOverlaps, q3s1len);
-      G4LogicalVolume *log_q3s1 = q3s1->GetLogicalVolume();
-      G4VPhysicalVolume *phys_q3s1 = q3s1->GetPhysicalVolume();
-
-
-      G4ThreeVector locateTransmon1 = anchorq3 + G4ThreeVector((0.5 * q3s1len)+(0.5*dp_transmonFieldDimY), 0.0, 0);
+         anchorq3 = anchorq3 - G4ThreeVector(0, dp_resonatorCurveCentralRadius + (0.5*dp_tlCouplingEmptyDimY), 0);  // fix later
+         FourQubitCurve *q3c0 = arena->Make<FourQubitCurve>(rotq3c0,
+                                                            anchorq3,
+                                                            "q3c0",
+                                                            log_components,
+                                                            false,
+                                                            0,
+                                                            checkOverlaps, dp_resonatorCurveCentralRadius, 90, 90);
+
+         G4LogicalVolume *log_q3c0 = q3c0->GetLogicalVolume();
+         G4VPhysicalVolume *phys_q3c0 = q3c0->GetPhysicalVolume();
+
+         // q2l0
+         G4RotationMatrix *rotq3s0 = arena->Rotation();
+         rotq3s0->rotateZ(90. * deg);
+
+         G4float q3s0len =  350 * um;
+         anchorq3 = anchorq3 - G4ThreeVector(1.0*(dp_resonatorCurveCentralRadius + (0.5*dp_tlCouplingEmptyDimY)), 0.5 * q3s0len, 0);
+
+         FourQubitStraight *q3s0 = arena->Make<FourQubitStraight>(rotq3s0,
+                                                                  anchorq3,
+                                                                  "q3s0",
+                                                                  log_components,
+                                                                  false,
+                                                                  0,
+                                                                  checkOverlaps, q3s0len);
+         G4LogicalVolume *log_q3s0 = q3s0->GetLogicalVolume();
+         G4VPhysicalVolume *phys_q3s0 = q3s0->GetPhysicalVolume();
+
+         // q3c1
+         G4RotationMatrix *rotq3c1 = arena->Rotation();
+         rotq3c1->rotateZ(0.0 * deg);
       
-      FourQubitTransmon *bottomTransmon = new FourQubitTransmon(0,
-                                                            locateTransmon1,
-                                                            "Transmon",
-                                                            log_groundPlane,
+         //anchorq3 = anchorq3 - G4ThreeVector(0, dp_resonatorCurveCentralRadius + (0.5*dp_tlCouplingEmptyDimY), 0);  // fix later
+         anchorq3 = anchorq3 + G4ThreeVector(dp_resonatorCurveCentralRadius + 0.5*dp_tlCouplingEmptyDimY, -0.5 * q3s0len, 0);  // fix later
+
+         FourQubitCurve *q3c1 = arena->Make<FourQubitCurve>(rotq3c1,
+                                                            anchorq3,
+                                                            "q3c1",
+                                                            log_components,
                                                             false,
                                                             0,
-                                                            checkOverlaps);
-      G4LogicalVolume *log_bottomTransmon = bottomTransmon->GetLogicalVolume();
-      G4VPhysicalVolume *phys_bottomTransmon = bottomTransmon->GetPhysicalVolume();
-
-      // Do the logical border creation now
-      LogicalBorderCreation(bottomTransmon, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
-      // for (int iSubVol = 0; iSubVol < bottomTransmon->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol)
-      // {
-      //    std::cout << "TLine sub volume names (to be used for boundaries): " << std::get<1>(bottomTransmon->GetListOfAllFundamentalSubVolumes()[iSubVol]) 
-      //              << " with material " << std::get<0>(bottomTransmon->GetListOfAllFundamentalSubVolumes()[iSubVol]) << std::endl;
-
-      //    std::string tempName = "border_siliconChip_" + std::get<1>(bottomTransmon->GetListOfAllFundamentalSubVolumes()[iSubVol]);
-      //    if (std::get<0>(bottomTransmon->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Vacuum") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_bottomTransmonEmpty = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip, 
-      //                                        std::get<2>(bottomTransmon->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiVacuumInterface);
-      //    }
-      //    if (std::get<0>(bottomTransmon->GetListOfAllFundamentalSubVolumes()[iSubVol]).find("Niobium") != std::string::npos)
-      //    {
-      //       G4CMPLogicalBorderSurface *border_siliconChip_bottomTransmonConductor = new G4CMPLogicalBorderSurface(tempName, phys_siliconChip, 
-      //                                        std::get<2>(bottomTransmon->GetListOfAllFundamentalSubVolumes()[iSubVol]), fSiNbInterface);
-      //    }
-      // }
+                                                            checkOverlaps, dp_resonatorCurveCentralRadius, 180, 90);
+
+         G4LogicalVolume *log_q3c1 = q3c1->GetLogicalVolume();
+         G4VPhysicalVolume *phys_q3c1 = q3c1->GetPhysicalVolume();
+
+         // q2l1
+         G4RotationMatrix *rotq3s1 = arena->Rotation();
+         rotq3s1->rotateZ(0. * deg);
+
+         G4float q3s1len =  350 * um;
+         anchorq3 = anchorq3 + G4ThreeVector(0.5 * q3s1len, -1.0*(dp_resonatorCurveCentralRadius + (0.5*dp_tlCouplingEmptyDimY)), 0);
+
+         FourQubitStraight *q3s1 = arena->Make<FourQubitStraight>(rotq3s1,
+                                                                  anchorq3,
+                                                                  "q3s1",
+                                                                  log_components,
+                                                                  false,
+                                                                  0,
+                                                                  checkOverlaps, q3s1len);
+         G4LogicalVolume *log_q3s1 = q3s1->GetLogicalVolume();
+         G4VPhysicalVolume *phys_q3s1 = q3s1->GetPhysicalVolume();
+
+
+         G4ThreeVector locateTransmon1 = anchorq3 + G4ThreeVector((0.5 * q3s1len)+(0.5*dp_transmonFieldDimY), 0.0, 0);
+      
+         FourQubitTransmon *bottomTransmon = arena->Make<FourQubitTransmon>(nullptr,
+                                                                        locateTransmon1,
+                                                                        "Transmon",
+                                                                        log_components,
+                                                                        false,
+                                                                        0,
+                                                                        checkOverlaps);
+         G4LogicalVolume *log_bottomTransmon = bottomTransmon->GetLogicalVolume();
+         G4VPhysicalVolume *phys_bottomTransmon = bottomTransmon->GetPhysicalVolume();
+
+         // Do the logical border creation now
+         LogicalBorderCreation(bottomTransmon, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
+         FourQubitSensorTable::Instance()->AddQubit("Transmon", bottomTransmon->GetPhysicalVolume(),
+                                                    bottomTransmon->GetListOfAllFundamentalSubVolumes(), phys_groundPlane);
+      }
+
+      //-------------------------------------------------------------------------------------------------------------------
+      // Any further traces described in a /g4cmp/LayoutFile, built by the generic layout builder
+      if (!FourQubitConfigManager::GetLayoutFile().empty())
+      {
+         FourQubitLayout layout(FourQubitConfigManager::GetLayoutFile());
+         layout.Place("Layout", log_components, G4ThreeVector(0, 0, 0), checkOverlaps);
+         LogicalBorderCreation(&layout, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
+      }
+
+      //-------------------------------------------------------------------------------------------------------------------
+      // Flattened geometry: one G4MultiUnion per material layer replaces everything built above
+      if (fBuildingFlatSource)
+      {
+         fBuildingFlatSource = false;
+         FourQubitFlatLayers flatLayers(log_components, "FlatLayer", phys_groundPlane, checkOverlaps);
+         G4cout << "Flattened " << flatLayers.GetNumberOfNodes() << " ground-plane volumes into "
+                << flatLayers.GetListOfAllFundamentalSubVolumes().size() << " layers" << G4endl;
+         LogicalBorderCreation(&flatLayers, phys_siliconChip, fSiNbInterface, fSiVacuumInterface);
+      }
 
    } // end
 
+   // All the component border surfaces at once
+   size_t nBorders = borders->CreateQueued();
+   G4cout << "Created " << nBorders << " component border surfaces (" << borders->size()
+          << " in total)" << G4endl;
+}
 
-   //---------------------------------------------------------------------------------------------------------------------
-   //---------------------------------------------------------------------------------------------------------------------
-   // Now we establish a sensitivity object
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+// Lattices are read from their config files on first use only, with
+// G4LatticeReader rather than G4LatticeManager::LoadLattice(), so that they
+// stay ours when a rebuild resets the lattice manager (in Construct()). The
+// physical lattices, which are cheap, are made again for the new volumes.
 
-   G4SDManager *SDman = G4SDManager::GetSDMpointer();
-   if (!fSuperconductorSensitivity)
-      fSuperconductorSensitivity = new FourQubitSensitivity("PhononElectrode");
-   SDman->AddNewDetector(fSuperconductorSensitivity);
-   log_siliconChip->SetSensitiveDetector(fSuperconductorSensitivity);
+G4LatticeLogical *FourQubitDetectorConstruction::GetLogicalLattice(G4Material *mat, const G4String &latDir)
+{
+   G4LatticeLogical *&lattice = fLogicalLattices[std::make_pair(mat, latDir)];
+   if (!lattice)
+   {
+      G4LatticeReader reader;
+      lattice = reader.MakeLattice(latDir + "/config.txt");
+   }
+   return lattice;
+}
+
+G4LatticePhysical *FourQubitDetectorConstruction::GetPhysicalLattice(G4LatticeLogical *lattice,
+                                                                     G4int h, G4int k, G4int l)
+{
+   G4LatticePhysical *&physLattice = fPhysicalLattices[std::make_tuple(lattice, h, k, l)];
+   if (!physLattice)
+   {
+      physLattice = new G4LatticePhysical(lattice);
+      physLattice->SetMillerOrientation(h, k, l);
+   }
+   return physLattice;
+}
+
+// G4LatticeManager gives physics processes access to lattices by volume;
+// each registration is also kept for the geometry snapshot
+
+void FourQubitDetectorConstruction::RegisterLattice(G4VPhysicalVolume *pv, const G4String &latDir,
+                                                    G4int h, G4int k, G4int l)
+{
+   G4LatticeLogical *lattice = GetLogicalLattice(pv->GetLogicalVolume()->GetMaterial(), latDir);
+   G4LatticeManager::GetLatticeManager()->RegisterLattice(pv, GetPhysicalLattice(lattice, h, k, l));
+
+   FourQubitGeometrySnapshot::Lattice entry = {pv, latDir, h, k, l};
+   fLattices.push_back(entry);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////
+//
+// FourQubitDetectorParameters.cc
+//
+// Runtime store behind the dp_ parameters declared in
+// FourQubitDetectorParameters.hh: registration, lookup
+// by name, and parsing of macro or file values.
+//
+////////////////////////////////////////////////////////
+
+#include "FourQubitDetectorParameters.hh"
+#include "G4UnitsTable.hh"
+#include "globals.hh"
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+
+namespace FourQubitDetectorParameters
+{
+  namespace {
+    //Function-local statics, since parameters register during static
+    //initialization of every translation unit that includes the header
+    std::vector<ParameterBase*>& Registry() {
+      static std::vector<ParameterBase*> all;
+      return all;
+    }
+
+    std::unordered_map<std::string,ParameterBase*>& Index() {
+      static std::unordered_map<std::string,ParameterBase*> byName;
+      return byName;
+    }
+  }
+
+  ParameterBase::ParameterBase(const char* name) : fName(name) {
+    Registry().push_back(this);
+    Index()[name] = this;
+  }
+
+  ParameterBase* FindParameter(const std::string& name) {
+    auto entry = Index().find(name);
+    if (entry == Index().end()) entry = Index().find("dp_" + name);
+    return (entry == Index().end()) ? 0 : entry->second;
+  }
+
+  const std::vector<ParameterBase*>& GetAllParameters() {
+    return Registry();
+  }
+
+
+  bool SetParameter(const std::string& name, const std::string& value) {
+    ParameterBase* param = FindParameter(name);
+    if (!param) {
+      G4ExceptionDescription msg;
+      msg << "No geometry parameter named " << name << ".";
+      G4Exception("FourQubitDetectorParameters::SetParameter", "Geometry001",
+		  JustWarning, msg);
+      return false;
+    }
+
+    std::istringstream fields(value);
+    std::string number, unit;
+    fields >> number >> unit;
+
+    if (number == "default") {
+      param->Reset();
+      return true;
+    }
+
+    double parsed = 0.;
+    if (param->IsBool() && (number == "true" || number == "false")) {
+      parsed = (number == "true");
+    } else {
+      std::istringstream numberStream(number);
+      if (!(numberStream >> parsed) || !numberStream.eof()) {
+	G4ExceptionDescription msg;
+	msg << "Cannot read \"" << value << "\" as a value for " << name << ".";
+	G4Exception("FourQubitDetectorParameters::SetParameter", "Geometry002",
+		    JustWarning, msg);
+	return false;
+      }
+    }
+
+    if (!unit.empty()) {
+      if (!G4UnitDefinition::IsUnitDefined(unit)) {
+	G4ExceptionDescription msg;
+	msg << "Unknown unit \"" << unit << "\" for " << name << ".";
+	G4Exception("FourQubitDetectorParameters::SetParameter", "Geometry002",
+		    JustWarning, msg);
+	return false;
+      }
+      parsed *= G4UnitDefinition::GetValueOf(unit);
+    }
+
+    param->SetValue(parsed);
+    return true;
+  }
+
+
+  void ResetParameters() {
+    for (ParameterBase* param : Registry()) param->Reset();
+  }
+
+
+  bool LoadParameterFile(const std::string& filename) {
+    std::ifstream in(filename);
+    if (!in.good()) {
+      G4ExceptionDescription msg;
+      msg << "Unable to open geometry parameter file " << filename << ".";
+      G4Exception("FourQubitDetectorParameters::LoadParameterFile",
+		  "Geometry003", JustWarning, msg);
+      return false;
+    }
+
+    bool allSet = true;
+    std::string line;
+    while (std::getline(in, line)) {
+      line = line.substr(0, line.find('#'));
+
+      std::istringstream fields(line);
+      std::string name, value;
+      if (!(fields >> name)) continue;		// Blank or comment
+      std::getline(fields, value);
+
+      allSet &= SetParameter(name, value);
+    }
+    return allSet;
+  }
+
+
+  void ListParameters(std::ostream& out) {
+    out << "Geometry parameters (internal units: mm, ns, rad); * = changed"
+	<< std::endl;
+    for (const ParameterBase* param : Registry()) {
+      out << (param->IsSet() ? " * " : "   ") << std::left << std::setw(48)
+	  << param->GetName() << " ";
+      if (param->IsBool()) out << (param->GetValue() ? "true" : "false");
+      else out << param->GetValue();
+      out << std::endl;
+    }
+    out << std::right;
+  }
+}
@@ -0,0 +1,59 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitEventAction.cc
+//
+// Description:	Event boundaries for /g4cmp/EventTiming.
+
+#include "FourQubitEventAction.hh"
+#include "FourQubitSteppingAction.hh"
+#include "G4Event.hh"
+#include "G4EventManager.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4VHitsCollection.hh"
+
+
+FourQubitEventAction::FourQubitEventAction()
+  : stepping(0), stepsAtStart(0), tracksAtStart(0) {;}
+
+
+void FourQubitEventAction::BeginOfRun(G4int runID) {
+  timer.BeginOfRun(runID);
+  stepping = dynamic_cast<FourQubitSteppingAction*>
+    (G4EventManager::GetEventManager()->GetUserSteppingAction());
+}
+
+void FourQubitEventAction::EndOfRun() {
+  timer.EndOfRun();
+}
+
+
+void FourQubitEventAction::BeginOfEventAction(const G4Event*) {
+  if (stepping) stepping->BeginOfEvent();
+  if (!timer.IsActive()) return;
+
+  stepsAtStart = stepping ? stepping->GetStepCount() : 0;
+  tracksAtStart = stepping ? stepping->GetTrackCount() : 0;
+  timer.BeginOfEvent();
+}
+
+// The sensitive detectors have finished with the event by now, so its hit
+// collections are complete
+
+void FourQubitEventAction::EndOfEventAction(const G4Event* event) {
+  if (!timer.IsActive()) return;
+
+  G4long nHits = 0;
+  G4HCofThisEvent* HCE = event->GetHCofThisEvent();
+  for (size_t i=0; HCE && i<HCE->GetCapacity(); i++) {
+    G4VHitsCollection* hc = HCE->GetHC(G4int(i));
+    if (hc) nHits += G4long(hc->GetSize());
+  }
+
+  G4long nSteps = stepping ? stepping->GetStepCount() - stepsAtStart : 0;
+  G4long nTracks = stepping ? stepping->GetTrackCount() - tracksAtStart : 0;
+  timer.EndOfEvent(event->GetEventID(), nSteps, nTracks, nHits);
+}
@@ -0,0 +1,254 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitEventTimer.cc
+//
+// Description:	Per-thread event statistics for /g4cmp/EventTiming.
+
+#include "FourQubitEventTimer.hh"
+#include "FourQubitConfigManager.hh"
+#include "G4AutoLock.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iomanip>
+#include <sys/resource.h>
+#include <unistd.h>
+
+
+// Shared totals; each worker's values are appended under the lock
+
+namespace {
+  G4Mutex totalsMutex = G4MUTEX_INITIALIZER;
+
+  struct Totals {
+    std::vector<float> seconds, steps, tracks, hits;
+    std::vector<FourQubitEventTimer::EventInfo> slowest;
+    size_t nSlowest = 0;
+    G4double peakRSS = 0.;
+  } totals;
+
+  G4bool Slower(const FourQubitEventTimer::EventInfo& a,
+		const FourQubitEventTimer::EventInfo& b) {
+    return a.seconds > b.seconds;
+  }
+
+  // Startup of the job, written by the master before any worker runs
+  std::chrono::steady_clock::time_point jobStart;
+  G4bool jobStarted = false, startupPrinted = false;
+  G4double geometrySeconds = 0.;
+
+  // Nearest-rank percentile; reorders the values
+  G4double Percentile(std::vector<float>& values, G4double fraction) {
+    if (values.empty()) return 0.;
+    size_t rank = size_t(fraction * (values.size()-1) + 0.5);
+    std::nth_element(values.begin(), values.begin()+rank, values.end());
+    return values[rank];
+  }
+
+  void PrintRow(const char* name, std::vector<float>& values, G4double scale) {
+    G4double p50 = Percentile(values, 0.50);
+    G4double p99 = Percentile(values, 0.99);
+    G4double max = values.empty() ? 0. : *std::max_element(values.begin(), values.end());
+    G4cout << std::setw(16) << std::left << name << std::right
+	   << std::setw(14) << p50*scale << std::setw(14) << p99*scale
+	   << std::setw(14) << max*scale << G4endl;
+  }
+}
+
+
+FourQubitEventTimer::FourQubitEventTimer()
+  : timing(false), nSlowest(0), heartbeat(0.), runID(0), nEvents(0),
+    peakRSS(0.) {;}
+
+
+// Linux reports the current RSS in /proc; elsewhere the peak will do.
+// The file is opened once and re-read with pread(), which needs no lock
+// and costs one syscall per call instead of an ifstream per event.
+
+G4double FourQubitEventTimer::ResidentMB() {
+  static const int statm = open("/proc/self/statm", O_RDONLY);
+  static const long pageSize = sysconf(_SC_PAGESIZE);
+  if (statm >= 0) {
+    char buf[64];
+    ssize_t n = pread(statm, buf, sizeof(buf)-1, 0);
+    if (n > 0) {
+      buf[n] = '\0';
+      char* end = 0;
+      strtol(buf, &end, 10);			// Total pages
+      long resident = strtol(end, 0, 10);
+      return G4double(resident) * pageSize / (1024.*1024.);
+    }
+  }
+
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.;
+#ifdef __APPLE__
+  return usage.ru_maxrss / (1024.*1024.);
+#else
+  return usage.ru_maxrss / 1024.;
+#endif
+}
+
+
+// Run boundaries
+
+void FourQubitEventTimer::BeginOfRun(G4int theRunID) {
+  timing = FourQubitConfigManager::GetEventTiming();
+  nSlowest = size_t(std::max(FourQubitConfigManager::GetEventTimingSlowest(), 0));
+  heartbeat = FourQubitConfigManager::GetHeartbeatInterval() / s;
+  runID = theRunID;
+
+  nEvents = 0;
+  seconds.clear(); steps.clear(); tracks.clear(); hits.clear();
+  slowest.clear();
+  peakRSS = 0.;
+  runStart = lastBeat = Clock::now();
+}
+
+void FourQubitEventTimer::EndOfRun() {
+  if (!timing) return;
+
+  G4AutoLock lock(&totalsMutex);
+  totals.seconds.insert(totals.seconds.end(), seconds.begin(), seconds.end());
+  totals.steps.insert(totals.steps.end(), steps.begin(), steps.end());
+  totals.tracks.insert(totals.tracks.end(), tracks.begin(), tracks.end());
+  totals.hits.insert(totals.hits.end(), hits.begin(), hits.end());
+  totals.slowest.insert(totals.slowest.end(), slowest.begin(), slowest.end());
+  totals.nSlowest = nSlowest;
+  totals.peakRSS = std::max(totals.peakRSS, peakRSS);
+  lock.unlock();
+
+  seconds.clear(); steps.clear(); tracks.clear(); hits.clear();
+  slowest.clear();
+}
+
+
+// Hot path: a clock read at each end, a pread of /proc, four push_backs
+
+void FourQubitEventTimer::BeginOfEvent() {
+  eventStart = Clock::now();
+}
+
+void FourQubitEventTimer::EndOfEvent(G4int eventID, G4long nSteps,
+				     G4long nTracks, G4long nHits) {
+  const Clock::time_point now = Clock::now();
+  const G4double dt = std::chrono::duration<G4double>(now - eventStart).count();
+  nEvents++;
+  G4double rss = -1.;
+
+  if (timing) {
+    seconds.push_back(float(dt));
+    steps.push_back(float(nSteps));
+    tracks.push_back(float(nTracks));
+    hits.push_back(float(nHits));
+
+    rss = ResidentMB();
+    peakRSS = std::max(peakRSS, rss);
+
+    if (nSlowest > 0 && (slowest.size() < nSlowest || dt > slowest.front().seconds)) {
+      EventInfo info = { eventID, G4Threading::G4GetThreadId(), dt,
+			 nSteps, nTracks, nHits, rss };
+      if (slowest.size() == nSlowest) {
+	std::pop_heap(slowest.begin(), slowest.end(), Slower);
+	slowest.pop_back();
+      }
+      slowest.push_back(info);
+      std::push_heap(slowest.begin(), slowest.end(), Slower);
+    }
+  }
+
+  if (heartbeat > 0. &&
+      std::chrono::duration<G4double>(now - lastBeat).count() >= heartbeat) {
+    lastBeat = now;
+    if (rss < 0.) rss = ResidentMB();
+    const G4double elapsed = std::chrono::duration<G4double>(now - runStart).count();
+    G4cout << "FourQubit heartbeat: run " << runID << ", " << nEvents
+	   << " events in " << std::fixed << std::setprecision(1) << elapsed
+	   << " s (" << (elapsed > 0. ? nEvents/elapsed : 0.) << "/s), event "
+	   << eventID << " took " << std::setprecision(2) << dt*1e3
+	   << " ms, RSS " << std::setprecision(0) << rss << " MB"
+	   << std::defaultfloat << std::setprecision(6) << G4endl;
+  }
+}
+
+
+// Output: one table of percentiles, then the slowest events
+
+void FourQubitEventTimer::PrintSummary(G4int runID) {
+  G4AutoLock lock(&totalsMutex);
+  if (totals.seconds.empty()) return;
+
+  G4double summed = 0.;
+  for (float s : totals.seconds) summed += s;
+
+  G4cout << "\n=========== Event timing (/g4cmp/EventTiming) ===========\n"
+	 << "Run " << runID << ": " << totals.seconds.size() << " events, "
+	 << summed << " s summed event time, peak RSS "
+	 << std::fixed << std::setprecision(1) << totals.peakRSS << " MB\n"
+	 << std::setw(16) << std::left << "" << std::right
+	 << std::setw(14) << "p50" << std::setw(14) << "p99"
+	 << std::setw(14) << "max" << G4endl;
+  G4cout << std::setprecision(3);
+  PrintRow("wall time [ms]", totals.seconds, 1e3);
+  G4cout << std::setprecision(0);
+  PrintRow("steps", totals.steps, 1.);
+  PrintRow("tracks", totals.tracks, 1.);
+  PrintRow("hits", totals.hits, 1.);
+
+  std::sort(totals.slowest.begin(), totals.slowest.end(), Slower);
+  if (totals.slowest.size() > totals.nSlowest) totals.slowest.resize(totals.nSlowest);
+
+  if (!totals.slowest.empty()) {
+    G4cout << "\n--- Slowest " << totals.slowest.size() << " events ---\n"
+	   << std::setw(10) << "event" << std::setw(8) << "thread"
+	   << std::setw(14) << "time [ms]" << std::setw(14) << "steps"
+	   << std::setw(12) << "tracks" << std::setw(10) << "hits"
+	   << std::setw(12) << "RSS [MB]" << G4endl;
+    for (const EventInfo& e : totals.slowest) {
+      G4cout << std::setw(10) << e.eventID << std::setw(8) << e.threadID
+	     << std::setw(14) << std::setprecision(3) << e.seconds*1e3
+	     << std::setw(14) << e.steps << std::setw(12) << e.tracks
+	     << std::setw(10) << e.hits
+	     << std::setw(12) << std::setprecision(1) << e.rssMB << G4endl;
+    }
+  }
+  G4cout << "=========================================================="
+	 << std::defaultfloat << std::setprecision(6) << G4endl;
+
+  totals.seconds.clear(); totals.steps.clear();
+  totals.tracks.clear(); totals.hits.clear();
+  totals.slowest.clear();
+  totals.peakRSS = 0.;
+}
+
+
+// Job startup
+
+void FourQubitEventTimer::MarkJobStart() {
+  jobStart = Clock::now();
+  jobStarted = true;
+}
+
+void FourQubitEventTimer::AddGeometryTime(G4double seconds) {
+  geometrySeconds += seconds;
+}
+
+// Up to the first run: physics tables are built by then too
+
+void FourQubitEventTimer::PrintStartup() {
+  if (!jobStarted || startupPrinted) return;
+  startupPrinted = true;
+
+  G4double seconds = std::chrono::duration<G4double>(Clock::now()-jobStart).count();
+  G4cout << "FourQubit startup: " << std::fixed << std::setprecision(2)
+	 << seconds << " s to the first run (geometry " << geometrySeconds
+	 << " s" << (FourQubitConfigManager::GetHeadless() ? ", headless)" : ")")
+	 << std::defaultfloat << std::setprecision(6) << G4endl;
+}
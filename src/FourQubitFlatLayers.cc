@@ -0,0 +1,159 @@
+//
+/// \file FourQubitFlatLayers.cc
+/// \brief Implementation of the class merging the ground-plane features
+///        into one solid per material layer
+
+// Includes (G4)
+#include "G4Colour.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4MultiUnion.hh"
+#include "G4PVPlacement.hh"
+#include "G4Transform3D.hh"
+#include "G4VisAttributes.hh"
+
+// Includes (specific to this project)
+#include "FourQubitFlatLayers.hh"
+#include "FourQubitSensorTable.hh"
+#include "FourQubitVisAttributes.hh"
+
+#include <cstdio>
+#include <map>
+#include <utility>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Primary Constructor
+FourQubitFlatLayers::FourQubitFlatLayers(G4LogicalVolume *pSourceLogical,
+                                         const G4String &pName,
+                                         G4VPhysicalVolume *pMotherPhysical,
+                                         G4bool pSurfChk)
+    : fNodeCount(0)
+{
+  // One layer per (depth, material): depth counts the material changes on
+  // the way down from the ground plane
+  struct Layer
+  {
+    G4Material *material;
+    const G4Material *motherMaterial;
+    std::vector<FourQubitSensorTable::FlatNode> nodes;
+    std::vector<G4Transform3D> transforms; // Node to ground-plane frame
+  };
+  std::map<std::pair<G4int, const G4Material *>, Layer> layers;
+
+  struct Entry
+  {
+    G4VPhysicalVolume *pv;
+    G4Transform3D transform; // Volume to ground-plane frame
+    G4int depth;
+    const G4Material *motherMaterial;
+  };
+
+  std::vector<Entry> stack;
+  for (size_t i = 0; i < pSourceLogical->GetNoDaughters(); ++i)
+  {
+    G4VPhysicalVolume *d = pSourceLogical->GetDaughter(i);
+    stack.push_back({d, G4Transform3D(d->GetObjectRotationValue(), d->GetObjectTranslation()),
+                     0, pSourceLogical->GetMaterial()});
+  }
+
+  G4bool warnedReplica = false;
+  while (!stack.empty())
+  {
+    Entry entry = stack.back();
+    stack.pop_back();
+
+    if (entry.pv->IsReplicated())
+    {
+      if (!warnedReplica)
+      {
+        G4ExceptionDescription msg;
+        msg << "Replicated volume " << entry.pv->GetName() << " cannot be merged and is left out"
+            << " of the flattened geometry.";
+        G4Exception("FourQubitFlatLayers::FourQubitFlatLayers", "Flatten001", JustWarning, msg);
+        warnedReplica = true;
+      }
+      continue;
+    }
+
+    G4LogicalVolume *log = entry.pv->GetLogicalVolume();
+    G4Material *material = log->GetMaterial();
+    G4int depth = entry.depth;
+    if (material != entry.motherMaterial)
+    {
+      depth++;
+      Layer &layer = layers[std::make_pair(depth, material)];
+      layer.material = material;
+      layer.motherMaterial = entry.motherMaterial;
+      layer.nodes.push_back({log->GetSolid(), G4Transform3D(), entry.pv});
+      layer.transforms.push_back(entry.transform);
+    }
+
+    for (size_t i = 0; i < log->GetNoDaughters(); ++i)
+    {
+      G4VPhysicalVolume *d = log->GetDaughter(i);
+      G4Transform3D toDaughter(d->GetObjectRotationValue(), d->GetObjectTranslation());
+      stack.push_back({d, entry.transform * toDaughter, depth, material});
+    }
+  }
+
+  //------------------------------------------------------------------------------------------
+  // Build the unions, shallowest first, each inside the layer of its mother material
+  const G4VisAttributes *niobium_vis = FourQubitVisAttributes::Get(G4Colour(0.0, 1.0, 1.0, 0.5));
+  const G4VisAttributes *air_vis = FourQubitVisAttributes::Get(G4Colour(0.5, 0.5, 0.5, 0.5));
+
+  const G4Transform3D worldFromGround(pMotherPhysical->GetObjectRotationValue(),
+                                      pMotherPhysical->GetObjectTranslation());
+  std::map<std::pair<G4int, const G4Material *>, G4LogicalVolume *> layerLogicals;
+  FourQubitSensorTable *sensors = FourQubitSensorTable::Instance();
+
+  for (auto &entry : layers)
+  {
+    G4int depth = entry.first.first;
+    Layer &layer = entry.second;
+
+    G4LogicalVolume *mother = pMotherPhysical->GetLogicalVolume();
+    if (depth > 1)
+    {
+      auto found = layerLogicals.find(std::make_pair(depth - 1, layer.motherMaterial));
+      if (found == layerLogicals.end())
+        continue; // No layer above to sit in (e.g. a replica's daughters)
+      mother = found->second;
+    }
+
+    G4bool niobium = layer.material->GetName().find("Nb") != std::string::npos;
+    char name[400];
+    sprintf(name, "%s_%s%d", pName.c_str(), niobium ? "Conductor" : "Empty", depth);
+    G4String layerName(name);
+
+    G4MultiUnion *solid_layer = new G4MultiUnion(layerName + "_solid");
+    for (size_t i = 0; i < layer.nodes.size(); ++i)
+    {
+      solid_layer->AddNode(*const_cast<G4VSolid *>(layer.nodes[i].solid), layer.transforms[i]);
+      layer.nodes[i].toNode = (worldFromGround * layer.transforms[i]).inverse();
+    }
+    solid_layer->Voxelize();
+
+    G4LogicalVolume *log_layer = new G4LogicalVolume(solid_layer, layer.material, layerName + "_log");
+    log_layer->SetVisAttributes(niobium ? niobium_vis : air_vis);
+    G4VPhysicalVolume *phys_layer = new G4PVPlacement(0,
+                                                      G4ThreeVector(0, 0, 0),
+                                                      log_layer,
+                                                      layerName,
+                                                      mother,
+                                                      false,
+                                                      0,
+                                                      pSurfChk);
+    layerLogicals[entry.first] = log_layer;
+
+    sensors->AddFlatVolume(phys_layer, layer.nodes);
+    fNodeCount += layer.nodes.size();
+    fFundamentalVolumeList.push_back(FourQubitSubVolume(niobium ? FourQubitMaterialTag::Niobium : FourQubitMaterialTag::Vacuum,
+                                                        layerName, phys_layer));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+const FourQubitSubVolumeList& FourQubitFlatLayers::GetListOfAllFundamentalSubVolumes() const
+{
+  return fFundamentalVolumeList;
+}
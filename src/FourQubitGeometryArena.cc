@@ -0,0 +1,45 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitGeometryArena.cc
+//
+// Description:	Pooled ownership of the non-store geometry objects.
+
+#include "FourQubitGeometryArena.hh"
+#include "G4ios.hh"
+
+
+// The first block is sized for the default chip; bigger builds (arrays,
+// layouts) just add blocks
+
+FourQubitGeometryArena::FourQubitGeometryArena()
+  : pool(64*1024), nObjects(0), nRotations(0), nBytes(0), nReleased(0),
+    nBuilds(0) {;}
+
+FourQubitGeometryArena* FourQubitGeometryArena::Instance() {
+  static FourQubitGeometryArena theArena;
+  return &theArena;
+}
+
+void FourQubitGeometryArena::Release() {
+  for (auto obj = owned.rbegin(); obj != owned.rend(); ++obj)
+    obj->destroy(obj->object);
+  owned.clear();
+  pool.release();
+
+  if (nObjects > 0) nBuilds++;
+  nReleased += nObjects;
+  nObjects = nRotations = nBytes = 0;
+}
+
+void FourQubitGeometryArena::Report() const {
+  G4cout << "Geometry arena: " << nObjects << " objects (" << nRotations
+	 << " rotations, " << nObjects-nRotations << " other), "
+	 << nBytes/1024. << " kB";
+  if (nBuilds > 0)
+    G4cout << "; " << nReleased << " released by " << nBuilds << " earlier builds";
+  G4cout << G4endl;
+}
@@ -0,0 +1,203 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitGeometryCheck.cc
+//
+// Description:	One-off, multithreaded overlap check of the whole geometry
+//		and the geometry hash that records a passed check.
+
+#include "FourQubitGeometryCheck.hh"
+#include "FourQubitConfigManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4RotationMatrix.hh"
+#include "G4VPVParameterisation.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+
+namespace {
+  void StreamPlacement(std::ostream& out, const G4VPhysicalVolume* pv) {
+    const G4RotationMatrix rot = pv->GetObjectRotationValue();
+    out << pv->GetObjectTranslation() << ' '
+	<< rot.xx() << ' ' << rot.xy() << ' ' << rot.xz() << ' '
+	<< rot.yx() << ' ' << rot.yy() << ' ' << rot.yz() << ' '
+	<< rot.zx() << ' ' << rot.zy() << ' ' << rot.zz() << '\n';
+  }
+
+  // Volumes whose check can't run alongside others: a parameterised
+  // volume moves itself to each copy while being checked, and the
+  // navigation caches of G4MultiUnion are not shared safely
+  G4bool CheckAlone(const G4VPhysicalVolume* pv) {
+    return pv->IsReplicated() ||
+      pv->GetLogicalVolume()->GetSolid()->GetEntityType() == "G4MultiUnion";
+  }
+}
+
+
+// Volumes are hashed in store order, which is the construction order, so
+// the same parameters always give the same digest
+
+G4String FourQubitGeometryCheck::GeometryHash() {
+  uint64_t hash = kHashBasis;
+
+  for (G4VPhysicalVolume* pv : *G4PhysicalVolumeStore::GetInstance()) {
+    const G4LogicalVolume* log = pv->GetLogicalVolume();
+    const G4LogicalVolume* mother = pv->GetMotherLogical();
+
+    std::ostringstream desc;
+    desc << std::setprecision(17)
+	 << pv->GetName() << ' ' << pv->GetCopyNo() << ' '
+	 << (mother ? mother->GetName() : G4String("none")) << ' '
+	 << log->GetName() << ' '
+	 << (log->GetMaterial() ? log->GetMaterial()->GetName() : G4String("none")) << '\n';
+    log->GetSolid()->StreamInfo(desc);
+
+    if (pv->IsParameterised()) {
+      G4VPVParameterisation* param = pv->GetParameterisation();
+      for (G4int i=0; i<pv->GetMultiplicity(); i++) {
+	param->ComputeTransformation(i, pv);
+	StreamPlacement(desc, pv);
+      }
+    } else {
+      StreamPlacement(desc, pv);
+    }
+
+    HashBytes(hash, desc.str());
+  }
+
+  return HexDigest(hash);
+}
+
+void FourQubitGeometryCheck::HashBytes(uint64_t& hash, const std::string& bytes) {
+  for (unsigned char c : bytes) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+}
+
+G4String FourQubitGeometryCheck::HexDigest(uint64_t hash) {
+  char digest[17];
+  snprintf(digest, sizeof(digest), "%016llx", (unsigned long long)hash);
+  return digest;
+}
+
+
+// Everything a check touches is read-only except lazily filled solid
+// caches (e.g. the primitives behind a boolean solid's surface points),
+// so each solid is sampled once here before the threads start
+
+G4int FourQubitGeometryCheck::CheckOverlaps(G4int nThreads, G4int nPoints,
+					    std::ostream& report) {
+  std::vector<G4VPhysicalVolume*> shared, alone;
+  std::set<G4VSolid*> solids;
+  for (G4VPhysicalVolume* pv : *G4PhysicalVolumeStore::GetInstance()) {
+    if (!pv->GetMotherLogical()) continue;		// World
+    (CheckAlone(pv) ? alone : shared).push_back(pv);
+    solids.insert(pv->GetLogicalVolume()->GetSolid());
+  }
+  for (G4VSolid* solid : solids) solid->GetPointOnSurface();
+
+  std::vector<char> overlaps(shared.size(), 0);
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    for (size_t i = next++; i < shared.size(); i = next++)
+      overlaps[i] = shared[i]->CheckOverlaps(nPoints, 0., false, 1);
+  };
+
+  nThreads = std::max(1, std::min(nThreads, G4int(shared.size())));
+  std::vector<std::thread> threads;
+  for (G4int t=1; t<nThreads; t++) threads.emplace_back(worker);
+  worker();
+  for (std::thread& t : threads) t.join();
+
+  G4int nOverlaps = 0;
+  for (size_t i=0; i<shared.size(); i++) {
+    if (!overlaps[i]) continue;
+    report << "  overlap: " << shared[i]->GetName() << " in "
+	   << shared[i]->GetMotherLogical()->GetName() << std::endl;
+    nOverlaps++;
+  }
+  for (G4VPhysicalVolume* pv : alone) {
+    if (!pv->CheckOverlaps(nPoints, 0., false, 1)) continue;
+    report << "  overlap: " << pv->GetName() << " in "
+	   << pv->GetMotherLogical()->GetName() << std::endl;
+    nOverlaps++;
+  }
+
+  report << "Checked " << shared.size()+alone.size() << " volumes ("
+	 << alone.size() << " on their own) with " << nThreads
+	 << " threads, " << nPoints << " points each: " << nOverlaps
+	 << " overlapping" << std::endl;
+
+  return nOverlaps;
+}
+
+
+G4int FourQubitGeometryCheck::Run(G4int nThreads, G4int nPoints) {
+  const G4String hash = GeometryHash();
+  G4cout << "Geometry check, hash " << hash << G4endl;
+
+  G4int nOverlaps = CheckOverlaps(nThreads, nPoints, G4cout);
+  if (nOverlaps == 0)
+    RecordValidated(FourQubitConfigManager::GetValidationFile(), hash);
+  return nOverlaps;
+}
+
+
+G4bool FourQubitGeometryCheck::IsValidated(const G4String& file,
+					   const G4String& hash) {
+  std::ifstream in(file);
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream fields(line.substr(0, line.find('#')));
+    std::string known;
+    if ((fields >> known) && known == hash) return true;
+  }
+  return false;
+}
+
+void FourQubitGeometryCheck::RecordValidated(const G4String& file,
+					     const G4String& hash) {
+  if (file.empty() || IsValidated(file, hash)) return;
+
+  std::ofstream out(file, std::ios_base::app);
+  if (!out.good()) {
+    G4ExceptionDescription msg;
+    msg << "Unable to write geometry validation file " << file << ".";
+    G4Exception("FourQubitGeometryCheck::RecordValidated", "Check001",
+		JustWarning, msg);
+    return;
+  }
+  out << hash << std::endl;
+  G4cout << "Geometry " << hash << " recorded as validated in " << file << G4endl;
+}
+
+void FourQubitGeometryCheck::WarnIfNotValidated(const G4String& file) {
+  if (file.empty()) return;
+
+  const G4String hash = GeometryHash();
+  if (IsValidated(file, hash)) return;
+
+  G4ExceptionDescription msg;
+  msg << "Geometry " << hash << " has not been checked for overlaps (not in "
+      << file << ").  Run FourQubit --check-geometry with the same settings,"
+      << " or use /g4cmp/CheckOverlaps true.";
+  G4Exception("FourQubitGeometryCheck::WarnIfNotValidated", "Check002",
+	      JustWarning, msg);
+}
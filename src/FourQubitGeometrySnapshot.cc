@@ -0,0 +1,358 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitGeometrySnapshot.cc
+//
+// Description:	Saving and loading of /g4cmp/GeometrySnapshot geometries.
+
+#include "FourQubitGeometrySnapshot.hh"
+#include "FourQubitBorderTable.hh"
+#include "FourQubitConfigManager.hh"
+#include "FourQubitDetectorParameters.hh"
+#include "FourQubitGeometryCheck.hh"
+#include "FourQubitMPI.hh"
+#include "FourQubitSensorTable.hh"
+#include "G4CMPSurfaceProperty.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4SolidStore.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Version.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <system_error>
+#include <unordered_map>
+#include <unistd.h>
+
+#ifdef FOURQUBIT_GDML
+#include "G4GDMLParser.hh"
+#endif
+
+// Generated by CMake from every source and header; see Key()
+#if __has_include("FourQubitSourceHash.hh")
+#include "FourQubitSourceHash.hh"
+#endif
+#ifndef FOURQUBIT_SOURCE_HASH
+#define FOURQUBIT_SOURCE_HASH ""
+#endif
+
+
+namespace {
+  const char* const kSnapshotMagic = "FourQubitGeometrySnapshot";
+  const G4int kSnapshotVersion = 2;	// Bump when the file layout changes
+
+  // Every physical volume in a fixed order: the world, then the daughters
+  // of each logical volume the first time it is reached, breadth first.
+  // GDML keeps logical volumes shared and daughters in order, so a volume
+  // has the same index in the saved and the loaded tree.
+  std::vector<G4VPhysicalVolume*> VolumeOrder(G4VPhysicalVolume* world) {
+    std::vector<G4VPhysicalVolume*> order(1, world);
+    std::set<const G4LogicalVolume*> seen;
+    for (size_t i=0; i<order.size(); i++) {
+      G4LogicalVolume* log = order[i]->GetLogicalVolume();
+      if (!seen.insert(log).second) continue;
+      for (size_t d=0; d<log->GetNoDaughters(); d++)
+	order.push_back(log->GetDaughter(d));
+    }
+    return order;
+  }
+
+  // The rest of the line, without its leading space
+  G4String RestOfLine(std::istream& in) {
+    std::string rest;
+    std::getline(in, rest);
+    if (!rest.empty() && rest[0] == ' ') rest.erase(0, 1);
+    return rest;
+  }
+
+  void WriteFootprint(std::ostream& out, const char* type,
+		      const FourQubitSensorTable::Footprint& f) {
+    out << type << ' ' << f.id << ' ' << f.qubitID << ' '
+	<< f.min.x() << ' ' << f.min.y() << ' ' << f.min.z() << ' '
+	<< f.max.x() << ' ' << f.max.y() << ' ' << f.max.z() << ' '
+	<< f.name << '\n';
+  }
+
+  G4bool ReadFootprint(std::istream& in, FourQubitSensorTable::Footprint& f) {
+    G4double x0, y0, z0, x1, y1, z1;
+    if (!(in >> f.id >> f.qubitID >> x0 >> y0 >> z0 >> x1 >> y1 >> z1)) return false;
+    f.min.set(x0, y0, z0);
+    f.max.set(x1, y1, z1);
+    f.name = RestOfLine(in);
+    return true;
+  }
+
+  // For a load that fails after the GDML was read: nothing else is in the
+  // stores yet, since Construct() cleaned them before loading
+  void CleanStores() {
+    G4PhysicalVolumeStore::GetInstance()->Clean();
+    G4LogicalVolumeStore::GetInstance()->Clean();
+    G4SolidStore::GetInstance()->Clean();
+  }
+}
+
+
+G4bool FourQubitGeometrySnapshot::Available() {
+#ifdef FOURQUBIT_GDML
+  return FOURQUBIT_SOURCE_HASH[0] != '\0';
+#else
+  return false;
+#endif
+}
+
+// Parameters are sorted by name, so the key doesn't depend on the order
+// they register in.  The source hash ties the key to the construction
+// code: a snapshot saved by a different build of FourQubit is never found.
+// Builds without the hash (not made with CMake) don't use snapshots.
+
+G4String FourQubitGeometrySnapshot::Key() {
+  std::vector<FourQubitDetectorParameters::ParameterBase*> params =
+    FourQubitDetectorParameters::GetAllParameters();
+  std::sort(params.begin(), params.end(),
+	    [](const FourQubitDetectorParameters::ParameterBase* a,
+	       const FourQubitDetectorParameters::ParameterBase* b) {
+	      return std::string(a->GetName()) < b->GetName(); });
+
+  std::ostringstream desc;
+  desc << std::setprecision(17) << kSnapshotMagic << ' ' << kSnapshotVersion
+       << ' ' << G4VERSION_NUMBER << ' ' << FOURQUBIT_SOURCE_HASH << '\n';
+  for (const FourQubitDetectorParameters::ParameterBase* p : params)
+    desc << p->GetName() << ' ' << p->GetValue() << '\n';
+
+  const G4String& layout = FourQubitConfigManager::GetLayoutFile();
+  desc << "layout " << layout << '\n';
+  if (!layout.empty()) {
+    std::ifstream in(layout);
+    desc << in.rdbuf();
+  }
+
+  uint64_t hash = FourQubitGeometryCheck::kHashBasis;
+  FourQubitGeometryCheck::HashBytes(hash, desc.str());
+  return FourQubitGeometryCheck::HexDigest(hash);
+}
+
+G4String FourQubitGeometrySnapshot::FileName(const G4String& dir,
+					     const G4String& key) {
+  return dir + "/FourQubit_" + key + ".gdml";
+}
+
+
+// Saving
+//
+// Both files are written under scratch names and renamed into place,
+// sidecar last: a snapshot is only used once its sidecar exists, so a job
+// killed while saving, or two jobs saving the same key, never leave a
+// half-written one
+
+G4bool FourQubitGeometrySnapshot::Save(const G4String& dir,
+				       G4VPhysicalVolume* world,
+				       const std::vector<Lattice>& lattices) {
+  if (!Available()) {
+    static G4bool warned = false;
+    if (!warned) {
+      G4Exception("FourQubitGeometrySnapshot::Save", "Snapshot001", JustWarning,
+		  "Built without GDML (cmake -DWITH_GDML=ON) or without the CMake source hash; geometry snapshots are off.");
+      warned = true;
+    }
+    return false;
+  }
+
+  // Every MPI rank builds the same geometry; one copy is enough
+  if (FourQubitMPI::GetRank() != 0) return false;
+
+  const FourQubitSensorTable* sensors = FourQubitSensorTable::Instance();
+  if (sensors->HasPositionLookups()) {
+    G4cout << "FourQubitGeometrySnapshot: a qubit array or flattened build is"
+	   << " not saved" << G4endl;
+    return false;
+  }
+
+  const G4String key = Key();
+  const G4String name = FileName(dir, key);
+  std::error_code error;
+  std::filesystem::create_directories(std::string(dir), error);
+
+  std::vector<G4VPhysicalVolume*> order = VolumeOrder(world);
+  std::unordered_map<const G4VPhysicalVolume*,size_t> index;
+  for (size_t i=0; i<order.size(); i++) index[order[i]] = i;
+
+  std::ostringstream side;
+  side << std::setprecision(17)
+       << kSnapshotMagic << ' ' << kSnapshotVersion << '\n'
+       << "key " << key << '\n'
+       << "volumes " << order.size() << '\n';
+
+  for (const Lattice& lat : lattices) {
+    if (!index.count(lat.volume)) continue;
+    side << "lattice " << index[lat.volume] << ' ' << lat.h << ' ' << lat.k
+	 << ' ' << lat.l << ' ' << lat.latticeDir << '\n';
+  }
+
+  for (const FourQubitBorderTable::Entry& b : FourQubitBorderTable::Instance()->GetCreated()) {
+    if (!index.count(b.from) || !index.count(b.to)) continue;
+    side << "border " << index[b.from] << ' ' << index[b.to] << ' '
+	 << b.property->GetName() << ' ' << b.name << '\n';
+  }
+
+  for (const auto& q : sensors->GetQubits()) WriteFootprint(side, "qubit", q);
+  for (const auto& s : sensors->GetSensors()) WriteFootprint(side, "sensor", s);
+
+  // By index, so the lines don't depend on the hash map's order
+  std::vector<std::pair<size_t,FourQubitSensorTable::VolumeID> > ids;
+  for (const auto& entry : sensors->GetVolumeIDs()) {
+    if (index.count(entry.first)) ids.push_back(std::make_pair(index[entry.first], entry.second));
+  }
+  std::sort(ids.begin(), ids.end(),
+	    [](const std::pair<size_t,FourQubitSensorTable::VolumeID>& a,
+	       const std::pair<size_t,FourQubitSensorTable::VolumeID>& b) {
+	      return a.first < b.first; });
+  for (const auto& id : ids) {
+    side << "volume " << id.first << ' ' << id.second.sensorID << ' '
+	 << id.second.qubitID << '\n';
+  }
+  side << "end\n";
+
+  const G4String scratch = name + ".tmp" + std::to_string(getpid());
+  std::remove(scratch.c_str());				// GDML won't overwrite
+
+#ifdef FOURQUBIT_GDML
+  G4GDMLParser parser;
+  parser.Write(scratch, world);
+#endif
+
+  std::ofstream out(scratch+".fq", std::ios_base::trunc);
+  out << side.str();
+  out.close();
+
+  if (!out.good() || std::rename(scratch.c_str(), name.c_str()) != 0 ||
+      std::rename((scratch+".fq").c_str(), (name+".fq").c_str()) != 0) {
+    std::remove(scratch.c_str());
+    std::remove((scratch+".fq").c_str());
+    G4ExceptionDescription msg;
+    msg << "Error writing geometry snapshot " << name;
+    G4Exception("FourQubitGeometrySnapshot::Save", "Snapshot002", JustWarning, msg);
+    return false;
+  }
+
+  G4cout << "FourQubitGeometrySnapshot: saved " << order.size() << " volumes to "
+	 << name << G4endl;
+  return true;
+}
+
+
+// Loading
+
+G4VPhysicalVolume*
+FourQubitGeometrySnapshot::Load(const G4String& dir,
+				const std::vector<G4CMPSurfaceProperty*>& properties,
+				std::vector<Lattice>& lattices) {
+  lattices.clear();
+  if (!Available()) return nullptr;
+
+  const G4String key = Key();
+  const G4String name = FileName(dir, key);
+  std::ifstream side(name+".fq");
+  if (!side.good()) return nullptr;		// Not saved yet
+
+  // The whole sidecar is read before the GDML, so a bad one costs nothing
+  struct SavedLattice { size_t volume; G4int h, k, l; G4String dir; };
+  struct SavedBorder { size_t from, to; G4CMPSurfaceProperty* property; G4String name; };
+  std::vector<SavedLattice> savedLattices;
+  std::vector<SavedBorder> savedBorders;
+  std::vector<FourQubitSensorTable::Footprint> qubits, sensors;
+  std::vector<std::pair<size_t,FourQubitSensorTable::VolumeID> > ids;
+  size_t nVolumes = 0;
+
+  G4ExceptionDescription msg;
+  std::string word, value;
+  G4int version = 0;
+  G4bool good = ((side >> word >> version) && word == kSnapshotMagic &&
+		 version == kSnapshotVersion &&
+		 (side >> word >> value) && word == "key" && value == key &&
+		 (side >> word >> nVolumes) && word == "volumes");
+
+  G4bool ended = false;
+  while (good && !ended && (side >> word)) {
+    if (word == "lattice") {
+      SavedLattice lat;
+      good = bool(side >> lat.volume >> lat.h >> lat.k >> lat.l);
+      lat.dir = RestOfLine(side);
+      good = good && lat.volume < nVolumes;
+      savedLattices.push_back(lat);
+    } else if (word == "border") {
+      SavedBorder b;
+      G4String propName;
+      good = bool(side >> b.from >> b.to >> propName);
+      b.name = RestOfLine(side);
+      auto prop = std::find_if(properties.begin(), properties.end(),
+			       [&](const G4CMPSurfaceProperty* p) { return p->GetName() == propName; });
+      b.property = (prop == properties.end()) ? nullptr : *prop;
+      good = good && b.from < nVolumes && b.to < nVolumes && b.property;
+      savedBorders.push_back(b);
+    } else if (word == "qubit" || word == "sensor") {
+      FourQubitSensorTable::Footprint f;
+      good = ReadFootprint(side, f);
+      (word == "qubit" ? qubits : sensors).push_back(f);
+    } else if (word == "volume") {
+      std::pair<size_t,FourQubitSensorTable::VolumeID> id;
+      id.second.target = false;
+      good = bool(side >> id.first >> id.second.sensorID >> id.second.qubitID);
+      good = good && id.first < nVolumes;
+      ids.push_back(id);
+    } else {
+      ended = (word == "end");
+      good = ended;
+    }
+  }
+
+  if (!good || !ended) {
+    msg << name << ".fq is unreadable or from another version; building the geometry.";
+    G4Exception("FourQubitGeometrySnapshot::Load", "Snapshot003", JustWarning, msg);
+    return nullptr;
+  }
+
+  G4VPhysicalVolume* world = nullptr;
+#ifdef FOURQUBIT_GDML
+  G4GDMLParser parser;
+  parser.Read(name, false);			// No schema validation
+  world = parser.GetWorldVolume();
+#endif
+
+  std::vector<G4VPhysicalVolume*> order;
+  if (world) order = VolumeOrder(world);
+  if (order.size() != nVolumes) {
+    msg << name << " has " << order.size() << " volumes, not " << nVolumes
+	<< "; building the geometry.";
+    G4Exception("FourQubitGeometrySnapshot::Load", "Snapshot003", JustWarning, msg);
+    CleanStores();
+    return nullptr;
+  }
+
+  for (const SavedLattice& lat : savedLattices) {
+    Lattice entry = { order[lat.volume], lat.dir, lat.h, lat.k, lat.l };
+    lattices.push_back(entry);
+  }
+
+  FourQubitBorderTable* borders = FourQubitBorderTable::Instance();
+  for (const SavedBorder& b : savedBorders)
+    borders->Create(b.name, order[b.from], order[b.to], b.property);
+
+  std::unordered_map<const G4VPhysicalVolume*,FourQubitSensorTable::VolumeID> volumeIDs;
+  for (const auto& id : ids) volumeIDs[order[id.first]] = id.second;
+  FourQubitSensorTable::Instance()->Restore(qubits, sensors, volumeIDs);
+
+  G4cout << "FourQubitGeometrySnapshot: loaded " << nVolumes << " volumes and "
+	 << borders->size() << " border surfaces from " << name << G4endl;
+  return world;
+}
@@ -0,0 +1,306 @@
+//
+/// \file FourQubitLayout.cc
+/// \brief Implementation of the class building ground-plane traces from a
+///        layout file
+
+// Includes (G4)
+#include "G4Box.hh"
+#include "G4Colour.hh"
+#include "G4LogicalVolume.hh"
+#include "G4NistManager.hh"
+#include "G4PVPlacement.hh"
+#include "G4RotationMatrix.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Tubs.hh"
+#include "G4UnitsTable.hh"
+#include "G4VisAttributes.hh"
+
+// Includes (specific to this project)
+#include "FourQubitLayout.hh"
+#include "FourQubitDetectorParameters.hh"
+#include "FourQubitGeometryArena.hh"
+#include "FourQubitVisAttributes.hh"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+using namespace FourQubitDetectorParameters;
+
+namespace
+{
+  // Straights closer than this are treated as touching or collinear
+  const G4double kMergeTolerance = 1. * nm;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Primary Constructor
+FourQubitLayout::FourQubitLayout(const G4String &fileName)
+    : fValid(false)
+{
+  fValid = Load(fileName);
+  if (fValid)
+    MergeStraights();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Destructor
+FourQubitLayout::~FourQubitLayout()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Read the netlist. Any malformed line invalidates the whole layout, so a
+// typo can't silently drop a trace from the chip
+G4bool FourQubitLayout::Load(const G4String &fileName)
+{
+  std::ifstream in(fileName);
+  if (!in.good())
+  {
+    G4ExceptionDescription msg;
+    msg << "Unable to open layout file " << fileName << ".";
+    G4Exception("FourQubitLayout::Load", "Layout001", JustWarning, msg);
+    return false;
+  }
+
+  G4double unit = um;
+  G4double conductorWidth = dp_tlCouplingConductorDimY;
+  G4double emptyWidth = dp_tlCouplingEmptyDimY;
+
+  std::string line;
+  G4int lineNo = 0;
+  while (std::getline(in, line))
+  {
+    lineNo++;
+    line = line.substr(0, line.find('#'));
+
+    std::istringstream fields(line);
+    std::string keyword;
+    if (!(fields >> keyword))
+      continue; // Blank or comment
+
+    // Lengths are numbers in the current unit, or geometry parameter names
+    G4bool good = true;
+    auto length = [&]() -> G4double {
+      std::string token;
+      if (!(fields >> token)) { good = false; return 0.; }
+      ParameterBase *param = FindParameter(token);
+      if (param) return param->GetValue();
+      std::istringstream number(token);
+      G4double value = 0.;
+      if (!(number >> value) || !number.eof()) good = false;
+      return value * unit;
+    };
+    auto angle = [&]() -> G4double {
+      G4double value = 0.;
+      if (!(fields >> value)) good = false;
+      return value * deg;
+    };
+
+    Trace trace = Trace();
+    trace.conductorWidth = conductorWidth;
+    trace.emptyWidth = emptyWidth;
+
+    if (keyword == "unit")
+    {
+      std::string name;
+      good = (fields >> name) && G4UnitDefinition::IsUnitDefined(name);
+      if (good)
+        unit = G4UnitDefinition::GetValueOf(name);
+    }
+    else if (keyword == "width")
+    {
+      conductorWidth = length();
+      emptyWidth = length();
+      good &= (conductorWidth > 0. && emptyWidth > conductorWidth);
+    }
+    else if (keyword == "straight")
+    {
+      good = bool(fields >> trace.name);
+      trace.x = length();
+      trace.y = length();
+      trace.angle = angle();
+      trace.length = length();
+      good &= (trace.length > 0.);
+      if (good)
+        fTraces.push_back(trace);
+    }
+    else if (keyword == "curve")
+    {
+      trace.curve = true;
+      good = bool(fields >> trace.name);
+      trace.x = length();
+      trace.y = length();
+      trace.radius = length();
+      trace.start = angle();
+      trace.span = angle();
+      good &= (trace.radius >= 0. && trace.span > 0.);
+      if (good)
+        fTraces.push_back(trace);
+    }
+    else
+    {
+      good = false;
+    }
+
+    if (!good)
+    {
+      G4ExceptionDescription msg;
+      msg << fileName << " line " << lineNo << ": cannot read \"" << line << "\".";
+      G4Exception("FourQubitLayout::Load", "Layout002", JustWarning, msg);
+      fTraces.clear();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Two straights merge if they have the same widths, run along one line and
+// touch or overlap; lo and hi are then the ends of the union, measured
+// along a's direction from a's centre
+G4bool FourQubitLayout::Mergeable(const Trace &a, const Trace &b, G4double &lo, G4double &hi) const
+{
+  if (a.curve || b.curve)
+    return false;
+  if (std::fabs(a.conductorWidth - b.conductorWidth) > kMergeTolerance ||
+      std::fabs(a.emptyWidth - b.emptyWidth) > kMergeTolerance)
+    return false;
+
+  const G4double ux = std::cos(a.angle), uy = std::sin(a.angle);
+  if (std::fabs(ux * std::sin(b.angle) - uy * std::cos(b.angle)) * b.length > kMergeTolerance)
+    return false; // Not parallel
+
+  const G4double dx = b.x - a.x, dy = b.y - a.y;
+  if (std::fabs(dx * uy - dy * ux) > kMergeTolerance)
+    return false; // Parallel, but offset sideways
+
+  const G4double along = dx * ux + dy * uy;
+  if (std::fabs(along) > 0.5 * (a.length + b.length) + kMergeTolerance)
+    return false; // A gap between them
+
+  lo = std::min(-0.5 * a.length, along - 0.5 * b.length);
+  hi = std::max(0.5 * a.length, along + 0.5 * b.length);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Fewer, longer boxes: each merge removes an Empty/Conductor pair and
+// its two border surfaces
+void FourQubitLayout::MergeStraights()
+{
+  G4bool merged = true;
+  while (merged)
+  {
+    merged = false;
+    for (size_t i = 0; i < fTraces.size() && !merged; ++i)
+    {
+      for (size_t j = i + 1; j < fTraces.size() && !merged; ++j)
+      {
+        G4double lo = 0., hi = 0.;
+        if (!Mergeable(fTraces[i], fTraces[j], lo, hi))
+          continue;
+
+        Trace &a = fTraces[i];
+        const G4double mid = 0.5 * (lo + hi);
+        a.x += mid * std::cos(a.angle);
+        a.y += mid * std::sin(a.angle);
+        a.length = hi - lo;
+        fTraces.erase(fTraces.begin() + j);
+        merged = true;
+      }
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Build the Empty/Conductor pairs. Names follow the hand-built components,
+// so /g4cmp/TargetVolumes and the border naming treat them alike
+void FourQubitLayout::Place(const G4String &pName,
+                            G4LogicalVolume *pMotherLogical,
+                            const G4ThreeVector &tLate,
+                            G4bool pSurfChk)
+{
+  fFundamentalVolumeList.clear();
+  if (!fValid)
+    return;
+
+  // Start with some preliminaries - NIST manager
+  G4NistManager *nist = G4NistManager::Instance();
+  G4Material *niobium_mat = nist->FindOrBuildMaterial("G4_Nb");
+  G4Material *air_mat = nist->FindOrBuildMaterial("G4_AIR");
+
+  // Set up the visualization
+  const G4VisAttributes *niobium_vis = FourQubitVisAttributes::Get(G4Colour(0.0, 1.0, 1.0, 0.5));
+  const G4VisAttributes *air_vis = FourQubitVisAttributes::Get(G4Colour(0.5, 0.5, 0.5, 0.5));
+
+  for (const Trace &trace : fTraces)
+  {
+    G4String emptyName = pName + "_" + trace.name + "_Empty";
+    G4String conductorName = pName + "_" + trace.name + "_Conductor";
+
+    G4VSolid *solid_empty = 0;
+    G4VSolid *solid_conductor = 0;
+    G4RotationMatrix *rotation = 0;
+
+    if (trace.curve)
+    {
+      const G4double centralRadius = trace.radius + 0.5 * trace.emptyWidth;
+      solid_empty = new G4Tubs(emptyName + "_solid",
+                               trace.radius,
+                               trace.radius + trace.emptyWidth,
+                               0.5 * dp_curveEmptyDimZ,
+                               trace.start, trace.span);
+      solid_conductor = new G4Tubs(conductorName + "_solid",
+                                   centralRadius - 0.5 * trace.conductorWidth,
+                                   centralRadius + 0.5 * trace.conductorWidth,
+                                   0.5 * dp_curveEmptyDimZ,
+                                   trace.start, trace.span);
+    }
+    else
+    {
+      solid_empty = new G4Box(emptyName + "_solid", 0.5 * trace.length,
+                              0.5 * trace.emptyWidth, 0.5 * dp_groundPlaneDimZ);
+      solid_conductor = new G4Box(conductorName + "_solid", 0.5 * trace.length,
+                                  0.5 * trace.conductorWidth, 0.5 * dp_shlConductorDimZ);
+
+      // G4PVPlacement takes the frame rotation, the inverse of the trace's
+      if (trace.angle != 0.)
+      {
+        rotation = FourQubitGeometryArena::Instance()->Rotation();
+        rotation->rotateZ(-trace.angle);
+      }
+    }
+
+    G4LogicalVolume *log_empty = new G4LogicalVolume(solid_empty, air_mat, emptyName + "_log");
+    log_empty->SetVisAttributes(air_vis);
+    G4VPhysicalVolume *phys_empty = new G4PVPlacement(rotation,
+                                                      tLate + G4ThreeVector(trace.x, trace.y, 0),
+                                                      log_empty,
+                                                      emptyName,
+                                                      pMotherLogical,
+                                                      false,
+                                                      0,
+                                                      pSurfChk);
+    fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum, emptyName, phys_empty));
+
+    G4LogicalVolume *log_conductor = new G4LogicalVolume(solid_conductor, niobium_mat, conductorName + "_log");
+    log_conductor->SetVisAttributes(niobium_vis);
+    G4VPhysicalVolume *phys_conductor = new G4PVPlacement(0,
+                                                          G4ThreeVector(0, 0, 0),
+                                                          log_conductor,
+                                                          conductorName,
+                                                          log_empty,
+                                                          false,
+                                                          0,
+                                                          pSurfChk);
+    fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium, conductorName, phys_conductor));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+const FourQubitSubVolumeList& FourQubitLayout::GetListOfAllFundamentalSubVolumes() const
+{
+  return fFundamentalVolumeList;
+}
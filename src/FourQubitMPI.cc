@@ -0,0 +1,152 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitMPI.cc
+//
+// Description:	Thin MPI layer: event splitting, per-rank seeds, merging.
+
+#include "FourQubitMPI.hh"
+#include "FourQubitConfigManager.hh"
+#include "FourQubitShardMerger.hh"
+#include "FourQubitVertexBank.hh"
+#include "G4RunManager.hh"
+#include "G4ios.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+#ifdef FOURQUBIT_MPI
+#include <mpi.h>
+#endif
+
+
+G4int FourQubitMPI::rank = 0;
+G4int FourQubitMPI::size = 1;
+G4bool FourQubitMPI::inSplitRun = false;
+G4int FourQubitMPI::eventOffset = 0;
+G4long FourQubitMPI::eventsRun = 0;
+
+
+G4bool FourQubitMPI::IsEnabled() {
+#ifdef FOURQUBIT_MPI
+  return true;
+#else
+  return false;
+#endif
+}
+
+void FourQubitMPI::Init(int* argc, char*** argv) {
+#ifdef FOURQUBIT_MPI
+  MPI_Init(argc, argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+#else
+  (void)argc; (void)argv;
+#endif
+}
+
+void FourQubitMPI::Finalize() {
+#ifdef FOURQUBIT_MPI
+  MPI_Finalize();
+#endif
+}
+
+
+// SplitMix64 finalizer: nearby inputs give unrelated outputs
+
+namespace {
+  uint64_t Mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+  }
+}
+
+// Every rank's engine holds the macro's seeds here, so drawing from it gives
+// the same base everywhere and the rank makes the difference
+
+void FourQubitMPI::BeamOn(G4int nEventsTotal) {
+  G4int share = nEventsTotal / size;
+  G4int extra = nEventsTotal % size;
+  G4int nEvents = share + (rank < extra ? 1 : 0);
+  eventOffset = rank*share + std::min(rank, extra);
+
+  if (size > 1) {
+    uint64_t base = (uint64_t(G4UniformRand() * 4294967296.) << 32)
+      ^ uint64_t(G4UniformRand() * 4294967296.);
+    uint64_t mixed = Mix(base ^ Mix(uint64_t(rank)));
+    long seeds[3] = { long(mixed & 0x7fffffff) | 1,
+		      long((mixed >> 32) & 0x7fffffff) | 1, 0 };
+    G4Random::setTheSeeds(seeds);
+
+    G4cout << "FourQubitMPI: rank " << rank << " of " << size << " runs events "
+	   << eventOffset << " to " << eventOffset+nEvents-1 << G4endl;
+  }
+
+  inSplitRun = true;
+  if (nEvents > 0) G4RunManager::GetRunManager()->BeamOn(nEvents);
+  inSplitRun = false;
+  eventsRun += nEvents;
+  FourQubitVertexBank::EndOfRun(FourQubitConfigManager::GetVertexBank(), nEventsTotal);
+}
+
+
+// The merged files take the names a single-rank job would have used
+
+void FourQubitMPI::MergeOutputs() {
+  if (size < 2) return;
+
+  std::vector<long long> events(size, 0);
+  long long mine = eventsRun;
+#ifdef FOURQUBIT_MPI
+  MPI_Gather(&mine, 1, MPI_LONG_LONG, events.data(), 1, MPI_LONG_LONG,
+	     0, MPI_COMM_WORLD);			// Also waits for every rank
+#else
+  events[0] = mine;
+#endif
+  if (rank != 0) return;
+
+  const G4bool merge = (FourQubitConfigManager::GetHitsMode() != "none" &&
+			FourQubitConfigManager::GetHitsFormat() != "root");
+
+  std::vector<G4String> hitFiles, primaryFiles;
+  for (G4int i=0; i<size; i++) {
+    hitFiles.push_back(FourQubitConfigManager::GetHitOutputOfRank(i));
+    primaryFiles.push_back(FourQubitConfigManager::GetPrimaryOutputOfRank(i));
+  }
+
+  G4String hitName = FourQubitConfigManager::GetHitOutputOfRank(-1);
+  G4String primaryName = FourQubitConfigManager::GetPrimaryOutputOfRank(-1);
+  if (merge) {
+    FourQubitShardMerger merger;
+    merger.Merge(hitName, hitFiles);
+    merger.Merge(primaryName, primaryFiles);
+  }
+
+  // The manifest is plain text even when the outputs are compressed
+  G4String manifestName = FourQubitConfigManager::TaggedFileName(hitName, "manifest");
+  if (FourQubitConfigManager::GetCompressedOutput())
+    manifestName.erase(manifestName.size()-4);		// ".zst"
+  std::ofstream manifest(manifestName, std::ios_base::trunc);
+  manifest << "# FourQubit MPI job: " << size << " ranks\n";
+  if (merge) manifest << "merged " << hitName << " " << primaryName << "\n";
+  else manifest << "merged none\n";
+  for (G4int i=0; i<size; i++) {
+    manifest << "rank " << i << " events " << events[i];
+    if (!merge) manifest << " hits " << hitFiles[i] << " primaries " << primaryFiles[i];
+    G4String pceName = FourQubitConfigManager::GetPCEMapFileOfRank(i);
+    if (!pceName.empty()) manifest << " pceMap " << pceName;
+    manifest << "\n";
+  }
+  manifest.close();
+
+  G4cout << "FourQubitMPI: " << size << " ranks"
+	 << (merge ? G4String(" merged into "+hitName+",") : G4String(","))
+	 << " manifest in " << manifestName << G4endl;
+}
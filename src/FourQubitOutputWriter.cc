@@ -0,0 +1,329 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitOutputWriter.cc
+//
+// Description:	Output files for the hit and primary streams, their
+//		event indexes, and the writer thread behind
+//		/g4cmp/AsyncOutput.
+
+#include "FourQubitOutputWriter.hh"
+#include "FourQubitConfigManager.hh"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef FOURQUBIT_ZSTD
+#include <zstd.h>
+#endif
+
+
+// One queue and one writer thread for the whole job, started by the first
+// asynchronous block.  The thread is stopped when the job ends; every file
+// has been closed, and so drained, by then.
+
+class FourQubitOutputQueue {
+public:
+  static FourQubitOutputQueue& Instance() {
+    static FourQubitOutputQueue theQueue;
+    return theQueue;
+  }
+
+  ~FourQubitOutputQueue() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!writer.joinable()) return;
+    stop = true;
+    ready.notify_one();
+    lock.unlock();
+    writer.join();
+  }
+
+  // Backpressure: wait while the queue is over its limit, unless it is
+  // empty, so that a single block larger than the limit still goes
+  void Push(FourQubitOutputFile* file, std::string& block) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!writer.joinable()) writer = std::thread(&FourQubitOutputQueue::Run, this);
+
+    const size_t limit = FourQubitConfigManager::GetOutputQueueSize();
+    space.wait(lock, [&]{ return queued == 0 || queued + block.size() <= limit; });
+
+    queued += block.size();
+    file->pending++;
+    jobs.push_back(Job());
+    jobs.back().file = file;
+    jobs.back().data.swap(block);
+
+    if (!spares.empty()) {		// Keeps the caller's buffer grown
+      block.swap(spares.back());
+      spares.pop_back();
+    }
+    ready.notify_one();
+  }
+
+  void WaitFor(const FourQubitOutputFile* file) {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&]{ return file->pending == 0; });
+  }
+
+private:
+  FourQubitOutputQueue() : queued(0), stop(false) {;}
+
+  struct Job {
+    FourQubitOutputFile* file;
+    std::string data;
+  };
+
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+      ready.wait(lock, [&]{ return stop || !jobs.empty(); });
+      if (jobs.empty()) return;		// Stopped, and nothing left
+
+      Job job;
+      job.file = jobs.front().file;
+      job.data.swap(jobs.front().data);
+      jobs.pop_front();
+
+      lock.unlock();
+      const size_t size = job.data.size();
+      job.file->WriteBlock(job.data);		// Compression and I/O unlocked
+      lock.lock();
+
+      queued -= size;
+      job.file->pending--;
+      if (spares.size() < kMaxSpares) spares.push_back(std::move(job.data));
+      space.notify_all();
+      done.notify_all();
+    }
+  }
+
+  static const size_t kMaxSpares = 16;
+
+  std::mutex mutex;
+  std::condition_variable ready;	// Job queued, or stop
+  std::condition_variable space;	// Queue below its limit
+  std::condition_variable done;		// A job finished
+  std::deque<Job> jobs;
+  std::vector<std::string> spares;	// Written blocks, cleared for reuse
+  size_t queued;			// Bytes waiting
+  G4bool stop;
+  std::thread writer;
+};
+
+
+// Output file
+
+FourQubitOutputFile::FourQubitOutputFile()
+  : compress(false), level(0), async(false), failed(false), length(0),
+    startLength(0), handed(0), written(0), pending(0), context(0),
+    indexed(false) {;}
+
+FourQubitOutputFile::~FourQubitOutputFile() {
+  Close();
+#ifdef FOURQUBIT_ZSTD
+  ZSTD_freeCCtx(static_cast<ZSTD_CCtx*>(context));
+#endif
+}
+
+G4bool FourQubitOutputFile::CompressionAvailable() {
+#ifdef FOURQUBIT_ZSTD
+  return true;
+#else
+  return false;
+#endif
+}
+
+G4bool FourQubitOutputFile::Open(const G4String& fn, std::ios_base::openmode mode,
+				 G4bool index) {
+  Close();
+
+  compress = FourQubitConfigManager::GetCompressedOutput();
+  level = FourQubitConfigManager::GetCompressionLevel();
+  async = FourQubitConfigManager::GetAsyncOutput();
+
+  static std::atomic<G4bool> warned(false);
+  if (FourQubitConfigManager::GetOutputCompression() == "zstd" &&
+      !CompressionAvailable() && !warned.exchange(true)) {
+    G4Exception("FourQubitOutputFile::Open", "OutputWriter001", JustWarning,
+		"Built without zstd (cmake -DWITH_ZSTD=ON); output is not compressed.");
+  }
+
+#ifdef FOURQUBIT_ZSTD
+  if (compress && !context) context = ZSTD_createCCtx();
+#endif
+
+  file.open(fn, mode | std::ios_base::out | std::ios_base::binary);
+  failed = !file.good();
+  file.seekp(0, std::ios_base::end);		// Where app writes start
+  length = file.good() ? G4long(file.tellp()) : 0;
+  startLength = length;
+  handed = written = 0;
+
+  indexed = false;
+  pendingIndex.clear();
+  frames.clear();
+  if (index && !failed) OpenIndex(fn);
+  return !failed;
+}
+
+void FourQubitOutputFile::Close() {
+  if (!file.is_open()) return;
+  Flush();
+  file.close();
+  if (!file.good()) failed = true;
+  if (indexFile.is_open()) indexFile.close();
+  indexed = false;
+}
+
+void FourQubitOutputFile::Write(std::string& block) {
+  if (block.empty() || !file.is_open()) return;
+  handed += G4long(block.size());
+  if (async) FourQubitOutputQueue::Instance().Push(this, block);
+  else WriteBlock(block);
+}
+
+void FourQubitOutputFile::Flush() {
+  if (async) FourQubitOutputQueue::Instance().WaitFor(this);
+  if (file.is_open()) file.flush();
+  if (!file.good()) failed = true;
+  if (indexed) WriteIndex();
+}
+
+
+// Each block is an independent frame, so the file is valid after any block
+
+void FourQubitOutputFile::WriteBlock(std::string& block) {
+#ifdef FOURQUBIT_ZSTD
+  if (compress) {
+    if (indexed) frames.push_back(std::make_pair(written, length));
+    written += G4long(block.size());
+    frame.resize(ZSTD_compressBound(block.size()));
+    size_t n = ZSTD_compressCCtx(static_cast<ZSTD_CCtx*>(context), &frame[0],
+				 frame.size(), block.data(), block.size(), level);
+    if (ZSTD_isError(n)) failed = true;
+    else {
+      file.write(frame.data(), n);
+      length += G4long(n);
+    }
+    block.clear();
+    return;
+  }
+#endif
+
+  file.write(block.data(), block.size());
+  length += G4long(block.size());
+  written += G4long(block.size());
+  block.clear();
+}
+
+
+// Event index
+
+namespace {
+  void AppendIndexRecord(std::string& buffer, FourQubitHitFormat::IndexRecord rec) {
+    if (!FourQubitHitFormat::HostIsLittleEndian())
+      FourQubitHitFormat::SwapRecord(&rec, FourQubitHitFormat::IndexFields());
+    buffer.append(reinterpret_cast<const char*>(&rec), sizeof(rec));
+  }
+}
+
+// An appended file keeps the entries for its first startLength bytes: a
+// resumed file was cut back to a checkpoint, and the later entries went
+// with the events after it
+
+void FourQubitOutputFile::OpenIndex(const G4String& fn) {
+  const G4String name = FourQubitHitFormat::IndexFileName(fn);
+
+  std::string block;
+  FourQubitHitFormat::AppendHeader(block, FourQubitHitFormat::kIndexMagic,
+				   sizeof(FourQubitHitFormat::IndexRecord),
+				   FourQubitHitFormat::IndexFields(),
+				   std::vector<std::string>());
+
+  if (startLength > 0) {
+    std::ifstream old(name, std::ios_base::binary);
+    FourQubitHitFormat::Header hdr;
+    if (!FourQubitHitFormat::ReadHeader(old, hdr) || !hdr.IsIndex() ||
+	hdr.recordSize != sizeof(FourQubitHitFormat::IndexRecord)) {
+      G4ExceptionDescription msg;
+      msg << fn << " is appended to but has no usable " << name
+	  << "; the file is not indexed.";
+      G4Exception("FourQubitOutputFile::Open", "OutputWriter002", JustWarning, msg);
+      old.close();
+      std::remove(name.c_str());
+      return;
+    }
+
+    FourQubitHitFormat::IndexRecord rec;
+    while (old.read(reinterpret_cast<char*>(&rec), sizeof(rec))) {
+      if (!FourQubitHitFormat::HostIsLittleEndian())
+	FourQubitHitFormat::SwapRecord(&rec, FourQubitHitFormat::IndexFields());
+      if (rec.offset < startLength) AppendIndexRecord(block, rec);
+    }
+  }
+
+  indexFile.open(name, std::ios_base::trunc | std::ios_base::binary);
+  indexFile.write(block.data(), block.size());
+  if (!indexFile.good()) {
+    G4Exception("FourQubitOutputFile::Open", "OutputWriter003", JustWarning,
+		("Cannot write "+name+"; the file is not indexed.").c_str());
+    indexFile.close();
+    return;
+  }
+  indexed = true;
+}
+
+void FourQubitOutputFile::IndexEvent(G4int runID, G4int eventID,
+				     G4long position, G4int nRecords) {
+  if (!indexed) return;
+  FourQubitHitFormat::IndexRecord rec;
+  rec.runID = runID;
+  rec.eventID = eventID;
+  rec.nRecords = nRecords;
+  rec.reserved = 0;
+  rec.offset = position;		// Resolved by WriteIndex()
+  rec.skip = 0;
+  pendingIndex.push_back(rec);
+}
+
+// Called with every handed-over block written.  A plain file is written
+// as it is handed over; in a compressed one the position is found in the
+// frame that holds it.  Entries past the written bytes wait for a later
+// Flush(), and they lie beyond every frame seen so far.
+
+void FourQubitOutputFile::WriteIndex() {
+  std::string block;
+  size_t nLeft = 0;
+  for (FourQubitHitFormat::IndexRecord& rec : pendingIndex) {
+    if (rec.offset >= written) {
+      pendingIndex[nLeft++] = rec;
+      continue;
+    }
+
+    if (compress) {
+      auto next = std::upper_bound(frames.begin(), frames.end(), G4long(rec.offset),
+	[](G4long pos, const std::pair<G4long,G4long>& f) { return pos < f.first; });
+      if (next == frames.begin()) continue;	// Not possible
+      --next;
+      rec.skip = rec.offset - next->first;
+      rec.offset = next->second;
+    } else {
+      rec.offset += startLength;
+    }
+    AppendIndexRecord(block, rec);
+  }
+  pendingIndex.resize(nLeft);
+  frames.clear();
+
+  if (block.empty()) return;
+  indexFile.write(block.data(), block.size());
+  indexFile.flush();
+}
@@ -0,0 +1,231 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitPCEMap.cc
+//
+// Description:	In-run XY maps for /g4cmp/PCEMapFile.
+
+#include "FourQubitPCEMap.hh"
+#include "FourQubitHitFormat.hh"
+#include "G4AutoLock.hh"
+#include "G4CMPElectrodeHit.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+#include "tools/histo/h2d"
+#include "tools/wroot/file"
+#include "tools/wroot/to"
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <utility>
+
+
+// Shared totals; each worker's maps are added under the lock
+
+namespace {
+  G4Mutex totalsMutex = G4MUTEX_INITIALIZER;
+
+  struct Totals {
+    FourQubitConfigManager::MapBinning binning;
+    std::vector<std::vector<G4double> > maps;
+  } totals;
+
+  // Bin contents are stored in Geant4 units; files hold eV (or counts)
+  G4double OutputUnit(FourQubitPCEMap::Quantity q) {
+    return (q == FourQubitPCEMap::kPrimaries || q == FourQubitPCEMap::kHits)
+      ? 1. : eV;
+  }
+
+  G4bool SameBinning(const FourQubitConfigManager::MapBinning& a,
+		     const FourQubitConfigManager::MapBinning& b) {
+    return (a.nX == b.nX && a.nY == b.nY && a.xMin == b.xMin &&
+	    a.xMax == b.xMax && a.yMin == b.yMin && a.yMax == b.yMax);
+  }
+}
+
+
+const char* FourQubitPCEMap::QuantityName(Quantity q) {
+  static const char* names[kNQuantities] = {
+    "hitEnergy", "primaryEnergy", "primaries", "hits", "hitEnergyAtHitXY"
+  };
+  return names[q];
+}
+
+const char* FourQubitPCEMap::HistogramName(Quantity q) {
+  static const char* names[kNQuantities] = {
+    "h_totalHitEnergyAtPrimaryXY", "h_totalPrimaryEnergyAtPrimaryXY",
+    "h_nPrimariesAtPrimaryXY", "h_nHitsAtPrimaryXY", "h_totalHitEnergyAtHitXY"
+  };
+  return names[q];
+}
+
+
+// Run boundaries
+
+void FourQubitPCEMap::BeginOfRun() {
+  maps.assign(kNQuantities, std::vector<G4double>());
+  active = !FourQubitConfigManager::GetPCEMapFile().empty();
+  if (!active) return;
+
+  binning = FourQubitConfigManager::GetPCEMapBinning();
+  const size_t nBins = size_t(binning.nX) * size_t(binning.nY);
+
+  for (const G4String& name : FourQubitConfigManager::GetPCEMapQuantities()) {
+    G4int q = 0;
+    while (q < kNQuantities && name != QuantityName(Quantity(q))) q++;
+    if (q == kNQuantities) {
+      G4ExceptionDescription msg;
+      msg << "Unknown map quantity \"" << name << "\" in /g4cmp/PCEMapQuantities.";
+      G4Exception("FourQubitPCEMap::BeginOfRun", "PCEMap001", JustWarning, msg);
+      continue;
+    }
+    maps[q].assign(nBins, 0.);
+  }
+}
+
+void FourQubitPCEMap::EndOfRun() {
+  if (!active) return;
+
+  G4AutoLock lock(&totalsMutex);
+  if (totals.maps.empty()) {
+    totals.binning = binning;
+    totals.maps = maps;
+  } else if (SameBinning(totals.binning, binning) &&
+	     totals.maps.size() == maps.size()) {
+    for (size_t q=0; q<maps.size(); q++) {
+      if (totals.maps[q].size() != maps[q].size()) continue;
+      for (size_t i=0; i<maps[q].size(); i++) totals.maps[q][i] += maps[q][i];
+    }
+  }
+  lock.unlock();
+
+  for (auto& map : maps) map.assign(map.size(), 0.);
+}
+
+
+// Hot path: one call per event, a few adds per hit at most
+
+G4int FourQubitPCEMap::Bin(G4double x, G4double y) const {
+  if (x < binning.xMin || x >= binning.xMax ||
+      y < binning.yMin || y >= binning.yMax) return -1;
+
+  G4int ix = G4int((x-binning.xMin) / (binning.xMax-binning.xMin) * binning.nX);
+  G4int iy = G4int((y-binning.yMin) / (binning.yMax-binning.yMin) * binning.nY);
+  ix = std::min(ix, binning.nX-1);
+  iy = std::min(iy, binning.nY-1);
+  return iy*binning.nX + ix;
+}
+
+void FourQubitPCEMap::Fill(const G4PrimaryVertex* vertex,
+			   const std::vector<G4CMPElectrodeHit*>& hits) {
+  if (!active || !vertex) return;
+
+  const G4int primBin = Bin(vertex->GetX0(), vertex->GetY0());
+  const G4double weight = vertex->GetPrimary()->GetWeight();
+  std::vector<G4double>& atHit = maps[kHitEnergyAtHitXY];
+
+  G4double hitEnergy = 0., nHits = 0.;
+  for (const G4CMPElectrodeHit* hit : hits) {
+    hitEnergy += hit->GetWeight() * hit->GetEnergyDeposit();
+    nHits += hit->GetWeight();
+    if (atHit.empty()) continue;
+
+    G4int b = Bin(hit->GetFinalPosition().x(), hit->GetFinalPosition().y());
+    if (b >= 0) atHit[b] += hit->GetWeight() * hit->GetEnergyDeposit();
+  }
+
+  if (primBin < 0) return;
+  if (!maps[kHitEnergy].empty()) maps[kHitEnergy][primBin] += hitEnergy;
+  if (!maps[kPrimaryEnergy].empty())
+    maps[kPrimaryEnergy][primBin] += weight * vertex->GetPrimary()->GetTotalEnergy();
+  if (!maps[kPrimaries].empty()) maps[kPrimaries][primBin] += weight;
+  if (!maps[kHits].empty()) maps[kHits][primBin] += nHits;
+}
+
+
+// Output: the same maps either way, plus h_pceVsXY (hit over primary
+// energy, zero where no primary landed) if both energies were filled
+
+void FourQubitPCEMap::WriteTotals(G4int runID) {
+  G4AutoLock lock(&totalsMutex);
+  if (totals.maps.empty()) return;
+
+  G4String fn = FourQubitConfigManager::GetPCEMapFile();
+  if (runID > 0) fn = FourQubitConfigManager::TaggedFileName(fn, "run" + std::to_string(runID));
+
+  const FourQubitConfigManager::MapBinning& bins = totals.binning;
+  const size_t nBins = size_t(bins.nX) * size_t(bins.nY);
+
+  std::vector<std::pair<G4String,std::vector<G4double> > > output;
+  for (G4int q=0; q<kNQuantities; q++) {
+    if (totals.maps[q].empty()) continue;
+    output.emplace_back(HistogramName(Quantity(q)), totals.maps[q]);
+    for (G4double& v : output.back().second) v /= OutputUnit(Quantity(q));
+  }
+
+  const std::vector<G4double>& hitE = totals.maps[kHitEnergy];
+  const std::vector<G4double>& primE = totals.maps[kPrimaryEnergy];
+  if (!hitE.empty() && !primE.empty()) {
+    output.emplace_back("h_pceVsXY", std::vector<G4double>(nBins, 0.));
+    for (size_t i=0; i<nBins; i++)
+      if (primE[i] != 0.) output.back().second[i] = hitE[i] / primE[i];
+  }
+  totals.maps.clear();
+  lock.unlock();
+
+  G4bool written = false;
+  if (fn.size() > 5 && fn.compare(fn.size()-5, 5, ".root") == 0) {
+    tools::wroot::file file(G4cout, fn);
+    if (file.is_open()) {
+      for (const auto& map : output) {
+	tools::histo::h2d h(map.first, bins.nX, bins.xMin/mm, bins.xMax/mm,
+			    bins.nY, bins.yMin/mm, bins.yMax/mm);
+	const G4double dx = (bins.xMax-bins.xMin)/mm / bins.nX;
+	const G4double dy = (bins.yMax-bins.yMin)/mm / bins.nY;
+	for (G4int iy=0; iy<bins.nY; iy++) {
+	  for (G4int ix=0; ix<bins.nX; ix++) {
+	    G4double v = map.second[iy*bins.nX + ix];
+	    if (v != 0.) h.fill(bins.xMin/mm + (ix+0.5)*dx,
+				bins.yMin/mm + (iy+0.5)*dy, v);
+	  }
+	}
+	tools::wroot::to(file.dir(), h, map.first);
+      }
+      unsigned int nBytes = 0;
+      written = file.write(nBytes);
+      file.close();
+    }
+  } else {
+    FourQubitHitFormat::GridHeader hdr;
+    hdr.nX = uint32_t(bins.nX);
+    hdr.nY = uint32_t(bins.nY);
+    hdr.xMin = bins.xMin/mm; hdr.xMax = bins.xMax/mm;
+    hdr.yMin = bins.yMin/mm; hdr.yMax = bins.yMax/mm;
+    for (const auto& map : output) hdr.names.push_back(map.first);
+
+    std::string buffer;
+    FourQubitHitFormat::AppendGridHeader(buffer, hdr);
+    for (const auto& map : output)
+      for (G4double v : map.second) FourQubitHitFormat::PutF64(buffer, v);
+
+    std::ofstream out(fn, std::ios_base::binary | std::ios_base::trunc);
+    out.write(buffer.data(), buffer.size());
+    out.close();
+    written = out.good();
+  }
+
+  if (!written) {
+    G4ExceptionDescription msg;
+    msg << "Error writing map file " << fn;
+    G4Exception("FourQubitPCEMap::WriteTotals", "PCEMap002", JustWarning, msg);
+    return;
+  }
+
+  G4cout << "FourQubitPCEMap: wrote " << output.size() << " maps of "
+	 << bins.nX << " x " << bins.nY << " bins to " << fn << G4endl;
+}
@@ -44,6 +44,8 @@
 //Includes (specific to this project)
 #include "FourQubitPad.hh"
 #include "FourQubitDetectorParameters.hh"
+#include "FourQubitGeometryArena.hh"
+#include "FourQubitVisAttributes.hh"
 
 using namespace FourQubitDetectorParameters;
 
@@ -97,12 +99,11 @@ void FourQubitPad::ConstructPad(G4RotationMatrix * pRot,
   G4NistManager* nist = G4NistManager::Instance();
   G4Material* niobium_mat = nist->FindOrBuildMaterial("G4_Nb");
   G4Material* air_mat = nist->FindOrBuildMaterial("G4_AIR");
+  bool checkOverlaps = pSurfChk;
 
   //Set up the niobium visualization
-  G4VisAttributes* niobium_vis= new G4VisAttributes(G4Colour(0.0,1.0,1.0,0.5));
-  niobium_vis->SetVisibility(true);
-  G4VisAttributes* air_vis= new G4VisAttributes(G4Colour(0.5,0.5,0.5,0.5));
-  air_vis->SetVisibility(true);
+  const G4VisAttributes* niobium_vis= FourQubitVisAttributes::Get(G4Colour(0.0,1.0,1.0,0.5));
+  const G4VisAttributes* air_vis= FourQubitVisAttributes::Get(G4Colour(0.5,0.5,0.5,0.5));
   
 
   //------------------------------------------------------------------------------------------
@@ -126,7 +127,7 @@ void FourQubitPad::ConstructPad(G4RotationMatrix * pRot,
 					  0.5 * dp_padEmptyPart2TrdZ);
 
   //We need to rotate the part 2 so that it can be aligned and placed next to part 1
-  G4RotationMatrix * rotEmptyPart2 = new G4RotationMatrix();
+  G4RotationMatrix * rotEmptyPart2 = FourQubitGeometryArena::Instance()->Rotation();
   rotEmptyPart2->rotateX(90.*deg);
   rotEmptyPart2->rotateY(-90.*deg);
 
@@ -168,7 +169,7 @@ void FourQubitPad::ConstructPad(G4RotationMatrix * pRot,
 
   
   //We need to rotate the part 2 so that it can be aligned and placed next to part 1
-  G4RotationMatrix * rotPart2 = new G4RotationMatrix();
+  G4RotationMatrix * rotPart2 = FourQubitGeometryArena::Instance()->Rotation();
   rotPart2->rotateX(90.*deg);
   rotPart2->rotateY(-90.*deg);
 
@@ -217,7 +218,7 @@ void FourQubitPad::ConstructPad(G4RotationMatrix * pRot,
 							   log_padEmpty,
 							   false,
 							   0,
-							   true);
+							   checkOverlaps);
   
   G4VPhysicalVolume* phys_padEmpty = new G4PVPlacement(pRot,
 						       tLate,
@@ -229,19 +230,17 @@ void FourQubitPad::ConstructPad(G4RotationMatrix * pRot,
 						       pSurfChk);
 
   //Push these back into the fundamental volume list
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",padEmptyName,phys_padEmpty));
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",padConductorName,phys_padConductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,padEmptyName,phys_padEmpty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,padConductorName,phys_padConductor));
 
   
   
   
   /*  
-  G4VisAttributes* simpleBoxVisAtt= new G4VisAttributes(G4Colour(1.0,0.0,0.0,0.9));
-  simpleBoxVisAtt->SetVisibility(true);
+  const G4VisAttributes* simpleBoxVisAtt= FourQubitVisAttributes::Get(G4Colour(1.0,0.0,0.0,0.9));
   log_pad->SetVisAttributes(simpleBoxVisAtt);
 
-  G4VisAttributes* simpleBoxVisAtt2= new G4VisAttributes(G4Colour(0.0,1.0,0.0,0.9));
-  simpleBoxVisAtt2->SetVisibility(true);
+  const G4VisAttributes* simpleBoxVisAtt2= FourQubitVisAttributes::Get(G4Colour(0.0,1.0,0.0,0.9));
   log_padEmpty->SetVisAttributes(simpleBoxVisAtt2);
   */
 
@@ -261,7 +260,7 @@ void FourQubitPad::ConstructPad(G4RotationMatrix * pRot,
 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > FourQubitPad::GetListOfAllFundamentalSubVolumes()
+const FourQubitSubVolumeList& FourQubitPad::GetListOfAllFundamentalSubVolumes() const
 {
   return fFundamentalVolumeList;
 }
@@ -0,0 +1,132 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitParameterScan.cc
+//
+// Description:	Batch driver running one macro over a list of geometry
+//		parameter points.
+
+#include "FourQubitParameterScan.hh"
+#include "FourQubitConfigManager.hh"
+#include "FourQubitDetectorParameters.hh"
+#include "G4UImanager.hh"
+#include "G4ios.hh"
+#include <fstream>
+#include <sstream>
+
+
+FourQubitParameterScan::FourQubitParameterScan(const G4String& scanFile)
+  : valid(false) {
+  valid = Load(scanFile);
+}
+
+
+// Every parameter line must follow a "point" line; tags must be unique
+// since they name the output files
+
+G4bool FourQubitParameterScan::Load(const G4String& scanFile) {
+  std::ifstream in(scanFile);
+  if (!in.good()) {
+    G4ExceptionDescription msg;
+    msg << "Unable to open parameter scan file " << scanFile << ".";
+    G4Exception("FourQubitParameterScan::Load", "Scan001", JustWarning, msg);
+    return false;
+  }
+
+  std::string line;
+  G4int lineNo = 0;
+  while (std::getline(in, line)) {
+    lineNo++;
+    line = line.substr(0, line.find('#'));
+
+    std::istringstream fields(line);
+    std::string name, value;
+    if (!(fields >> name)) continue;		// Blank or comment
+    std::getline(fields, value);
+
+    if (name == "point") {
+      std::istringstream tagField(value);
+      std::string tag;
+      tagField >> tag;
+      for (const Point& point : points) {
+	if (point.tag == tag) tag.clear();
+      }
+
+      if (tag.empty()) {
+	G4ExceptionDescription msg;
+	msg << scanFile << " line " << lineNo << ": each point needs its own tag.";
+	G4Exception("FourQubitParameterScan::Load", "Scan002", JustWarning, msg);
+	return false;
+      }
+
+      points.emplace_back();
+      points.back().tag = tag;
+    } else if (points.empty() || !FourQubitDetectorParameters::FindParameter(name)) {
+      G4ExceptionDescription msg;
+      msg << scanFile << " line " << lineNo << ": "
+	  << (points.empty() ? "parameter before the first point."
+	      : "no geometry parameter named " + name + ".");
+      G4Exception("FourQubitParameterScan::Load", "Scan002", JustWarning, msg);
+      return false;
+    } else {
+      points.back().values.emplace_back(name, value);
+    }
+  }
+
+  if (points.empty()) {
+    G4ExceptionDescription msg;
+    msg << "No points in parameter scan file " << scanFile << ".";
+    G4Exception("FourQubitParameterScan::Load", "Scan002", JustWarning, msg);
+    return false;
+  }
+
+  return true;
+}
+
+
+G4int FourQubitParameterScan::Run(const G4String& macroName) {
+  if (!valid) return G4int(points.size());
+
+  G4UImanager* UImanager = G4UImanager::GetUIpointer();
+  G4String command = "/control/execute " + macroName;
+
+  G4int skipped = 0;
+  for (size_t i=0; i<points.size(); i++) {
+    G4cout << "\n=== Parameter scan point " << i+1 << "/" << points.size()
+	   << ": " << points[i].tag << " ===" << G4endl;
+
+    if (!Apply(i)) {
+      G4cout << "=== Skipping point " << points[i].tag << " ===" << G4endl;
+      skipped++;
+      continue;
+    }
+
+    UImanager->ApplyCommand(command);
+  }
+
+  // Leave the job as it was before the scan
+  FourQubitDetectorParameters::ResetParameters();
+  FourQubitConfigManager::SetOutputTag("");
+  FourQubitConfigManager::UpdateGeometry();
+
+  return skipped;
+}
+
+
+// Each point starts from the defaults, so points don't depend on order
+
+G4bool FourQubitParameterScan::Apply(size_t index) const {
+  FourQubitDetectorParameters::ResetParameters();
+
+  for (const auto& value : points[index].values) {
+    if (!FourQubitDetectorParameters::SetParameter(value.first, value.second))
+      return false;
+  }
+
+  FourQubitConfigManager::SetOutputTag(points[index].tag);
+  FourQubitConfigManager::UpdateGeometry();
+  return true;
+}
@@ -0,0 +1,45 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitPhysicsList.cc
+//
+// Description:	The physics lists selectable with "FourQubit -p".
+
+#include "FourQubitPhysicsList.hh"
+#include "FTFP_BERT.hh"
+#include "G4CMPPhysics.hh"
+#include "G4DecayPhysics.hh"
+#include "G4EmStandardPhysics.hh"
+#include "G4StepLimiterPhysics.hh"
+#include "G4VModularPhysicsList.hh"
+
+
+G4bool FourQubitPhysicsList::IsKnown(const G4String& name) {
+  return (name == "phonon" || name == "em" || name == "full");
+}
+
+G4VModularPhysicsList* FourQubitPhysicsList::Create(const G4String& name) {
+  if (!IsKnown(name)) return 0;
+
+  G4VModularPhysicsList* physics = 0;
+  if (name == "full") physics = new FTFP_BERT;
+  else physics = new G4VModularPhysicsList;
+
+  if (name == "em") {
+    physics->RegisterPhysics(new G4EmStandardPhysics);
+    physics->RegisterPhysics(new G4DecayPhysics);
+  }
+  physics->RegisterPhysics(new G4CMPPhysics);
+
+  // Region limits, for every particle: by default G4StepLimiterPhysics
+  // limits charged particles only, which would leave out the phonons.  A
+  // region without limits costs each step two quick lookups.
+  G4StepLimiterPhysics* limiter = new G4StepLimiterPhysics;
+  limiter->SetApplyToAll(true);
+  physics->RegisterPhysics(limiter);
+  physics->SetCuts();
+  return physics;
+}
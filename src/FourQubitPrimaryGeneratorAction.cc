@@ -10,22 +10,51 @@
 //
 // 20140519  Allow the user to specify phonon type by name in macro; if
 //	     "geantino" is set, use random generator to select.
+// 20261014  Add stratified and Halton position sampling (/g4cmp/PrimarySampling)
+// 20261014  Add qubit-biased position sampling with primary weights
+// 20261014  Add pre-sampled vertex bank (/g4cmp/VertexBank)
+// 20261014  Number samples by the written event number (resumed, MPI runs)
+// 20261014  Vertex bank: carry on across runs, mark events without a vertex aborted
 
 #include "FourQubitPrimaryGeneratorAction.hh"
+#include "FourQubitEventInfo.hh"
+#include "FourQubitConfigManager.hh"
+#include "FourQubitSensorTable.hh"
+#include "FourQubitVertexBank.hh"
+#include "FourQubitVertexInfo.hh"
 
 #include "G4Event.hh"
 #include "G4Geantino.hh"
+#include "G4IonTable.hh"
 #include "G4ParticleGun.hh"
 #include "G4GeneralParticleSource.hh"
 #include "G4RandomDirection.hh"
 #include "G4PhononTransFast.hh"
 #include "G4PhononTransSlow.hh"
 #include "G4PhononLong.hh"
+#include "G4ParticleTable.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4SPSPosDistribution.hh"
+#include "G4SingleParticleSource.hh"
 #include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <vector>
 
 using namespace std;
 
-FourQubitPrimaryGeneratorAction::FourQubitPrimaryGeneratorAction() { 
+namespace {
+  // Radical inverse of i in the given base: the i'th Halton coordinate
+  G4double RadicalInverse(G4long i, G4int base) {
+    G4double result = 0., digit = 1./base;
+    for (; i > 0; i /= base, digit /= base) result += (i % base) * digit;
+    return result;
+  }
+}
+
+FourQubitPrimaryGeneratorAction::FourQubitPrimaryGeneratorAction()
+  : fBank(0), fPrefetchBegin(0), fPrefetchEnd(0) {
   fParticleGun  = new G4GeneralParticleSource();
 
   // default particle kinematics ("geantino" triggers random phonon choice)
@@ -62,9 +91,199 @@ void FourQubitPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
   
   //fParticleGun->SetParticleMomentumDirection(G4ThreeVector(0,0,1));
   //  fParticleGun->SetParticleMomentumDirection(G4RandomDirection());
+  if (!FourQubitConfigManager::GetVertexBank().empty()) {
+    GenerateFromBank(anEvent);
+    return;
+  }
+
+  G4int firstVertex = anEvent->GetNumberOfPrimaryVertex();
   fParticleGun->GeneratePrimaryVertex(anEvent);
+
+  // GPS still picks the particle, energy and direction; only the position
+  // is replaced
+  if (FourQubitConfigManager::GetPrimarySampling() == "gps") return;
+
+  G4ThreeVector pos;
+  G4int stratum = -1;
+  G4double weight = 1.;
+  if (FourQubitConfigManager::GetPrimarySampling() == "biased")
+    weight = SampleBiasedPosition(pos);
+  else
+    stratum = SamplePosition(FourQubitEventInfo::EventNumber(anEvent), pos);
+
+  // Secondaries inherit the primary's weight, so it reaches every hit
+  for (G4int i=firstVertex; i<anEvent->GetNumberOfPrimaryVertex(); i++) {
+    G4PrimaryVertex* vertex = anEvent->GetPrimaryVertex(i);
+    vertex->SetPosition(pos.x(), pos.y(), pos.z());
+    vertex->SetUserInformation(new FourQubitVertexInfo(stratum));
+    for (G4PrimaryParticle* p=vertex->GetPrimary(); p; p=p->GetNext())
+      p->SetWeight(p->GetWeight() * weight);
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 
+// The box is /gps/pos/centre and halfx, halfy, halfz (as for the Para
+// shape in pceStudy.mac; any rotation is ignored).  Positions depend only
+// on the event ID, so MT workers cover the strata between them without
+// sharing any state:
+//  - stratified: event i goes in cell i modulo the number of cells, at a
+//    uniformly random point inside it, so every pass over the cells puts
+//    exactly one primary in each
+//  - halton: point i+1 of the base 2, 3, 5 Halton sequence, with no
+//    randomness at all
+
+G4int FourQubitPrimaryGeneratorAction::SamplePosition(G4int eventID,
+						      G4ThreeVector& pos) const {
+  const G4SPSPosDistribution* box = fParticleGun->GetCurrentSource()->GetPosDist();
+  const G4ThreeVector half(box->GetHalfX(), box->GetHalfY(), box->GetHalfZ());
+  const G4ThreeVector corner = box->GetCentreCoords() - half;
+
+  G4int nCells[3];
+  for (G4int i=0; i<3; i++) nCells[i] = FourQubitConfigManager::GetPrimaryStrata(i);
+  const G4long nStrata = G4long(nCells[0]) * nCells[1] * nCells[2];
+
+  G4double u[3];
+  if (FourQubitConfigManager::GetPrimarySampling() == "halton") {
+    const G4int bases[3] = { 2, 3, 5 };
+    for (G4int i=0; i<3; i++) u[i] = RadicalInverse(G4long(eventID)+1, bases[i]);
+  } else {
+    G4long cell = G4long(eventID) % nStrata;
+    const G4long index[3] = { cell % nCells[0], (cell / nCells[0]) % nCells[1],
+			      cell / (G4long(nCells[0]) * nCells[1]) };
+    for (G4int i=0; i<3; i++) u[i] = (index[i] + G4UniformRand()) / nCells[i];
+  }
+
+  G4int cell[3];
+  for (G4int i=0; i<3; i++) {
+    pos[i] = corner[i] + 2.*half[i]*u[i];
+    cell[i] = std::min(G4int(u[i]*nCells[i]), nCells[i]-1);
+  }
+  return cell[0] + nCells[0]*(cell[1] + nCells[1]*cell[2]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+
+// A mixture of the uniform box and the qubit footprints (world-frame XY
+// boxes from FourQubitSensorTable, widened by the margin and clipped to
+// the box); z stays uniform.  The weight is the uniform density over the
+// mixture density at the chosen point, so weighted sums are unbiased:
+//   1/w = (1-f) + f * A_box/N * sum over footprints containing it of 1/A_q
+
+G4double FourQubitPrimaryGeneratorAction::SampleBiasedPosition(G4ThreeVector& pos) const {
+  const G4SPSPosDistribution* box = fParticleGun->GetCurrentSource()->GetPosDist();
+  const G4ThreeVector half(box->GetHalfX(), box->GetHalfY(), box->GetHalfZ());
+  const G4ThreeVector lo = box->GetCentreCoords() - half;
+  const G4ThreeVector hi = box->GetCentreCoords() + half;
+
+  struct Region { G4double xMin, xMax, yMin, yMax; };
+  std::vector<Region> regions;
+  const G4double margin = FourQubitConfigManager::GetPrimaryBiasMargin();
+  for (const auto& qubit : FourQubitSensorTable::Instance()->GetQubits()) {
+    Region r = { std::max(qubit.min.x()-margin, lo.x()), std::min(qubit.max.x()+margin, hi.x()),
+		 std::max(qubit.min.y()-margin, lo.y()), std::min(qubit.max.y()+margin, hi.y()) };
+    if (r.xMax > r.xMin && r.yMax > r.yMin) regions.push_back(r);
+  }
+
+  const G4double fraction = FourQubitConfigManager::GetPrimaryBiasFraction();
+  const G4double boxArea = 4.*half.x()*half.y();
+  pos.setZ(lo.z() + 2.*half.z()*G4UniformRand());
+
+  if (regions.empty() || boxArea <= 0.) {		// Nothing to aim at
+    pos.setX(lo.x() + 2.*half.x()*G4UniformRand());
+    pos.setY(lo.y() + 2.*half.y()*G4UniformRand());
+    return 1.;
+  }
 
+  if (G4UniformRand() < fraction) {
+    const Region& r = regions[std::min(size_t(G4UniformRand()*regions.size()), regions.size()-1)];
+    pos.setX(r.xMin + (r.xMax-r.xMin)*G4UniformRand());
+    pos.setY(r.yMin + (r.yMax-r.yMin)*G4UniformRand());
+  } else {
+    pos.setX(lo.x() + 2.*half.x()*G4UniformRand());
+    pos.setY(lo.y() + 2.*half.y()*G4UniformRand());
+  }
+
+  G4double inRegions = 0.;
+  for (const Region& r : regions) {
+    if (pos.x() >= r.xMin && pos.x() <= r.xMax && pos.y() >= r.yMin && pos.y() <= r.yMax)
+      inRegions += 1./((r.xMax-r.xMin)*(r.yMax-r.yMin));
+  }
+  return 1./((1.-fraction) + fraction*boxArea/regions.size()*inRegions);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+
+// Record i is event i, so each worker reads exactly the records of the
+// events it was given, in order.  Pages for the next stretch of records
+// are requested well before they are needed; the window is moved on
+// when half of it has been used, or when the worker jumps to a new block
+// of events.
+
+void FourQubitPrimaryGeneratorAction::GenerateFromBank(G4Event* anEvent) {
+  const G4String& bankFile = FourQubitConfigManager::GetVertexBank();
+  if (!fBank || bankFile != fBankFile) {
+    fBankFile = bankFile;
+    fBank = FourQubitVertexBank::Open(bankFile);
+    fPrefetchBegin = fPrefetchEnd = 0;
+
+    fBankParticles.clear();
+    if (fBank) {
+      G4ParticleTable* particles = G4ParticleTable::GetParticleTable();
+      for (const std::string& name : fBank->GetParticleNames())
+	fBankParticles.push_back(particles->FindParticle(name));
+    }
+  }
+
+  const G4long index = FourQubitVertexBank::GetRunOffset(bankFile)
+    + FourQubitEventInfo::EventNumber(anEvent);
+  FourQubitHitFormat::VertexRecord rec;
+  if (!fBank || !fBank->Read(index, rec)) {
+    G4ExceptionDescription msg;
+    if (fBank) msg << "Vertex bank " << bankFile << " has only "
+		   << fBank->GetNumberOfRecords() << " vertices; no vertex for event "
+		   << index << ".";
+    else msg << "No usable vertex bank " << bankFile << ".";
+    G4Exception("FourQubitPrimaryGeneratorAction::GenerateFromBank",
+		"VertexBank004", RunMustBeAborted, msg);
+    anEvent->SetEventAborted();		// Nothing is recorded for it
+    return;
+  }
+
+  const G4long window = 1 << 16;		// 5 MB of records
+  if (index < fPrefetchBegin || index >= fPrefetchEnd - window/2) {
+    fBank->Prefetch(index, window);
+    fPrefetchBegin = index;
+    fPrefetchEnd = index + window;
+  }
+
+  G4ParticleDefinition* particle = 0;
+  if (rec.particle >= 0 && size_t(rec.particle) < fBankParticles.size())
+    particle = fBankParticles[rec.particle];
+  else if (rec.particle < 0) {
+    particle = G4ParticleTable::GetParticleTable()->FindParticle(rec.pdg);
+    if (!particle) particle = G4IonTable::GetIonTable()->GetIon(rec.pdg);
+  }
+
+  if (!particle) {
+    G4ExceptionDescription msg;
+    msg << "Unknown particle (code " << rec.particle << ", PDG " << rec.pdg
+	<< ") in vertex " << index << " of " << bankFile << ".";
+    G4Exception("FourQubitPrimaryGeneratorAction::GenerateFromBank",
+		"VertexBank005", RunMustBeAborted, msg);
+    anEvent->SetEventAborted();
+    return;
+  }
+
+  G4PrimaryParticle* primary = new G4PrimaryParticle(particle);
+  primary->SetKineticEnergy(rec.kineticEnergy*eV);
+  primary->SetMomentumDirection(G4ThreeVector(rec.dirX, rec.dirY, rec.dirZ).unit());
+  primary->SetWeight(rec.weight);
+
+  G4PrimaryVertex* vertex = new G4PrimaryVertex(rec.x*mm, rec.y*mm, rec.z*mm,
+						rec.time*ns);
+  vertex->SetPrimary(primary);
+  anEvent->AddPrimaryVertex(vertex);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
@@ -0,0 +1,226 @@
+//
+/// \file FourQubitQubitArray.cc
+/// \brief Implementation of the class placing an N x M array of qubit
+///        units with a single G4PVParameterised
+
+// Includes (G4)
+#include "G4Box.hh"
+#include "G4LogicalVolume.hh"
+#include "G4PVParameterised.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4VPhysicalVolume.hh"
+#include <algorithm>
+#include <cfloat>
+
+// Includes (specific to this project)
+#include "FourQubitQubitArray.hh"
+#include "FourQubitGeometryArena.hh"
+#include "FourQubitCurve.hh"
+#include "FourQubitDetectorParameters.hh"
+#include "FourQubitResonator.hh"
+#include "FourQubitStraight.hh"
+#include "FourQubitXmon.hh"
+
+using namespace FourQubitDetectorParameters;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+FourQubitArrayParameterisation::FourQubitArrayParameterisation(G4int nColumns, G4int nRows,
+                                                               G4double pitchX, G4double pitchY)
+    : fColumns(nColumns), fRows(nRows), fPitchX(pitchX), fPitchY(pitchY)
+{
+}
+
+G4ThreeVector FourQubitArrayParameterisation::GetCellPosition(G4int copyNo) const
+{
+  G4int column = copyNo % fColumns;
+  G4int row = copyNo / fColumns;
+  return G4ThreeVector((column - 0.5 * (fColumns - 1)) * fPitchX,
+                       (row - 0.5 * (fRows - 1)) * fPitchY,
+                       0.0);
+}
+
+void FourQubitArrayParameterisation::ComputeTransformation(const G4int copyNo, G4VPhysicalVolume *physVol) const
+{
+  physVol->SetTranslation(GetCellPosition(copyNo));
+  physVol->SetRotation(0);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Primary Constructor
+FourQubitQubitArray::FourQubitQubitArray(G4int nColumns,
+                                         G4int nRows,
+                                         G4double pitchX,
+                                         G4double pitchY,
+                                         G4double gap,
+                                         const G4String &pName,
+                                         G4LogicalVolume *pMotherLogical,
+                                         G4bool pSurfChk)
+{
+  FourQubitGeometryArena *arena = FourQubitGeometryArena::Instance();
+
+  // The unit is built in a copy of the mother that is never placed, measured, and then
+  // moved into a ground-plane box of its own size, which becomes the cell
+  G4LogicalVolume *log_template = new G4LogicalVolume(pMotherLogical->GetSolid(),
+                                                      pMotherLogical->GetMaterial(),
+                                                      pName + "_template_log");
+  std::vector<const FourQubitSubVolumeList *> pieces;
+  ConstructQubitUnit(pName, log_template, pSurfChk, pieces);
+
+  G4ThreeVector unitMin(DBL_MAX, DBL_MAX, DBL_MAX);
+  G4ThreeVector unitMax(-DBL_MAX, -DBL_MAX, -DBL_MAX);
+  for (size_t i = 0; i < log_template->GetNoDaughters(); ++i)
+  {
+    G4VPhysicalVolume *piece = log_template->GetDaughter(i);
+    G4ThreeVector lMin, lMax;
+    piece->GetLogicalVolume()->GetSolid()->BoundingLimits(lMin, lMax);
+    for (G4int iC = 0; iC < 8; ++iC)
+    {
+      G4ThreeVector corner((iC & 1) ? lMax.x() : lMin.x(),
+                           (iC & 2) ? lMax.y() : lMin.y(),
+                           (iC & 4) ? lMax.z() : lMin.z());
+      corner = piece->GetObjectRotationValue() * corner + piece->GetObjectTranslation();
+      unitMin.set(std::min(unitMin.x(), corner.x()), std::min(unitMin.y(), corner.y()), std::min(unitMin.z(), corner.z()));
+      unitMax.set(std::max(unitMax.x(), corner.x()), std::max(unitMax.y(), corner.y()), std::max(unitMax.z(), corner.z()));
+    }
+  }
+
+  // The cell is as thick as the mother, so it replaces the ground plane wherever it sits
+  G4ThreeVector motherMin, motherMax;
+  pMotherLogical->GetSolid()->BoundingLimits(motherMin, motherMax);
+  G4ThreeVector centre(0.5 * (unitMin.x() + unitMax.x()), 0.5 * (unitMin.y() + unitMax.y()), 0.0);
+  fCellDimX = unitMax.x() - unitMin.x();
+  fCellDimY = unitMax.y() - unitMin.y();
+  if (pitchX <= 0) pitchX = fCellDimX + gap;
+  if (pitchY <= 0) pitchY = fCellDimY + gap;
+  CheckFit(nColumns, nRows, pitchX, pitchY, motherMin, motherMax);
+
+  G4Box *solid_cell = new G4Box(pName + "_Cell", 0.5 * fCellDimX, 0.5 * fCellDimY,
+                                0.5 * (motherMax.z() - motherMin.z()));
+  fLog_output = new G4LogicalVolume(solid_cell, pMotherLogical->GetMaterial(), pName + "_Cell_log");
+  fLog_output->SetVisAttributes(pMotherLogical->GetVisAttributes());
+  while (log_template->GetNoDaughters() > 0)
+  {
+    G4VPhysicalVolume *piece = log_template->GetDaughter(0);
+    log_template->RemoveDaughter(piece);
+    piece->SetTranslation(piece->GetTranslation() - centre);
+    piece->SetMotherLogical(fLog_output);
+    fLog_output->AddDaughter(piece);
+  }
+
+  // The navigator calls back into the parameterisation for as long as the
+  // geometry exists, so it belongs to the arena, not to this builder
+  fParameterisation = arena->Make<FourQubitArrayParameterisation>(nColumns, nRows, pitchX, pitchY);
+
+  fPhys_output = new G4PVParameterised(pName,
+                                       fLog_output,
+                                       pMotherLogical,
+                                       kUndefined,
+                                       fParameterisation->GetNumberOfCells(),
+                                       fParameterisation,
+                                       pSurfChk);
+
+  // The cell's own ground plane, then every piece of the unit
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium, pName, fPhys_output));
+  for (size_t i = 0; i < pieces.size(); ++i)
+    fFundamentalVolumeList.insert(fFundamentalVolumeList.end(), pieces[i]->begin(), pieces[i]->end());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// One qubit as on the hand-built chip (its top-left qubit): a readout resonator, the
+// curve and straight that couple it to the qubit, and the Xmon island. The resonator's
+// open end is at "anchor", and each piece is placed from the end of the one before
+void FourQubitQubitArray::ConstructQubitUnit(const G4String &pName,
+                                             G4LogicalVolume *log_unit,
+                                             G4bool pSurfChk,
+                                             std::vector<const FourQubitSubVolumeList *> &pieces)
+{
+  FourQubitGeometryArena *arena = FourQubitGeometryArena::Instance();
+
+  FourQubitResonator *resonator = arena->Make<FourQubitResonator>(nullptr,
+                                                                  G4ThreeVector(0, 0, 0),
+                                                                  pName + "_Resonator",
+                                                                  log_unit,
+                                                                  false,
+                                                                  0,
+                                                                  pSurfChk,
+                                                                  7,
+                                                                  546 * um);
+  pieces.push_back(&resonator->GetListOfAllFundamentalSubVolumes());
+  G4ThreeVector anchor = resonator->GetResEndVector();
+
+  anchor = anchor + G4ThreeVector(0, dp_resonatorCurveCentralRadius + (0.5 * dp_tlCouplingEmptyDimY), 0);
+  FourQubitCurve *couplerCurve = arena->Make<FourQubitCurve>(arena->Rotation(),
+                                                             anchor,
+                                                             pName + "_CouplerCurve",
+                                                             log_unit,
+                                                             false,
+                                                             0,
+                                                             pSurfChk, dp_resonatorCurveCentralRadius, 180, 90);
+  pieces.push_back(&couplerCurve->GetListOfAllFundamentalSubVolumes());
+
+  G4RotationMatrix *rotCouplerStraight = arena->Rotation();
+  rotCouplerStraight->rotateZ(90. * deg);
+  anchor = anchor + G4ThreeVector(-1.0 * (dp_resonatorCurveCentralRadius + (0.5 * dp_tlCouplingEmptyDimY)), 0.5 * 130 * um, 0);
+  FourQubitStraight *couplerStraight = arena->Make<FourQubitStraight>(rotCouplerStraight,
+                                                                      anchor,
+                                                                      pName + "_CouplerStraight",
+                                                                      log_unit,
+                                                                      false,
+                                                                      0,
+                                                                      pSurfChk, 130 * um);
+  pieces.push_back(&couplerStraight->GetListOfAllFundamentalSubVolumes());
+
+  FourQubitXmon *xmon = arena->Make<FourQubitXmon>(nullptr,
+                                                   anchor + G4ThreeVector(0.0, (0.5 * 130 * um) + (0.5 * dp_xmonBaseNbLayerDimY), 0),
+                                                   pName + "_Xmon",
+                                                   log_unit,
+                                                   false,
+                                                   0,
+                                                   pSurfChk);
+  pieces.push_back(&xmon->GetListOfAllFundamentalSubVolumes());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Neighbouring cells must not overlap, and the array must fit in its mother
+void FourQubitQubitArray::CheckFit(G4int nColumns, G4int nRows, G4double pitchX, G4double pitchY,
+                                   const G4ThreeVector &motherMin, const G4ThreeVector &motherMax) const
+{
+  if (pitchX < fCellDimX || pitchY < fCellDimY)
+  {
+    G4ExceptionDescription msg;
+    msg << "Array pitch " << pitchX / um << " x " << pitchY / um << " um is smaller than the "
+        << fCellDimX / um << " x " << fCellDimY / um << " um qubit cell";
+    G4Exception("FourQubitQubitArray::FourQubitQubitArray", "Geometry004", FatalException, msg);
+  }
+
+  G4double arrayDimX = (nColumns - 1) * pitchX + fCellDimX;
+  G4double arrayDimY = (nRows - 1) * pitchY + fCellDimY;
+  if (arrayDimX > motherMax.x() - motherMin.x() || arrayDimY > motherMax.y() - motherMin.y())
+  {
+    G4ExceptionDescription msg;
+    msg << "A " << nColumns << " x " << nRows << " array is " << arrayDimX / mm << " x "
+        << arrayDimY / mm << " mm, larger than its mother; enlarge dp_siliconChipDimX/Y";
+    G4Exception("FourQubitQubitArray::FourQubitQubitArray", "Geometry005", FatalException, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Destructor
+FourQubitQubitArray::~FourQubitQubitArray()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+std::vector<G4ThreeVector> FourQubitQubitArray::GetCellPositions() const
+{
+  std::vector<G4ThreeVector> positions;
+  for (G4int i = 0; i < fParameterisation->GetNumberOfCells(); ++i)
+    positions.push_back(fParameterisation->GetCellPosition(i));
+  return positions;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+const FourQubitSubVolumeList& FourQubitQubitArray::GetListOfAllFundamentalSubVolumes() const
+{
+  return fFundamentalVolumeList;
+}
@@ -44,6 +44,8 @@
 //Includes (specific to this project)
 #include "FourQubitQubitHousing.hh"
 #include "FourQubitDetectorParameters.hh"
+#include "FourQubitGeometryArena.hh"
+#include "FourQubitVisAttributes.hh"
 
 using namespace FourQubitDetectorParameters;
 
@@ -94,6 +96,7 @@ void FourQubitQubitHousing::ConstructQubitHousing(G4RotationMatrix * pRot,
 							     G4int pCopyNo,
 							     G4bool pSurfChk)
 {
+  FourQubitGeometryArena * arena = FourQubitGeometryArena::Instance();
 
   //Start with some preliminaries - NIST manager
   G4NistManager* nist = G4NistManager::Instance();
@@ -126,7 +129,7 @@ void FourQubitQubitHousing::ConstructQubitHousing(G4RotationMatrix * pRot,
   //Now take the radial cutouts and move them to the right position relative to the primary cutout
 
   //First of eight
-  G4RotationMatrix * rot1 = new G4RotationMatrix();
+  G4RotationMatrix * rot1 = arena->Rotation();
   rot1->rotateZ(45.*deg);
   G4ThreeVector trans1(0.5*dp_housingCentralCutoutDimX, //Move to top right corner
 		       0.5*dp_housingCentralCutoutDimY, //Move to top right corner
@@ -138,7 +141,7 @@ void FourQubitQubitHousing::ConstructQubitHousing(G4RotationMatrix * pRot,
 							 trans1);
   
   //Second of eight
-  G4RotationMatrix * rot2 = new G4RotationMatrix();
+  G4RotationMatrix * rot2 = arena->Rotation();
   rot2->rotateZ(-45.*deg);
   G4ThreeVector trans2(0.5*dp_housingCentralCutoutDimX, //Move to bottom right corner
 		       -0.5*dp_housingCentralCutoutDimY, //Move to bottom right corner
@@ -150,7 +153,7 @@ void FourQubitQubitHousing::ConstructQubitHousing(G4RotationMatrix * pRot,
 							 trans2);
 
   //Third of eight
-  G4RotationMatrix * rot3 = new G4RotationMatrix();
+  G4RotationMatrix * rot3 = arena->Rotation();
   rot3->rotateZ(-45.*deg);
   G4ThreeVector trans3(-0.5*dp_housingCentralCutoutDimX, //Move to top left corner
 		       0.5*dp_housingCentralCutoutDimY, //Move to top left corner
@@ -162,7 +165,7 @@ void FourQubitQubitHousing::ConstructQubitHousing(G4RotationMatrix * pRot,
 							 trans3);
 
   //Fourth of eight
-  G4RotationMatrix * rot4 = new G4RotationMatrix();
+  G4RotationMatrix * rot4 = arena->Rotation();
   rot4->rotateZ(45.*deg);
   G4ThreeVector trans4(-0.5*dp_housingCentralCutoutDimX, //Move to bottom left corner
 		       -0.5*dp_housingCentralCutoutDimY, //Move to bottom left corner
@@ -175,7 +178,7 @@ void FourQubitQubitHousing::ConstructQubitHousing(G4RotationMatrix * pRot,
 
 
   //Fifth of eight
-  G4RotationMatrix * rot5 = new G4RotationMatrix();
+  G4RotationMatrix * rot5 = arena->Rotation();
   rot5->rotateZ(90.*deg);
   G4ThreeVector trans5(0.5*dp_housingCentralCutoutDimX, //Move to top in X
 		       0,
@@ -187,7 +190,7 @@ void FourQubitQubitHousing::ConstructQubitHousing(G4RotationMatrix * pRot,
 							 trans5);
   
   //Sixth of eight
-  G4RotationMatrix * rot6 = new G4RotationMatrix();
+  G4RotationMatrix * rot6 = arena->Rotation();
   rot6->rotateZ(90.*deg);
   G4ThreeVector trans6(-0.5*dp_housingCentralCutoutDimX, //Move to bottom in X
 		       0,
@@ -199,7 +202,7 @@ void FourQubitQubitHousing::ConstructQubitHousing(G4RotationMatrix * pRot,
 							 trans6);
  
   //Seventh of eight
-  G4RotationMatrix * rot7 = new G4RotationMatrix();
+  G4RotationMatrix * rot7 = arena->Rotation();
   rot7->rotateZ(0.*deg);
   G4ThreeVector trans7(0,
 		       0.5*dp_housingCentralCutoutDimY, //Move to bottom (Y)
@@ -212,7 +215,7 @@ void FourQubitQubitHousing::ConstructQubitHousing(G4RotationMatrix * pRot,
   
 
   //Eigth of eight
-  G4RotationMatrix * rot8 = new G4RotationMatrix();
+  G4RotationMatrix * rot8 = arena->Rotation();
   rot8->rotateZ(0.*deg);
   G4ThreeVector trans8(0,
 		       -0.5*dp_housingCentralCutoutDimY, //Move to top (Y)
@@ -264,7 +267,7 @@ void FourQubitQubitHousing::ConstructQubitHousing(G4RotationMatrix * pRot,
 					      (0.5 * (dp_housingCentralCutoutDimZ - dp_housingRadialCutoutDimZ)));
 
   //First corner
-  G4RotationMatrix * rot9 = new G4RotationMatrix();
+  G4RotationMatrix * rot9 = arena->Rotation();
   rot9->rotateZ(45.*deg);  
   G4ThreeVector addInTranslation1(0.5*dp_housingCentralCutoutDimX,
 				  0.5*dp_housingCentralCutoutDimY,
@@ -335,8 +338,7 @@ void FourQubitQubitHousing::ConstructQubitHousing(G4RotationMatrix * pRot,
 
 
 
-  G4VisAttributes* simpleBoxVisAtt= new G4VisAttributes(G4Colour(1.0,0.647,0.0,0.9));
-  simpleBoxVisAtt->SetVisibility(true);
+  const G4VisAttributes* simpleBoxVisAtt= FourQubitVisAttributes::Get(G4Colour(1.0,0.647,0.0,0.9));
   log_QubitHousing->SetVisAttributes(simpleBoxVisAtt);
 
 
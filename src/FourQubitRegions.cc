@@ -0,0 +1,127 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitRegions.cc
+//
+// Description:	Regions, production cuts and user limits of the chip.
+
+#include "FourQubitRegions.hh"
+#include "FourQubitConfigManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4Threading.hh"
+#include "G4UnitsTable.hh"
+#include "G4UserLimits.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <cctype>
+#include <float.h>
+
+
+namespace {
+  const char* const kNames[FourQubitRegions::kNumberOfRegions] =
+    { "World", "Housing", "Chip", "Films" };
+
+  // Root logical volume of each region; the world is Geant4's own
+  const char* const kRoots[FourQubitRegions::kNumberOfRegions] =
+    { 0, "QubitHousing", "SiliconChip_log", "GroundPlane_log" };
+
+  const char* const kWorldRegion = "DefaultRegionForTheWorld";
+
+  // Kept for the whole job: material-cuts couples point at the cuts, and
+  // reusing them lets a cut change reach the couples without a rebuild
+  G4ProductionCuts* theCuts[FourQubitRegions::kNumberOfRegions] = { 0 };
+  G4UserLimits* theLimits[FourQubitRegions::kNumberOfRegions] = { 0 };
+
+  G4Region* GetRegion(G4int region) {
+    return G4RegionStore::GetInstance()->GetRegion(region == FourQubitRegions::kWorld
+						   ? kWorldRegion : kNames[region], false);
+  }
+}
+
+
+const char* FourQubitRegions::Name(G4int region) {
+  return (region >= 0 && region < kNumberOfRegions) ? kNames[region] : "";
+}
+
+G4int FourQubitRegions::Find(const G4String& name) {
+  auto same = [](char a, char b) { return std::tolower(a) == std::tolower(b); };
+  for (G4int i=0; i<kNumberOfRegions; i++) {
+    const std::string region(kNames[i]);
+    if (name.size() == region.size() &&
+	std::equal(name.begin(), name.end(), region.begin(), same)) return i;
+  }
+  return -1;
+}
+
+
+// A rebuild has deleted the root volumes of the old regions, so they are
+// replaced rather than refilled
+
+void FourQubitRegions::Define() {
+  G4LogicalVolumeStore* volumes = G4LogicalVolumeStore::GetInstance();
+  for (G4int i=kWorld+1; i<kNumberOfRegions; i++) {
+    delete GetRegion(i);
+
+    G4LogicalVolume* root = volumes->GetVolume(kRoots[i], false);
+    if (root) (new G4Region(kNames[i]))->AddRootLogicalVolume(root);
+  }
+
+  Apply();
+  Print();
+}
+
+// The world's cuts are the physics list's default cuts, so its value also
+// replaces /run/setCut
+
+void FourQubitRegions::Apply() {
+  if (!G4Threading::IsMasterThread()) return;
+
+  for (G4int i=0; i<kNumberOfRegions; i++) {
+    G4Region* region = GetRegion(i);
+    if (!region) continue;
+
+    const FourQubitConfigManager::RegionSettings& set =
+      FourQubitConfigManager::GetRegionSettings(i);
+
+    if (i == kWorld) {
+      if (region->GetProductionCuts()) region->GetProductionCuts()->SetProductionCut(set.cut);
+    } else {
+      if (!theCuts[i]) theCuts[i] = new G4ProductionCuts;
+      theCuts[i]->SetProductionCut(set.cut);
+      region->SetProductionCuts(theCuts[i]);
+    }
+
+    if (set.maxStep <= 0. && set.minEnergy <= 0.) {
+      region->SetUserLimits(0);
+      continue;
+    }
+    if (!theLimits[i]) theLimits[i] = new G4UserLimits;
+    theLimits[i]->SetMaxAllowedStep(set.maxStep > 0. ? set.maxStep : DBL_MAX);
+    theLimits[i]->SetUserMinEkine(set.minEnergy);
+    region->SetUserLimits(theLimits[i]);
+  }
+}
+
+void FourQubitRegions::Print() {
+  for (G4int i=0; i<kNumberOfRegions; i++) {
+    if (!GetRegion(i)) continue;
+
+    const FourQubitConfigManager::RegionSettings& set =
+      FourQubitConfigManager::GetRegionSettings(i);
+    G4cout << "Region " << kNames[i] << ": cut " << G4BestUnit(set.cut, "Length")
+	   << ", max step ";
+    if (set.maxStep > 0.) G4cout << G4BestUnit(set.maxStep, "Length");
+    else G4cout << "none";
+    G4cout << ", min energy ";
+    if (set.minEnergy > 0.) G4cout << G4BestUnit(set.minEnergy, "Energy");
+    else G4cout << "none";
+    G4cout << G4endl;
+  }
+}
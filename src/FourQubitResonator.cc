@@ -22,6 +22,8 @@
 // Includes (specific to this project)
 #include "FourQubitResonator.hh"
 #include "FourQubitDetectorParameters.hh"
+#include "FourQubitGeometryArena.hh"
+#include "FourQubitVisAttributes.hh"
 
 using namespace FourQubitDetectorParameters;
 
@@ -81,15 +83,12 @@ void FourQubitResonator::ConstructResonator(G4RotationMatrix *pRot,
   G4NistManager *nist = G4NistManager::Instance();
   G4Material *niobium_mat = nist->FindOrBuildMaterial("G4_Nb");
   G4Material *air_mat = nist->FindOrBuildMaterial("G4_AIR");
-  //bool checkOverlaps = true;
+  bool checkOverlaps = pSurfChk;
 
   // Set up the visualization
-  G4VisAttributes *niobium_vis = new G4VisAttributes(G4Colour(0.0, 1.0, 1.0, 0.5));
-  niobium_vis->SetVisibility(true);
-  G4VisAttributes *air_vis = new G4VisAttributes(G4Colour(0.5, 0.5, 0.5, 0.5));
-  air_vis->SetVisibility(true);
-  G4VisAttributes *attention_vis = new G4VisAttributes(G4Colour(1.0, 0.0, 0.0, 1.0)); // used for debuging
-  attention_vis->SetVisibility(true);
+  const G4VisAttributes *niobium_vis = FourQubitVisAttributes::Get(G4Colour(0.0, 1.0, 1.0, 0.5));
+  const G4VisAttributes *air_vis = FourQubitVisAttributes::Get(G4Colour(0.5, 0.5, 0.5, 0.5));
+  const G4VisAttributes *attention_vis = FourQubitVisAttributes::Get(G4Colour(1.0, 0.0, 0.0, 1.0)); // used for debuging
 
   //------------------------------------------------------------------------------------------
   // Start with a base layer of niobium into which our objects will fit. We'll return this in the end.
@@ -121,7 +120,7 @@ void FourQubitResonator::ConstructResonator(G4RotationMatrix *pRot,
                                                           pMany,
                                                           pCopyNo,
                                                           pSurfChk);
-  fFundamentalVolumeList.push_back(std::tuple<std::string, G4String, G4VPhysicalVolume *>("Niobium", baseNbLayerName, phys_baseNbLayer));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium, baseNbLayerName, phys_baseNbLayer));
 
   //------------------------------------------------------------------------------------------
   // Resonator
@@ -135,7 +134,7 @@ void FourQubitResonator::ConstructResonator(G4RotationMatrix *pRot,
   G4ThreeVector currentPoint = G4ThreeVector(-0.5 * dp_tlCouplingEmptyDimX, 0.5 * dp_tlCouplingEmptyDimY + dp_resonatorAssemblyBaseNbEdgeBottomDimY, 0.0)
     + brCornerOfBaseNbLayer; // Good for empty or conductor
 
-  G4RotationMatrix *rotation = new G4RotationMatrix();
+  G4RotationMatrix *rotation = FourQubitGeometryArena::Instance()->Rotation();
   rotation->rotateZ(180.0 * deg);
 
   for (int i = 0; i != pLines-1; ++i)
@@ -152,9 +151,9 @@ void FourQubitResonator::ConstructResonator(G4RotationMatrix *pRot,
     G4LogicalVolume *log_shlEmpty = new G4LogicalVolume(solid_shlEmpty, air_mat, shlEmptyNameLog);
 
 
-    G4VPhysicalVolume *shlEmpty = new G4PVPlacement(0, currentPoint, log_shlEmpty, shlEmptyName, log_baseNbLayer, false, 0, true);
+    G4VPhysicalVolume *shlEmpty = new G4PVPlacement(0, currentPoint, log_shlEmpty, shlEmptyName, log_baseNbLayer, false, 0, checkOverlaps);
     log_shlEmpty->SetVisAttributes(air_vis);
-    fFundamentalVolumeList.push_back(std::tuple<std::string, G4String, G4VPhysicalVolume *>("Vacuum", shlEmptyName, shlEmpty));
+    fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum, shlEmptyName, shlEmpty));
 
     //------------------------------------------------------
     // Straight horizontal line (SHL) (conductor)
@@ -167,9 +166,9 @@ void FourQubitResonator::ConstructResonator(G4RotationMatrix *pRot,
                                           0.5 * dp_shlConductorDimY,
                                           0.5 * dp_shlConductorDimZ);
     G4LogicalVolume *log_shlConductor = new G4LogicalVolume(solid_shlConductor, niobium_mat, shlConductorNameLog);
-    G4VPhysicalVolume *shlConductor = new G4PVPlacement(0, G4ThreeVector(0, 0, 0), log_shlConductor, shlConductorName, log_shlEmpty, false, 0, true);
+    G4VPhysicalVolume *shlConductor = new G4PVPlacement(0, G4ThreeVector(0, 0, 0), log_shlConductor, shlConductorName, log_shlEmpty, false, 0, checkOverlaps);
     log_shlConductor->SetVisAttributes(niobium_vis);
-    fFundamentalVolumeList.push_back(std::tuple<std::string, G4String, G4VPhysicalVolume *>("Niobium", shlConductorName, shlConductor));
+    fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium, shlConductorName, shlConductor));
 
     //------------------------------------------------------
     // HalfCircle (empty/cavity)
@@ -196,9 +195,9 @@ void FourQubitResonator::ConstructResonator(G4RotationMatrix *pRot,
                                                            log_baseNbLayer,
                                                            false,
                                                            0,
-                                                           true);
+                                                           checkOverlaps);
     log_halfCircleEmpty->SetVisAttributes(air_vis);
-    fFundamentalVolumeList.push_back(std::tuple<std::string, G4String, G4VPhysicalVolume *>("Vacuum", halfCircleEmptyName, halfCircleEmpty));
+    fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum, halfCircleEmptyName, halfCircleEmpty));
 
     //------------------------------------------------------
     // HalfCircle (conductor)
@@ -220,9 +219,9 @@ void FourQubitResonator::ConstructResonator(G4RotationMatrix *pRot,
                                                                log_halfCircleEmpty,
                                                                false,
                                                                0,
-                                                               true);
+                                                               checkOverlaps);
     log_halfCircleConductor->SetVisAttributes(niobium_vis);
-    fFundamentalVolumeList.push_back(std::tuple<std::string, G4String, G4VPhysicalVolume *>("Niobium", halfCircleConductorName, halfCircleConductor));
+    fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium, halfCircleConductorName, halfCircleConductor));
 
     currentPoint = currentPoint + G4ThreeVector((i % 2 != 0) ? -0.5 * dp_shlEmptyDimX : 0.5 * dp_shlEmptyDimX, dp_resonatorCurveCentralRadius, 0);
   }
@@ -241,9 +240,9 @@ void FourQubitResonator::ConstructResonator(G4RotationMatrix *pRot,
                                     0.5 * dp_shlEmptyDimZ);
   G4LogicalVolume *log_shlEmpty = new G4LogicalVolume(solid_shlEmpty, air_mat, shlEmptyNameLog);
 
-  G4VPhysicalVolume *shlEmpty = new G4PVPlacement(0, currentPoint, log_shlEmpty, shlEmptyName, log_baseNbLayer, false, 0, true);
+  G4VPhysicalVolume *shlEmpty = new G4PVPlacement(0, currentPoint, log_shlEmpty, shlEmptyName, log_baseNbLayer, false, 0, checkOverlaps);
   log_shlEmpty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string, G4String, G4VPhysicalVolume *>("Vacuum", shlEmptyName, shlEmpty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum, shlEmptyName, shlEmpty));
 
   //------------------------------------------------------
   // Straight horizontal line (SHL) (conductor)
@@ -256,9 +255,9 @@ void FourQubitResonator::ConstructResonator(G4RotationMatrix *pRot,
                                         0.5 * dp_shlConductorDimY,
                                         0.5 * dp_shlConductorDimZ);
   G4LogicalVolume *log_shlConductor = new G4LogicalVolume(solid_shlConductor, niobium_mat, shlConductorNameLog);
-  G4VPhysicalVolume *shlConductor = new G4PVPlacement(0, G4ThreeVector(0, 0, 0), log_shlConductor, shlConductorName, log_shlEmpty, false, 0, true);
+  G4VPhysicalVolume *shlConductor = new G4PVPlacement(0, G4ThreeVector(0, 0, 0), log_shlConductor, shlConductorName, log_shlEmpty, false, 0, checkOverlaps);
   log_shlConductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string, G4String, G4VPhysicalVolume *>("Niobium", shlConductorName, shlConductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium, shlConductorName, shlConductor));
 
   currentPoint = currentPoint + G4ThreeVector((pLines % 2 != 0) ? -0.5 * plLineLen : 0.5 * plLineLen, 0.0, 0.0);
 
@@ -273,7 +272,7 @@ void FourQubitResonator::ConstructResonator(G4RotationMatrix *pRot,
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-std::vector<std::tuple<std::string, G4String, G4VPhysicalVolume *>> FourQubitResonator::GetListOfAllFundamentalSubVolumes()
+const FourQubitSubVolumeList& FourQubitResonator::GetListOfAllFundamentalSubVolumes() const
 {
   return fFundamentalVolumeList;
 }
@@ -46,6 +46,8 @@
 #include "FourQubitResonatorAssembly.hh"
 #include "FourQubitPad.hh"
 #include "FourQubitDetectorParameters.hh"
+#include "FourQubitGeometryArena.hh"
+#include "FourQubitVisAttributes.hh"
 
 using namespace FourQubitDetectorParameters;
 
@@ -74,6 +76,32 @@ FourQubitResonatorAssembly::FourQubitResonatorAssembly(G4RotationMatrix * pRot,
   
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Shared-tree constructor: every daughter of the base Nb layer is the same physical volume in
+// all copies, so the sub-volume list is the original's with only the top volume replaced
+FourQubitResonatorAssembly::FourQubitResonatorAssembly(const FourQubitResonatorAssembly * pShared,
+                                                       G4RotationMatrix * pRot,
+                                                       const G4ThreeVector & tLate,
+                                                       const G4String & pName,
+                                                       G4LogicalVolume * pMotherLogical,
+                                                       G4bool pMany,
+                                                       G4int pCopyNo,
+                                                       G4bool pSurfChk)
+{
+  fLog_output = pShared->fLog_output;
+  fPhys_output = new G4PVPlacement(pRot,
+				   tLate,
+				   fLog_output,
+				   pName,
+				   pMotherLogical,
+				   pMany,
+				   pCopyNo,
+				   pSurfChk);
+
+  fFundamentalVolumeList = pShared->fFundamentalVolumeList;
+  fFundamentalVolumeList[0] = FourQubitSubVolume(FourQubitMaterialTag::Niobium,pName,fPhys_output);
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 // Default Constructor
 FourQubitResonatorAssembly::FourQubitResonatorAssembly()
@@ -96,18 +124,17 @@ void FourQubitResonatorAssembly::ConstructResonatorAssembly(G4RotationMatrix * p
 							     G4int pCopyNo,
 							     G4bool pSurfChk)
 {
+  FourQubitGeometryArena * arena = FourQubitGeometryArena::Instance();
 
   //Start with some preliminaries - NIST manager
   G4NistManager* nist = G4NistManager::Instance();
   G4Material* niobium_mat = nist->FindOrBuildMaterial("G4_Nb");
   G4Material* air_mat = nist->FindOrBuildMaterial("G4_AIR");
-  bool checkOverlaps = true;
+  bool checkOverlaps = pSurfChk;
 
   //Set up the niobium visualization
-  G4VisAttributes* niobium_vis= new G4VisAttributes(G4Colour(0.0,1.0,1.0,0.5));
-  niobium_vis->SetVisibility(true);
-  G4VisAttributes* air_vis= new G4VisAttributes(G4Colour(0.5,0.5,0.5,0.5));
-  air_vis->SetVisibility(true);
+  const G4VisAttributes* niobium_vis= FourQubitVisAttributes::Get(G4Colour(0.0,1.0,1.0,0.5));
+  const G4VisAttributes* air_vis= FourQubitVisAttributes::Get(G4Colour(0.5,0.5,0.5,0.5));
   
 
 
@@ -143,14 +170,14 @@ void FourQubitResonatorAssembly::ConstructResonatorAssembly(G4RotationMatrix * p
 							  pSurfChk);
 
   //Also need an interface definition for this base layer...
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",baseNbLayerName,phys_baseNbLayer));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,baseNbLayerName,phys_baseNbLayer));
 
 
 
   //------------------------------------------------------------------------------------------
   //Now make the various components of the resonator array: line+coupling, shunt capacitance (cross), and qubit
-  MakeResonatorLine(pName,log_baseNbLayer);
-  MakeShuntCapacitorCross(pName,log_baseNbLayer);  
+  MakeResonatorLine(pName,log_baseNbLayer,pSurfChk);
+  MakeShuntCapacitorCross(pName,log_baseNbLayer,pSurfChk);  
 
   /*  
 
@@ -163,7 +190,7 @@ void FourQubitResonatorAssembly::ConstructResonatorAssembly(G4RotationMatrix * p
   
   //Pad 1:
   G4String pad1Name = pName + "_TransmissionLinePad1";
-  FourQubitPad * pad1 = new FourQubitPad(0,
+  FourQubitPad * pad1 = arena->Make<FourQubitPad>(nullptr,
 							       G4ThreeVector(dp_transmissionLinePad1Offset,0,0),
 							       pad1Name,
 							       log_baseNiLayer,
@@ -176,9 +203,9 @@ void FourQubitResonatorAssembly::ConstructResonatorAssembly(G4RotationMatrix * p
 
   //Pad 2: rotate around Z axis by 180 degrees
   G4String pad2Name = pName + "_TransmissionLinePad2";
-  G4RotationMatrix * pad2Rot = new G4RotationMatrix();
+  G4RotationMatrix * pad2Rot = arena->Rotation();
   pad2Rot->rotateZ(180*deg);
-  FourQubitPad * pad2 = new FourQubitPad(pad2Rot,
+  FourQubitPad * pad2 = arena->Make<FourQubitPad>(pad2Rot,
 							       G4ThreeVector(dp_transmissionLinePad2Offset,0,0),
 							       pad2Name,
 							       log_baseNiLayer,
@@ -216,7 +243,7 @@ void FourQubitResonatorAssembly::ConstructResonatorAssembly(G4RotationMatrix * p
 								     log_baseNiLayer,
 								     false,
 								     0,
-								     true);
+								     checkOverlaps);
 
 
   
@@ -240,7 +267,7 @@ void FourQubitResonatorAssembly::ConstructResonatorAssembly(G4RotationMatrix * p
 									 log_transmissionLineEmpty,
 									 false,
 									 0,
-									 true);
+									 checkOverlaps);
 
   
 
@@ -256,8 +283,7 @@ void FourQubitResonatorAssembly::ConstructResonatorAssembly(G4RotationMatrix * p
 
   /*
 
-  G4VisAttributes* simpleBoxVisAtt= new G4VisAttributes(G4Colour(1.0,0.647,0.0,0.9));
-  simpleBoxVisAtt->SetVisibility(true);
+  const G4VisAttributes* simpleBoxVisAtt= FourQubitVisAttributes::Get(G4Colour(1.0,0.647,0.0,0.9));
   log_QubitHousing->SetVisAttributes(simpleBoxVisAtt);
   */
 
@@ -270,7 +296,7 @@ void FourQubitResonatorAssembly::ConstructResonatorAssembly(G4RotationMatrix * p
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 // Make the resonator line
-void FourQubitResonatorAssembly::MakeShuntCapacitorCross(G4String pName, G4LogicalVolume * log_baseNbLayer)
+void FourQubitResonatorAssembly::MakeShuntCapacitorCross(G4String pName, G4LogicalVolume * log_baseNbLayer, G4bool pSurfChk)
 {
 
 
@@ -279,13 +305,11 @@ void FourQubitResonatorAssembly::MakeShuntCapacitorCross(G4String pName, G4Logic
   G4NistManager* nist = G4NistManager::Instance();
   G4Material* niobium_mat = nist->FindOrBuildMaterial("G4_Nb");
   G4Material* air_mat = nist->FindOrBuildMaterial("G4_AIR");
-  bool checkOverlaps = true;
+  bool checkOverlaps = pSurfChk;
   
   //Set up the niobium visualization
-  G4VisAttributes* niobium_vis= new G4VisAttributes(G4Colour(0.0,1.0,1.0,0.5));
-  niobium_vis->SetVisibility(true);
-  G4VisAttributes* air_vis= new G4VisAttributes(G4Colour(0.5,0.5,0.5,0.5));
-  air_vis->SetVisibility(true);
+  const G4VisAttributes* niobium_vis= FourQubitVisAttributes::Get(G4Colour(0.0,1.0,1.0,0.5));
+  const G4VisAttributes* air_vis= FourQubitVisAttributes::Get(G4Colour(0.5,0.5,0.5,0.5));
 
 
   //This will be made in two batches: one for "empty" space and one for "conductor" space (the line itself)
@@ -308,9 +332,9 @@ void FourQubitResonatorAssembly::MakeShuntCapacitorCross(G4String pName, G4Logic
   
   G4LogicalVolume * log_shuntEmpty = new G4LogicalVolume(solid_shuntEmpty,air_mat,shuntEmptyNameLog);
   G4ThreeVector shuntWrtBRCorner(-1*dp_shuntCenterToBottomRightCornerOfBaseLayerDimX,dp_shuntCenterToBottomRightCornerOfBaseLayerDimY,0);
-  G4VPhysicalVolume * shuntEmpty = new G4PVPlacement(0,shuntWrtBRCorner+brCornerOfBaseNbLayer,log_shuntEmpty,shuntEmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * shuntEmpty = new G4PVPlacement(0,shuntWrtBRCorner+brCornerOfBaseNbLayer,log_shuntEmpty,shuntEmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_shuntEmpty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",shuntEmptyName,shuntEmpty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,shuntEmptyName,shuntEmpty));
 
 
   //------------------------------------------------------
@@ -322,9 +346,9 @@ void FourQubitResonatorAssembly::MakeShuntCapacitorCross(G4String pName, G4Logic
   G4Box * solid_shuntHorizontalBlockConductor = new G4Box("ShuntHorizontalBlockConductor",0.5 * dp_shuntHorizontalBlockConductorDimX,0.5 * dp_shuntHorizontalBlockConductorDimY,0.5 * dp_shuntHorizontalBlockConductorDimZ);
   G4UnionSolid * solid_shuntConductor = new G4UnionSolid(shuntConductorNameSolid,solid_shuntVertBlockConductor,solid_shuntHorizontalBlockConductor,0,G4ThreeVector(0,0,0));  
   G4LogicalVolume * log_shuntConductor = new G4LogicalVolume(solid_shuntConductor,niobium_mat,shuntConductorNameLog);
-  G4VPhysicalVolume * shuntConductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shuntConductor,shuntConductorName,log_shuntEmpty,false,0,true);
+  G4VPhysicalVolume * shuntConductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shuntConductor,shuntConductorName,log_shuntEmpty,false,0,checkOverlaps);
   log_shuntConductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",shuntConductorName,shuntConductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,shuntConductorName,shuntConductor));
 
 
 
@@ -334,7 +358,7 @@ void FourQubitResonatorAssembly::MakeShuntCapacitorCross(G4String pName, G4Logic
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 // Make the resonator line
-void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolume * log_baseNbLayer)
+void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolume * log_baseNbLayer, G4bool pSurfChk)
 {
 
   //Materials and NIST
@@ -342,15 +366,12 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4NistManager* nist = G4NistManager::Instance();
   G4Material* niobium_mat = nist->FindOrBuildMaterial("G4_Nb");
   G4Material* air_mat = nist->FindOrBuildMaterial("G4_AIR");
-  bool checkOverlaps = true;
+  bool checkOverlaps = pSurfChk;
 
   //Set up the niobium visualization
-  G4VisAttributes* niobium_vis= new G4VisAttributes(G4Colour(0.0,1.0,1.0,0.5));
-  niobium_vis->SetVisibility(true);
-  G4VisAttributes* air_vis= new G4VisAttributes(G4Colour(0.5,0.5,0.5,0.5));
-  air_vis->SetVisibility(true);
-  G4VisAttributes* attention_vis= new G4VisAttributes(G4Colour(1.0,0.0,0.0,1.0));
-  attention_vis->SetVisibility(true);
+  const G4VisAttributes* niobium_vis= FourQubitVisAttributes::Get(G4Colour(0.0,1.0,1.0,0.5));
+  const G4VisAttributes* air_vis= FourQubitVisAttributes::Get(G4Colour(0.5,0.5,0.5,0.5));
+  const G4VisAttributes* attention_vis= FourQubitVisAttributes::Get(G4Colour(1.0,0.0,0.0,1.0));
   
   
   //This will be made in two batches: one for "empty" space and one for "conductor" space (the line itself)
@@ -391,9 +412,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Box * solid_tlCouplingEmpty = new G4Box(tlCouplingEmptyNameSolid,0.5 * dp_tlCouplingEmptyDimX,0.5 * dp_tlCouplingEmptyDimY,0.5 * dp_tlCouplingEmptyDimZ);
   G4LogicalVolume * log_tlCouplingEmpty = new G4LogicalVolume(solid_tlCouplingEmpty,air_mat,tlCouplingEmptyNameLog);
   G4ThreeVector tlCouplingWrtBRCorner(-0.5*dp_tlCouplingEmptyDimX,0.5*dp_tlCouplingEmptyDimY + dp_resonatorAssemblyBaseNbEdgeBottomDimY,0.0); //Good for empty or conductor
-  G4VPhysicalVolume * tlCouplingEmpty = new G4PVPlacement(0,tlCouplingWrtBRCorner+brCornerOfBaseNbLayer,log_tlCouplingEmpty,tlCouplingEmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * tlCouplingEmpty = new G4PVPlacement(0,tlCouplingWrtBRCorner+brCornerOfBaseNbLayer,log_tlCouplingEmpty,tlCouplingEmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_tlCouplingEmpty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",tlCouplingEmptyName,tlCouplingEmpty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,tlCouplingEmptyName,tlCouplingEmpty));
 
 
   
@@ -404,9 +425,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String tlCouplingConductorNameLog = tlCouplingConductorName + "_log";
   G4Box * solid_tlCouplingConductor = new G4Box(tlCouplingConductorNameSolid,0.5 * dp_tlCouplingConductorDimX,0.5 * dp_tlCouplingConductorDimY,0.5 * dp_tlCouplingConductorDimZ);
   G4LogicalVolume * log_tlCouplingConductor = new G4LogicalVolume(solid_tlCouplingConductor,niobium_mat,tlCouplingConductorNameLog);
-  G4VPhysicalVolume * tlCouplingConductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_tlCouplingConductor,tlCouplingConductorName,log_tlCouplingEmpty,false,0,true);
+  G4VPhysicalVolume * tlCouplingConductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_tlCouplingConductor,tlCouplingConductorName,log_tlCouplingEmpty,false,0,checkOverlaps);
   log_tlCouplingConductor->SetVisAttributes(attention_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",tlCouplingConductorName,tlCouplingConductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,tlCouplingConductorName,tlCouplingConductor));
 
 
   //------------------------------------------------------
@@ -417,9 +438,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Tubs * solid_curve1Empty = new G4Tubs(curve1EmptyNameSolid,dp_resonatorAssemblyCurveSmallestRadius,dp_resonatorAssemblyCurveSmallestRadius + dp_tlCouplingEmptyDimY,dp_curveEmptyDimZ/2.0,180.*deg,90.*deg);
   G4LogicalVolume * log_curve1Empty = new G4LogicalVolume(solid_curve1Empty,air_mat,curve1EmptyNameLog);  
   G4ThreeVector curve1WrtBRCorner(-1*dp_tlCouplingEmptyDimX,0.5*dp_tlCouplingEmptyDimY + dp_resonatorAssemblyBaseNbEdgeBottomDimY + dp_resonatorAssemblyCurveCentralRadius,0.0); //Good for empty or conductor
-  G4VPhysicalVolume * curve1Empty = new G4PVPlacement(0,curve1WrtBRCorner+brCornerOfBaseNbLayer,log_curve1Empty,curve1EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * curve1Empty = new G4PVPlacement(0,curve1WrtBRCorner+brCornerOfBaseNbLayer,log_curve1Empty,curve1EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_curve1Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",curve1EmptyName,curve1Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,curve1EmptyName,curve1Empty));
 
   //------------------------------------------------------
   //Curve 1 (conductor)
@@ -428,9 +449,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String curve1ConductorNameLog = curve1ConductorName + "_log";
   G4Tubs * solid_curve1Conductor = new G4Tubs(curve1ConductorNameSolid,dp_resonatorAssemblyCurveCentralRadius - dp_tlCouplingConductorDimY/2.0,dp_resonatorAssemblyCurveCentralRadius + dp_tlCouplingConductorDimY/2.0,dp_curveEmptyDimZ/2.0,180.*deg,90.*deg);
   G4LogicalVolume * log_curve1Conductor = new G4LogicalVolume(solid_curve1Conductor,niobium_mat,curve1ConductorNameLog);  
-  G4VPhysicalVolume * curve1Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_curve1Conductor,curve1ConductorName,log_curve1Empty,false,0,true);
+  G4VPhysicalVolume * curve1Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_curve1Conductor,curve1ConductorName,log_curve1Empty,false,0,checkOverlaps);
   log_curve1Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",curve1ConductorName,curve1Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,curve1ConductorName,curve1Conductor));
 
 
   //------------------------------------------------------
@@ -441,9 +462,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Tubs * solid_curve2Empty = new G4Tubs(curve2EmptyNameSolid,dp_resonatorAssemblyCurveSmallestRadius,dp_resonatorAssemblyCurveSmallestRadius + dp_tlCouplingEmptyDimY,dp_curveEmptyDimZ/2.0,0.*deg,90.*deg);
   G4LogicalVolume * log_curve2Empty = new G4LogicalVolume(solid_curve2Empty,air_mat,curve2EmptyNameLog);  
   G4ThreeVector curve2WrtBRCorner(-1*dp_tlCouplingEmptyDimX - 2*dp_resonatorAssemblyCurveCentralRadius,0.5*dp_tlCouplingEmptyDimY + dp_resonatorAssemblyBaseNbEdgeBottomDimY + dp_resonatorAssemblyCurveCentralRadius,0.0); //Good for empty or conductor
-  G4VPhysicalVolume * curve2Empty = new G4PVPlacement(0,curve2WrtBRCorner+brCornerOfBaseNbLayer,log_curve2Empty,curve2EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * curve2Empty = new G4PVPlacement(0,curve2WrtBRCorner+brCornerOfBaseNbLayer,log_curve2Empty,curve2EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_curve2Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",curve2EmptyName,curve2Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,curve2EmptyName,curve2Empty));
 
   
 
@@ -454,9 +475,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String curve2ConductorNameLog = curve2ConductorName + "_log";
   G4Tubs * solid_curve2Conductor = new G4Tubs(curve2ConductorNameSolid,dp_resonatorAssemblyCurveCentralRadius - dp_tlCouplingConductorDimY/2.0,dp_resonatorAssemblyCurveCentralRadius + dp_tlCouplingConductorDimY/2.0,dp_curveEmptyDimZ/2.0,0.*deg,90.*deg);
   G4LogicalVolume * log_curve2Conductor = new G4LogicalVolume(solid_curve2Conductor,niobium_mat,curve2ConductorNameLog);  
-  G4VPhysicalVolume * curve2Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_curve2Conductor,curve2ConductorName,log_curve2Empty,false,0,true);
+  G4VPhysicalVolume * curve2Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_curve2Conductor,curve2ConductorName,log_curve2Empty,false,0,checkOverlaps);
   log_curve2Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",curve2ConductorName,curve2Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,curve2ConductorName,curve2Conductor));
 
 
 
@@ -469,9 +490,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Box * solid_shl1Empty = new G4Box(shl1EmptyNameSolid,0.5 * dp_shl1EmptyDimX,0.5 * dp_shl1EmptyDimY,0.5 * dp_shl1EmptyDimZ);
   G4LogicalVolume * log_shl1Empty = new G4LogicalVolume(solid_shl1Empty,air_mat,shl1EmptyNameLog);
   G4ThreeVector shl1WrtBRCorner = curve2WrtBRCorner + G4ThreeVector(-0.5*dp_shl1EmptyDimX,dp_resonatorAssemblyCurveCentralRadius,0);  
-  G4VPhysicalVolume * shl1Empty = new G4PVPlacement(0,shl1WrtBRCorner+brCornerOfBaseNbLayer,log_shl1Empty,shl1EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * shl1Empty = new G4PVPlacement(0,shl1WrtBRCorner+brCornerOfBaseNbLayer,log_shl1Empty,shl1EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_shl1Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",shl1EmptyName,shl1Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,shl1EmptyName,shl1Empty));
 
 
   //------------------------------------------------------
@@ -481,9 +502,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String shl1ConductorNameLog = shl1ConductorName + "_log";
   G4Box * solid_shl1Conductor = new G4Box(shl1ConductorNameSolid,0.5 * dp_shl1ConductorDimX,0.5 * dp_shl1ConductorDimY,0.5 * dp_shl1ConductorDimZ);
   G4LogicalVolume * log_shl1Conductor = new G4LogicalVolume(solid_shl1Conductor,niobium_mat,shl1ConductorNameLog);
-  G4VPhysicalVolume * shl1Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shl1Conductor,shl1ConductorName,log_shl1Empty,false,0,true);
+  G4VPhysicalVolume * shl1Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shl1Conductor,shl1ConductorName,log_shl1Empty,false,0,checkOverlaps);
   log_shl1Conductor->SetVisAttributes(attention_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",shl1ConductorName,shl1Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,shl1ConductorName,shl1Conductor));
 
 
 
@@ -496,9 +517,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Tubs * solid_halfCircle1Empty = new G4Tubs(halfCircle1EmptyNameSolid,dp_resonatorAssemblyCurveSmallestRadius,dp_resonatorAssemblyCurveSmallestRadius + dp_tlCouplingEmptyDimY,dp_curveEmptyDimZ/2.0,90.*deg,180.*deg);
   G4LogicalVolume * log_halfCircle1Empty = new G4LogicalVolume(solid_halfCircle1Empty,air_mat,halfCircle1EmptyNameLog);  
   G4ThreeVector halfCircle1WrtBRCorner = shl1WrtBRCorner + G4ThreeVector(-0.5*dp_shl1EmptyDimX,dp_resonatorAssemblyCurveCentralRadius,0.0);
-  G4VPhysicalVolume * halfCircle1Empty = new G4PVPlacement(0,halfCircle1WrtBRCorner+brCornerOfBaseNbLayer,log_halfCircle1Empty,halfCircle1EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * halfCircle1Empty = new G4PVPlacement(0,halfCircle1WrtBRCorner+brCornerOfBaseNbLayer,log_halfCircle1Empty,halfCircle1EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_halfCircle1Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",halfCircle1EmptyName,halfCircle1Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,halfCircle1EmptyName,halfCircle1Empty));
   
   //------------------------------------------------------
   //HalfCircle 1 (conductor)
@@ -507,9 +528,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String halfCircle1ConductorNameLog = halfCircle1ConductorName + "_log";
   G4Tubs * solid_halfCircle1Conductor = new G4Tubs(halfCircle1ConductorNameSolid,dp_resonatorAssemblyCurveCentralRadius - dp_tlCouplingConductorDimY/2.0,dp_resonatorAssemblyCurveCentralRadius + dp_tlCouplingConductorDimY/2.0,dp_curveEmptyDimZ/2.0,90.*deg,180.*deg);
   G4LogicalVolume * log_halfCircle1Conductor = new G4LogicalVolume(solid_halfCircle1Conductor,niobium_mat,halfCircle1ConductorNameLog);  
-  G4VPhysicalVolume * halfCircle1Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_halfCircle1Conductor,halfCircle1ConductorName,log_halfCircle1Empty,false,0,true);
+  G4VPhysicalVolume * halfCircle1Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_halfCircle1Conductor,halfCircle1ConductorName,log_halfCircle1Empty,false,0,checkOverlaps);
   log_halfCircle1Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",halfCircle1ConductorName,halfCircle1Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,halfCircle1ConductorName,halfCircle1Conductor));
 
 
   
@@ -521,9 +542,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Box * solid_shl2Empty = new G4Box(shl2EmptyNameSolid,0.5 * dp_shl2EmptyDimX,0.5 * dp_shl2EmptyDimY,0.5 * dp_shl2EmptyDimZ);
   G4LogicalVolume * log_shl2Empty = new G4LogicalVolume(solid_shl2Empty,air_mat,shl2EmptyNameLog);
   G4ThreeVector shl2WrtBRCorner = halfCircle1WrtBRCorner + G4ThreeVector(0.5*dp_shl2EmptyDimX,dp_resonatorAssemblyCurveCentralRadius,0);
-  G4VPhysicalVolume * shl2Empty = new G4PVPlacement(0,shl2WrtBRCorner+brCornerOfBaseNbLayer,log_shl2Empty,shl2EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * shl2Empty = new G4PVPlacement(0,shl2WrtBRCorner+brCornerOfBaseNbLayer,log_shl2Empty,shl2EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_shl2Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",shl2EmptyName,shl2Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,shl2EmptyName,shl2Empty));
 
   //------------------------------------------------------
   //Straight horizontal line (SHL) 2 (conductor)
@@ -532,9 +553,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String shl2ConductorNameLog = shl2ConductorName + "_log";
   G4Box * solid_shl2Conductor = new G4Box(shl2ConductorNameSolid,0.5 * dp_shl2ConductorDimX,0.5 * dp_shl2ConductorDimY,0.5 * dp_shl2ConductorDimZ);
   G4LogicalVolume * log_shl2Conductor = new G4LogicalVolume(solid_shl2Conductor,niobium_mat,shl2ConductorNameLog);
-  G4VPhysicalVolume * shl2Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shl2Conductor,shl2ConductorName,log_shl2Empty,false,0,true);
+  G4VPhysicalVolume * shl2Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shl2Conductor,shl2ConductorName,log_shl2Empty,false,0,checkOverlaps);
   log_shl2Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",shl2ConductorName,shl2Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,shl2ConductorName,shl2Conductor));
 
 
   
@@ -546,9 +567,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Tubs * solid_halfCircle2Empty = new G4Tubs(halfCircle2EmptyNameSolid,dp_resonatorAssemblyCurveSmallestRadius,dp_resonatorAssemblyCurveSmallestRadius + dp_tlCouplingEmptyDimY,dp_curveEmptyDimZ/2.0,270.*deg,180.*deg);
   G4LogicalVolume * log_halfCircle2Empty = new G4LogicalVolume(solid_halfCircle2Empty,air_mat,halfCircle2EmptyNameLog);  
   G4ThreeVector halfCircle2WrtBRCorner = shl2WrtBRCorner + G4ThreeVector(0.5*dp_shl2EmptyDimX,dp_resonatorAssemblyCurveCentralRadius,0.0);
-  G4VPhysicalVolume * halfCircle2Empty = new G4PVPlacement(0,halfCircle2WrtBRCorner+brCornerOfBaseNbLayer,log_halfCircle2Empty,halfCircle2EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * halfCircle2Empty = new G4PVPlacement(0,halfCircle2WrtBRCorner+brCornerOfBaseNbLayer,log_halfCircle2Empty,halfCircle2EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_halfCircle2Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",halfCircle2EmptyName,halfCircle2Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,halfCircle2EmptyName,halfCircle2Empty));
 
   //------------------------------------------------------
   //HalfCircle 2 (conductor)
@@ -557,9 +578,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String halfCircle2ConductorNameLog = halfCircle2ConductorName + "_log";
   G4Tubs * solid_halfCircle2Conductor = new G4Tubs(halfCircle2ConductorNameSolid,dp_resonatorAssemblyCurveCentralRadius - dp_tlCouplingConductorDimY/2.0,dp_resonatorAssemblyCurveCentralRadius + dp_tlCouplingConductorDimY/2.0,dp_curveEmptyDimZ/2.0,270.*deg,180.*deg);
   G4LogicalVolume * log_halfCircle2Conductor = new G4LogicalVolume(solid_halfCircle2Conductor,niobium_mat,halfCircle2ConductorNameLog);  
-  G4VPhysicalVolume * halfCircle2Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_halfCircle2Conductor,halfCircle2ConductorName,log_halfCircle2Empty,false,0,true);
+  G4VPhysicalVolume * halfCircle2Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_halfCircle2Conductor,halfCircle2ConductorName,log_halfCircle2Empty,false,0,checkOverlaps);
   log_halfCircle2Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",halfCircle2ConductorName,halfCircle2Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,halfCircle2ConductorName,halfCircle2Conductor));
   
   //------------------------------------------------------
   //Straight horizontal line (SHL) 3, (empty/cavity)
@@ -569,9 +590,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Box * solid_shl3Empty = new G4Box(shl3EmptyNameSolid,0.5 * dp_shl3EmptyDimX,0.5 * dp_shl3EmptyDimY,0.5 * dp_shl3EmptyDimZ);
   G4LogicalVolume * log_shl3Empty = new G4LogicalVolume(solid_shl3Empty,air_mat,shl3EmptyNameLog);
   G4ThreeVector shl3WrtBRCorner = halfCircle2WrtBRCorner + G4ThreeVector(-0.5*dp_shl3EmptyDimX,dp_resonatorAssemblyCurveCentralRadius,0);
-  G4VPhysicalVolume * shl3Empty = new G4PVPlacement(0,shl3WrtBRCorner+brCornerOfBaseNbLayer,log_shl3Empty,shl3EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * shl3Empty = new G4PVPlacement(0,shl3WrtBRCorner+brCornerOfBaseNbLayer,log_shl3Empty,shl3EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_shl3Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",shl3EmptyName,shl3Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,shl3EmptyName,shl3Empty));
 
   //------------------------------------------------------
   //Straight horizontal line (SHL) 3 (conductor)
@@ -580,9 +601,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String shl3ConductorNameLog = shl3ConductorName + "_log";
   G4Box * solid_shl3Conductor = new G4Box(shl3ConductorNameSolid,0.5 * dp_shl3ConductorDimX,0.5 * dp_shl3ConductorDimY,0.5 * dp_shl3ConductorDimZ);
   G4LogicalVolume * log_shl3Conductor = new G4LogicalVolume(solid_shl3Conductor,niobium_mat,shl3ConductorNameLog);
-  G4VPhysicalVolume * shl3Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shl3Conductor,shl3ConductorName,log_shl3Empty,false,0,true);
+  G4VPhysicalVolume * shl3Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shl3Conductor,shl3ConductorName,log_shl3Empty,false,0,checkOverlaps);
   log_shl3Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",shl3ConductorName,shl3Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,shl3ConductorName,shl3Conductor));
 
   //------------------------------------------------------
   //HalfCircle 3 (empty/cavity)
@@ -592,9 +613,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Tubs * solid_halfCircle3Empty = new G4Tubs(halfCircle3EmptyNameSolid,dp_resonatorAssemblyCurveSmallestRadius,dp_resonatorAssemblyCurveSmallestRadius + dp_tlCouplingEmptyDimY,dp_curveEmptyDimZ/2.0,90.*deg,180.*deg);
   G4LogicalVolume * log_halfCircle3Empty = new G4LogicalVolume(solid_halfCircle3Empty,air_mat,halfCircle3EmptyNameLog);  
   G4ThreeVector halfCircle3WrtBRCorner = shl3WrtBRCorner + G4ThreeVector(-0.5*dp_shl3EmptyDimX,dp_resonatorAssemblyCurveCentralRadius,0.0);
-  G4VPhysicalVolume * halfCircle3Empty = new G4PVPlacement(0,halfCircle3WrtBRCorner+brCornerOfBaseNbLayer,log_halfCircle3Empty,halfCircle3EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * halfCircle3Empty = new G4PVPlacement(0,halfCircle3WrtBRCorner+brCornerOfBaseNbLayer,log_halfCircle3Empty,halfCircle3EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_halfCircle3Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",halfCircle3EmptyName,halfCircle3Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,halfCircle3EmptyName,halfCircle3Empty));
 
   
   //------------------------------------------------------
@@ -604,9 +625,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String halfCircle3ConductorNameLog = halfCircle3ConductorName + "_log";
   G4Tubs * solid_halfCircle3Conductor = new G4Tubs(halfCircle3ConductorNameSolid,dp_resonatorAssemblyCurveCentralRadius - dp_tlCouplingConductorDimY/2.0,dp_resonatorAssemblyCurveCentralRadius + dp_tlCouplingConductorDimY/2.0,dp_curveEmptyDimZ/2.0,90.*deg,180.*deg);
   G4LogicalVolume * log_halfCircle3Conductor = new G4LogicalVolume(solid_halfCircle3Conductor,niobium_mat,halfCircle3ConductorNameLog);  
-  G4VPhysicalVolume * halfCircle3Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_halfCircle3Conductor,halfCircle3ConductorName,log_halfCircle3Empty,false,0,true);
+  G4VPhysicalVolume * halfCircle3Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_halfCircle3Conductor,halfCircle3ConductorName,log_halfCircle3Empty,false,0,checkOverlaps);
   log_halfCircle3Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",halfCircle3ConductorName,halfCircle3Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,halfCircle3ConductorName,halfCircle3Conductor));
 
 
   //------------------------------------------------------
@@ -617,9 +638,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Box * solid_shl4Empty = new G4Box(shl4EmptyNameSolid,0.5 * dp_shl4EmptyDimX,0.5 * dp_shl4EmptyDimY,0.5 * dp_shl4EmptyDimZ);
   G4LogicalVolume * log_shl4Empty = new G4LogicalVolume(solid_shl4Empty,air_mat,shl4EmptyNameLog);
   G4ThreeVector shl4WrtBRCorner = halfCircle3WrtBRCorner + G4ThreeVector(0.5*dp_shl4EmptyDimX,dp_resonatorAssemblyCurveCentralRadius,0);
-  G4VPhysicalVolume * shl4Empty = new G4PVPlacement(0,shl4WrtBRCorner+brCornerOfBaseNbLayer,log_shl4Empty,shl4EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * shl4Empty = new G4PVPlacement(0,shl4WrtBRCorner+brCornerOfBaseNbLayer,log_shl4Empty,shl4EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_shl4Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",shl4EmptyName,shl4Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,shl4EmptyName,shl4Empty));
 
   //------------------------------------------------------
   //Straight horizontal line (SHL) 4 (conductor)
@@ -628,9 +649,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String shl4ConductorNameLog = shl4ConductorName + "_log";
   G4Box * solid_shl4Conductor = new G4Box(shl4ConductorNameSolid,0.5 * dp_shl4ConductorDimX,0.5 * dp_shl4ConductorDimY,0.5 * dp_shl4ConductorDimZ);
   G4LogicalVolume * log_shl4Conductor = new G4LogicalVolume(solid_shl4Conductor,niobium_mat,shl4ConductorNameLog);
-  G4VPhysicalVolume * shl4Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shl4Conductor,shl4ConductorName,log_shl4Empty,false,0,true);
+  G4VPhysicalVolume * shl4Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shl4Conductor,shl4ConductorName,log_shl4Empty,false,0,checkOverlaps);
   log_shl4Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",shl4ConductorName,shl4Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,shl4ConductorName,shl4Conductor));
 
     //------------------------------------------------------
   //HalfCircle 4 (empty/cavity)
@@ -640,9 +661,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Tubs * solid_halfCircle4Empty = new G4Tubs(halfCircle4EmptyNameSolid,dp_resonatorAssemblyCurveSmallestRadius,dp_resonatorAssemblyCurveSmallestRadius + dp_tlCouplingEmptyDimY,dp_curveEmptyDimZ/2.0,270.*deg,180.*deg);
   G4LogicalVolume * log_halfCircle4Empty = new G4LogicalVolume(solid_halfCircle4Empty,air_mat,halfCircle4EmptyNameLog);  
   G4ThreeVector halfCircle4WrtBRCorner = shl4WrtBRCorner + G4ThreeVector(+0.5*dp_shl4EmptyDimX,dp_resonatorAssemblyCurveCentralRadius,0.0);
-  G4VPhysicalVolume * halfCircle4Empty = new G4PVPlacement(0,halfCircle4WrtBRCorner+brCornerOfBaseNbLayer,log_halfCircle4Empty,halfCircle4EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * halfCircle4Empty = new G4PVPlacement(0,halfCircle4WrtBRCorner+brCornerOfBaseNbLayer,log_halfCircle4Empty,halfCircle4EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_halfCircle4Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",halfCircle4EmptyName,halfCircle4Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,halfCircle4EmptyName,halfCircle4Empty));
 
   //------------------------------------------------------
   //HalfCircle 4 (conductor)
@@ -651,9 +672,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String halfCircle4ConductorNameLog = halfCircle4ConductorName + "_log";
   G4Tubs * solid_halfCircle4Conductor = new G4Tubs(halfCircle4ConductorNameSolid,dp_resonatorAssemblyCurveCentralRadius - dp_tlCouplingConductorDimY/2.0,dp_resonatorAssemblyCurveCentralRadius + dp_tlCouplingConductorDimY/2.0,dp_curveEmptyDimZ/2.0,270.*deg,180.*deg);
   G4LogicalVolume * log_halfCircle4Conductor = new G4LogicalVolume(solid_halfCircle4Conductor,niobium_mat,halfCircle4ConductorNameLog);  
-  G4VPhysicalVolume * halfCircle4Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_halfCircle4Conductor,halfCircle4ConductorName,log_halfCircle4Empty,false,0,true);
+  G4VPhysicalVolume * halfCircle4Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_halfCircle4Conductor,halfCircle4ConductorName,log_halfCircle4Empty,false,0,checkOverlaps);
   log_halfCircle4Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",halfCircle4ConductorName,halfCircle4Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,halfCircle4ConductorName,halfCircle4Conductor));
 
 
 
@@ -667,9 +688,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Box * solid_shl5Empty = new G4Box(shl5EmptyNameSolid,0.5 * dp_shl5EmptyDimX,0.5 * dp_shl5EmptyDimY,0.5 * dp_shl5EmptyDimZ);
   G4LogicalVolume * log_shl5Empty = new G4LogicalVolume(solid_shl5Empty,air_mat,shl5EmptyNameLog);
   G4ThreeVector shl5WrtBRCorner = halfCircle4WrtBRCorner + G4ThreeVector(-0.5*dp_shl5EmptyDimX,dp_resonatorAssemblyCurveCentralRadius,0);
-  G4VPhysicalVolume * shl5Empty = new G4PVPlacement(0,shl5WrtBRCorner+brCornerOfBaseNbLayer,log_shl5Empty,shl5EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * shl5Empty = new G4PVPlacement(0,shl5WrtBRCorner+brCornerOfBaseNbLayer,log_shl5Empty,shl5EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_shl5Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",shl5EmptyName,shl5Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,shl5EmptyName,shl5Empty));
  
 
   //------------------------------------------------------
@@ -679,9 +700,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String shl5ConductorNameLog = shl5ConductorName + "_log";
   G4Box * solid_shl5Conductor = new G4Box(shl5ConductorNameSolid,0.5 * dp_shl5ConductorDimX,0.5 * dp_shl5ConductorDimY,0.5 * dp_shl5ConductorDimZ);
   G4LogicalVolume * log_shl5Conductor = new G4LogicalVolume(solid_shl5Conductor,niobium_mat,shl5ConductorNameLog);
-  G4VPhysicalVolume * shl5Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shl5Conductor,shl5ConductorName,log_shl5Empty,false,0,true);
+  G4VPhysicalVolume * shl5Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shl5Conductor,shl5ConductorName,log_shl5Empty,false,0,checkOverlaps);
   log_shl5Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",shl5ConductorName,shl5Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,shl5ConductorName,shl5Conductor));
 
   //------------------------------------------------------
   //HalfCircle 5 (empty/cavity)
@@ -691,9 +712,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Tubs * solid_halfCircle5Empty = new G4Tubs(halfCircle5EmptyNameSolid,dp_resonatorAssemblyCurveSmallestRadius,dp_resonatorAssemblyCurveSmallestRadius + dp_tlCouplingEmptyDimY,dp_curveEmptyDimZ/2.0,90.*deg,180.*deg);
   G4LogicalVolume * log_halfCircle5Empty = new G4LogicalVolume(solid_halfCircle5Empty,air_mat,halfCircle5EmptyNameLog);  
   G4ThreeVector halfCircle5WrtBRCorner = shl5WrtBRCorner + G4ThreeVector(-0.5*dp_shl5EmptyDimX,dp_resonatorAssemblyCurveCentralRadius,0.0);
-  G4VPhysicalVolume * halfCircle5Empty = new G4PVPlacement(0,halfCircle5WrtBRCorner+brCornerOfBaseNbLayer,log_halfCircle5Empty,halfCircle5EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * halfCircle5Empty = new G4PVPlacement(0,halfCircle5WrtBRCorner+brCornerOfBaseNbLayer,log_halfCircle5Empty,halfCircle5EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_halfCircle5Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",halfCircle5EmptyName,halfCircle5Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,halfCircle5EmptyName,halfCircle5Empty));
 
   //------------------------------------------------------
   //HalfCircle 5 (conductor)
@@ -702,9 +723,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String halfCircle5ConductorNameLog = halfCircle5ConductorName + "_log";
   G4Tubs * solid_halfCircle5Conductor = new G4Tubs(halfCircle5ConductorNameSolid,dp_resonatorAssemblyCurveCentralRadius - dp_tlCouplingConductorDimY/2.0,dp_resonatorAssemblyCurveCentralRadius + dp_tlCouplingConductorDimY/2.0,dp_curveEmptyDimZ/2.0,90.*deg,180.*deg);
   G4LogicalVolume * log_halfCircle5Conductor = new G4LogicalVolume(solid_halfCircle5Conductor,niobium_mat,halfCircle5ConductorNameLog);  
-  G4VPhysicalVolume * halfCircle5Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_halfCircle5Conductor,halfCircle5ConductorName,log_halfCircle5Empty,false,0,true);
+  G4VPhysicalVolume * halfCircle5Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_halfCircle5Conductor,halfCircle5ConductorName,log_halfCircle5Empty,false,0,checkOverlaps);
   log_halfCircle5Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",halfCircle5ConductorName,halfCircle5Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,halfCircle5ConductorName,halfCircle5Conductor));
 
 
 
@@ -722,9 +743,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Box * solid_shl6Empty = new G4Box(shl6EmptyNameSolid,0.5 * dp_shl6EmptyDimX,0.5 * dp_shl6EmptyDimY,0.5 * dp_shl6EmptyDimZ);
   G4LogicalVolume * log_shl6Empty = new G4LogicalVolume(solid_shl6Empty,air_mat,shl6EmptyNameLog);
   G4ThreeVector shl6WrtBRCorner = halfCircle5WrtBRCorner + G4ThreeVector(0.5*dp_shl6EmptyDimX,dp_resonatorAssemblyCurveCentralRadius,0);
-  G4VPhysicalVolume * shl6Empty = new G4PVPlacement(0,shl6WrtBRCorner+brCornerOfBaseNbLayer,log_shl6Empty,shl6EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * shl6Empty = new G4PVPlacement(0,shl6WrtBRCorner+brCornerOfBaseNbLayer,log_shl6Empty,shl6EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_shl6Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",shl6EmptyName,shl6Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,shl6EmptyName,shl6Empty));
 
 
   //------------------------------------------------------
@@ -734,9 +755,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String shl6ConductorNameLog = shl6ConductorName + "_log";
   G4Box * solid_shl6Conductor = new G4Box(shl6ConductorNameSolid,0.5 * dp_shl6ConductorDimX,0.5 * dp_shl6ConductorDimY,0.5 * dp_shl6ConductorDimZ);
   G4LogicalVolume * log_shl6Conductor = new G4LogicalVolume(solid_shl6Conductor,niobium_mat,shl6ConductorNameLog);
-  G4VPhysicalVolume * shl6Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shl6Conductor,shl6ConductorName,log_shl6Empty,false,0,true);
+  G4VPhysicalVolume * shl6Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shl6Conductor,shl6ConductorName,log_shl6Empty,false,0,checkOverlaps);
   log_shl6Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",shl6ConductorName,shl6Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,shl6ConductorName,shl6Conductor));
 
 
   //------------------------------------------------------
@@ -747,9 +768,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Tubs * solid_halfCircle6Empty = new G4Tubs(halfCircle6EmptyNameSolid,dp_resonatorAssemblyCurveSmallestRadius,dp_resonatorAssemblyCurveSmallestRadius + dp_tlCouplingEmptyDimY,dp_curveEmptyDimZ/2.0,270.*deg,180.*deg);
   G4LogicalVolume * log_halfCircle6Empty = new G4LogicalVolume(solid_halfCircle6Empty,air_mat,halfCircle6EmptyNameLog);  
   G4ThreeVector halfCircle6WrtBRCorner = shl6WrtBRCorner + G4ThreeVector(0.5*dp_shl6EmptyDimX,dp_resonatorAssemblyCurveCentralRadius,0.0);
-  G4VPhysicalVolume * halfCircle6Empty = new G4PVPlacement(0,halfCircle6WrtBRCorner+brCornerOfBaseNbLayer,log_halfCircle6Empty,halfCircle6EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * halfCircle6Empty = new G4PVPlacement(0,halfCircle6WrtBRCorner+brCornerOfBaseNbLayer,log_halfCircle6Empty,halfCircle6EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_halfCircle6Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",halfCircle6EmptyName,halfCircle6Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,halfCircle6EmptyName,halfCircle6Empty));
 
   //------------------------------------------------------
   //HalfCircle 5 (conductor)
@@ -758,9 +779,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String halfCircle6ConductorNameLog = halfCircle6ConductorName + "_log";
   G4Tubs * solid_halfCircle6Conductor = new G4Tubs(halfCircle6ConductorNameSolid,dp_resonatorAssemblyCurveCentralRadius - dp_tlCouplingConductorDimY/2.0,dp_resonatorAssemblyCurveCentralRadius + dp_tlCouplingConductorDimY/2.0,dp_curveEmptyDimZ/2.0,270.*deg,180.*deg);
   G4LogicalVolume * log_halfCircle6Conductor = new G4LogicalVolume(solid_halfCircle6Conductor,niobium_mat,halfCircle6ConductorNameLog);  
-  G4VPhysicalVolume * halfCircle6Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_halfCircle6Conductor,halfCircle6ConductorName,log_halfCircle6Empty,false,0,true);
+  G4VPhysicalVolume * halfCircle6Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_halfCircle6Conductor,halfCircle6ConductorName,log_halfCircle6Empty,false,0,checkOverlaps);
   log_halfCircle6Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",halfCircle6ConductorName,halfCircle6Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,halfCircle6ConductorName,halfCircle6Conductor));
 
   //------------------------------------------------------
   //Straight horizontal line (SHL) 7, (empty/cavity)
@@ -770,9 +791,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Box * solid_shl7Empty = new G4Box(shl7EmptyNameSolid,0.5 * dp_shl7EmptyDimX,0.5 * dp_shl7EmptyDimY,0.5 * dp_shl7EmptyDimZ);
   G4LogicalVolume * log_shl7Empty = new G4LogicalVolume(solid_shl7Empty,air_mat,shl7EmptyNameLog);
   G4ThreeVector shl7WrtBRCorner = halfCircle6WrtBRCorner + G4ThreeVector(-0.5*dp_shl7EmptyDimX,dp_resonatorAssemblyCurveCentralRadius,0);
-  G4VPhysicalVolume * shl7Empty = new G4PVPlacement(0,shl7WrtBRCorner+brCornerOfBaseNbLayer,log_shl7Empty,shl7EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * shl7Empty = new G4PVPlacement(0,shl7WrtBRCorner+brCornerOfBaseNbLayer,log_shl7Empty,shl7EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_shl7Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",shl7EmptyName,shl7Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,shl7EmptyName,shl7Empty));
 
   //------------------------------------------------------
   //Straight horizontal line (SHL) 7 (conductor)
@@ -781,9 +802,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String shl7ConductorNameLog = shl7ConductorName + "_log";
   G4Box * solid_shl7Conductor = new G4Box(shl7ConductorNameSolid,0.5 * dp_shl7ConductorDimX,0.5 * dp_shl7ConductorDimY,0.5 * dp_shl7ConductorDimZ);
   G4LogicalVolume * log_shl7Conductor = new G4LogicalVolume(solid_shl7Conductor,niobium_mat,shl7ConductorNameLog);
-  G4VPhysicalVolume * shl7Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shl7Conductor,shl7ConductorName,log_shl7Empty,false,0,true);
+  G4VPhysicalVolume * shl7Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shl7Conductor,shl7ConductorName,log_shl7Empty,false,0,checkOverlaps);
   log_shl7Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",shl7ConductorName,shl7Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,shl7ConductorName,shl7Conductor));
 
 
 
@@ -795,9 +816,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Tubs * solid_curve3Empty = new G4Tubs(curve3EmptyNameSolid,dp_resonatorAssemblyCurveSmallestRadius,dp_resonatorAssemblyCurveSmallestRadius + dp_tlCouplingEmptyDimY,dp_curveEmptyDimZ/2.0,180.*deg,90.*deg);
   G4LogicalVolume * log_curve3Empty = new G4LogicalVolume(solid_curve3Empty,air_mat,curve3EmptyNameLog);  
   G4ThreeVector curve3WrtBRCorner = shl7WrtBRCorner + G4ThreeVector(-0.5*dp_shl7EmptyDimX,dp_resonatorAssemblyCurveCentralRadius,0.0); //Good for empty or conductor
-  G4VPhysicalVolume * curve3Empty = new G4PVPlacement(0,curve3WrtBRCorner+brCornerOfBaseNbLayer,log_curve3Empty,curve3EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * curve3Empty = new G4PVPlacement(0,curve3WrtBRCorner+brCornerOfBaseNbLayer,log_curve3Empty,curve3EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_curve3Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",curve3EmptyName,curve3Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,curve3EmptyName,curve3Empty));
 
 
   //------------------------------------------------------
@@ -807,9 +828,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String curve3ConductorNameLog = curve3ConductorName + "_log";
   G4Tubs * solid_curve3Conductor = new G4Tubs(curve3ConductorNameSolid,dp_resonatorAssemblyCurveCentralRadius - dp_tlCouplingConductorDimY/2.0,dp_resonatorAssemblyCurveCentralRadius + dp_tlCouplingConductorDimY/2.0,dp_curveEmptyDimZ/2.0,180.*deg,90.*deg);
   G4LogicalVolume * log_curve3Conductor = new G4LogicalVolume(solid_curve3Conductor,niobium_mat,curve3ConductorNameLog);  
-  G4VPhysicalVolume * curve3Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_curve3Conductor,curve3ConductorName,log_curve3Empty,false,0,true);
+  G4VPhysicalVolume * curve3Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_curve3Conductor,curve3ConductorName,log_curve3Empty,false,0,checkOverlaps);
   log_curve3Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",curve3ConductorName,curve3Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,curve3ConductorName,curve3Conductor));
 
 
 
@@ -823,9 +844,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4Box * solid_svl1Empty = new G4Box(svl1EmptyNameSolid,0.5 * dp_svl1EmptyDimX,0.5 * dp_svl1EmptyDimY,0.5 * dp_svl1EmptyDimZ);
   G4LogicalVolume * log_svl1Empty = new G4LogicalVolume(solid_svl1Empty,air_mat,svl1EmptyNameLog);
   G4ThreeVector svl1WrtBRCorner = curve3WrtBRCorner + G4ThreeVector(-1*dp_resonatorAssemblyCurveCentralRadius,0.5*dp_svl1EmptyDimY,0);
-  G4VPhysicalVolume * svl1Empty = new G4PVPlacement(0,svl1WrtBRCorner+brCornerOfBaseNbLayer,log_svl1Empty,svl1EmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * svl1Empty = new G4PVPlacement(0,svl1WrtBRCorner+brCornerOfBaseNbLayer,log_svl1Empty,svl1EmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_svl1Empty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",svl1EmptyName,svl1Empty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,svl1EmptyName,svl1Empty));
 
 
   //------------------------------------------------------
@@ -835,9 +856,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4String svl1ConductorNameLog = svl1ConductorName + "_log";
   G4Box * solid_svl1Conductor = new G4Box(svl1ConductorNameSolid,0.5 * dp_svl1ConductorDimX,0.5 * dp_svl1ConductorDimY,0.5 * dp_svl1ConductorDimZ);
   G4LogicalVolume * log_svl1Conductor = new G4LogicalVolume(solid_svl1Conductor,niobium_mat,svl1ConductorNameLog);
-  G4VPhysicalVolume * svl1Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_svl1Conductor,svl1ConductorName,log_svl1Empty,false,0,true);
+  G4VPhysicalVolume * svl1Conductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_svl1Conductor,svl1ConductorName,log_svl1Empty,false,0,checkOverlaps);
   log_svl1Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",svl1ConductorName,svl1Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,svl1ConductorName,svl1Conductor));
 
 
 
@@ -855,9 +876,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4UnionSolid * solid_shuntCouplerEmpty = new G4UnionSolid(shuntCouplerEmptyNameSolid,solid_shuntCouplerMerge1Empty,solid_shuntCouplerRightLobeEmpty,0,G4ThreeVector(0.5*dp_shuntCouplerHorizontalEmptyDimX - 0.5*dp_shuntCouplerLobeEmptyDimX,0.5*(dp_shuntCouplerHorizontalEmptyDimY+dp_shuntCouplerLobeEmptyDimY),0));    
   G4LogicalVolume * log_shuntCouplerEmpty = new G4LogicalVolume(solid_shuntCouplerEmpty,air_mat,shuntCouplerEmptyNameLog);  
   G4ThreeVector shuntCouplerEmptyWrtBRCorner = svl1WrtBRCorner + G4ThreeVector(0,0.5*(dp_shuntCouplerHorizontalEmptyDimY+dp_svl1EmptyDimY),0);
-  G4VPhysicalVolume * shuntCouplerEmpty = new G4PVPlacement(0,shuntCouplerEmptyWrtBRCorner+brCornerOfBaseNbLayer,log_shuntCouplerEmpty,shuntCouplerEmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * shuntCouplerEmpty = new G4PVPlacement(0,shuntCouplerEmptyWrtBRCorner+brCornerOfBaseNbLayer,log_shuntCouplerEmpty,shuntCouplerEmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_shuntCouplerEmpty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",shuntCouplerEmptyName,shuntCouplerEmpty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,shuntCouplerEmptyName,shuntCouplerEmpty));
   
   
   //------------------------------------------------------
@@ -873,9 +894,9 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
   G4UnionSolid * solid_shuntCouplerMerge2Conductor = new G4UnionSolid("shuntCouplerHorizontalPlusNubPlusLeft",solid_shuntCouplerHorizontalConductor,solid_shuntCouplerLeftLobeConductor,0,G4ThreeVector(-0.5*dp_shuntCouplerHorizontalConductorDimX + 0.5*dp_shuntCouplerLobeConductorDimX,0.5*(dp_shuntCouplerHorizontalConductorDimY+dp_shuntCouplerLobeConductorDimY),0));
   G4UnionSolid * solid_shuntCouplerConductor = new G4UnionSolid(shuntCouplerConductorNameSolid,solid_shuntCouplerMerge2Conductor,solid_shuntCouplerRightLobeConductor,0,G4ThreeVector(0.5*dp_shuntCouplerHorizontalConductorDimX - 0.5*dp_shuntCouplerLobeConductorDimX,0.5*(dp_shuntCouplerHorizontalConductorDimY+dp_shuntCouplerLobeConductorDimY),0));      
   G4LogicalVolume * log_shuntCouplerConductor = new G4LogicalVolume(solid_shuntCouplerConductor,niobium_mat,shuntCouplerConductorNameLog);
-  G4VPhysicalVolume * shuntCouplerConductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shuntCouplerConductor,shuntCouplerConductorName,log_shuntCouplerEmpty,false,0,true);
+  G4VPhysicalVolume * shuntCouplerConductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_shuntCouplerConductor,shuntCouplerConductorName,log_shuntCouplerEmpty,false,0,checkOverlaps);
   log_shuntCouplerConductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",shuntCouplerConductorName,shuntCouplerConductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,shuntCouplerConductorName,shuntCouplerConductor));
  
   
 									  
@@ -887,7 +908,7 @@ void FourQubitResonatorAssembly::MakeResonatorLine(G4String pName, G4LogicalVolu
 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > FourQubitResonatorAssembly::GetListOfAllFundamentalSubVolumes()
+const FourQubitSubVolumeList& FourQubitResonatorAssembly::GetListOfAllFundamentalSubVolumes() const
 {
   return fFundamentalVolumeList;
 }
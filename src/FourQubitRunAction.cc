@@ -0,0 +1,151 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitRunAction.cc
+//
+// Description:	Run boundaries for the hit and primary output.
+
+#include "FourQubitRunAction.hh"
+#include "FourQubitCheckpoint.hh"
+#include "FourQubitConfigManager.hh"
+#include "FourQubitEventAction.hh"
+#include "FourQubitEventTimer.hh"
+#include "FourQubitMPI.hh"
+#include "FourQubitPCEMap.hh"
+#include "FourQubitSensitivity.hh"
+#include "FourQubitSteppingAction.hh"
+#include "FourQubitVertexBank.hh"
+#include "G4AnalysisManager.hh"
+#include "G4EventManager.hh"
+#include "G4MTRunManager.hh"
+#include "G4Run.hh"
+#include "G4SDManager.hh"
+#include "G4Threading.hh"
+#include <vector>
+
+
+FourQubitRunAction::FourQubitRunAction()
+  : rootOutput(FourQubitConfigManager::GetHitsFormat() == "root" &&
+	       FourQubitConfigManager::GetHitsMode() != "none"),
+    hitFiles(FourQubitConfigManager::GetHitsMode() != "none"),
+    profiling(false) {
+  if (rootOutput) FourQubitSensitivity::BookNtuples();
+}
+
+
+// Only the master of an MT job merges; everyone else owns a sensitivity
+
+G4bool FourQubitRunAction::IsMTMaster() const {
+  return (G4Threading::IsMultithreadedApplication() &&
+	  G4Threading::IsMasterThread());
+}
+
+FourQubitSensitivity* FourQubitRunAction::GetSensitivity() const {
+  G4VSensitiveDetector* sd =
+    G4SDManager::GetSDMpointer()->FindSensitiveDetector("PhononElectrode", false);
+  return dynamic_cast<FourQubitSensitivity*>(sd);
+}
+
+FourQubitSteppingAction* FourQubitRunAction::GetSteppingAction() const {
+  G4UserSteppingAction* step =
+    G4EventManager::GetEventManager()->GetUserSteppingAction();
+  return dynamic_cast<FourQubitSteppingAction*>(step);
+}
+
+FourQubitEventAction* FourQubitRunAction::GetEventAction() const {
+  G4UserEventAction* event =
+    G4EventManager::GetEventManager()->GetUserEventAction();
+  return dynamic_cast<FourQubitEventAction*>(event);
+}
+
+
+void FourQubitRunAction::BeginOfRunAction(const G4Run* run) {
+  profiling = FourQubitConfigManager::GetStepProfile();
+
+  // Every rank would repeat the same events under the same seeds
+  if (FourQubitMPI::GetSize() > 1 && !FourQubitMPI::InSplitRun() &&
+      !G4Threading::IsWorkerThread() && run->GetNumberOfEventToBeProcessed() > 0) {
+    G4Exception("FourQubitRunAction::BeginOfRunAction", "MPI001", JustWarning,
+		"/run/beamOn in an MPI job runs the same events on every rank;"
+		" use /g4cmp/BeamOnRanks to split them.");
+  }
+  if (!G4Threading::IsWorkerThread()) FourQubitEventTimer::PrintStartup();
+
+  if (!IsMTMaster()) {
+    FourQubitSteppingAction* stepping = GetSteppingAction();
+    if (stepping) stepping->BeginOfRun(run->GetRunID());
+
+    FourQubitEventAction* event = GetEventAction();
+    if (event) event->BeginOfRun(run->GetRunID());
+  }
+
+  if (rootOutput)
+    G4AnalysisManager::Instance()->OpenFile(FourQubitSensitivity::RootFileName(run->GetRunID()));
+
+  if (IsMTMaster()) return;
+
+  FourQubitSensitivity* sd = GetSensitivity();
+  if (sd) sd->BeginOfRun();
+}
+
+// Workers reach their EndOfRunAction before the master does, so by the
+// time the master runs here every shard has been flushed and closed, and
+// every thread's step counters are in the profile summary, every thread's
+// event statistics in the timing summary and every thread's maps in the
+// /g4cmp/PCEMapFile totals
+
+void FourQubitRunAction::EndOfRunAction(const G4Run* run) {
+  if (!IsMTMaster()) {
+    FourQubitSteppingAction* stepping = GetSteppingAction();
+    if (stepping) stepping->EndOfRun();
+
+    FourQubitEventAction* event = GetEventAction();
+    if (event) event->EndOfRun();
+
+    FourQubitSensitivity* sd = GetSensitivity();
+    if (sd) sd->EndOfRun();
+  }
+
+  if (!G4Threading::IsWorkerThread()) {
+    if (profiling) FourQubitStepProfiler::PrintSummary();
+    FourQubitEventTimer::PrintSummary(run->GetRunID());
+    FourQubitPCEMap::WriteTotals(run->GetRunID());
+
+    // The next run reads the vertices after this one's; a split run is
+    // accounted for by FourQubitMPI::BeamOn, for all ranks at once
+    if (!FourQubitMPI::InSplitRun())
+      FourQubitVertexBank::EndOfRun(FourQubitConfigManager::GetVertexBank(),
+				    FourQubitCheckpoint::GetEventOffset()
+				    + run->GetNumberOfEventToBeProcessed());
+  }
+
+  if (rootOutput) {
+    G4AnalysisManager* analysis = G4AnalysisManager::Instance();
+    analysis->Write();
+    analysis->CloseFile();
+    return;
+  }
+
+  if (IsMTMaster() && hitFiles) MergeShards();
+}
+
+
+void FourQubitRunAction::MergeShards() {
+  G4int nThreads = G4MTRunManager::GetMasterRunManager()->GetNumberOfThreads();
+
+  G4String hitName = FourQubitConfigManager::GetHitOutput();
+  G4String primName = FourQubitConfigManager::GetPrimaryOutput();
+
+  std::vector<G4String> hitShards, primShards;
+  for (G4int i=0; i<nThreads; i++) {
+    hitShards.push_back(FourQubitSensitivity::ShardFileName(hitName, i));
+    primShards.push_back(FourQubitSensitivity::ShardFileName(primName, i));
+  }
+
+  merger.Merge(hitName, hitShards);
+  merger.Merge(primName, primShards);
+}
+
@@ -0,0 +1,45 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitRunCounters.cc
+//
+// Description:	Job-wide step and hit totals.
+
+#include "FourQubitRunCounters.hh"
+#include "G4AutoLock.hh"
+
+
+namespace {
+  G4Mutex countersMutex = G4MUTEX_INITIALIZER;
+  G4long totalSteps = 0;
+  G4long totalHits = 0;
+}
+
+
+void FourQubitRunCounters::AddSteps(G4long n) {
+  G4AutoLock lock(&countersMutex);
+  totalSteps += n;
+}
+
+void FourQubitRunCounters::AddHits(G4long n) {
+  G4AutoLock lock(&countersMutex);
+  totalHits += n;
+}
+
+G4long FourQubitRunCounters::GetSteps() {
+  G4AutoLock lock(&countersMutex);
+  return totalSteps;
+}
+
+G4long FourQubitRunCounters::GetHits() {
+  G4AutoLock lock(&countersMutex);
+  return totalHits;
+}
+
+void FourQubitRunCounters::Reset() {
+  G4AutoLock lock(&countersMutex);
+  totalSteps = totalHits = 0;
+}
@@ -4,43 +4,102 @@
 \***********************************************************************/
 
 #include "FourQubitSensitivity.hh"
+#include "G4AnalysisManager.hh"
 #include "G4CMPElectrodeHit.hh"
 #include "G4Event.hh"
 #include "G4HCofThisEvent.hh"
+#include "G4ParticleTable.hh"
 #include "G4PhononLong.hh"
 #include "G4PhononTransFast.hh"
 #include "G4PhononTransSlow.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
 #include "G4Run.hh"
 #include "G4RunManager.hh"
 #include "G4SDManager.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
 #include "FourQubitConfigManager.hh"
+#include "FourQubitEventInfo.hh"
+#include "FourQubitHitFormat.hh"
+#include "FourQubitRunCounters.hh"
+#include "FourQubitVertexInfo.hh"
+#include <algorithm>
+#include <cstdio>
 #include <fstream>
 #include <iostream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Constructor and destructor
 
 FourQubitSensitivity::FourQubitSensitivity(G4String name) :
-  G4CMPElectrodeSensitivity(name), primaryFileName(""), hitFileName("") {
-  SetHitOutputFile(FourQubitConfigManager::GetHitOutput());
-  SetPrimaryOutputFile(FourQubitConfigManager::GetPrimaryOutput());
+  G4CMPElectrodeSensitivity(name), primaryFileName(""), hitFileName(""),
+  bufferSize(FourQubitConfigManager::GetOutputBufferSize()),
+  binaryOutput(FourQubitConfigManager::GetHitsFormat() == "binary"),
+  rootOutput(FourQubitConfigManager::GetHitsFormat() == "root" &&
+	     FourQubitConfigManager::GetHitsMode() != "none"),
+  eventSums(FourQubitConfigManager::GetHitsMode() == "event"),
+  hitFiles(FourQubitConfigManager::GetHitsMode() != "none"), nHitsThisRun(0) {
+  primaryBuffer.reserve(bufferSize/8);
+  hitBuffer.reserve(bufferSize + 1024);
+
+  // Sequential jobs write straight into the final files.  MT workers open
+  // per-run shards in BeginOfRun(); the master thread only merges them.
+  // ROOT output is opened and merged by G4AnalysisManager instead.
+  if (!G4Threading::IsMultithreadedApplication() && !rootOutput && hitFiles) {
+    SetHitOutputFile(FourQubitConfigManager::GetHitOutput());
+    SetPrimaryOutputFile(FourQubitConfigManager::GetPrimaryOutput());
+  }
 }
 
 
 FourQubitSensitivity::~FourQubitSensitivity() {
+  FlushOutput();
+
   //Close file and check: primaries
-  if (primaryOutput.is_open()) primaryOutput.close();
-  if (!primaryOutput.good()) {
+  primaryOutput.Close();
+  if (!primaryOutput.Good()) {
     G4cerr << "Error closing primary output file, " << primaryFileName << ".\n"
            << "Expect bad things like loss of data.";
   }
 
   //Close file and check: hits
-  if (hitOutput.is_open()) hitOutput.close();
-  if (!hitOutput.good()) {
+  hitOutput.Close();
+  if (!hitOutput.Good()) {
     G4cerr << "Error closing hit output file, " << hitFileName << ".\n"
            << "Expect bad things like loss of data.";
   }
 }
 
+void FourQubitSensitivity::Initialize(G4HCofThisEvent* HCE) {
+  G4CMPElectrodeSensitivity::Initialize(HCE);
+  hitVolumeIDs.clear();
+}
+
+
+// G4CMPElectrodeHit has no volume field, so the sensor and qubit of each new
+// hit are looked up here (one hash probe, plus a node search in flattened
+// geometry) and kept in a parallel vector
+
+G4bool FourQubitSensitivity::ProcessHits(G4Step* step, G4TouchableHistory* ROhist) {
+  size_t nHits = hitsCollection->entries();
+  G4bool result = G4CMPElectrodeSensitivity::ProcessHits(step, ROhist);
+
+  if (hitsCollection->entries() > nHits) {
+    const G4StepPoint* postSP = step->GetPostStepPoint();
+    hitVolumeIDs.push_back(FourQubitSensorTable::Instance()->Find(postSP));
+  }
+  return result;
+}
+
+const FourQubitSensorTable::VolumeID&
+FourQubitSensitivity::HitVolumeID(size_t iHit) const {
+  static const FourQubitSensorTable::VolumeID none = { -1, -1 };
+  return (iHit < hitVolumeIDs.size()) ? hitVolumeIDs[iHit] : none;
+}
+
+
 void FourQubitSensitivity::EndOfEvent(G4HCofThisEvent* HCE) {
   G4int HCID = G4SDManager::GetSDMpointer()->GetCollectionID(hitsCollection);
   auto* hitCol = static_cast<G4CMPElectrodeHitsCollection*>(HCE->GetHC(HCID));
@@ -48,81 +107,596 @@ void FourQubitSensitivity::EndOfEvent(G4HCofThisEvent* HCE) {
 
   G4RunManager* runMan = G4RunManager::GetRunManager();
 
-  //Do primary output writing to file
-  if( primaryOutput.good() ){
-    primaryOutput << runMan->GetCurrentRun()->GetRunID() << " "
-		  << runMan->GetCurrentEvent()->GetEventID() << " "
-		  << runMan->GetCurrentEvent()->GetPrimaryVertex()->GetPrimary()->GetParticleDefinition()->GetParticleName() << " "
-		  << runMan->GetCurrentEvent()->GetPrimaryVertex()->GetPrimary()->GetTotalEnergy()/eV << " "
-		  << runMan->GetCurrentEvent()->GetPrimaryVertex()->GetX0()/mm << " "
-		  << runMan->GetCurrentEvent()->GetPrimaryVertex()->GetY0()/mm << " "
-		  << runMan->GetCurrentEvent()->GetPrimaryVertex()->GetZ0()/mm << " "
-		  << runMan->GetCurrentEvent()->GetPrimaryVertex()->GetT0()/ns << "\n";
-  }
-      
-    
+  // An event the generator could not give a primary (an exhausted
+  // /g4cmp/VertexBank, which aborts the run) has nothing to record
+  const G4PrimaryVertex* vertex = runMan->GetCurrentEvent()->GetPrimaryVertex();
+  if (!vertex) return;
+
+  // Records are formatted into in-memory buffers and handed to the output
+  // stage in large blocks (FourQubitOutputWriter), so event processing
+  // waits on the file system at most once per block, or not at all
+  G4int runID = runMan->GetCurrentRun()->GetRunID();
+  G4int eventID = FourQubitEventInfo::EventNumber(runMan->GetCurrentEvent());
+  G4int eventFlags = FourQubitEventInfo::Flags(runMan->GetCurrentEvent());
+  nHitsThisRun += G4long(hitVec->size());
+  G4bool checkpointDue = checkpoint.EndOfEvent(eventID);
+
+  if (pceMap.IsActive())
+    pceMap.Fill(vertex, *hitVec);
+  if (!hitFiles) {
+    if (checkpointDue) WriteCheckpoint();
+    return;
+  }
+
+  if (eventSums) {
+    for (size_t i=0; i<hitVec->size(); i++)
+      AddToSensorSums((*hitVec)[i], HitVolumeID(i));
+  }
+
+  if (rootOutput) {
+    FillPrimaryNtuple(runID, eventID, vertex, eventFlags);
+    if (eventSums) WriteSensorSums(runID, eventID);
+    else {
+      for (size_t i=0; i<hitVec->size(); i++)
+	FillHitNtuple(runID, eventID, (*hitVec)[i], HitVolumeID(i));
+    }
+    return;
+  }
+
+  //Do primary output writing to file.  The /g4cmp/EventIndex entry of
+  //each file is where the buffer ends now, before this event's records
+  if (primaryOutput.IsOpen()) {
+    primaryOutput.IndexEvent(runID, eventID,
+			     primaryOutput.Position() + G4long(primaryBuffer.size()), 1);
+    if (binaryOutput) WritePrimaryBinary(runID, eventID, vertex, eventFlags);
+    else WritePrimaryText(runID, eventID, vertex, eventFlags);
+  }
+
   // Do hit output writing to file
-  if (hitOutput.good()) {    
-    for (G4CMPElectrodeHit* hit : *hitVec) {
-      hitOutput << runMan->GetCurrentRun()->GetRunID() << ' '
-                << runMan->GetCurrentEvent()->GetEventID() << ' '
-                << hit->GetTrackID() << ' '
-                << hit->GetParticleName() << ' '
-                << hit->GetStartEnergy()/eV << ' '
-                << hit->GetStartPosition().getX()/mm << ' '
-                << hit->GetStartPosition().getY()/mm << ' '
-                << hit->GetStartPosition().getZ()/mm << ' '
-                << hit->GetStartTime()/ns << ' '
-                << hit->GetEnergyDeposit()/eV << ' '
-                << hit->GetWeight() << ' '
-                << hit->GetFinalPosition().getX()/mm << ' '
-                << hit->GetFinalPosition().getY()/mm << ' '
-                << hit->GetFinalPosition().getZ()/mm << ' '
-                << hit->GetFinalTime()/ns << '\n';
+  const G4long hitStart = hitOutput.Position() + G4long(hitBuffer.size());
+  const size_t nHitRecords = eventSums ? touchedSums.size() : hitVec->size();
+  if (hitOutput.IsOpen() && nHitRecords > 0)
+    hitOutput.IndexEvent(runID, eventID, hitStart, G4int(nHitRecords));
+
+  if (eventSums) WriteSensorSums(runID, eventID);
+  else if (hitOutput.IsOpen()) {
+    for (size_t i=0; i<hitVec->size(); i++) {
+      if (binaryOutput) WriteHitBinary(runID, eventID, (*hitVec)[i], HitVolumeID(i));
+      else WriteHitText(runID, eventID, (*hitVec)[i], HitVolumeID(i));
+    }
+  }
+
+  if (hitBuffer.size() >= bufferSize) Flush(hitBuffer, hitOutput);
+  if (primaryBuffer.size() >= bufferSize/8) Flush(primaryBuffer, primaryOutput);
+  if (checkpointDue) WriteCheckpoint();
+}
+
+
+// Everything up to this event goes to disk first, so the recorded lengths
+// end on an event boundary
+
+void FourQubitSensitivity::WriteCheckpoint() {
+  FlushOutput();
+  G4long hitBytes = hitOutput.IsOpen() ? hitOutput.Length() : 0;
+  G4long primaryBytes = primaryOutput.IsOpen() ? primaryOutput.Length() : 0;
+  checkpoint.Write(hitOutput.IsOpen() ? hitFileName : G4String(), hitBytes,
+		   primaryOutput.IsOpen() ? primaryFileName : G4String(), primaryBytes);
+}
+
+
+// Per-event sums: muon events deposit millions of hits, but most studies
+// only want each sensor's total, so in event mode the hits are summed into
+// a fixed table and one short record per sensor hit replaces them
+
+void FourQubitSensitivity::ResetSensorSums() {
+  const FourQubitSensorTable* table = FourQubitSensorTable::Instance();
+  const size_t nSensors = table->GetSensors().size();
+  const size_t nQubits = table->GetQubits().size();
+
+  const SensorSum empty = { -1, -1, 0, 0., 0., 0. };
+  sensorSums.assign(nSensors + nQubits + 1, empty);
+  for (size_t i=0; i<nSensors; i++) {
+    sensorSums[i].sensorID = table->GetSensors()[i].id;
+    sensorSums[i].qubitID = table->GetSensors()[i].qubitID;
+  }
+  for (size_t i=0; i<nQubits; i++)
+    sensorSums[nSensors+i].qubitID = table->GetQubits()[i].id;
+
+  touchedSums.clear();
+  touchedSums.reserve(sensorSums.size());
+}
+
+size_t FourQubitSensitivity::
+SensorSumSlot(const FourQubitSensorTable::VolumeID& volID) const {
+  const size_t nSensors = FourQubitSensorTable::Instance()->GetSensors().size();
+  const size_t outside = sensorSums.size()-1;
+
+  size_t slot = outside;
+  if (volID.sensorID >= 0) slot = size_t(volID.sensorID);
+  else if (volID.qubitID >= 0) slot = nSensors + size_t(volID.qubitID);
+  return std::min(slot, outside);
+}
+
+void FourQubitSensitivity::AddToSensorSums(const G4CMPElectrodeHit* hit,
+					   const FourQubitSensorTable::VolumeID& volID) {
+  if (sensorSums.empty()) ResetSensorSums();
+
+  const size_t slot = SensorSumSlot(volID);
+  SensorSum& sum = sensorSums[slot];
+  const G4double time = hit->GetFinalTime();
+
+  if (sum.nHits == 0) {
+    touchedSums.push_back(slot);
+    sum.firstTime = sum.lastTime = time;
+  } else {
+    sum.firstTime = std::min(sum.firstTime, time);
+    sum.lastTime = std::max(sum.lastTime, time);
+  }
+  sum.nHits++;
+  sum.energy += hit->GetEnergyDeposit();
+}
+
+// Records come out in slot (sensor ID) order; the slots are cleared as
+// they are written, whether or not an output file is open
+
+void FourQubitSensitivity::WriteSensorSums(G4int runID, G4int eventID) {
+  std::sort(touchedSums.begin(), touchedSums.end());
+  G4AnalysisManager* analysis = rootOutput ? G4AnalysisManager::Instance() : 0;
+
+  for (size_t slot : touchedSums) {
+    SensorSum& sum = sensorSums[slot];
+
+    if (rootOutput) {
+      analysis->FillNtupleIColumn(kHitNtuple, 0, runID);
+      analysis->FillNtupleIColumn(kHitNtuple, 1, eventID);
+      analysis->FillNtupleIColumn(kHitNtuple, 2, sum.sensorID);
+      analysis->FillNtupleIColumn(kHitNtuple, 3, sum.qubitID);
+      analysis->FillNtupleIColumn(kHitNtuple, 4, sum.nHits);
+      analysis->FillNtupleDColumn(kHitNtuple, 5, sum.energy/eV);
+      analysis->FillNtupleDColumn(kHitNtuple, 6, sum.firstTime/ns);
+      analysis->FillNtupleDColumn(kHitNtuple, 7, sum.lastTime/ns);
+      analysis->AddNtupleRow(kHitNtuple);
+    } else if (hitOutput.IsOpen() && binaryOutput) {
+      FourQubitHitFormat::EventSumRecord rec;
+      rec.runID = runID;
+      rec.eventID = eventID;
+      rec.sensorID = sum.sensorID;
+      rec.qubitID = sum.qubitID;
+      rec.nHits = sum.nHits;
+      rec.reserved = 0;
+      rec.energyDeposit = sum.energy/eV;
+      rec.firstTime = sum.firstTime/ns;
+      rec.lastTime = sum.lastTime/ns;
+
+      if (!FourQubitHitFormat::HostIsLittleEndian())
+	FourQubitHitFormat::SwapRecord(&rec, FourQubitHitFormat::EventSumFields());
+
+      hitBuffer.append(reinterpret_cast<const char*>(&rec), sizeof(rec));
+    } else if (hitOutput.IsOpen()) {
+      char line[256];
+      G4int n = snprintf(line, sizeof(line), "%d %d %d %d %d %g %g %g\n",
+			 runID, eventID, sum.sensorID, sum.qubitID, sum.nHits,
+			 sum.energy/eV, sum.firstTime/ns, sum.lastTime/ns);
+      hitBuffer.append(line, std::min<size_t>(n, sizeof(line)-1));
+    }
+
+    sum.nHits = 0;
+    sum.energy = 0.;
+  }
+
+  touchedSums.clear();
+}
+
+
+// Text records are space-separated, one per line, matching the header
+
+void FourQubitSensitivity::WritePrimaryText(G4int runID, G4int eventID,
+					    const G4PrimaryVertex* vertex,
+					    G4int flags) {
+  char line[512];
+  G4int n = snprintf(line, sizeof(line), "%d %d %s %g %g %g %g %g %d %g %d\n",
+		     runID,
+		     eventID,
+		     vertex->GetPrimary()->GetParticleDefinition()->GetParticleName().c_str(),
+		     vertex->GetPrimary()->GetTotalEnergy()/eV,
+		     vertex->GetX0()/mm,
+		     vertex->GetY0()/mm,
+		     vertex->GetZ0()/mm,
+		     vertex->GetT0()/ns,
+		     FourQubitVertexInfo::Stratum(vertex),
+		     vertex->GetPrimary()->GetWeight(),
+		     flags);
+  primaryBuffer.append(line, std::min<size_t>(n, sizeof(line)-1));
+}
+
+void FourQubitSensitivity::WriteHitText(G4int runID, G4int eventID,
+					const G4CMPElectrodeHit* hit,
+					const FourQubitSensorTable::VolumeID& volID) {
+  char line[512];
+  G4int n = snprintf(line, sizeof(line),
+		     "%d %d %d %s %g %g %g %g %g %g %g %g %g %g %g %d %d\n",
+		     runID,
+		     eventID,
+		     hit->GetTrackID(),
+		     hit->GetParticleName().c_str(),
+		     hit->GetStartEnergy()/eV,
+		     hit->GetStartPosition().getX()/mm,
+		     hit->GetStartPosition().getY()/mm,
+		     hit->GetStartPosition().getZ()/mm,
+		     hit->GetStartTime()/ns,
+		     hit->GetEnergyDeposit()/eV,
+		     hit->GetWeight(),
+		     hit->GetFinalPosition().getX()/mm,
+		     hit->GetFinalPosition().getY()/mm,
+		     hit->GetFinalPosition().getZ()/mm,
+		     hit->GetFinalTime()/ns,
+		     volID.sensorID,
+		     volID.qubitID);
+  hitBuffer.append(line, std::min<size_t>(n, sizeof(line)-1));
+}
+
+
+// Binary records are copied straight into the buffer (little-endian)
+
+void FourQubitSensitivity::WritePrimaryBinary(G4int runID, G4int eventID,
+					      const G4PrimaryVertex* vertex,
+					      G4int flags) {
+  const G4PrimaryParticle* primary = vertex->GetPrimary();
+
+  FourQubitHitFormat::PrimaryRecord rec;
+  rec.runID = runID;
+  rec.eventID = eventID;
+  rec.particle = ParticleCode(primary->GetParticleDefinition()->GetParticleName());
+  rec.stratum = FourQubitVertexInfo::Stratum(vertex);
+  rec.energy = primary->GetTotalEnergy()/eV;
+  rec.x = vertex->GetX0()/mm;
+  rec.y = vertex->GetY0()/mm;
+  rec.z = vertex->GetZ0()/mm;
+  rec.time = vertex->GetT0()/ns;
+  rec.weight = primary->GetWeight();
+  rec.flags = flags;
+  rec.reserved = 0;
+
+  if (!FourQubitHitFormat::HostIsLittleEndian())
+    FourQubitHitFormat::SwapRecord(&rec, FourQubitHitFormat::PrimaryFields());
+
+  primaryBuffer.append(reinterpret_cast<const char*>(&rec), sizeof(rec));
+}
+
+void FourQubitSensitivity::WriteHitBinary(G4int runID, G4int eventID,
+					  const G4CMPElectrodeHit* hit,
+					  const FourQubitSensorTable::VolumeID& volID) {
+  FourQubitHitFormat::HitRecord rec;
+  rec.runID = runID;
+  rec.eventID = eventID;
+  rec.trackID = hit->GetTrackID();
+  rec.particle = ParticleCode(hit->GetParticleName());
+  rec.startEnergy = hit->GetStartEnergy()/eV;
+  rec.startX = hit->GetStartPosition().getX()/mm;
+  rec.startY = hit->GetStartPosition().getY()/mm;
+  rec.startZ = hit->GetStartPosition().getZ()/mm;
+  rec.startTime = hit->GetStartTime()/ns;
+  rec.energyDeposit = hit->GetEnergyDeposit()/eV;
+  rec.weight = hit->GetWeight();
+  rec.finalX = hit->GetFinalPosition().getX()/mm;
+  rec.finalY = hit->GetFinalPosition().getY()/mm;
+  rec.finalZ = hit->GetFinalPosition().getZ()/mm;
+  rec.finalTime = hit->GetFinalTime()/ns;
+  rec.sensorID = volID.sensorID;
+  rec.qubitID = volID.qubitID;
+
+  if (!FourQubitHitFormat::HostIsLittleEndian())
+    FourQubitHitFormat::SwapRecord(&rec, FourQubitHitFormat::HitFields());
+
+  hitBuffer.append(reinterpret_cast<const char*>(&rec), sizeof(rec));
+}
+
+
+// ROOT ntuples: same columns and units as the text output
+
+void FourQubitSensitivity::BookNtuples() {
+  G4AnalysisManager* analysis = G4AnalysisManager::Instance();
+  analysis->SetDefaultFileType("root");
+  analysis->SetFirstNtupleId(0);
+  if (G4Threading::IsMultithreadedApplication())
+    analysis->SetNtupleMerging(true);		// Workers feed the master's file
+
+  if (FourQubitConfigManager::GetHitsMode() == "event") {
+    analysis->CreateNtuple("sensorSums", "Phonon hits summed per sensor and event");
+    analysis->CreateNtupleIColumn("RunID");
+    analysis->CreateNtupleIColumn("EventID");
+    analysis->CreateNtupleIColumn("SensorID");		// -1: off every sensor
+    analysis->CreateNtupleIColumn("QubitID");		// -1: outside every qubit
+    analysis->CreateNtupleIColumn("NHits");
+    analysis->CreateNtupleDColumn("EnergyDeposited");	// eV
+    analysis->CreateNtupleDColumn("FirstTime");		// ns, of the final times
+    analysis->CreateNtupleDColumn("LastTime");
+    analysis->FinishNtuple();
+  } else {
+    analysis->CreateNtuple("hits", "Phonon hits on the chip surface");
+    analysis->CreateNtupleIColumn("RunID");
+    analysis->CreateNtupleIColumn("EventID");
+    analysis->CreateNtupleIColumn("TrackID");
+    analysis->CreateNtupleSColumn("ParticleName");
+    analysis->CreateNtupleDColumn("StartEnergy");		// eV
+    analysis->CreateNtupleDColumn("StartX");		// mm
+    analysis->CreateNtupleDColumn("StartY");
+    analysis->CreateNtupleDColumn("StartZ");
+    analysis->CreateNtupleDColumn("StartTime");		// ns
+    analysis->CreateNtupleDColumn("EnergyDeposited");	// eV
+    analysis->CreateNtupleDColumn("TrackWeight");
+    analysis->CreateNtupleDColumn("EndX");		// mm
+    analysis->CreateNtupleDColumn("EndY");
+    analysis->CreateNtupleDColumn("EndZ");
+    analysis->CreateNtupleDColumn("FinalTime");		// ns
+    analysis->CreateNtupleIColumn("SensorID");		// FourQubitSensorTable
+    analysis->CreateNtupleIColumn("QubitID");
+    analysis->FinishNtuple();
+  }
+
+  analysis->CreateNtuple("primaries", "Primary vertex of each event");
+  analysis->CreateNtupleIColumn("RunID");
+  analysis->CreateNtupleIColumn("EventID");
+  analysis->CreateNtupleSColumn("ParticleName");
+  analysis->CreateNtupleDColumn("StartEnergy");		// eV
+  analysis->CreateNtupleDColumn("StartX");		// mm
+  analysis->CreateNtupleDColumn("StartY");
+  analysis->CreateNtupleDColumn("StartZ");
+  analysis->CreateNtupleDColumn("StartTime");		// ns
+  analysis->CreateNtupleIColumn("Stratum");		// /g4cmp/PrimaryStrata
+  analysis->CreateNtupleDColumn("Weight");		// /g4cmp/PrimarySampling biased
+  analysis->CreateNtupleIColumn("Flags");		// FourQubitEventInfo
+  analysis->FinishNtuple();
+}
+
+// One file per run, since G4AnalysisManager rewrites the file it opens:
+// "hits.txt" -> "hits.root", "hits_run1.root", ...
+
+G4String FourQubitSensitivity::RootFileName(G4int runID) {
+  G4String fn = FourQubitConfigManager::GetHitOutput();
+  size_t dot = fn.rfind('.');
+  if (dot != std::string::npos && fn.find('/', dot) == std::string::npos)
+    fn = fn.substr(0, dot);
+  if (runID > 0) fn += "_run" + std::to_string(runID);
+  return fn + ".root";
+}
+
+void FourQubitSensitivity::FillPrimaryNtuple(G4int runID, G4int eventID,
+					     const G4PrimaryVertex* vertex,
+					     G4int flags) {
+  const G4PrimaryParticle* primary = vertex->GetPrimary();
+  G4AnalysisManager* analysis = G4AnalysisManager::Instance();
+  analysis->FillNtupleIColumn(kPrimaryNtuple, 0, runID);
+  analysis->FillNtupleIColumn(kPrimaryNtuple, 1, eventID);
+  analysis->FillNtupleSColumn(kPrimaryNtuple, 2,
+			      primary->GetParticleDefinition()->GetParticleName());
+  analysis->FillNtupleDColumn(kPrimaryNtuple, 3, primary->GetTotalEnergy()/eV);
+  analysis->FillNtupleDColumn(kPrimaryNtuple, 4, vertex->GetX0()/mm);
+  analysis->FillNtupleDColumn(kPrimaryNtuple, 5, vertex->GetY0()/mm);
+  analysis->FillNtupleDColumn(kPrimaryNtuple, 6, vertex->GetZ0()/mm);
+  analysis->FillNtupleDColumn(kPrimaryNtuple, 7, vertex->GetT0()/ns);
+  analysis->FillNtupleIColumn(kPrimaryNtuple, 8, FourQubitVertexInfo::Stratum(vertex));
+  analysis->FillNtupleDColumn(kPrimaryNtuple, 9, primary->GetWeight());
+  analysis->FillNtupleIColumn(kPrimaryNtuple, 10, flags);
+  analysis->AddNtupleRow(kPrimaryNtuple);
+}
+
+void FourQubitSensitivity::FillHitNtuple(G4int runID, G4int eventID,
+					 const G4CMPElectrodeHit* hit,
+					 const FourQubitSensorTable::VolumeID& volID) {
+  G4AnalysisManager* analysis = G4AnalysisManager::Instance();
+  analysis->FillNtupleIColumn(kHitNtuple, 0, runID);
+  analysis->FillNtupleIColumn(kHitNtuple, 1, eventID);
+  analysis->FillNtupleIColumn(kHitNtuple, 2, hit->GetTrackID());
+  analysis->FillNtupleSColumn(kHitNtuple, 3, hit->GetParticleName());
+  analysis->FillNtupleDColumn(kHitNtuple, 4, hit->GetStartEnergy()/eV);
+  analysis->FillNtupleDColumn(kHitNtuple, 5, hit->GetStartPosition().getX()/mm);
+  analysis->FillNtupleDColumn(kHitNtuple, 6, hit->GetStartPosition().getY()/mm);
+  analysis->FillNtupleDColumn(kHitNtuple, 7, hit->GetStartPosition().getZ()/mm);
+  analysis->FillNtupleDColumn(kHitNtuple, 8, hit->GetStartTime()/ns);
+  analysis->FillNtupleDColumn(kHitNtuple, 9, hit->GetEnergyDeposit()/eV);
+  analysis->FillNtupleDColumn(kHitNtuple, 10, hit->GetWeight());
+  analysis->FillNtupleDColumn(kHitNtuple, 11, hit->GetFinalPosition().getX()/mm);
+  analysis->FillNtupleDColumn(kHitNtuple, 12, hit->GetFinalPosition().getY()/mm);
+  analysis->FillNtupleDColumn(kHitNtuple, 13, hit->GetFinalPosition().getZ()/mm);
+  analysis->FillNtupleDColumn(kHitNtuple, 14, hit->GetFinalTime()/ns);
+  analysis->FillNtupleIColumn(kHitNtuple, 15, volID.sensorID);
+  analysis->FillNtupleIColumn(kHitNtuple, 16, volID.qubitID);
+  analysis->AddNtupleRow(kHitNtuple);
+}
+
+
+// Every particle known at file-open time gets a code; the table is taken
+// in G4ParticleTable order, so all worker shards carry identical headers
+
+void FourQubitSensitivity::FillParticleTable() {
+  if (!particleNames.empty()) return;
+
+  G4ParticleTable::G4PTblDicIterator* iter =
+    G4ParticleTable::GetParticleTable()->GetIterator();
+  iter->reset();
+  while ((*iter)()) {
+    const G4String& name = iter->value()->GetParticleName();
+    particleCodes[name] = G4int(particleNames.size());
+    particleNames.push_back(name);
+  }
+}
+
+G4int FourQubitSensitivity::ParticleCode(const G4String& name) const {
+  auto code = particleCodes.find(name);
+  return (code == particleCodes.end()) ? -1 : code->second;
+}
+
+
+// Run boundaries: sequential jobs keep one pair of files for the whole job;
+// MT workers write a fresh shard per run, closed at the end so the master
+// can merge it (see FourQubitRunAction)
+
+G4bool FourQubitSensitivity::WritesShards() const {
+  return G4Threading::IsMultithreadedApplication();
+}
+
+void FourQubitSensitivity::BeginOfRun() {
+  G4int tid = WritesShards() ? G4Threading::G4GetThreadId() : -1;
+  G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+
+  pceMap.BeginOfRun();
+  checkpoint.BeginOfRun(runID, tid);
+  if (eventSums) ResetSensorSums();		// The geometry may have changed
+  if (rootOutput || !hitFiles) return;		// See FourQubitRunAction
+
+  G4String hitName = FourQubitConfigManager::GetHitOutput();
+  G4String primName = FourQubitConfigManager::GetPrimaryOutput();
+  if (WritesShards()) {
+    hitName = ShardFileName(hitName, tid);
+    primName = ShardFileName(primName, tid);
+  }
+
+  // In /g4cmp/ResumeRun, carry on from this thread's checkpoint: its files
+  // must be the ones being opened now
+  G4long hitAt = 0, primAt = 0;
+  const FourQubitCheckpoint::State* resume = FourQubitCheckpoint::ResumeState(tid);
+  if (resume) {
+    if (resume->hitFile == hitName && resume->primaryFile == primName) {
+      hitAt = resume->hitBytes;
+      primAt = resume->primaryBytes;
+    } else {
+      G4ExceptionDescription msg;
+      msg << "Checkpoint was written for " << resume->hitFile << " and "
+	  << resume->primaryFile << ", not " << hitName << " and " << primName
+	  << "; starting them over.";
+      G4Exception("FourQubitSensitivity::BeginOfRun", "PhonSense005",
+		  JustWarning, msg);
     }
   }
+
+  SetHitOutputFile(hitName, hitAt);
+  SetPrimaryOutputFile(primName, primAt);
+}
+
+void FourQubitSensitivity::EndOfRun() {
+  pceMap.EndOfRun();
+  FourQubitRunCounters::AddHits(nHitsThisRun);
+  nHitsThisRun = 0;
+  FlushOutput();
+
+  if (WritesShards()) {
+    hitOutput.Close();
+    primaryOutput.Close();
+    hitFileName = primaryFileName = "";		// Forces reopen next run
+  }
+}
+
+void FourQubitSensitivity::FlushOutput() {
+  Flush(hitBuffer, hitOutput);
+  Flush(primaryBuffer, primaryOutput);
+  hitOutput.Flush();
+  primaryOutput.Flush();
 }
 
-void FourQubitSensitivity::SetHitOutputFile(const G4String &fn) {
+// Hands the block over; with /g4cmp/AsyncOutput it is written later
+
+void FourQubitSensitivity::Flush(std::string& buffer, FourQubitOutputFile& output) {
+  if (output.IsOpen()) output.Write(buffer);
+  buffer.clear();
+}
+
+
+// Shard names carry the worker thread ID ahead of the extension:
+// "hits.txt" -> "hits_t3.txt"
+
+G4String FourQubitSensitivity::ShardFileName(const G4String& fn, G4int tid) {
+  return FourQubitConfigManager::TaggedFileName(fn, "t" + std::to_string(tid));
+}
+
+
+void FourQubitSensitivity::SetHitOutputFile(const G4String &fn, G4long resumeAt) {
   if (hitFileName != fn) {
-    if (hitOutput.is_open()) hitOutput.close();
+    Flush(hitBuffer, hitOutput);
+    hitOutput.Close();
     hitFileName = fn;
-    hitOutput.open(hitFileName, std::ios_base::trunc);
-    if (!hitOutput.good()) {
-      G4ExceptionDescription msg;
-      msg << "Error opening hit output file " << hitFileName;
-      G4Exception("FourQubitSensitivity::SetHitOutputFile", "PhonSense003",
-                  FatalException, msg);
-      hitOutput.close();
+    OpenOutput(hitOutput, hitFileName, "SetHitOutputFile", resumeAt);
+    if (!hitOutput.IsOpen() || resumeAt > 0) return;	// Header already there
+
+    if (binaryOutput && eventSums) {
+      FourQubitHitFormat::AppendHeader(hitBuffer, FourQubitHitFormat::kEventMagic,
+				       sizeof(FourQubitHitFormat::EventSumRecord),
+				       FourQubitHitFormat::EventSumFields(),
+				       std::vector<std::string>());
+    } else if (binaryOutput) {
+      FourQubitHitFormat::AppendHeader(hitBuffer, FourQubitHitFormat::kHitMagic,
+				       sizeof(FourQubitHitFormat::HitRecord),
+				       FourQubitHitFormat::HitFields(),
+				       particleNames);
+    } else if (eventSums) {
+      hitBuffer += "RunID EventID SensorID QubitID NHits EnergyDeposited[eV]"
+	" FirstTime[ns] LastTime[ns]\n";
     } else {
-      hitOutput << "Run ID,Event ID,Track ID,Particle Name,Start Energy [eV],"
-		<< "Start X [mm],Start Y [mm],Start Z [mm],Start Time [ns],"
-		<< "Energy Deposited [eV],Track Weight,End X [mm],End Y [mm],End Z [mm],"
-		<< "Final Time [ns],Volume Name\n";
+      hitBuffer += "RunID EventID TrackID ParticleName StartEnergy[eV]"
+	" StartX[mm] StartY[mm] StartZ[mm] StartTime[ns]"
+	" EnergyDeposited[eV] TrackWeight EndX[mm] EndY[mm] EndZ[mm]"
+	" FinalTime[ns] SensorID QubitID\n";
     }
   }
 }
 
 
-void FourQubitSensitivity::SetPrimaryOutputFile(const G4String &fn) {
+void FourQubitSensitivity::SetPrimaryOutputFile(const G4String &fn, G4long resumeAt) {
   if (primaryFileName != fn) {
-    if (primaryOutput.is_open()) primaryOutput.close();
+    Flush(primaryBuffer, primaryOutput);
+    primaryOutput.Close();
     primaryFileName = fn;
-    primaryOutput.open(primaryFileName, std::ios_base::trunc);
-    if (!primaryOutput.good()) {
-      G4ExceptionDescription msg;
-      msg << "Error opening output file " << primaryFileName;
-      G4Exception("FourQubitSensitivity::SetPrimaryOutputFile", "PhonSense003",
-                  FatalException, msg);
-      primaryOutput.close();
+    OpenOutput(primaryOutput, primaryFileName, "SetPrimaryOutputFile", resumeAt);
+    if (!primaryOutput.IsOpen() || resumeAt > 0) return;
+
+    if (binaryOutput) {
+      FourQubitHitFormat::AppendHeader(primaryBuffer,
+				       FourQubitHitFormat::kPrimaryMagic,
+				       sizeof(FourQubitHitFormat::PrimaryRecord),
+				       FourQubitHitFormat::PrimaryFields(),
+				       particleNames);
     } else {
-      primaryOutput << "Run ID,Event ID,Particle Name,Start Energy [eV],"
-		    << "Start X [mm],Start Y [mm],Start Z [mm],Start Time [ns]\n";
+      primaryBuffer += "RunID EventID ParticleName StartEnergy[eV]"
+	" StartX[mm] StartY[mm] StartZ[mm] StartTime[ns] Stratum Weight Flags\n";
     }
   }
 }
 
 
+// Anything past "resumeAt" was written after the last checkpoint, so may
+// end in a partial event; it is dropped and the rest appended to
+
+void FourQubitSensitivity::OpenOutput(FourQubitOutputFile& output, const G4String& fn,
+				      const char* method, G4long resumeAt) {
+  if (binaryOutput) FillParticleTable();
+
+  std::ios_base::openmode mode = std::ios_base::trunc;
+  if (resumeAt > 0) {
+    struct stat info;
+    if (stat(fn.c_str(), &info) != 0 || info.st_size < resumeAt ||
+	truncate(fn.c_str(), off_t(resumeAt)) != 0) {
+      G4ExceptionDescription msg;
+      msg << "Cannot resume " << fn << " at its checkpointed length of "
+	  << resumeAt << " bytes";
+      G4Exception((G4String("FourQubitSensitivity::")+method).c_str(),
+		  "PhonSense004", FatalException, msg);
+      return;
+    }
+    mode = std::ios_base::app;
+  }
+
+  // Shards are indexed when merged (FourQubitShardMerger)
+  G4bool indexed = FourQubitConfigManager::GetEventIndex() && !WritesShards();
+  if (!output.Open(fn, mode, indexed)) {
+    G4ExceptionDescription msg;
+    msg << "Error opening output file " << fn;
+    G4Exception((G4String("FourQubitSensitivity::")+method).c_str(),
+		"PhonSense003", FatalException, msg);
+    output.Close();
+  }
+}
+
+
 G4bool FourQubitSensitivity::IsHit(const G4Step* step,
                                 const G4TouchableHistory*) const
 {
@@ -134,7 +708,9 @@ G4bool FourQubitSensitivity::IsHit(const G4Step* step,
 
   //-------------------------------------------------------------------
   //Set criteion for what counts as a "hit" that should be recorded.
-  bool selectTargetVolumes = false;
+  //Target volumes are chosen at run time with /g4cmp/TargetVolumes.
+  const FourQubitSensorTable* sensors = FourQubitSensorTable::Instance();
+  G4bool selectTargetVolumes = sensors->HasTargets();
 
   //Option one: a phonon that is stopped and killed at a boundary with a
   //nonzero energy deposition.
@@ -146,16 +722,16 @@ G4bool FourQubitSensitivity::IsHit(const G4Step* step,
                          postStepPoint->GetStepStatus() == fGeomBoundary &&
                          step->GetNonIonizingEnergyDeposit() > 0.;
 
-  G4bool landedOnTargetSurface = (postStepPoint->GetPhysicalVolume()->GetName().find("shuntConductor") != std::string::npos);
-
   //Now select which critera matter:
   //Option one: a phonon that is stopped and killed at a boundary with a
   //nonzero energy deposition.  
   if( !selectTargetVolumes ){ return correctParticle && correctStatus; }
     
-  //Option two: a phonon that satisfies all of the above things, but also landed in a specific
-  //volume name. Here, we're looking for a volume that contains the words "shuntConductor", which
-  //in this tutorial's geometry is one of the qubit crosses. (Can also just put this info in
-  //the output file and sort through this in analysis, but this helps us minimize output filesize.)
-  else{ return correctParticle && correctStatus && landedOnTargetSurface; }
+  //Option two: a phonon that satisfies all of the above things, but also landed in one of
+  //the target volumes, e.g. "/g4cmp/TargetVolumes shuntConductor" for the qubit crosses. The
+  //patterns are resolved to volume pointers once per geometry build, so this is a single hash
+  //lookup. (Can also just put this info in the output file and sort through this in analysis,
+  //but this helps us minimize output filesize.)
+  if( !(correctParticle && correctStatus) ) return false;
+  return sensors->Find(postStepPoint).target;
 }
@@ -0,0 +1,333 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitSensorTable.cc
+//
+// Description:	Singleton registry of qubit and sensor footprints.
+
+#include "FourQubitSensorTable.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Point3D.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4RotationMatrix.hh"
+#include "G4StepPoint.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4VTouchable.hh"
+#include <algorithm>
+#include <cfloat>
+#include <fstream>
+#include <set>
+#include <string>
+
+
+namespace {
+  // Placement of a volume's local frame in the world: p_world = rot*p + pos
+  struct Placement {
+    G4RotationMatrix rot;
+    G4ThreeVector pos;
+
+    Placement Daughter(const G4VPhysicalVolume* pv) const {
+      Placement d;
+      d.rot = rot * pv->GetObjectRotationValue();
+      d.pos = rot * pv->GetObjectTranslation() + pos;
+      return d;
+    }
+  };
+
+  // World-frame bounding box of a solid at the given placement
+  void WorldExtent(const G4VSolid* solid, const Placement& where,
+		   G4ThreeVector& wMin, G4ThreeVector& wMax) {
+    G4ThreeVector lMin, lMax;
+    solid->BoundingLimits(lMin, lMax);
+
+    wMin.set(DBL_MAX, DBL_MAX, DBL_MAX);
+    wMax.set(-DBL_MAX, -DBL_MAX, -DBL_MAX);
+    for (G4int i=0; i<8; i++) {
+      G4ThreeVector corner((i&1) ? lMax.x() : lMin.x(),
+			   (i&2) ? lMax.y() : lMin.y(),
+			   (i&4) ? lMax.z() : lMin.z());
+      corner = where.rot * corner + where.pos;
+      wMin.set(std::min(wMin.x(), corner.x()), std::min(wMin.y(), corner.y()),
+	       std::min(wMin.z(), corner.z()));
+      wMax.set(std::max(wMax.x(), corner.x()), std::max(wMax.y(), corner.y()),
+	       std::max(wMax.z(), corner.z()));
+    }
+  }
+}
+
+
+FourQubitSensorTable* FourQubitSensorTable::Instance() {
+  static FourQubitSensorTable theTable;
+  return &theTable;
+}
+
+void FourQubitSensorTable::Clear() {
+  qubits.clear();
+  sensors.clear();
+  volumeIDs.clear();
+  flatVolumes.clear();
+  arrays.clear();
+}
+
+void FourQubitSensorTable::Restore(const std::vector<Footprint>& qubitList,
+				   const std::vector<Footprint>& sensorList,
+				   const std::unordered_map<const G4VPhysicalVolume*,VolumeID>& ids) {
+  Clear();
+  qubits = qubitList;
+  sensors = sensorList;
+  volumeIDs = ids;
+}
+
+
+// Component sub-volumes are nested several levels deep, so the daughter
+// tree below the qubit is walked to find where each niobium piece sits
+
+G4int FourQubitSensorTable::AddQubit(const G4String& name,
+				     G4VPhysicalVolume* pv,
+				     const SubVolumeList& subVolumes,
+				     G4VPhysicalVolume* motherPV) {
+  G4int qubitID = G4int(qubits.size());
+
+  Placement world;
+  world = world.Daughter(motherPV).Daughter(pv);
+
+  Footprint qubit;
+  qubit.id = qubit.qubitID = qubitID;
+  qubit.name = name;
+  WorldExtent(pv->GetLogicalVolume()->GetSolid(), world, qubit.min, qubit.max);
+  qubits.push_back(qubit);
+
+  std::set<const G4VPhysicalVolume*> conductors;
+  for (const auto& sub : subVolumes) {
+    if (std::get<0>(sub) == FourQubitMaterialTag::Niobium)
+      conductors.insert(std::get<2>(sub));
+  }
+
+  std::vector<std::pair<G4VPhysicalVolume*,Placement> > stack;
+  stack.push_back(std::make_pair(pv, world));
+  while (!stack.empty()) {
+    G4VPhysicalVolume* vol = stack.back().first;
+    Placement where = stack.back().second;
+    stack.pop_back();
+
+    VolumeID& volID = volumeIDs[vol];
+    volID.qubitID = qubitID;
+    volID.sensorID = -1;
+    volID.target = false;
+
+    if (conductors.count(vol)) {
+      volID.sensorID = G4int(sensors.size());
+
+      Footprint sensor;
+      sensor.id = G4int(sensors.size());
+      sensor.qubitID = qubitID;
+      sensor.name = name + "_" + vol->GetName();
+      WorldExtent(vol->GetLogicalVolume()->GetSolid(), where,
+		  sensor.min, sensor.max);
+      sensors.push_back(sensor);
+    }
+
+    G4LogicalVolume* log = vol->GetLogicalVolume();
+    for (size_t i=0; i<log->GetNoDaughters(); i++) {
+      G4VPhysicalVolume* d = log->GetDaughter(i);
+      stack.push_back(std::make_pair(d, where.Daughter(d)));
+    }
+  }
+
+  return qubitID;
+}
+
+
+// The cells are identical, so the template below arrayPV is walked once
+// for the sensor order and the footprints are shifted for each cell.  The
+// shared daughters get one volumeIDs entry, for cell 0; Find(G4StepPoint*)
+// corrects it from the copy number.
+
+G4int FourQubitSensorTable::AddQubitArray(const G4String& name,
+					  G4VPhysicalVolume* arrayPV,
+					  const SubVolumeList& subVolumes,
+					  G4VPhysicalVolume* motherPV,
+					  const std::vector<G4ThreeVector>& cellPositions) {
+  QubitArray& array = arrays[arrayPV];
+  array.firstQubit = G4int(qubits.size());
+  array.firstSensor = G4int(sensors.size());
+  array.localSensors.clear();
+
+  std::set<const G4VPhysicalVolume*> conductors;
+  for (const auto& sub : subVolumes) {
+    if (std::get<0>(sub) == FourQubitMaterialTag::Niobium)
+      conductors.insert(std::get<2>(sub));
+  }
+
+  // Cell-frame placements of the cell and its shared daughters, in sensor order
+  std::vector<std::pair<G4VPhysicalVolume*,Placement> > cellSensors;
+  std::vector<std::pair<G4VPhysicalVolume*,Placement> > stack;
+  stack.push_back(std::make_pair(arrayPV, Placement()));
+  while (!stack.empty()) {
+    G4VPhysicalVolume* vol = stack.back().first;
+    Placement where = stack.back().second;
+    stack.pop_back();
+
+    VolumeID& volID = volumeIDs[vol];
+    volID.qubitID = array.firstQubit;
+    volID.sensorID = -1;
+    volID.target = false;
+
+    if (conductors.count(vol)) {
+      volID.sensorID = array.firstSensor + G4int(cellSensors.size());
+      array.localSensors[vol] = G4int(cellSensors.size());
+      cellSensors.push_back(std::make_pair(vol, where));
+    }
+
+    G4LogicalVolume* log = vol->GetLogicalVolume();
+    for (size_t i=0; i<log->GetNoDaughters(); i++) {
+      G4VPhysicalVolume* d = log->GetDaughter(i);
+      stack.push_back(std::make_pair(d, where.Daughter(d)));
+    }
+  }
+  array.sensorsPerCell = G4int(cellSensors.size());
+
+  // The parameterised volume's own transform is only valid mid-navigation,
+  // so each cell is placed from its position instead
+  Placement mother;
+  mother = mother.Daughter(motherPV);
+  for (size_t c=0; c<cellPositions.size(); c++) {
+    Placement cell;
+    cell.rot = mother.rot;
+    cell.pos = mother.rot * cellPositions[c] + mother.pos;
+
+    Footprint qubit;
+    qubit.id = qubit.qubitID = G4int(qubits.size());
+    qubit.name = name + "_" + std::to_string(c);
+    WorldExtent(arrayPV->GetLogicalVolume()->GetSolid(), cell, qubit.min, qubit.max);
+    qubits.push_back(qubit);
+
+    for (const auto& cs : cellSensors) {
+      Placement where;
+      where.rot = cell.rot * cs.second.rot;
+      where.pos = cell.rot * cs.second.pos + cell.pos;
+
+      Footprint sensor;
+      sensor.id = G4int(sensors.size());
+      sensor.qubitID = qubit.id;
+      sensor.name = qubit.name + "_" + cs.first->GetName();
+      WorldExtent(cs.first->GetLogicalVolume()->GetSolid(), where,
+		  sensor.min, sensor.max);
+      sensors.push_back(sensor);
+    }
+  }
+
+  return array.firstQubit;
+}
+
+
+// The touchable is only walked when an array exists, so the common case
+// stays the one or two hash lookups above
+
+FourQubitSensorTable::VolumeID
+FourQubitSensorTable::Find(const G4StepPoint* point) const {
+  const G4VPhysicalVolume* pv = point->GetPhysicalVolume();
+  if (arrays.empty()) return Find(pv, point->GetPosition());
+
+  const G4VTouchable* touchable = point->GetTouchable();
+  for (G4int depth=0; depth<=touchable->GetHistoryDepth(); depth++) {
+    auto array = arrays.find(touchable->GetVolume(depth));
+    if (array == arrays.end()) continue;
+
+    const QubitArray& a = array->second;
+    const G4int copy = touchable->GetReplicaNumber(depth);
+    VolumeID id = Find(pv);
+    id.qubitID = a.firstQubit + copy;
+    auto local = a.localSensors.find(pv);
+    id.sensorID = (local == a.localSensors.end()) ? -1
+      : a.firstSensor + copy*a.sensorsPerCell + local->second;
+    return id;
+  }
+
+  return Find(pv, point->GetPosition());
+}
+
+
+// Hits only, not every step, come here: a linear scan of the nodes is
+// cheap next to the step that produced the hit.  A point on a face shared
+// by two nodes goes to the first.
+
+const FourQubitSensorTable::VolumeID&
+FourQubitSensorTable::FindNode(const G4VPhysicalVolume* pv,
+			       const std::vector<FlatNode>& nodes,
+			       const G4ThreeVector& pos) const {
+  for (const FlatNode& node : nodes) {
+    G4Point3D local = node.toNode * G4Point3D(pos);
+    if (node.solid->Inside(G4ThreeVector(local.x(), local.y(), local.z())) != kOutside)
+      return Find(node.original);
+  }
+  return Find(pv);
+}
+
+
+// Volumes outside any qubit get an entry too, with no sensor or qubit ID,
+// so FourQubitSensitivity::IsHit needs only the one lookup
+
+void FourQubitSensorTable::ResolveTargets(const std::vector<G4String>& patterns) {
+  for (auto& entry : volumeIDs) entry.second.target = false;
+  selectTargets = !patterns.empty();
+  if (!selectTargets) return;
+
+  // Before /run/initialize there is nothing to resolve yet; Construct()
+  // calls back here once the volumes exist
+  G4PhysicalVolumeStore* store = G4PhysicalVolumeStore::GetInstance();
+  if (store->empty()) return;
+
+  G4int nTargets = 0;
+  for (G4VPhysicalVolume* pv : *store) {
+    const G4String& name = pv->GetName();
+    for (const G4String& pattern : patterns) {
+      if (name.find(pattern) == std::string::npos) continue;
+
+      auto entry = volumeIDs.find(pv);
+      if (entry == volumeIDs.end()) {
+	VolumeID outside = { -1, -1, true };
+	volumeIDs[pv] = outside;
+      } else {
+	entry->second.target = true;
+      }
+      nTargets++;
+      break;
+    }
+  }
+
+  if (nTargets == 0) {
+    G4Exception("FourQubitSensorTable::ResolveTargets", "Sensors002",
+		JustWarning, "No volume matches /g4cmp/TargetVolumes; every hit will be rejected.");
+  }
+}
+
+
+void FourQubitSensorTable::Write(const G4String& filename) const {
+  std::ofstream out(filename, std::ios_base::trunc);
+  if (!out.good()) {
+    G4ExceptionDescription msg;
+    msg << "Error opening geometry description file " << filename;
+    G4Exception("FourQubitSensorTable::Write", "Sensors001",
+		JustWarning, msg);
+    return;
+  }
+
+  out << "# FourQubit qubit and sensor footprints, world coordinates [mm]\n"
+      << "# type id qubitID name xMin xMax yMin yMax zMin zMax\n";
+
+  auto writeEntry = [&out](const char* type, const Footprint& f) {
+    out << type << ' ' << f.id << ' ' << f.qubitID << ' ' << f.name
+	<< ' ' << f.min.x()/mm << ' ' << f.max.x()/mm
+	<< ' ' << f.min.y()/mm << ' ' << f.max.y()/mm
+	<< ' ' << f.min.z()/mm << ' ' << f.max.z()/mm << '\n';
+  };
+
+  for (const Footprint& q : qubits) writeEntry("qubit", q);
+  for (const Footprint& s : sensors) writeEntry("sensor", s);
+}
@@ -0,0 +1,175 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitShardMerger.cc
+//
+// Description:	Master-thread merge of the per-worker output shards written
+//		by FourQubitSensitivity during an MT run.  Compressed shards
+//		are read through FourQubitInputFile, and the merged file is
+//		written like the shards were (FourQubitOutputWriter), with
+//		its /g4cmp/EventIndex built as the records go by.
+
+#include "FourQubitShardMerger.hh"
+#include "FourQubitCompressedInput.hh"
+#include "FourQubitConfigManager.hh"
+#include "FourQubitHitFormat.hh"
+#include "FourQubitOutputWriter.hh"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <queue>
+#include <string>
+
+
+namespace {
+  // One open shard, positioned at its next record.  Text records begin
+  // with "runID eventID"; anything else (the column header) is skipped.
+  // Binary shards (see FourQubitHitFormat.hh) have a header followed by
+  // fixed-width records which begin with int32 runID, eventID.
+  struct ShardCursor {
+    FourQubitInputFile in;
+    std::string record;			// Bytes to copy, including '\n'
+    long run = 0, event = 0;
+    size_t recordSize = 0;		// Nonzero for binary shards
+
+    // Open and read any header, leaving "header" as the bytes to copy.
+    // A compressed shard cannot seek, so it is reopened to go back.
+    G4bool Open(const G4String& name, std::string& header) {
+      in.open(name);
+      if (!in.is_open()) return false;
+
+      FourQubitHitFormat::Header hdr;
+      G4bool binary = FourQubitHitFormat::ReadHeader(in, hdr);
+      in.open(name);
+      if (binary) {
+	recordSize = hdr.recordSize;
+	header.resize(hdr.size);
+	in.read(&header[0], hdr.size);
+      }
+      return in.good();
+    }
+
+    G4bool Next(std::string* header=0) {
+      if (recordSize > 0) return NextBinary();
+
+      while (std::getline(in, record)) {
+	char* end = 0;
+	run = std::strtol(record.c_str(), &end, 10);
+	if (end == record.c_str()) {		// Not a record
+	  if (header && header->empty()) *header = record + '\n';
+	  continue;
+	}
+	event = std::strtol(end, 0, 10);
+	record += '\n';
+	return true;
+      }
+      return false;
+    }
+
+    G4bool NextBinary() {
+      record.resize(recordSize);
+      if (!in.read(&record[0], recordSize)) return false;
+
+      int32_t ids[2];
+      std::memcpy(ids, record.data(), sizeof(ids));
+      if (!FourQubitHitFormat::HostIsLittleEndian()) {
+	FourQubitHitFormat::SwapBytes(&ids[0], sizeof(int32_t));
+	FourQubitHitFormat::SwapBytes(&ids[1], sizeof(int32_t));
+      }
+      run = ids[0];
+      event = ids[1];
+      return true;
+    }
+  };
+
+  typedef std::unique_ptr<ShardCursor> CursorPtr;
+
+  // Priority queue ordering: smallest (run, event) first
+  struct LaterKey {
+    const std::vector<CursorPtr>* cursors;
+    G4bool operator()(size_t a, size_t b) const {
+      const ShardCursor& ca = *(*cursors)[a];
+      const ShardCursor& cb = *(*cursors)[b];
+      if (ca.run != cb.run) return ca.run > cb.run;
+      if (ca.event != cb.event) return ca.event > cb.event;
+      return a > b;
+    }
+  };
+}
+
+
+void FourQubitShardMerger::Merge(const G4String& output,
+				 const std::vector<G4String>& shards) {
+  std::vector<CursorPtr> cursors;
+  std::string header;
+  for (const G4String& name : shards) {
+    CursorPtr cur(new ShardCursor);
+    if (!cur->Open(name, header)) continue;	// Thread processed nothing
+    if (cur->Next(&header)) cursors.push_back(std::move(cur));
+  }
+
+  // First merge of the job replaces any old file; later runs append
+  G4bool fresh = (created.insert(output).second);
+  FourQubitOutputFile out;
+  if (!out.Open(output, fresh ? std::ios_base::trunc : std::ios_base::app,
+		FourQubitConfigManager::GetEventIndex())) {
+    G4ExceptionDescription msg;
+    msg << "Error opening merged output file " << output;
+    G4Exception("FourQubitShardMerger::Merge", "Merger001",
+		JustWarning, msg, "Per-thread shards were kept.");
+    return;
+  }
+
+  // Records are collected into blocks, as in FourQubitSensitivity
+  const size_t blockSize = FourQubitConfigManager::GetOutputBufferSize();
+  std::string block;
+  if (fresh) block = header;
+
+  LaterKey order{&cursors};
+  std::priority_queue<size_t, std::vector<size_t>, LaterKey> queue(order);
+  for (size_t i=0; i<cursors.size(); i++) queue.push(i);
+
+  // An event's records all come from one shard, so they arrive together
+  long run = 0, event = 0;
+  G4long start = 0;
+  G4int nRecords = 0;
+
+  while (!queue.empty()) {
+    size_t i = queue.top();
+    queue.pop();
+
+    const ShardCursor& cur = *cursors[i];
+    if (nRecords == 0 || cur.run != run || cur.event != event) {
+      if (nRecords > 0) out.IndexEvent(G4int(run), G4int(event), start, nRecords);
+      run = cur.run;
+      event = cur.event;
+      start = out.Position() + G4long(block.size());
+      nRecords = 0;
+    }
+    nRecords++;
+
+    block += cursors[i]->record;
+    if (block.size() >= blockSize) out.Write(block);
+    if (cursors[i]->Next()) queue.push(i);
+  }
+  if (nRecords > 0) out.IndexEvent(G4int(run), G4int(event), start, nRecords);
+
+  out.Write(block);
+  out.Close();
+  if (!out.Good()) {
+    G4Exception("FourQubitShardMerger::Merge", "Merger002", JustWarning,
+		("Error writing "+output+"; per-thread shards were kept.").c_str());
+    return;
+  }
+
+  cursors.clear();		// Close shards before removing them
+  for (const G4String& name : shards) {
+    std::remove(name.c_str());
+    std::remove(FourQubitHitFormat::IndexFileName(name).c_str());	// MPI ranks'
+  }
+}
@@ -0,0 +1,45 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitStackingAction.cc
+//
+// Description:	G4CMPStackingAction plus phonon culling at birth.
+
+#include "FourQubitStackingAction.hh"
+#include "FourQubitConfigManager.hh"
+#include "G4PhononLong.hh"
+#include "G4PhononTransFast.hh"
+#include "G4PhononTransSlow.hh"
+#include "G4Track.hh"
+
+
+FourQubitStackingAction::FourQubitStackingAction()
+  : G4CMPStackingAction(), cullEnergy(0.), cullTime(0.) {;}
+
+void FourQubitStackingAction::PrepareNewEvent() {
+  G4CMPStackingAction::PrepareNewEvent();
+  cullEnergy = FourQubitConfigManager::GetPhononCullEnergy();
+  cullTime = FourQubitConfigManager::GetPhononCullTime();
+}
+
+
+// The base class still sets up every track (e.g. phonon polarization and
+// wave vector) before the cuts are looked at
+
+G4ClassificationOfNewTrack
+FourQubitStackingAction::ClassifyNewTrack(const G4Track* track) {
+  G4ClassificationOfNewTrack result = G4CMPStackingAction::ClassifyNewTrack(track);
+  if (result == fKill || (cullEnergy <= 0. && cullTime <= 0.)) return result;
+
+  const G4ParticleDefinition* particle = track->GetDefinition();
+  if (particle != G4PhononLong::Definition() &&
+      particle != G4PhononTransFast::Definition() &&
+      particle != G4PhononTransSlow::Definition()) return result;
+
+  if (cullEnergy > 0. && track->GetKineticEnergy() < cullEnergy) return fKill;
+  if (cullTime > 0. && track->GetGlobalTime() > cullTime) return fKill;
+  return result;
+}
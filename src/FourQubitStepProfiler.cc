@@ -0,0 +1,142 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitStepProfiler.cc
+//
+// Description:	Per-thread step counters for /g4cmp/StepProfile.
+
+#include "FourQubitStepProfiler.hh"
+#include "FourQubitBorderTable.hh"
+#include "G4AutoLock.hh"
+#include "G4CMPLogicalBorderSurface.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+
+
+// Shared totals, keyed by name since the pointers differ between threads
+// (processes) or may not outlive the geometry (volumes)
+
+namespace {
+  G4Mutex totalsMutex = G4MUTEX_INITIALIZER;
+
+  struct Total {
+    G4long steps;
+    G4double time;
+    Total() : steps(0), time(0.) {;}
+  };
+
+  typedef std::map<G4String,Total> TotalMap;
+  TotalMap processTotals, volumeTotals, borderTotals, particleTotals;
+
+  G4String VolumeName(const G4VPhysicalVolume* pv) {
+    return pv ? pv->GetName() : G4String("OutOfWorld");
+  }
+
+  void PrintTable(const G4String& title, const TotalMap& totals,
+		  G4bool withTime) {
+    std::vector<std::pair<G4String,Total> > rows(totals.begin(), totals.end());
+    std::sort(rows.begin(), rows.end(),
+	      [](const std::pair<G4String,Total>& a, const std::pair<G4String,Total>& b)
+	      { return a.second.steps > b.second.steps; });
+
+    G4long sum = 0;
+    for (const auto& row : rows) sum += row.second.steps;
+
+    G4cout << "\n--- " << title << " (" << rows.size() << " entries, "
+	   << sum << " total) ---" << G4endl;
+    for (const auto& row : rows) {
+      G4cout << std::setw(12) << row.second.steps << "  "
+	     << std::setw(6) << std::fixed << std::setprecision(2)
+	     << (sum ? 100.*row.second.steps/sum : 0.) << "%  ";
+      if (withTime) {
+	G4cout << std::setw(12) << std::scientific << std::setprecision(4)
+	       << row.second.time/ns << " ns  ";
+      }
+      G4cout << row.first << G4endl;
+    }
+    G4cout << std::defaultfloat;
+  }
+}
+
+
+void FourQubitStepProfiler::Record(const G4Step* step) {
+  const G4StepPoint* preSP = step->GetPreStepPoint();
+  const G4StepPoint* postSP = step->GetPostStepPoint();
+
+  processes[postSP->GetProcessDefinedStep()].steps++;
+  volumes[preSP->GetPhysicalVolume()].steps++;
+
+  Tally& particle = particles[step->GetTrack()->GetDefinition()];
+  particle.steps++;
+  particle.time += step->GetDeltaTime();
+
+  if (postSP->GetStepStatus() == fGeomBoundary) {
+    borders[Border(preSP->GetPhysicalVolume(), postSP->GetPhysicalVolume())].steps++;
+  }
+}
+
+
+void FourQubitStepProfiler::EndOfRun() {
+  G4AutoLock lock(&totalsMutex);
+
+  for (size_t i=0; i<processes.size(); i++) {
+    const G4VProcess* proc = processes.key(i);
+    Total& total = processTotals[proc ? proc->GetProcessName() : G4String("UserLimit")];
+    total.steps += processes.tally(i).steps;
+  }
+
+  for (size_t i=0; i<volumes.size(); i++) {
+    volumeTotals[VolumeName(volumes.key(i))].steps += volumes.tally(i).steps;
+  }
+
+  // Border surfaces are only registered one way round; report the volume
+  // pair for crossings with no surface (e.g. into the qubit housing gap)
+  for (size_t i=0; i<borders.size(); i++) {
+    const Border& border = borders.key(i);
+    G4CMPLogicalBorderSurface* surf =
+      FourQubitBorderTable::Instance()->Find(border.first, border.second);
+    G4String name = surf ? surf->GetName()
+      : VolumeName(border.first) + " -> " + VolumeName(border.second);
+    borderTotals[name].steps += borders.tally(i).steps;
+  }
+
+  for (size_t i=0; i<particles.size(); i++) {
+    Total& total = particleTotals[particles.key(i)->GetParticleName()];
+    total.steps += particles.tally(i).steps;
+    total.time += particles.tally(i).time;
+  }
+
+  processes.clear();
+  volumes.clear();
+  borders.clear();
+  particles.clear();
+}
+
+
+void FourQubitStepProfiler::PrintSummary() {
+  G4AutoLock lock(&totalsMutex);
+
+  G4cout << "\n=========== Step profile (/g4cmp/StepProfile) ===========";
+  PrintTable("Steps by process", processTotals, false);
+  PrintTable("Steps by volume", volumeTotals, false);
+  PrintTable("Boundary steps by border surface", borderTotals, false);
+  PrintTable("Steps and summed step time by particle", particleTotals, true);
+  G4cout << "=========================================================" << G4endl;
+
+  processTotals.clear();
+  volumeTotals.clear();
+  borderTotals.clear();
+  particleTotals.clear();
+}
@@ -0,0 +1,302 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitStepTrace.cc
+//
+// Description:	Sampled binary step traces for /g4cmp/StepTraceFile.
+
+#include "FourQubitStepTrace.hh"
+#include "FourQubitConfigManager.hh"
+#include "FourQubitEventInfo.hh"
+#include "FourQubitHitFormat.hh"
+#include "FourQubitSensitivity.hh"
+#include "G4Event.hh"
+#include "G4EventManager.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTable.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4ProcessTable.hh"
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+  const size_t kRingBlocks = 4;
+
+  // SplitMix64 finalizer: sampling depends only on (run, event, track)
+  uint64_t Mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  G4bool Keep(uint64_t hash, G4double fraction) {
+    if (fraction >= 1.) return true;
+    return G4double(hash >> 11) * (1./9007199254740992.) < fraction;
+  }
+}
+
+
+FourQubitStepTrace::FourQubitStepTrace()
+  : runID(0), eventFraction(1.), trackFraction(1.), lastEventID(-1),
+    eventSampled(false), trackSampled(false), blockSize(0), current(0),
+    writing(false), stopping(false) {;}
+
+FourQubitStepTrace::~FourQubitStepTrace() {
+  Close();
+}
+
+
+// Run boundaries
+
+void FourQubitStepTrace::BeginOfRun(G4int run) {
+  runID = run;
+  lastEventID = -1;
+  eventSampled = trackSampled = false;
+
+  G4String name = FourQubitConfigManager::GetStepTraceFile();
+  if (name.empty() || name == "none") {
+    Close();
+    return;
+  }
+
+  if (G4Threading::IsMultithreadedApplication())
+    name = FourQubitSensitivity::ShardFileName(name, G4Threading::G4GetThreadId());
+
+  if (name != fileName) {
+    Close();
+    if (!Open(name)) return;
+  }
+
+  eventFraction = FourQubitConfigManager::GetStepTraceEventFraction();
+  trackFraction = FourQubitConfigManager::GetStepTraceTrackFraction();
+  filter = FourQubitConfigManager::GetStepTraceFilter();
+
+  // Volumes and processes may have been rebuilt since the last run
+  filterCache.clear();
+  codeCache.clear();
+}
+
+void FourQubitStepTrace::EndOfRun() {
+  if (!IsActive()) return;
+  Drain();
+  out.flush();
+}
+
+
+// Per-step entry point from FourQubitSteppingAction
+
+void FourQubitStepTrace::Record(const G4Step* step) {
+  const G4Track* track = step->GetTrack();
+  if (track->GetCurrentStepNumber() == 1) trackSampled = SampleTrack(track);
+  if (!trackSampled) return;
+
+  const G4StepPoint* preSP = step->GetPreStepPoint();
+  const G4StepPoint* postSP = step->GetPostStepPoint();
+  const G4ParticleDefinition* particle = track->GetDefinition();
+  const G4VPhysicalVolume* volume = preSP->GetPhysicalVolume();
+  const G4VProcess* process = postSP->GetProcessDefinedStep();
+
+  if (!filter.empty() &&
+      !MatchesFilter(particle, particle->GetParticleName()) &&
+      !MatchesFilter(volume, volume->GetName())) return;
+
+  FourQubitHitFormat::StepRecord rec;
+  rec.runID = runID;
+  rec.eventID = lastEventID;
+  rec.trackID = track->GetTrackID();
+  rec.particle = Code(particle, particle->GetParticleName());
+  rec.process = process ? Code(process, process->GetProcessName()) : -1;
+  rec.volume = Code(volume, volume->GetName());
+  rec.preX = preSP->GetPosition().x()/mm;
+  rec.preY = preSP->GetPosition().y()/mm;
+  rec.preZ = preSP->GetPosition().z()/mm;
+  rec.preEnergy = preSP->GetTotalEnergy()/eV;
+  rec.preKinEnergy = preSP->GetKineticEnergy()/eV;
+  rec.postX = postSP->GetPosition().x()/mm;
+  rec.postY = postSP->GetPosition().y()/mm;
+  rec.postZ = postSP->GetPosition().z()/mm;
+  rec.postEnergy = postSP->GetTotalEnergy()/eV;
+  rec.postKinEnergy = postSP->GetKineticEnergy()/eV;
+  rec.postTime = postSP->GetGlobalTime()/ns;
+
+  if (!FourQubitHitFormat::HostIsLittleEndian())
+    FourQubitHitFormat::SwapRecord(&rec, FourQubitHitFormat::StepFields());
+
+  std::string& block = blocks[current];
+  block.append(reinterpret_cast<const char*>(&rec), sizeof(rec));
+  if (block.size() + sizeof(rec) > blockSize) Submit();
+}
+
+
+// Event decision is made once per event, track decision once per track
+
+G4bool FourQubitStepTrace::SampleTrack(const G4Track* track) {
+  const G4Event* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  G4int eventID = event ? FourQubitEventInfo::EventNumber(event) : -1;
+
+  uint64_t eventHash = Mix((uint64_t(uint32_t(runID)) << 32) | uint32_t(eventID));
+  if (eventID != lastEventID) {
+    lastEventID = eventID;
+    eventSampled = Keep(eventHash, eventFraction);
+  }
+  if (!eventSampled) return false;
+
+  return Keep(Mix(eventHash ^ uint32_t(track->GetTrackID())), trackFraction);
+}
+
+G4bool FourQubitStepTrace::MatchesFilter(const void* key, const G4String& name) {
+  auto cached = filterCache.find(key);
+  if (cached != filterCache.end()) return cached->second;
+
+  G4bool match = false;
+  for (const G4String& pattern : filter) {
+    if (name.find(pattern) != std::string::npos) { match = true; break; }
+  }
+  filterCache[key] = match;
+  return match;
+}
+
+G4int FourQubitStepTrace::Code(const void* key, const G4String& name) {
+  auto cached = codeCache.find(key);
+  if (cached != codeCache.end()) return cached->second;
+
+  auto entry = nameCodes.find(name);
+  G4int code = (entry == nameCodes.end()) ? -1 : entry->second;
+  codeCache[key] = code;
+  return code;
+}
+
+
+// Particles, then this thread's processes, then volumes; names are unique
+
+void FourQubitStepTrace::BuildNameTable(std::vector<std::string>& names) {
+  names.clear();
+  nameCodes.clear();
+
+  auto add = [&](const G4String& name) {
+    if (nameCodes.emplace(name, G4int(names.size())).second)
+      names.push_back(name);
+  };
+
+  G4ParticleTable::G4PTblDicIterator* iter =
+    G4ParticleTable::GetParticleTable()->GetIterator();
+  iter->reset();
+  while ((*iter)()) add(iter->value()->GetParticleName());
+
+  G4ProcessTable::G4ProcNameVector* procs =
+    G4ProcessTable::GetProcessTable()->GetNameList();
+  for (const G4String& proc : *procs) add(proc);
+
+  for (const G4VPhysicalVolume* pv : *G4PhysicalVolumeStore::GetInstance())
+    add(pv->GetName());
+}
+
+
+// File and writer thread
+
+G4bool FourQubitStepTrace::Open(const G4String& filename) {
+  out.open(filename, std::ios_base::binary | std::ios_base::trunc);
+  if (!out.good()) {
+    G4ExceptionDescription msg;
+    msg << "Unable to open " << filename << " for step tracing.";
+    G4Exception("FourQubitStepTrace::Open", "StepTrace001", JustWarning, msg);
+    out.close();
+    return false;
+  }
+
+  std::vector<std::string> names;
+  BuildNameTable(names);
+
+  std::string header;
+  FourQubitHitFormat::AppendHeader(header, FourQubitHitFormat::kStepMagic,
+				   sizeof(FourQubitHitFormat::StepRecord),
+				   FourQubitHitFormat::StepFields(), names);
+  out.write(header.data(), header.size());
+
+  // Hit output buffer size is shared out over the ring
+  blockSize = std::max<size_t>(FourQubitConfigManager::GetOutputBufferSize()/kRingBlocks,
+			       256*sizeof(FourQubitHitFormat::StepRecord));
+  blocks.assign(kRingBlocks, std::string());
+  for (std::string& block : blocks) block.reserve(blockSize);
+
+  current = 0;
+  fullBlocks.clear();
+  freeBlocks.clear();
+  for (size_t i=1; i<kRingBlocks; i++) freeBlocks.push_back(i);
+  writing = stopping = false;
+
+  fileName = filename;
+  writer = std::thread(&FourQubitStepTrace::WriterLoop, this);
+  return true;
+}
+
+void FourQubitStepTrace::Close() {
+  if (!IsActive()) return;
+
+  Drain();
+  {
+    std::lock_guard<std::mutex> lock(ringMutex);
+    stopping = true;
+  }
+  ringCond.notify_all();
+  writer.join();
+
+  if (!out.good()) {
+    G4ExceptionDescription msg;
+    msg << "Write error on step trace " << fileName << "; file is incomplete.";
+    G4Exception("FourQubitStepTrace::Close", "StepTrace002", JustWarning, msg);
+  }
+
+  out.close();
+  blocks.clear();
+  fileName = "";
+}
+
+void FourQubitStepTrace::Submit() {
+  std::unique_lock<std::mutex> lock(ringMutex);
+  fullBlocks.push_back(current);
+  ringCond.notify_all();
+  ringCond.wait(lock, [this]{ return !freeBlocks.empty(); });
+  current = freeBlocks.front();
+  freeBlocks.pop_front();
+}
+
+void FourQubitStepTrace::Drain() {
+  if (!blocks[current].empty()) Submit();
+
+  std::unique_lock<std::mutex> lock(ringMutex);
+  ringCond.wait(lock, [this]{ return fullBlocks.empty() && !writing; });
+}
+
+void FourQubitStepTrace::WriterLoop() {
+  std::unique_lock<std::mutex> lock(ringMutex);
+  for (;;) {
+    ringCond.wait(lock, [this]{ return stopping || !fullBlocks.empty(); });
+    if (fullBlocks.empty()) break;	// Stopping, and nothing left
+
+    size_t index = fullBlocks.front();
+    fullBlocks.pop_front();
+    writing = true;
+    lock.unlock();
+
+    std::string& block = blocks[index];
+    out.write(block.data(), block.size());
+    block.clear();
+
+    lock.lock();
+    writing = false;
+    freeBlocks.push_back(index);
+    ringCond.notify_all();
+  }
+}
@@ -7,9 +7,21 @@
 // Basic User Stepping action for the silicon six qubit array (mostly for debugging)
 
 #include "FourQubitSteppingAction.hh"
+#include "FourQubitConfigManager.hh"
+#include "FourQubitEventInfo.hh"
+#include "FourQubitRunCounters.hh"
 #include <iostream>
 #include "globals.hh"
+#include "G4CMPTrackInformation.hh"
+#include "G4CMPTrackUtils.hh"
+#include "G4Event.hh"
+#include "G4EventManager.hh"
+#include "G4PhononLong.hh"
+#include "G4PhononTransFast.hh"
+#include "G4PhononTransSlow.hh"
+#include "Randomize.hh"
 #include "G4Run.hh"
+#include "G4StackManager.hh"
 #include "G4Track.hh"
 #include "G4Step.hh"
 #include "G4Threading.hh"
@@ -21,19 +33,42 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 //Default constructor
 FourQubitSteppingAction::FourQubitSteppingAction()
+  : fNSteps(0), fNTracks(0), fProfiling(false), fCullTime(0.), fRouletteBounces(0), fRouletteSurvival(1.),
+    fStepBudget(0), fTrackBudget(0), fEventFirstStep(0), fEventFirstTrack(0), fEventCapped(false)
 {
-  //Upon construction of this class, create a ROOT file with step information and a tree with variables for
-  //storing the step information if needed
-  //fOutputFile.open("StepInformationFile.txt",std::ios::trunc);
-
-  
-  
+  //Step information is written by fTrace, which opens its file at the start
+  //of a run if /g4cmp/StepTraceFile is set
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 FourQubitSteppingAction::~FourQubitSteppingAction()
+{;}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+void FourQubitSteppingAction::BeginOfRun( G4int runID )
+{
+  fProfiling = FourQubitConfigManager::GetStepProfile();
+  fTrace.BeginOfRun(runID);
+  fCullTime = FourQubitConfigManager::GetPhononCullTime();
+  fRouletteBounces = FourQubitConfigManager::GetPhononRouletteBounces();
+  fRouletteSurvival = FourQubitConfigManager::GetPhononRouletteSurvival();
+  fStepBudget = FourQubitConfigManager::GetEventStepBudget();
+  fTrackBudget = FourQubitConfigManager::GetEventTrackBudget();
+}
+
+void FourQubitSteppingAction::BeginOfEvent()
+{
+  fEventFirstStep = fNSteps;
+  fEventFirstTrack = fNTracks;
+  fEventCapped = false;
+}
+
+void FourQubitSteppingAction::EndOfRun()
 {
-  //fOutputFile.close();
+  FourQubitRunCounters::AddSteps(fNSteps);
+  fNSteps = fNTracks = 0;
+  if( fProfiling ) fProfiler.EndOfRun();
+  fTrace.EndOfRun();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
@@ -43,8 +78,23 @@ void FourQubitSteppingAction::UserSteppingAction( const G4Step * step )
   //For now, simple: look at the pre-step point volume name and the track name
   //  std::cout << "REL stepping. PreSP volume name: " << step->GetPreStepPoint()->GetPhysicalVolume()->GetName() << ", track particle type: " << step->GetTrack()->GetParticleDefinition()->GetParticleName() << std::endl;
 
-  //First up: do generic exporting of step information (no cuts made here)
-  //ExportStepInformation(step);
+  ++fNSteps;
+  if( step->GetTrack()->GetCurrentStepNumber() == 1 ) ++fNTracks;
+
+  //Cheap per-thread counters, summarized at end of run (/g4cmp/StepProfile)
+  if( fProfiling ) fProfiler.Record(step);
+
+  //Sampled step trace; sampling and filters are applied by the recorder
+  if( fTrace.IsActive() ) ExportStepInformation(step);
+
+  //Phonon culling, after the sensor has seen the step
+  if( fCullTime > 0. || fRouletteBounces > 0 ) CullPhonon(step);
+
+  //Event watchdog, checked once the step is fully recorded
+  if( !fEventCapped &&
+      ((fStepBudget > 0 && fNSteps - fEventFirstStep >= fStepBudget) ||
+       (fTrackBudget > 0 && fNTracks - fEventFirstTrack >= fTrackBudget)) )
+    CapEvent(step);
   
   
   return;
@@ -53,37 +103,82 @@ void FourQubitSteppingAction::UserSteppingAction( const G4Step * step )
 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
-// Do a set of queries of information to test for anharmonic decay
+// Record pre/post step point, particle and process information, e.g. to test
+// for anharmonic decay.  See FourQubitStepTrace for the record layout.
 void FourQubitSteppingAction::ExportStepInformation( const G4Step * step )
 {
-  //Test
-  G4StepPoint * preSP = step->GetPreStepPoint();
-  G4StepPoint * postSP = step->GetPostStepPoint();
-
-  int runNo = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
-  int eventNo = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
-  int trackNo = step->GetTrack()->GetTrackID();
-  std::string particleName = step->GetTrack()->GetParticleDefinition()->GetParticleName();
-  double preStepX_mm = preSP->GetPosition().x() / CLHEP::mm;
-  double preStepY_mm = preSP->GetPosition().y() / CLHEP::mm;
-  double preStepZ_mm = preSP->GetPosition().z() / CLHEP::mm;
-  double preStepEnergy_eV = preSP->GetTotalEnergy() / CLHEP::eV;
-  double preStepKinEnergy_eV = preSP->GetKineticEnergy() / CLHEP::eV;
-  
-  double postStepX_mm = postSP->GetPosition().x() / CLHEP::mm;
-  double postStepY_mm = postSP->GetPosition().y() / CLHEP::mm;
-  double postStepZ_mm = postSP->GetPosition().z() / CLHEP::mm; 
-  double postStepEnergy_eV = postSP->GetTotalEnergy() / CLHEP::eV;
-  double postStepKinEnergy_eV = postSP->GetKineticEnergy() / CLHEP::eV;
+  fTrace.Record(step);
+}
 
-  std::string stepProcess = postSP->GetProcessDefinedStep()->GetProcessName();
-  
-  //Fill the output file with the step info
-  fOutputFile << runNo << " " << eventNo << " " << trackNo << " " << particleName << " "
-	      << preStepX_mm << " " << preStepY_mm << " " << preStepZ_mm << " " << preStepEnergy_eV << " " << preStepKinEnergy_eV << " " 
-	      << postStepX_mm << " " << postStepY_mm << " " << postStepZ_mm << " " << postStepEnergy_eV << " " << postStepKinEnergy_eV
-	      << " " << stepProcess << std::endl;
 
-  
-  
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+// Tracks already stopped (e.g. absorbed into a hit) are left alone.  The
+// roulette keeps weighted sums unbiased: a survivor carries 1/p of its old
+// weight, and its hits carry the new weight.  Reflections are counted by
+// G4CMP for /g4cmp/phononBounces; each reflection step is seen once, so
+// the check fires once per fRouletteBounces reflections.
+void FourQubitSteppingAction::CullPhonon( const G4Step * step )
+{
+  G4Track* track = step->GetTrack();
+  if( track->GetTrackStatus() != fAlive ) return;
+
+  const G4ParticleDefinition* particle = track->GetDefinition();
+  if( particle != G4PhononLong::Definition() &&
+      particle != G4PhononTransFast::Definition() &&
+      particle != G4PhononTransSlow::Definition() ) return;
+
+  if( fCullTime > 0. && track->GetGlobalTime() > fCullTime ){
+    track->SetTrackStatus(fStopAndKill);
+    return;
+  }
+
+  if( fRouletteBounces <= 0 ||
+      step->GetPostStepPoint()->GetStepStatus() != fGeomBoundary ) return;
+
+  const G4CMPTrackInformation* info = G4CMP::GetTrackInfo<G4CMPTrackInformation>(track);
+  G4int nBounces = info ? info->GetReflectionNumber() : 0;
+  if( nBounces == 0 || nBounces % fRouletteBounces != 0 ) return;
+
+  if( G4UniformRand() < fRouletteSurvival )
+    track->SetWeight(track->GetWeight() / fRouletteSurvival);
+  else
+    track->SetTrackStatus(fStopAndKill);
+}
+
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+// A Geant4 event is tracked start to finish on one thread, so a runaway
+// event cannot be handed to idle workers; instead it is stopped here, which
+// bounds the tail of the whole job.  Hits already made are kept, the current
+// track and its secondaries are killed, and the stacks are emptied so the
+// event ends at once.  The flags go out with the primary record, so the
+// analysis can drop or reweight capped events.
+void FourQubitSteppingAction::CapEvent( const G4Step * step )
+{
+  fEventCapped = true;
+
+  G4EventManager* eventMan = G4EventManager::GetEventManager();
+  G4Event* event = eventMan->GetNonconstCurrentEvent();
+  G4long nSteps = fNSteps - fEventFirstStep;
+  G4long nTracks = fNTracks - fEventFirstTrack;
+
+  FourQubitEventInfo* info = dynamic_cast<FourQubitEventInfo*>(event->GetUserInformation());
+  if( !info && !event->GetUserInformation() ){
+    info = new FourQubitEventInfo;
+    event->SetUserInformation(info);	//The event owns it
+  }
+  if( info ){
+    if( fStepBudget > 0 && nSteps >= fStepBudget ) info->SetFlag(FourQubitEventInfo::kStepBudget);
+    if( fTrackBudget > 0 && nTracks >= fTrackBudget ) info->SetFlag(FourQubitEventInfo::kTrackBudget);
+  }
+
+  step->GetTrack()->SetTrackStatus(fKillTrackAndSecondaries);
+  eventMan->GetStackManager()->clear();
+
+  G4ExceptionDescription msg;
+  msg << "Event " << event->GetEventID() << " stopped after " << nSteps
+      << " steps and " << nTracks << " tracks (/g4cmp/EventStepBudget "
+      << fStepBudget << ", /g4cmp/EventTrackBudget " << fTrackBudget << ")";
+  if( !info ) msg << "; it already carries other user information, so is not flagged";
+  G4Exception("FourQubitSteppingAction", "Watchdog001", JustWarning, msg);
 }
@@ -22,6 +22,7 @@
 // Includes (specific to this project)
 #include "FourQubitStraight.hh"
 #include "FourQubitDetectorParameters.hh"
+#include "FourQubitVisAttributes.hh"
 
 using namespace FourQubitDetectorParameters;
 
@@ -78,15 +79,12 @@ void FourQubitStraight::ConstructStraight(G4RotationMatrix *pRot,
   G4NistManager *nist = G4NistManager::Instance();
   G4Material *niobium_mat = nist->FindOrBuildMaterial("G4_Nb");
   G4Material *air_mat = nist->FindOrBuildMaterial("G4_AIR");
-  bool checkOverlaps = true;
+  bool checkOverlaps = pSurfChk;
 
   // Set up the visualization
-  G4VisAttributes *niobium_vis = new G4VisAttributes(G4Colour(0.0, 1.0, 1.0, 0.5));
-  niobium_vis->SetVisibility(true);
-  G4VisAttributes *air_vis = new G4VisAttributes(G4Colour(0.5, 0.5, 0.5, 0.5));
-  air_vis->SetVisibility(true);
-  G4VisAttributes *attention_vis = new G4VisAttributes(G4Colour(1.0, 0.0, 0.0, 1.0)); // used for debuging
-  attention_vis->SetVisibility(true);
+  const G4VisAttributes *niobium_vis = FourQubitVisAttributes::Get(G4Colour(0.0, 1.0, 1.0, 0.5));
+  const G4VisAttributes *air_vis = FourQubitVisAttributes::Get(G4Colour(0.5, 0.5, 0.5, 0.5));
+  const G4VisAttributes *attention_vis = FourQubitVisAttributes::Get(G4Colour(1.0, 0.0, 0.0, 1.0)); // used for debuging
 
   //------------------------------------------------------------------------------------------
   // Start with a base layer of niobium into which our objects will fit. We'll return this in the end.
@@ -118,7 +116,7 @@ void FourQubitStraight::ConstructStraight(G4RotationMatrix *pRot,
                                                           pMany,
                                                           pCopyNo,
                                                           pSurfChk);
-  fFundamentalVolumeList.push_back(std::tuple<std::string, G4String, G4VPhysicalVolume *>("Niobium", baseNbLayerName, phys_baseNbLayer));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium, baseNbLayerName, phys_baseNbLayer));
 
   //------------------------------------------------------------------------------------------
   // Straight
@@ -133,9 +131,9 @@ void FourQubitStraight::ConstructStraight(G4RotationMatrix *pRot,
     G4LogicalVolume *log_shlEmpty = new G4LogicalVolume(solid_shlEmpty, air_mat, shlEmptyNameLog);
 
 
-    G4VPhysicalVolume *shlEmpty = new G4PVPlacement(0, G4ThreeVector(0,0,0), log_shlEmpty, shlEmptyName, log_baseNbLayer, false, 0, true);
+    G4VPhysicalVolume *shlEmpty = new G4PVPlacement(0, G4ThreeVector(0,0,0), log_shlEmpty, shlEmptyName, log_baseNbLayer, false, 0, checkOverlaps);
     log_shlEmpty->SetVisAttributes(air_vis);
-    fFundamentalVolumeList.push_back(std::tuple<std::string, G4String, G4VPhysicalVolume *>("Vacuum", shlEmptyName, shlEmpty));
+    fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum, shlEmptyName, shlEmpty));
 
     // //------------------------------------------------------
     // // Straight horizontal line (SHL) (conductor)
@@ -144,9 +142,9 @@ void FourQubitStraight::ConstructStraight(G4RotationMatrix *pRot,
     G4String shlConductorNameLog = shlConductorName + "_log";
     G4Box *solid_shlConductor = new G4Box(shlConductorNameSolid, 0.5 * pLength, 0.5 * dp_tlCouplingConductorDimY, 0.5 * dp_shlConductorDimZ);
     G4LogicalVolume *log_shlConductor = new G4LogicalVolume(solid_shlConductor, niobium_mat, shlConductorNameLog);
-    G4VPhysicalVolume *shlConductor = new G4PVPlacement(0, G4ThreeVector(0, 0, 0), log_shlConductor, shlConductorName, log_shlEmpty, false, 0, true);
+    G4VPhysicalVolume *shlConductor = new G4PVPlacement(0, G4ThreeVector(0, 0, 0), log_shlConductor, shlConductorName, log_shlEmpty, false, 0, checkOverlaps);
     log_shlConductor->SetVisAttributes(niobium_vis);
-    fFundamentalVolumeList.push_back(std::tuple<std::string, G4String, G4VPhysicalVolume *>("Niobium", shlConductorName, shlConductor));
+    fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium, shlConductorName, shlConductor));
 
     
 
@@ -159,7 +157,7 @@ void FourQubitStraight::ConstructStraight(G4RotationMatrix *pRot,
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-std::vector<std::tuple<std::string, G4String, G4VPhysicalVolume *>> FourQubitStraight::GetListOfAllFundamentalSubVolumes()
+const FourQubitSubVolumeList& FourQubitStraight::GetListOfAllFundamentalSubVolumes() const
 {
   return fFundamentalVolumeList;
 }
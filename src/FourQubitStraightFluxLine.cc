@@ -45,6 +45,8 @@
 #include "FourQubitStraightFluxLine.hh"
 #include "FourQubitPad.hh"
 #include "FourQubitDetectorParameters.hh"
+#include "FourQubitGeometryArena.hh"
+#include "FourQubitVisAttributes.hh"
 
 using namespace FourQubitDetectorParameters;
 
@@ -100,13 +102,11 @@ void FourQubitStraightFluxLine::ConstructStraightFluxLine(G4RotationMatrix * pRo
   G4NistManager* nist = G4NistManager::Instance();
   G4Material* niobium_mat = nist->FindOrBuildMaterial("G4_Nb");
   G4Material* air_mat = nist->FindOrBuildMaterial("G4_AIR");
-  bool checkOverlaps = true;
+  bool checkOverlaps = pSurfChk;
 
   //Set up the niobium visualization
-  G4VisAttributes* niobium_vis= new G4VisAttributes(G4Colour(0.0,1.0,1.0,0.5));
-  niobium_vis->SetVisibility(true);
-  G4VisAttributes* air_vis= new G4VisAttributes(G4Colour(0.5,0.5,0.5,0.5));
-  air_vis->SetVisibility(true);
+  const G4VisAttributes* niobium_vis= FourQubitVisAttributes::Get(G4Colour(0.0,1.0,1.0,0.5));
+  const G4VisAttributes* air_vis= FourQubitVisAttributes::Get(G4Colour(0.5,0.5,0.5,0.5));
   
 
   
@@ -137,7 +137,7 @@ void FourQubitStraightFluxLine::ConstructStraightFluxLine(G4RotationMatrix * pRo
 							  pMany,
 							  pCopyNo,
 							  pSurfChk);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",baseNbLayerName,phys_baseNbLayer));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,baseNbLayerName,phys_baseNbLayer));
 
 
 
@@ -148,9 +148,9 @@ void FourQubitStraightFluxLine::ConstructStraightFluxLine(G4RotationMatrix * pRo
   
   //Pad 1:
   G4String pad1Name = pName + "_FluxLinePad1";
-  G4RotationMatrix * pad1Rot = new G4RotationMatrix();
+  G4RotationMatrix * pad1Rot = FourQubitGeometryArena::Instance()->Rotation();
   pad1Rot->rotateZ(90.*deg);
-  FourQubitPad * pad1 = new FourQubitPad(pad1Rot,
+  FourQubitPad * pad1 = FourQubitGeometryArena::Instance()->Make<FourQubitPad>(pad1Rot,
 							       G4ThreeVector(0,dp_fluxLinePadOffsetY,0),
 							       pad1Name,
 							       log_baseNbLayer,
@@ -184,9 +184,9 @@ void FourQubitStraightFluxLine::ConstructStraightFluxLine(G4RotationMatrix * pRo
 							     log_baseNbLayer,
 							     false,
 							     0,
-							     true);
+							     checkOverlaps);
   log_fluxLineEmpty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",flNameEmpty,phys_fluxLineEmpty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,flNameEmpty,phys_fluxLineEmpty));
   
   
   G4String flNameConductor = pName + "_FluxLineConductor";
@@ -206,9 +206,9 @@ void FourQubitStraightFluxLine::ConstructStraightFluxLine(G4RotationMatrix * pRo
 								 log_fluxLineEmpty,
 								 false,
 								 0,
-								 true);
+								 checkOverlaps);
   log_fluxLineConductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",flNameConductor,phys_fluxLineConductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,flNameConductor,phys_fluxLineConductor));
   
   
 
@@ -224,8 +224,7 @@ void FourQubitStraightFluxLine::ConstructStraightFluxLine(G4RotationMatrix * pRo
 
   /*
 
-  G4VisAttributes* simpleBoxVisAtt= new G4VisAttributes(G4Colour(1.0,0.647,0.0,0.9));
-  simpleBoxVisAtt->SetVisibility(true);
+  const G4VisAttributes* simpleBoxVisAtt= FourQubitVisAttributes::Get(G4Colour(1.0,0.647,0.0,0.9));
   log_QubitHousing->SetVisAttributes(simpleBoxVisAtt);
   */
 
@@ -236,7 +235,7 @@ void FourQubitStraightFluxLine::ConstructStraightFluxLine(G4RotationMatrix * pRo
 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > FourQubitStraightFluxLine::GetListOfAllFundamentalSubVolumes()
+const FourQubitSubVolumeList& FourQubitStraightFluxLine::GetListOfAllFundamentalSubVolumes() const
 {
   return fFundamentalVolumeList;
 }
@@ -244,11 +243,7 @@ std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > FourQubitStrai
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 void FourQubitStraightFluxLine::AddComplexGeometryPadSubVolumesToThisList(FourQubitPad * pad)
 {
-  for( int iSubVol = 0; iSubVol < pad->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol){
-    std::tuple<std::string,G4String,G4VPhysicalVolume*> theTuple(std::get<0>(pad->GetListOfAllFundamentalSubVolumes()[iSubVol]),
-								 std::get<1>(pad->GetListOfAllFundamentalSubVolumes()[iSubVol]),
-								 std::get<2>(pad->GetListOfAllFundamentalSubVolumes()[iSubVol]));
-    fFundamentalVolumeList.push_back(theTuple);
-  }
+  const FourQubitSubVolumeList& padVolumes = pad->GetListOfAllFundamentalSubVolumes();
+  fFundamentalVolumeList.insert(fFundamentalVolumeList.end(), padVolumes.begin(), padVolumes.end());
 }
 
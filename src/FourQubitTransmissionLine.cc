@@ -45,6 +45,8 @@
 #include "FourQubitTransmissionLine.hh"
 #include "FourQubitPad.hh"
 #include "FourQubitDetectorParameters.hh"
+#include "FourQubitGeometryArena.hh"
+#include "FourQubitVisAttributes.hh"
 
 using namespace FourQubitDetectorParameters;
 
@@ -95,18 +97,17 @@ void FourQubitTransmissionLine::ConstructTransmissionLine(G4RotationMatrix * pRo
 							     G4int pCopyNo,
 							     G4bool pSurfChk)
 {
+  FourQubitGeometryArena * arena = FourQubitGeometryArena::Instance();
 
   //Start with some preliminaries - NIST manager
   G4NistManager* nist = G4NistManager::Instance();
   G4Material* niobium_mat = nist->FindOrBuildMaterial("G4_Nb");
   G4Material* air_mat = nist->FindOrBuildMaterial("G4_AIR");
-  bool checkOverlaps = true;
+  bool checkOverlaps = pSurfChk;
 
   //Set up the niobium visualization
-  G4VisAttributes* niobium_vis= new G4VisAttributes(G4Colour(0.0,1.0,1.0,0.5));
-  niobium_vis->SetVisibility(true);
-  G4VisAttributes* air_vis= new G4VisAttributes(G4Colour(0.5,0.5,0.5,0.5));
-  air_vis->SetVisibility(true);
+  const G4VisAttributes* niobium_vis= FourQubitVisAttributes::Get(G4Colour(0.0,1.0,1.0,0.5));
+  const G4VisAttributes* air_vis= FourQubitVisAttributes::Get(G4Colour(0.5,0.5,0.5,0.5));
   
 
   
@@ -140,7 +141,7 @@ void FourQubitTransmissionLine::ConstructTransmissionLine(G4RotationMatrix * pRo
 							  pSurfChk);
   
   //Push this sub volume (the niobium base layer) back into the fundamental volume list
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",baseNbLayerName,phys_baseNbLayer));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,baseNbLayerName,phys_baseNbLayer));
   
 
 
@@ -151,7 +152,7 @@ void FourQubitTransmissionLine::ConstructTransmissionLine(G4RotationMatrix * pRo
   
   //Pad 1:
   G4String pad1Name = pName + "_TransmissionLinePad1";
-  FourQubitPad * pad1 = new FourQubitPad(0,
+  FourQubitPad * pad1 = arena->Make<FourQubitPad>(nullptr,
 							       G4ThreeVector(dp_transmissionLinePad1Offset,0,0),
 							       pad1Name,
 							       log_baseNbLayer,
@@ -168,9 +169,9 @@ void FourQubitTransmissionLine::ConstructTransmissionLine(G4RotationMatrix * pRo
 
   //Pad 2: rotate around Z axis by 180 degrees
   G4String pad2Name = pName + "_TransmissionLinePad2";
-  G4RotationMatrix * pad2Rot = new G4RotationMatrix();
+  G4RotationMatrix * pad2Rot = arena->Rotation();
   pad2Rot->rotateZ(180*deg);
-  FourQubitPad * pad2 = new FourQubitPad(pad2Rot,
+  FourQubitPad * pad2 = arena->Make<FourQubitPad>(pad2Rot,
 							       G4ThreeVector(dp_transmissionLinePad2Offset,0,0),
 							       pad2Name,
 							       log_baseNbLayer,
@@ -212,8 +213,8 @@ void FourQubitTransmissionLine::ConstructTransmissionLine(G4RotationMatrix * pRo
 								     log_baseNbLayer,
 								     false,
 								     0,
-								     true);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",tlNameEmpty,phys_transmissionLineEmpty));
+								     checkOverlaps);
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,tlNameEmpty,phys_transmissionLineEmpty));
 
 
 
@@ -238,8 +239,8 @@ void FourQubitTransmissionLine::ConstructTransmissionLine(G4RotationMatrix * pRo
 									 log_transmissionLineEmpty,
 									 false,
 									 0,
-									 true);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",tlNameConductor,phys_transmissionLineConductor));
+									 checkOverlaps);
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,tlNameConductor,phys_transmissionLineConductor));
 
 
   ///////////////////////////////////////////
@@ -252,8 +253,7 @@ void FourQubitTransmissionLine::ConstructTransmissionLine(G4RotationMatrix * pRo
 
   /*
 
-  G4VisAttributes* simpleBoxVisAtt= new G4VisAttributes(G4Colour(1.0,0.647,0.0,0.9));
-  simpleBoxVisAtt->SetVisibility(true);
+  const G4VisAttributes* simpleBoxVisAtt= FourQubitVisAttributes::Get(G4Colour(1.0,0.647,0.0,0.9));
   log_QubitHousing->SetVisAttributes(simpleBoxVisAtt);
   */
 
@@ -277,7 +277,7 @@ G4UnionSolid * FourQubitTransmissionLine::CreatePieceBasedNbLayer(G4String nameS
   G4Trd * solid_padEmptyPart2 = new G4Trd("baseNbLayerEmptyPadPart2Solid",0.5 * dp_padEmptyPart2TrdX1,0.5 * dp_padEmptyPart2TrdX2,0.5 * dp_padEmptyPart2TrdY1,0.5 * dp_padEmptyPart2TrdY2,0.5 * dp_padEmptyPart2TrdZ);
 
   //We need to rotate the part 2 so that it can be aligned and placed next to part 1
-  G4RotationMatrix * rotEmptyPart2 = new G4RotationMatrix();
+  G4RotationMatrix * rotEmptyPart2 = FourQubitGeometryArena::Instance()->Rotation();
   rotEmptyPart2->rotateX(90.*deg);
   rotEmptyPart2->rotateY(-90.*deg);
 
@@ -299,7 +299,7 @@ G4UnionSolid * FourQubitTransmissionLine::CreatePieceBasedNbLayer(G4String nameS
 						  0,
 						  G4ThreeVector(dp_transmissionLinePad1Offset,0,0));
 
-  G4RotationMatrix * pad2Rot = new G4RotationMatrix();
+  G4RotationMatrix * pad2Rot = FourQubitGeometryArena::Instance()->Rotation();
   pad2Rot->rotateZ(180*deg);
   G4UnionSolid * solid_baseNbLayer = new G4UnionSolid(nameSolid,
 						      solid_merger1,
@@ -312,7 +312,7 @@ G4UnionSolid * FourQubitTransmissionLine::CreatePieceBasedNbLayer(G4String nameS
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > FourQubitTransmissionLine::GetListOfAllFundamentalSubVolumes()
+const FourQubitSubVolumeList& FourQubitTransmissionLine::GetListOfAllFundamentalSubVolumes() const
 {
   return fFundamentalVolumeList;
 }
@@ -320,10 +320,6 @@ std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > FourQubitTrans
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 void FourQubitTransmissionLine::AddComplexGeometryPadSubVolumesToThisList(FourQubitPad * pad)
 {
-  for( int iSubVol = 0; iSubVol < pad->GetListOfAllFundamentalSubVolumes().size(); ++iSubVol){
-    std::tuple<std::string,G4String,G4VPhysicalVolume*> theTuple(std::get<0>(pad->GetListOfAllFundamentalSubVolumes()[iSubVol]),
-								 std::get<1>(pad->GetListOfAllFundamentalSubVolumes()[iSubVol]),
-								 std::get<2>(pad->GetListOfAllFundamentalSubVolumes()[iSubVol]));
-    fFundamentalVolumeList.push_back(theTuple);
-  }
+  const FourQubitSubVolumeList& padVolumes = pad->GetListOfAllFundamentalSubVolumes();
+  fFundamentalVolumeList.insert(fFundamentalVolumeList.end(), padVolumes.begin(), padVolumes.end());
 }
@@ -21,6 +21,7 @@
 //Includes (specific to this project)
 #include "FourQubitTransmon.hh"
 #include "FourQubitDetectorParameters.hh"
+#include "FourQubitVisAttributes.hh"
 
 using namespace FourQubitDetectorParameters;
 
@@ -74,15 +75,12 @@ void FourQubitTransmon::ConstructTransmon(G4RotationMatrix * pRot,
   G4NistManager* nist = G4NistManager::Instance();
   G4Material* niobium_mat = nist->FindOrBuildMaterial("G4_Nb");
   G4Material* air_mat = nist->FindOrBuildMaterial("G4_AIR");
-  bool checkOverlaps = true;
+  bool checkOverlaps = pSurfChk;
 
   //Set up the visualization
-  G4VisAttributes* niobium_vis= new G4VisAttributes(G4Colour(0.0,1.0,1.0,0.5));
-  niobium_vis->SetVisibility(true);
-  G4VisAttributes* air_vis= new G4VisAttributes(G4Colour(0.5,0.5,0.5,0.5));
-  air_vis->SetVisibility(true);
-  G4VisAttributes* attention_vis= new G4VisAttributes(G4Colour(1.0,0.0,0.0,1.0)); // used for debuging
-  attention_vis->SetVisibility(true);
+  const G4VisAttributes* niobium_vis= FourQubitVisAttributes::Get(G4Colour(0.0,1.0,1.0,0.5));
+  const G4VisAttributes* air_vis= FourQubitVisAttributes::Get(G4Colour(0.5,0.5,0.5,0.5));
+  const G4VisAttributes* attention_vis= FourQubitVisAttributes::Get(G4Colour(1.0,0.0,0.0,1.0)); // used for debuging
   
 
 
@@ -113,7 +111,7 @@ void FourQubitTransmon::ConstructTransmon(G4RotationMatrix * pRot,
 							  pMany,
 							  pCopyNo,
 							  pSurfChk);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",baseAirLayerName,phys_baseAirLayer));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,baseAirLayerName,phys_baseAirLayer));
 
 
   //------------------------------------------------------------------------------------------
@@ -149,9 +147,9 @@ void FourQubitTransmon::ConstructTransmon(G4RotationMatrix * pRot,
 								 log_baseAirLayer,
 								 false,
 								 0,
-								 true);
+								 checkOverlaps);
   log_transmonCapBar0Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",cb0NameConductor,phys_transmonCapBar0Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,cb0NameConductor,phys_transmonCapBar0Conductor));
   
   //------------------------------------------------------------------------------------------
   //Capacitor Bar 1 conductor.  No need for emppty space as field is already empty
@@ -177,9 +175,9 @@ void FourQubitTransmon::ConstructTransmon(G4RotationMatrix * pRot,
 								 log_baseAirLayer,
 								 false,
 								 0,
-								 true);
+								 checkOverlaps);
   log_transmonCapBar1Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",cb1NameConductor,phys_transmonCapBar1Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,cb1NameConductor,phys_transmonCapBar1Conductor));
     
   //------------------------------------------------------------------------------------------
   //Coupler Bar 0 conductor.  No need for emppty space as field is already empty
@@ -207,9 +205,9 @@ void FourQubitTransmon::ConstructTransmon(G4RotationMatrix * pRot,
 								 log_baseAirLayer,
 								 false,
 								 0,
-								 true);
+								 checkOverlaps);
   log_transmonCapCoup0Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",co0NameConductor,phys_transmonCapCoup0Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,co0NameConductor,phys_transmonCapCoup0Conductor));
 
   //------------------------------------------------------------------------------------------
   //Coupler Bar 1 conductor.  No need for emppty space as field is already empty
@@ -237,9 +235,9 @@ void FourQubitTransmon::ConstructTransmon(G4RotationMatrix * pRot,
 								 log_baseAirLayer,
 								 false,
 								 0,
-								 true);
+								 checkOverlaps);
   log_transmonCapCoup1Conductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",co1NameConductor,phys_transmonCapCoup1Conductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,co1NameConductor,phys_transmonCapCoup1Conductor));
 
   //------------------------------------------------------------------------------------------
   //Res Coupling Bar conductor.  No need for emppty space as field is already empty
@@ -267,9 +265,9 @@ void FourQubitTransmon::ConstructTransmon(G4RotationMatrix * pRot,
 								 log_baseAirLayer,
 								 false,
 								 0,
-								 true);
+								 checkOverlaps);
   log_transmonResCoupConductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",rcNameConductor,phys_transmonResCoupConductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,rcNameConductor,phys_transmonResCoupConductor));
 
   //------------------------------------------------------------------------------------------
   //Res line conductor.  No need for emppty space as field is already empty
@@ -297,9 +295,9 @@ void FourQubitTransmon::ConstructTransmon(G4RotationMatrix * pRot,
 								 log_baseAirLayer,
 								 false,
 								 0,
-								 true);
+								 checkOverlaps);
   log_transmonResLineConductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",rlNameConductor,phys_transmonResLineConductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,rlNameConductor,phys_transmonResLineConductor));
 
   ///////////////////////////////////////////
   // Output logical/physical volume selection
@@ -310,8 +308,7 @@ void FourQubitTransmon::ConstructTransmon(G4RotationMatrix * pRot,
 
   /*
 
-  G4VisAttributes* simpleBoxVisAtt= new G4VisAttributes(G4Colour(1.0,0.647,0.0,0.9));
-  simpleBoxVisAtt->SetVisibility(true);
+  const G4VisAttributes* simpleBoxVisAtt= FourQubitVisAttributes::Get(G4Colour(1.0,0.647,0.0,0.9));
   log_QubitHousing->SetVisAttributes(simpleBoxVisAtt);
   */
 
@@ -322,7 +319,7 @@ void FourQubitTransmon::ConstructTransmon(G4RotationMatrix * pRot,
 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > FourQubitTransmon::GetListOfAllFundamentalSubVolumes()
+const FourQubitSubVolumeList& FourQubitTransmon::GetListOfAllFundamentalSubVolumes() const
 {
   return fFundamentalVolumeList;
 }
@@ -0,0 +1,141 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitVertexBank.cc
+//
+// Description:	Read-only memory mapping of a pre-sampled vertex file.
+
+#include "FourQubitVertexBank.hh"
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <fcntl.h>
+#include <fstream>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace {
+  G4Mutex bankMutex = G4MUTEX_INITIALIZER;
+  std::unique_ptr<FourQubitVertexBank> currentBank;
+
+  // Written by the master between runs, read by every thread during them
+  G4String offsetFile;
+  G4long runOffset = 0;
+}
+
+
+const FourQubitVertexBank* FourQubitVertexBank::Open(const G4String& filename) {
+  G4AutoLock lock(&bankMutex);
+  if (!currentBank || currentBank->GetFileName() != filename) {
+    currentBank.reset(new FourQubitVertexBank(filename));
+    if (currentBank->base) {
+      G4cout << "FourQubitVertexBank: " << currentBank->nRecords
+	     << " vertices in " << filename << G4endl;
+    }
+  }
+  return currentBank->base ? currentBank.get() : nullptr;
+}
+
+
+// The header is parsed with the ordinary stream reader; only the records
+// are read through the mapping
+
+FourQubitVertexBank::FourQubitVertexBank(const G4String& filename)
+  : fileName(filename), fields(FourQubitHitFormat::VertexFields()),
+    base(nullptr), length(0), nRecords(0) {
+  G4ExceptionDescription msg;
+  std::ifstream in(filename, std::ios_base::binary);
+  if (!FourQubitHitFormat::ReadHeader(in, header) || !header.IsVertices()) {
+    msg << filename << " is not a FourQubit vertex bank (FQVTXS).";
+    G4Exception("FourQubitVertexBank", "VertexBank001", JustWarning, msg);
+    return;
+  }
+  in.close();
+
+  if (header.recordSize < sizeof(FourQubitHitFormat::VertexRecord)) {
+    msg << filename << " has " << header.recordSize << "-byte records; at least "
+	<< sizeof(FourQubitHitFormat::VertexRecord) << " are needed.";
+    G4Exception("FourQubitVertexBank", "VertexBank001", JustWarning, msg);
+    return;
+  }
+
+  int fd = open(filename.c_str(), O_RDONLY);
+  struct stat info;
+  if (fd < 0 || fstat(fd, &info) != 0 || size_t(info.st_size) < header.size) {
+    msg << "Error opening vertex bank " << filename;
+    G4Exception("FourQubitVertexBank", "VertexBank002", JustWarning, msg);
+    if (fd >= 0) close(fd);
+    return;
+  }
+
+  length = size_t(info.st_size);
+  void* map = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);				// The mapping keeps the file open
+  if (map == MAP_FAILED) {
+    msg << "Error mapping vertex bank " << filename;
+    G4Exception("FourQubitVertexBank", "VertexBank002", JustWarning, msg);
+    length = 0;
+    return;
+  }
+
+  // Each thread reads forward through its own blocks of records, so the
+  // kernel may read ahead and drop pages once they are behind
+  madvise(map, length, MADV_SEQUENTIAL);
+  base = static_cast<const char*>(map);
+  nRecords = G4long((length - header.size) / header.recordSize);
+
+  if ((length - header.size) % header.recordSize != 0) {
+    msg << filename << " ends in a partial record, which is ignored.";
+    G4Exception("FourQubitVertexBank", "VertexBank003", JustWarning, msg);
+  }
+}
+
+FourQubitVertexBank::~FourQubitVertexBank() {
+  if (base) munmap(const_cast<char*>(base), length);
+}
+
+
+// Hot path: one copy per event
+
+G4bool FourQubitVertexBank::Read(G4long i, FourQubitHitFormat::VertexRecord& rec) const {
+  if (i < 0 || i >= nRecords) return false;
+
+  std::memcpy(&rec, base + header.size + size_t(i)*header.recordSize, sizeof(rec));
+  if (!FourQubitHitFormat::HostIsLittleEndian())
+    FourQubitHitFormat::SwapRecord(&rec, fields);
+  return true;
+}
+
+void FourQubitVertexBank::Prefetch(G4long first, G4long n) const {
+  first = std::max(first, G4long(0));
+  n = std::min(n, nRecords-first);
+  if (n <= 0) return;
+
+  static const size_t page = size_t(sysconf(_SC_PAGESIZE));
+  size_t begin = header.size + size_t(first)*header.recordSize;
+  size_t end = begin + size_t(n)*header.recordSize;
+  begin -= begin % page;			// madvise wants page alignment
+  madvise(const_cast<char*>(base) + begin, end-begin, MADV_WILLNEED);
+}
+
+
+// Run offsets
+
+G4long FourQubitVertexBank::GetRunOffset(const G4String& filename) {
+  return (filename == offsetFile) ? runOffset : 0;
+}
+
+void FourQubitVertexBank::EndOfRun(const G4String& filename, G4long span) {
+  if (filename.empty()) return;
+  if (filename != offsetFile) {
+    offsetFile = filename;
+    runOffset = 0;
+  }
+  runOffset += span;
+}
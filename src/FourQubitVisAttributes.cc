@@ -0,0 +1,36 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+// File:  FourQubitVisAttributes.cc
+//
+// Description:	Shared vis attributes for the geometry components.
+
+#include "FourQubitVisAttributes.hh"
+#include "FourQubitConfigManager.hh"
+#include "G4VisAttributes.hh"
+#include <map>
+#include <memory>
+#include <tuple>
+
+
+// The geometry is built on the master only, so no locking.  Attributes
+// are kept to the end of the job: a rebuilt geometry reuses them, and
+// the vis manager may still point at them.
+
+const G4VisAttributes* FourQubitVisAttributes::Get(const G4Colour& colour) {
+  if (FourQubitConfigManager::GetHeadless()) return nullptr;
+
+  typedef std::tuple<G4double,G4double,G4double,G4double> Key;
+  static std::map<Key, std::unique_ptr<G4VisAttributes> > cache;
+
+  Key key(colour.GetRed(), colour.GetGreen(), colour.GetBlue(), colour.GetAlpha());
+  std::unique_ptr<G4VisAttributes>& attributes = cache[key];
+  if (!attributes) {
+    attributes.reset(new G4VisAttributes(colour));
+    attributes->SetVisibility(true);
+  }
+  return attributes.get();
+}
@@ -21,6 +21,7 @@
 //Includes (specific to this project)
 #include "FourQubitXmon.hh"
 #include "FourQubitDetectorParameters.hh"
+#include "FourQubitVisAttributes.hh"
 
 using namespace FourQubitDetectorParameters;
 
@@ -74,15 +75,12 @@ void FourQubitXmon::ConstructXmon(G4RotationMatrix * pRot,
   G4NistManager* nist = G4NistManager::Instance();
   G4Material* niobium_mat = nist->FindOrBuildMaterial("G4_Nb");
   G4Material* air_mat = nist->FindOrBuildMaterial("G4_AIR");
-  bool checkOverlaps = true;
+  bool checkOverlaps = pSurfChk;
 
   //Set up the visualization
-  G4VisAttributes* niobium_vis= new G4VisAttributes(G4Colour(0.0,1.0,1.0,0.5));
-  niobium_vis->SetVisibility(true);
-  G4VisAttributes* air_vis= new G4VisAttributes(G4Colour(0.5,0.5,0.5,0.5));
-  air_vis->SetVisibility(true);
-  G4VisAttributes* attention_vis= new G4VisAttributes(G4Colour(1.0,0.0,0.0,1.0)); // used for debuging
-  attention_vis->SetVisibility(true);
+  const G4VisAttributes* niobium_vis= FourQubitVisAttributes::Get(G4Colour(0.0,1.0,1.0,0.5));
+  const G4VisAttributes* air_vis= FourQubitVisAttributes::Get(G4Colour(0.5,0.5,0.5,0.5));
+  const G4VisAttributes* attention_vis= FourQubitVisAttributes::Get(G4Colour(1.0,0.0,0.0,1.0)); // used for debuging
   
 
   //------------------------------------------------------------------------------------------
@@ -115,7 +113,7 @@ void FourQubitXmon::ConstructXmon(G4RotationMatrix * pRot,
 							                                            pMany,
 							                                            pCopyNo,
 							                                            pSurfChk);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",baseNbLayerName,phys_baseNbLayer));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,baseNbLayerName,phys_baseNbLayer));
 
 
   //------------------------------------------------------------------------------------------
@@ -145,9 +143,9 @@ void FourQubitXmon::ConstructXmon(G4RotationMatrix * pRot,
 
   G4LogicalVolume * log_xmonEmpty = new G4LogicalVolume(solid_xmonEmpty,air_mat,xmonEmptyNameLog);
 
-  G4VPhysicalVolume * xmonEmpty = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_xmonEmpty,xmonEmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * xmonEmpty = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_xmonEmpty,xmonEmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_xmonEmpty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",xmonEmptyName,xmonEmpty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,xmonEmptyName,xmonEmpty));
 
   //------------------------------------------------------
   //xmon block (conductor)
@@ -158,9 +156,9 @@ void FourQubitXmon::ConstructXmon(G4RotationMatrix * pRot,
   G4Box * solid_xmonHorizontalBlockConductor = new G4Box("xmonHorizontalBlockConductor",0.5 * dp_xmonHorizontalBlockConductorDimX,0.5 * dp_xmonHorizontalBlockConductorDimY,0.5 * dp_xmonHorizontalBlockConductorDimZ);
   G4UnionSolid * solid_xmonConductor = new G4UnionSolid(xmonConductorNameSolid,solid_xmonVertBlockConductor,solid_xmonHorizontalBlockConductor,0,G4ThreeVector(0,0,0));  
   G4LogicalVolume * log_xmonConductor = new G4LogicalVolume(solid_xmonConductor,niobium_mat,xmonConductorNameLog);
-  G4VPhysicalVolume * xmonConductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_xmonConductor,xmonConductorName,log_xmonEmpty,false,0,true);
+  G4VPhysicalVolume * xmonConductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_xmonConductor,xmonConductorName,log_xmonEmpty,false,0,checkOverlaps);
   log_xmonConductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",xmonConductorName,xmonConductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,xmonConductorName,xmonConductor));
     
   //------------------------------------------------------
   //Coupler (empty)
@@ -176,9 +174,9 @@ void FourQubitXmon::ConstructXmon(G4RotationMatrix * pRot,
   G4ThreeVector xmonCoupler(0,
                             - (0.5 * dp_xmonVertBlockConductorDimY) - dp_xmonSpacing - 0.5*dp_xmonCouplerHorizontalEmptyDimY,
                             0);
-  G4VPhysicalVolume * xmonCouplerEmpty = new G4PVPlacement(0,xmonCoupler,log_xmonCouplerEmpty,xmonCouplerEmptyName,log_baseNbLayer,false,0,true);
+  G4VPhysicalVolume * xmonCouplerEmpty = new G4PVPlacement(0,xmonCoupler,log_xmonCouplerEmpty,xmonCouplerEmptyName,log_baseNbLayer,false,0,checkOverlaps);
   log_xmonCouplerEmpty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",xmonCouplerEmptyName,xmonCouplerEmpty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,xmonCouplerEmptyName,xmonCouplerEmpty));
   
   //------------------------------------------------------
   //Coupler (conductor)
@@ -201,9 +199,9 @@ void FourQubitXmon::ConstructXmon(G4RotationMatrix * pRot,
   G4UnionSolid * solid_xmonCouplerMerge2Conductor = new G4UnionSolid("xmonCouplerHorizontalPlusLeft",solid_xmonCouplerHorizontalConductor,solid_xmonCouplerLeftLobeConductor,0,G4ThreeVector(-0.5*dp_xmonCouplerHorizontalConductorDimX + 0.5*dp_xmonCouplerLobeConductorDimX,0.5*(dp_xmonCouplerHorizontalConductorDimY+dp_xmonCouplerLobeConductorDimY),0));
   G4UnionSolid * solid_xmonCouplerConductor = new G4UnionSolid(xmonCouplerConductorNameSolid,solid_xmonCouplerMerge2Conductor,solid_xmonCouplerRightLobeConductor,0,G4ThreeVector(0.5*dp_xmonCouplerHorizontalConductorDimX - 0.5*dp_xmonCouplerLobeConductorDimX,0.5*(dp_xmonCouplerHorizontalConductorDimY+dp_xmonCouplerLobeConductorDimY),0));      
   G4LogicalVolume * log_xmonCouplerConductor = new G4LogicalVolume(solid_xmonCouplerConductor,niobium_mat,xmonCouplerConductorNameLog);
-  G4VPhysicalVolume * xmonCouplerConductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_xmonCouplerConductor,xmonCouplerConductorName,log_xmonCouplerEmpty,false,0,true);
+  G4VPhysicalVolume * xmonCouplerConductor = new G4PVPlacement(0,G4ThreeVector(0,0,0),log_xmonCouplerConductor,xmonCouplerConductorName,log_xmonCouplerEmpty,false,0,checkOverlaps);
   log_xmonCouplerConductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",xmonCouplerConductorName,xmonCouplerConductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,xmonCouplerConductorName,xmonCouplerConductor));
   
 
   //------------------------------------------------------------------------------------------
@@ -237,9 +235,9 @@ void FourQubitXmon::ConstructXmon(G4RotationMatrix * pRot,
 								                                                log_baseNbLayer,
 								                                                false,
 								                                                0,
-								                                                true);
+								                                                checkOverlaps);
   log_xmonResLineEmpty->SetVisAttributes(air_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Vacuum",rlNameEmpty,phys_xmonResLineEmpty));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Vacuum,rlNameEmpty,phys_xmonResLineEmpty));
 
   // Res Line
   G4String rlNameConductor = pName + "_xmonResLineConductor";
@@ -262,9 +260,9 @@ void FourQubitXmon::ConstructXmon(G4RotationMatrix * pRot,
 								 log_xmonResLineEmpty,
 								 false,
 								 0,
-								 true);
+								 checkOverlaps);
   log_xmonResLineConductor->SetVisAttributes(niobium_vis);
-  fFundamentalVolumeList.push_back(std::tuple<std::string,G4String,G4VPhysicalVolume*>("Niobium",rlNameConductor,phys_xmonResLineConductor));
+  fFundamentalVolumeList.push_back(FourQubitSubVolume(FourQubitMaterialTag::Niobium,rlNameConductor,phys_xmonResLineConductor));
 
   ///////////////////////////////////////////
   // Output logical/physical volume selection
@@ -275,8 +273,7 @@ void FourQubitXmon::ConstructXmon(G4RotationMatrix * pRot,
 
   /*
 
-  G4VisAttributes* simpleBoxVisAtt= new G4VisAttributes(G4Colour(1.0,0.647,0.0,0.9));
-  simpleBoxVisAtt->SetVisibility(true);
+  const G4VisAttributes* simpleBoxVisAtt= FourQubitVisAttributes::Get(G4Colour(1.0,0.647,0.0,0.9));
   log_QubitHousing->SetVisAttributes(simpleBoxVisAtt);
   */
 
@@ -287,7 +284,7 @@ void FourQubitXmon::ConstructXmon(G4RotationMatrix * pRot,
 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-std::vector<std::tuple<std::string,G4String,G4VPhysicalVolume*> > FourQubitXmon::GetListOfAllFundamentalSubVolumes()
+const FourQubitSubVolumeList& FourQubitXmon::GetListOfAllFundamentalSubVolumes() const
 {
   return fFundamentalVolumeList;
 }